@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "../include/arena.hpp"
+#include "../include/gameboy.hpp"
+#include "synthetic_roms.hpp"
+
+namespace {
+
+// A CGB, MBC5 ROM with 32 KB of cartridge RAM
+std::vector<uint8_t> bankedRom() {
+  std::vector<uint8_t> rom = synthetic::aluLoop();
+  rom[0x0143] = 0x80;
+  rom[0x0147] = 0x1B;
+  rom[0x0149] = 0x03;
+  return rom;
+}
+
+// Writes every RAM bank, as a running game eventually does
+void touchAllBanks(GameBoy &gameboy) {
+  Memory &memory = gameboy.memory;
+  memory.writeByte(0x0000, 0x0A);  // Enable cartridge RAM
+  for (uint8_t bank = 0; bank < 8; bank++) {
+    memory.selectVramBank(bank);
+    memory.selectWramBank(bank);
+    memory.writeByte(0x4000, bank);  // Cartridge RAM bank
+    for (uint32_t address = 0x8000; address < 0xE000; address += 0x1000) {
+      memory.writeByte(address, bank);
+    }
+  }
+}
+
+}  // namespace
+
+// Create, populate and destroy one machine, with and without an arena
+static void BM_InstanceLifecycle(benchmark::State &state) {
+  bool useArena = state.range(0);
+  Cartridge::Image rom = Cartridge::prepare(bankedRom());
+
+  for (auto _ : state) {
+    auto gameboy = std::make_unique<GameBoy>(
+        useArena ? std::make_shared<Arena>() : nullptr);
+    gameboy->loadRom(rom);
+    touchAllBanks(*gameboy);
+    benchmark::DoNotOptimize(gameboy.get());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_InstanceLifecycle)->ArgName("arena")->Arg(0)->Arg(1);
+
+// Creating and destroying many machines at once, as a search front does
+static void BM_InstanceBatch(benchmark::State &state) {
+  bool useArena = state.range(0);
+  Cartridge::Image rom = Cartridge::prepare(bankedRom());
+  std::vector<std::unique_ptr<GameBoy>> machines(1000);
+
+  for (auto _ : state) {
+    for (std::unique_ptr<GameBoy> &gameboy : machines) {
+      gameboy = std::make_unique<GameBoy>(
+          useArena ? std::make_shared<Arena>() : nullptr);
+      gameboy->loadRom(rom);
+      touchAllBanks(*gameboy);
+    }
+    for (std::unique_ptr<GameBoy> &gameboy : machines) {
+      gameboy.reset();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * machines.size());
+}
+BENCHMARK(BM_InstanceBatch)
+    ->ArgName("arena")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
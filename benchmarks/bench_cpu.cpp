@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/cpu.hpp"
+#include "../include/memory.hpp"
+#include "synthetic_roms.hpp"
+
+// Opcode dispatch throughput over a mixed register/ALU/jump loop
+static void BM_OpcodeDispatch(benchmark::State &state) {
+  Memory memory;
+  CPU cpu{memory};
+  memory.loadRom(synthetic::aluLoop());
+  cpu.PC = 0x0100;
+
+  for (auto _ : state) {
+    cpu.executeOpcode();
+  }
+  benchmark::DoNotOptimize(cpu.A);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OpcodeDispatch);
+
+// ALU flag computation for a single opcode, executed from register operands
+static void BM_AluFlags(benchmark::State &state) {
+  Memory memory;
+  CPU cpu{memory};
+  memory.writeByte(0x0000, static_cast<uint8_t>(state.range(0)));
+  uint8_t operand = 0;
+
+  for (auto _ : state) {
+    cpu.PC = 0;
+    cpu.B = operand++;
+    cpu.executeOpcode();
+    benchmark::DoNotOptimize(cpu.F);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AluFlags)
+    ->ArgName("opcode")
+    ->Arg(0x80)   // ADD A,B
+    ->Arg(0x88)   // ADC A,B
+    ->Arg(0x90)   // SUB B
+    ->Arg(0x98)   // SBC A,B
+    ->Arg(0xA0)   // AND B
+    ->Arg(0xA8)   // XOR B
+    ->Arg(0xB0)   // OR B
+    ->Arg(0xB8)   // CP B
+    ->Arg(0x04)   // INC B
+    ->Arg(0x27);  // DAA
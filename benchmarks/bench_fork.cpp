@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "../include/gameboy.hpp"
+#include "synthetic_roms.hpp"
+
+namespace {
+
+// Bytes currently allocated on the heap, or 0 where that is not available
+size_t heapInUse() {
+#if defined(__GLIBC__)
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
+// A memory with every RAM bank written, as after a game has been running
+Memory populatedMemory() {
+  Memory memory;
+  memory.setCgb(true);
+  for (uint8_t bank = 0; bank < 8; bank++) {
+    memory.selectVramBank(bank);
+    memory.selectWramBank(bank);
+    for (uint32_t address = 0x8000; address < 0xE000; address += 0x100) {
+      memory.writeByte(address, bank);
+    }
+  }
+  return memory;
+}
+
+}  // namespace
+
+// Memory::fork: a copy-on-write copy
+static void BM_MemoryFork(benchmark::State &state) {
+  Memory memory = populatedMemory();
+
+  for (auto _ : state) {
+    Memory fork = memory.fork();
+    benchmark::DoNotOptimize(&fork);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryFork);
+
+// The copy constructor, which copies every page, for comparison
+static void BM_MemoryCopy(benchmark::State &state) {
+  Memory memory = populatedMemory();
+
+  for (auto _ : state) {
+    Memory copy = memory;
+    benchmark::DoNotOptimize(&copy);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryCopy);
+
+// A fork that then writes one byte, paying for one page copy
+static void BM_MemoryForkAndWrite(benchmark::State &state) {
+  Memory memory = populatedMemory();
+
+  for (auto _ : state) {
+    Memory fork = memory.fork();
+    fork.writeByte(0xC000, 0x01);
+    benchmark::DoNotOptimize(&fork);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryForkAndWrite);
+
+// GameBoy::fork of a running machine, including CPU, PPU and framebuffer
+static void BM_GameBoyFork(benchmark::State &state) {
+  GameBoy gameboy;
+  gameboy.loadRom(synthetic::memoryLoop());
+  gameboy.runFrame();
+
+  for (auto _ : state) {
+    std::unique_ptr<GameBoy> fork = gameboy.fork();
+    benchmark::DoNotOptimize(fork.get());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GameBoyFork);
+
+// Heap footprint of 10k live forks, each of which has written `pages`
+// pages, against the footprint of a deep copy
+static void BM_LiveForks(benchmark::State &state) {
+  size_t count = static_cast<size_t>(state.range(0));
+  int pages = static_cast<int>(state.range(1));
+  Memory memory = populatedMemory();
+
+  size_t before = heapInUse();
+  auto copy = std::make_unique<Memory>(memory);
+  size_t deepCopyBytes = heapInUse() - before;
+  copy.reset();
+
+  size_t forkBytes = 0;
+  for (auto _ : state) {
+    std::vector<std::unique_ptr<Memory>> forks;
+    forks.reserve(count);
+    before = heapInUse();
+    for (size_t i = 0; i < count; i++) {
+      forks.push_back(std::make_unique<Memory>(memory.fork()));
+      for (int page = 0; page < pages; page++) {
+        forks.back()->writeByte(0x8000 + page * 0x2000, 0x01);
+      }
+    }
+    forkBytes = heapInUse() - before;
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.counters["bytes_per_fork"] = static_cast<double>(forkBytes) / count;
+  state.counters["deep_copy_bytes"] = static_cast<double>(deepCopyBytes);
+}
+BENCHMARK(BM_LiveForks)
+    ->ArgNames({"forks", "pages"})
+    ->Args({10000, 0})
+    ->Args({10000, 2})
+    ->Unit(benchmark::kMillisecond);
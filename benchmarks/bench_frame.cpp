@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../include/capture.hpp"
+#include "../include/gameboy.hpp"
+#include "../include/profiler.hpp"
+#include "synthetic_roms.hpp"
+
+// Whole-frame execution of a synthetic ROM on either tier, reported as
+// frames per second
+template <typename Machine, typename MakeRom>
+static void runFrames(benchmark::State &state, MakeRom makeRom) {
+  Machine gameboy;
+  gameboy.loadRom(makeRom());
+
+  for (auto _ : state) {
+    gameboy.runFrame();
+  }
+  benchmark::DoNotOptimize(gameboy.cpu.cycles);
+  state.SetItemsProcessed(state.iterations());
+  state.counters["fps"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+template <typename MakeRom>
+static void BM_Frame(benchmark::State &state, MakeRom makeRom) {
+  runFrames<GameBoy>(state, makeRom);
+}
+BENCHMARK_CAPTURE(BM_Frame, alu, synthetic::aluLoop);
+BENCHMARK_CAPTURE(BM_Frame, memory, synthetic::memoryLoop);
+BENCHMARK_CAPTURE(BM_Frame, ly_poll, synthetic::lyPollLoop);
+BENCHMARK_CAPTURE(BM_Frame, halt, synthetic::haltLoop);
+BENCHMARK_CAPTURE(BM_Frame, call, synthetic::callLoop);
+
+// The same ROMs in the accurate tier, for the cost of M-cycle bus timing
+template <typename MakeRom>
+static void BM_FrameAccurate(benchmark::State &state, MakeRom makeRom) {
+  runFrames<AccurateGameBoy>(state, makeRom);
+}
+BENCHMARK_CAPTURE(BM_FrameAccurate, alu, synthetic::aluLoop);
+BENCHMARK_CAPTURE(BM_FrameAccurate, memory, synthetic::memoryLoop);
+BENCHMARK_CAPTURE(BM_FrameAccurate, ly_poll, synthetic::lyPollLoop);
+BENCHMARK_CAPTURE(BM_FrameAccurate, halt, synthetic::haltLoop);
+BENCHMARK_CAPTURE(BM_FrameAccurate, call, synthetic::callLoop);
+
+// The same with the sampling profiler at its default interval
+template <typename MakeRom>
+static void BM_FrameProfiled(benchmark::State &state, MakeRom makeRom) {
+  GameBoy gameboy;
+  gameboy.loadRom(makeRom());
+  Profiler profiler(gameboy);
+
+  for (auto _ : state) {
+    gameboy.runFrame();
+  }
+  benchmark::DoNotOptimize(gameboy.cpu.cycles);
+  state.SetItemsProcessed(state.iterations());
+  state.counters["fps"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_FrameProfiled, alu, synthetic::aluLoop);
+BENCHMARK_CAPTURE(BM_FrameProfiled, ly_poll, synthetic::lyPollLoop);
+BENCHMARK_CAPTURE(BM_FrameProfiled, halt, synthetic::haltLoop);
+BENCHMARK_CAPTURE(BM_FrameProfiled, call, synthetic::callLoop);
+
+// The same with every frame streamed to a capture file, to compare with
+// BM_Frame: the emulation thread only copies each frame into the queue
+template <typename MakeRom>
+static void BM_FrameCaptured(benchmark::State &state, MakeRom makeRom) {
+  GameBoy gameboy;
+  gameboy.loadRom(makeRom());
+  std::string path =
+      (std::filesystem::temp_directory_path() / "bench_capture.gbv").string();
+  CaptureWriter capture;
+  std::string error;
+  if (!capture.open(path, CaptureFormat::forScreen(false), error)) {
+    state.SkipWithError(error.c_str());
+    return;
+  }
+
+  for (auto _ : state) {
+    gameboy.runFrame();
+    capture.pushFrame(gameboy.ppu.getFramebuffer());
+  }
+  capture.close(error);
+  std::filesystem::remove(path);
+  benchmark::DoNotOptimize(gameboy.cpu.cycles);
+  state.SetItemsProcessed(state.iterations());
+  state.counters["fps"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+  state.counters["stalls"] = static_cast<double>(capture.getStats().stalls);
+}
+BENCHMARK_CAPTURE(BM_FrameCaptured, alu, synthetic::aluLoop);
+BENCHMARK_CAPTURE(BM_FrameCaptured, halt, synthetic::haltLoop);
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <thread>
+
+#include "../include/link_cable.hpp"
+#include "synthetic_roms.hpp"
+
+namespace {
+
+constexpr int kFrames = 10;
+
+// Runs both machines for kFrames frames, each on its own thread
+void runOnThreads(GameBoy &first, GameBoy &second) {
+  std::thread thread([&] {
+    for (int frame = 0; frame < kFrames; frame++) {
+      second.runFrame();
+    }
+  });
+  for (int frame = 0; frame < kFrames; frame++) {
+    first.runFrame();
+  }
+  thread.join();
+}
+
+}  // namespace
+
+// Two independent machines on two threads: the baseline for the cable
+static void BM_UnlinkedPair(benchmark::State &state) {
+  GameBoy first;
+  GameBoy second;
+  first.loadRom(synthetic::aluLoop());
+  second.loadRom(synthetic::aluLoop());
+
+  for (auto _ : state) {
+    runOnThreads(first, second);
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * kFrames);
+}
+BENCHMARK(BM_UnlinkedPair)->UseRealTime();
+
+// The same pair linked, at several skew bounds; waits_per_frame counts
+// synchronizations that had to block for the other thread
+static void BM_LinkedPair(benchmark::State &state) {
+  GameBoy first;
+  GameBoy second;
+  first.loadRom(synthetic::aluLoop());
+  second.loadRom(synthetic::aluLoop());
+  LinkCable cable(first, second, static_cast<uint64_t>(state.range(0)));
+
+  for (auto _ : state) {
+    runOnThreads(first, second);
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * kFrames);
+  state.counters["waits_per_frame"] = benchmark::Counter(
+      static_cast<double>(cable.waits()) / kFrames / 2,
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_LinkedPair)
+    ->ArgName("skew")
+    ->Arg(512)
+    ->Arg(LinkCable::kDefaultMaxSkew)
+    ->Arg(LinkCable::kMaxSkew)
+    ->UseRealTime();
+
+// Both machines on one thread, one after the other, unlinked
+static void BM_SequentialPair(benchmark::State &state) {
+  GameBoy first;
+  GameBoy second;
+  first.loadRom(synthetic::aluLoop());
+  second.loadRom(synthetic::aluLoop());
+
+  for (auto _ : state) {
+    for (int frame = 0; frame < kFrames; frame++) {
+      first.runFrame();
+      second.runFrame();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * kFrames);
+}
+BENCHMARK(BM_SequentialPair);
+
+// LinkCable::run, alternating the machines on one thread at every
+// synchronization point
+static void BM_LockstepPair(benchmark::State &state) {
+  GameBoy first;
+  GameBoy second;
+  first.loadRom(synthetic::aluLoop());
+  second.loadRom(synthetic::aluLoop());
+  LinkCable cable(first, second, static_cast<uint64_t>(state.range(0)));
+
+  for (auto _ : state) {
+    cable.run(PPU::kFrameCycles * kFrames);
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * kFrames);
+}
+BENCHMARK(BM_LockstepPair)
+    ->ArgName("skew")
+    ->Arg(512)
+    ->Arg(LinkCable::kDefaultMaxSkew)
+    ->Arg(LinkCable::kMaxSkew);
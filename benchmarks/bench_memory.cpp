@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/memory.hpp"
+
+// Memory::readByte latency for one address per memory-map region
+static void BM_ReadByte(benchmark::State &state) {
+  Memory memory;
+  uint16_t address = static_cast<uint16_t>(state.range(0));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(memory.readByte(address));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadByte)
+    ->ArgName("address")
+    ->Arg(0x0150)   // ROM
+    ->Arg(0x8000)   // VRAM
+    ->Arg(0xC000)   // WRAM
+    ->Arg(0xFF44)   // IO (LY)
+    ->Arg(0xFF80);  // HRAM
+
+// Memory::writeWord latency, as used by PUSH/CALL
+static void BM_WriteWord(benchmark::State &state) {
+  Memory memory;
+  uint16_t address = static_cast<uint16_t>(state.range(0));
+  uint16_t value = 0;
+
+  for (auto _ : state) {
+    memory.writeWord(address, value++);
+  }
+  benchmark::DoNotOptimize(memory.readWord(address));
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WriteWord)
+    ->ArgName("address")
+    ->Arg(0xC000)   // WRAM
+    ->Arg(0xFFFC);  // HRAM, the usual stack
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include "../include/machine_pool.hpp"
+#include "synthetic_roms.hpp"
+
+namespace {
+
+// A short farm job: run a few frames and read the result
+void runJob(GameBoy &machine, int64_t frames) {
+  for (int64_t frame = 0; frame < frames; frame++) {
+    machine.runFrame();
+  }
+  benchmark::DoNotOptimize(machine.cpu.A);
+}
+
+}  // namespace
+
+// Each job on a newly constructed, fast-booted machine
+static void BM_JobsCold(benchmark::State &state) {
+  Cartridge::Image rom = Cartridge::prepare(synthetic::memoryLoop());
+
+  for (auto _ : state) {
+    auto machine = std::make_unique<GameBoy>();
+    machine->loadRom(rom);
+    machine->fastBoot();
+    runJob(*machine, state.range(0));
+  }
+  state.counters["jobs"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_JobsCold)->ArgName("frames")->Arg(0)->Arg(1)->Arg(10);
+
+// Each job on a pooled machine warm-reset to the fast-booted state
+static void BM_JobsPooled(benchmark::State &state) {
+  GameBoy snapshot;
+  snapshot.loadRom(synthetic::memoryLoop());
+  snapshot.fastBoot();
+  MachinePool pool(snapshot, 1);
+
+  for (auto _ : state) {
+    MachinePool::Lease machine = pool.acquire();
+    runJob(*machine, state.range(0));
+  }
+  state.counters["jobs"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_JobsPooled)->ArgName("frames")->Arg(0)->Arg(1)->Arg(10);
+
+// The warm reset alone, from a machine that has run
+static void BM_WarmReset(benchmark::State &state) {
+  GameBoy snapshot;
+  snapshot.loadRom(synthetic::memoryLoop());
+  snapshot.fastBoot();
+  MachinePool pool(snapshot, 1);
+  runJob(*pool.acquire(), 1);
+
+  for (auto _ : state) {
+    MachinePool::Lease machine = pool.acquire();
+    benchmark::DoNotOptimize(machine->cpu.PC);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WarmReset);
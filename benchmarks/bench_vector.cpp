@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "../include/joypad.hpp"
+#include "../include/vector_emulator.hpp"
+#include "synthetic_roms.hpp"
+
+namespace {
+
+// Half the machines hold A, so the batch has two diverging populations
+uint8_t action(size_t machine) { return machine % 2 ? ButtonA : 0; }
+
+void reportFrames(benchmark::State &state, size_t machines) {
+  double frames = static_cast<double>(state.iterations() * machines);
+  state.SetItemsProcessed(static_cast<int64_t>(frames));
+  state.counters["fps"] =
+      benchmark::Counter(frames, benchmark::Counter::kIsRate);
+}
+
+}  // namespace
+
+// N machines stepped together by the lockstep engine
+static void BM_VectorEmulator(benchmark::State &state) {
+  size_t machines = static_cast<size_t>(state.range(0));
+  VectorEmulator batch(synthetic::inputLoop(), machines);
+  std::vector<uint8_t> actions(machines);
+  for (size_t i = 0; i < machines; i++) {
+    actions[i] = action(i);
+  }
+  std::vector<Observation> observations(machines);
+
+  for (auto _ : state) {
+    batch.step(actions, observations);
+  }
+  benchmark::DoNotOptimize(observations.data());
+  reportFrames(state, machines);
+  state.counters["shared"] =
+      benchmark::Counter(static_cast<double>(batch.sharedDecodes),
+                         benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_VectorEmulator)->RangeMultiplier(4)->Range(1, 256);
+
+// The same workload as N independent machines, one after another
+static void BM_IndependentMachines(benchmark::State &state) {
+  size_t machines = static_cast<size_t>(state.range(0));
+  std::vector<uint8_t> rom = synthetic::inputLoop();
+  std::vector<std::unique_ptr<GameBoy>> gameboys;
+  for (size_t i = 0; i < machines; i++) {
+    gameboys.push_back(std::make_unique<GameBoy>());
+    gameboys.back()->loadRom(rom);
+    gameboys.back()->memory.setButtons(action(i));
+  }
+
+  for (auto _ : state) {
+    for (std::unique_ptr<GameBoy> &gameboy : gameboys) {
+      gameboy->runFrame();
+    }
+  }
+  reportFrames(state, machines);
+}
+BENCHMARK(BM_IndependentMachines)->RangeMultiplier(4)->Range(1, 256);
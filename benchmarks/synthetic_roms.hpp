@@ -0,0 +1,146 @@
+/**
+ * @file synthetic_roms.hpp
+ * @brief Small generated ROMs that exercise specific parts of the core.
+ *
+ * Each ROM is a 32 KB image with its code at the 0x0100 entry point, so the
+ * benchmarks need no ROM files and measure the same code on every machine.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace synthetic {
+
+/**
+ * @brief Builds a 32 KB ROM with `code` at 0x0100 and `handler` at the
+ * VBlank interrupt vector (0x0040).
+ */
+inline std::vector<uint8_t> makeRom(std::initializer_list<uint8_t> code,
+                                    std::initializer_list<uint8_t> handler = {
+                                        0xD9}) {  // RETI
+  std::vector<uint8_t> rom(0x8000, 0x00);
+  std::vector<uint8_t>::iterator out = rom.begin() + 0x0040;
+  for (uint8_t byte : handler) {
+    *out++ = byte;
+  }
+  out = rom.begin() + 0x0100;
+  for (uint8_t byte : code) {
+    *out++ = byte;
+  }
+  return rom;
+}
+
+/**
+ * @brief A tight loop of 8-bit ALU operations on registers.
+ */
+inline std::vector<uint8_t> aluLoop() {
+  return makeRom({
+      0x3E, 0x01,        // 0100 LD A,0x01
+      0x06, 0x03,        // 0102 LD B,0x03
+      0x80,              // 0104 ADD A,B
+      0x88,              // 0105 ADC A,B
+      0x90,              // 0106 SUB B
+      0x98,              // 0107 SBC A,B
+      0xA0,              // 0108 AND B
+      0xA8,              // 0109 XOR B
+      0xB0,              // 010A OR B
+      0xB8,              // 010B CP B
+      0x3C,              // 010C INC A
+      0x05,              // 010D DEC B
+      0xC3, 0x04, 0x01,  // 010E JP 0x0104
+  });
+}
+
+/**
+ * @brief Fills work RAM through HL, reading each byte back.
+ */
+inline std::vector<uint8_t> memoryLoop() {
+  return makeRom({
+      0x21, 0x00, 0xC0,  // 0100 LD HL,0xC000
+      0x77,              // 0103 LD (HL),A
+      0x7E,              // 0104 LD A,(HL)
+      0x3C,              // 0105 INC A
+      0x23,              // 0106 INC HL
+      0x7C,              // 0107 LD A,H
+      0xFE, 0xE0,        // 0108 CP 0xE0
+      0x20, 0xF7,        // 010A JR NZ,0x0103
+      0xC3, 0x00, 0x01,  // 010C JP 0x0100
+  });
+}
+
+/**
+ * @brief Busy-waits on LY for the start of VBlank, then for line 0.
+ */
+inline std::vector<uint8_t> lyPollLoop() {
+  return makeRom({
+      0x3E, 0x91,        // 0100 LD A,0x91
+      0xE0, 0x40,        // 0102 LDH (LCDC),A
+      0xF0, 0x44,        // 0104 LDH A,(LY)
+      0xFE, 0x90,        // 0106 CP 0x90
+      0x20, 0xFA,        // 0108 JR NZ,0x0104
+      0xF0, 0x44,        // 010A LDH A,(LY)
+      0xFE, 0x00,        // 010C CP 0x00
+      0x20, 0xFA,        // 010E JR NZ,0x010A
+      0xC3, 0x04, 0x01,  // 0110 JP 0x0104
+  });
+}
+
+/**
+ * @brief Halts between VBlank interrupts, like most games' main loops.
+ */
+inline std::vector<uint8_t> haltLoop() {
+  return makeRom({
+      0x3E, 0x91,        // 0100 LD A,0x91
+      0xE0, 0x40,        // 0102 LDH (LCDC),A
+      0x3E, 0x01,        // 0104 LD A,0x01
+      0xE0, 0xFF,        // 0106 LDH (IE),A
+      0xFB,              // 0108 EI
+      0x76,              // 0109 HALT
+      0xC3, 0x09, 0x01,  // 010A JP 0x0109
+  });
+}
+
+/**
+ * @brief Scrolls the background one way while A is held and the other way
+ * otherwise, so machines given different inputs take different paths.
+ */
+inline std::vector<uint8_t> inputLoop() {
+  return makeRom({
+      0x3E, 0x91,        // 0100 LD A,0x91
+      0xE0, 0x40,        // 0102 LDH (LCDC),A
+      0x3E, 0x10,        // 0104 LD A,0x10
+      0xE0, 0x00,        // 0106 LDH (P1),A
+      0xF0, 0x00,        // 0108 LDH A,(P1)
+      0xCB, 0x47,        // 010A BIT 0,A
+      0x28, 0x03,        // 010C JR Z,0x0111
+      0x04,              // 010E INC B
+      0x18, 0x01,        // 010F JR 0x0112
+      0x05,              // 0111 DEC B
+      0x78,              // 0112 LD A,B
+      0xE0, 0x43,        // 0113 LDH (SCX),A
+      0xC3, 0x08, 0x01,  // 0115 JP 0x0108
+  });
+}
+
+/**
+ * @brief Nested subroutine calls, the worst case for call tracking.
+ */
+inline std::vector<uint8_t> callLoop() {
+  return makeRom({
+      0xCD, 0x08, 0x01,  // 0100 CALL 0x0108
+      0x3C,              // 0103 INC A
+      0xC3, 0x00, 0x01,  // 0104 JP 0x0100
+      0x00,              // 0107 NOP
+      0xCD, 0x0E, 0x01,  // 0108 CALL 0x010E
+      0x04,              // 010B INC B
+      0xC9,              // 010C RET
+      0x00,              // 010D NOP
+      0x0C,              // 010E INC C
+      0xC9,              // 010F RET
+  });
+}
+
+}  // namespace synthetic
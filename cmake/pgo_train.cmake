@@ -0,0 +1,42 @@
+# Trains a PGO profile with a GB_PGO=GENERATE build (`pgo-train` target).
+#
+# Runs the instrumented benchmark ROM set and, if ROMS names a directory,
+# the instrumented headless runner over every ROM in it. Starts from an
+# empty PROFILE_DIR so the profile depends only on this run, and writes
+# profile.stamp once it is complete.
+#
+#   cmake -DPROFILE_DIR=... -DCOMPILER=GNU|Clang -DEMULATOR=...
+#         [-DBENCHMARKS=...] [-DROMS=...] [-DLLVM_PROFDATA=...]
+#         -P pgo_train.cmake
+
+file(REMOVE_RECURSE ${PROFILE_DIR})
+file(MAKE_DIRECTORY ${PROFILE_DIR})
+
+function(run)
+  execute_process(COMMAND ${ARGN} RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "PGO training run failed (${result}): ${ARGN}")
+  endif()
+endfunction()
+
+if(BENCHMARKS)
+  # Short runs: the profile needs the branch mix, not stable timings
+  run(${BENCHMARKS} --benchmark_min_time=0.05)
+endif()
+
+if(ROMS)
+  file(GLOB_RECURSE rom_files ${ROMS}/*.gb ${ROMS}/*.gbc)
+  list(SORT rom_files)
+  foreach(rom IN LISTS rom_files)
+    message(STATUS "Training on ${rom}")
+    run(${EMULATOR} ${rom} --frames 1800)
+  endforeach()
+endif()
+
+if(COMPILER STREQUAL "Clang")
+  file(GLOB raw_profiles ${PROFILE_DIR}/*.profraw)
+  run(${LLVM_PROFDATA} merge -output=${PROFILE_DIR}/default.profdata
+      ${raw_profiles})
+endif()
+
+file(TOUCH ${PROFILE_DIR}/profile.stamp)
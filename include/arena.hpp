@@ -0,0 +1,76 @@
+/**
+ * @file arena.hpp
+ * @brief Defines Arena: a memory resource owning one emulator instance's
+ * dynamic memory.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class Arena
+ * @brief A std::pmr memory resource that carves an instance's allocations
+ * out of a few large chunks.
+ *
+ * Memory comes from a monotonic buffer that grows geometrically, so an
+ * instance makes a handful of upstream allocations however many pages and
+ * buffers it creates. Freed blocks go to exact-size free lists and are
+ * reused, so an instance that keeps copying pages does not grow. Destroying
+ * the arena returns the chunks at once without visiting individual blocks.
+ *
+ * Pages allocated here may be shared with forks on other threads and freed
+ * there, so allocation and deallocation take a lock. Hold an arena through
+ * a shared_ptr (a PageResource): every page allocated from it keeps it
+ * alive.
+ */
+class Arena : public std::pmr::memory_resource {
+ public:
+  // Holds every page of the largest machine (CGB RAM plus 128 KB of
+  // cartridge RAM) in one chunk
+  static constexpr size_t kDefaultChunkSize = 256 * 1024;
+
+  /**
+   * @brief Creates an empty arena; nothing is allocated until first use.
+   *
+   * @param chunkSize The size of the first chunk. Later chunks grow
+   * geometrically.
+   */
+  explicit Arena(size_t chunkSize = kDefaultChunkSize);
+
+  /**
+   * @brief Returns the size of the first chunk, for creating similar
+   * arenas.
+   */
+  size_t chunkSize() const { return firstChunk; }
+
+  /**
+   * @brief Returns the bytes currently handed out and not freed.
+   */
+  size_t bytesInUse() const;
+
+ private:
+  // Freed blocks of one size, linked through their first bytes
+  struct FreeList {
+    size_t size;
+    void *head;
+  };
+
+  void *do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void *pointer, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+  FreeList &freeList(size_t size);
+
+  mutable std::mutex mutex;
+  size_t firstChunk;
+  std::pmr::monotonic_buffer_resource chunks;
+  std::pmr::vector<FreeList> freeLists;
+  size_t inUse = 0;
+};
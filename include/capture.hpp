@@ -0,0 +1,198 @@
+/**
+ * @file capture.hpp
+ * @brief Streams a run's screen and sound to a compact file on a background
+ * thread, and reads such files back.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ppu.hpp"
+#include "spsc_queue.hpp"
+
+/**
+ * @struct CaptureFormat
+ * @brief What a capture holds besides PPU::kScreenWidth by
+ * PPU::kScreenHeight frames.
+ */
+struct CaptureFormat {
+  uint8_t bytesPerPixel = 1;  ///< 1 for DMG shades, 2 for CGB colors.
+  uint32_t sampleRate = 0;    ///< PCM samples per second; 0 for no sound.
+  uint8_t channels = 2;       ///< Interleaved 16-bit PCM channels.
+
+  /**
+   * @brief Returns the format for a machine's framebuffer, without sound.
+   */
+  static CaptureFormat forScreen(bool cgb) {
+    return {static_cast<uint8_t>(cgb ? 2 : 1), 0, 2};
+  }
+};
+
+/**
+ * @struct CaptureStats
+ * @brief Counts for a capture; complete once it is closed.
+ */
+struct CaptureStats {
+  uint64_t frames = 0;
+  uint64_t keyFrames = 0;
+  uint64_t audioSamples = 0;
+  uint64_t rawBytes = 0;         ///< Frame and sample bytes before encoding.
+  uint64_t compressedBytes = 0;  ///< Record bytes written.
+  uint64_t stalls = 0;  ///< Pushes that waited for the writer to catch up.
+};
+
+/**
+ * @class CaptureWriter
+ * @brief Records frames and PCM audio to a file without doing the encoding
+ * or the I/O on the emulation thread.
+ *
+ * Pushes copy the data into a bounded queue and return; a writer thread
+ * delta-encodes each frame against the one before, compresses it with
+ * lzCompress() and writes it. A push only waits if the queue is full,
+ * which bounds the memory a slow disk can take.
+ *
+ * On disk a capture is the magic "GBCV", a version, the screen size, the
+ * CaptureFormat, then records. A record is a kind byte (key frame, delta
+ * frame or audio), the raw and compressed sizes and the compressed bytes.
+ * Frames are pixel bytes, which delta frames XOR with the previous frame's;
+ * there is a key frame every kKeyInterval frames. All integers are little
+ * endian.
+ *
+ * Pushes and close() are called from one thread.
+ */
+class CaptureWriter {
+ public:
+  static constexpr uint32_t kVersion = 1;
+  static constexpr uint32_t kKeyInterval = 600;
+
+  CaptureWriter() = default;
+  CaptureWriter(const CaptureWriter &) = delete;
+  CaptureWriter &operator=(const CaptureWriter &) = delete;
+  ~CaptureWriter();
+
+  /**
+   * @brief Creates the file, writes the header and starts the writer.
+   *
+   * @return False, with the reason in `error`, if the file cannot be
+   * created.
+   */
+  bool open(const std::string &path, const CaptureFormat &format,
+            std::string &error);
+
+  /**
+   * @brief Queues a frame.
+   *
+   * @param framebuffer PPU::kScreenWidth by PPU::kScreenHeight pixels, as
+   * PPU::getFramebuffer() holds them.
+   */
+  void pushFrame(std::span<const uint16_t> framebuffer);
+
+  /**
+   * @brief Queues interleaved samples in the format's channel count.
+   */
+  void pushAudio(std::span<const int16_t> samples);
+
+  /**
+   * @brief Writes everything queued and closes the file.
+   *
+   * @return False, with the reason in `error`, if any write failed.
+   */
+  bool close(std::string &error);
+
+  const CaptureStats &getStats() const { return stats; }
+
+ private:
+  static constexpr size_t kPixels = PPU::kScreenWidth * PPU::kScreenHeight;
+
+  struct Packet {
+    bool audio;
+    uint32_t count;
+    std::array<uint16_t, kPixels> values;
+  };
+
+  Packet &claim();
+  void publish();
+  void run();
+  void encode(const Packet &packet);
+  void writeRecord(uint8_t kind, std::span<const uint8_t> raw);
+
+  std::string path;
+  std::ofstream file;
+  CaptureFormat format;
+  std::unique_ptr<SpscQueue<Packet, 16>> queue;
+  // Counts that the waiting side sleeps on
+  std::atomic<uint32_t> pushed{0};
+  std::atomic<uint32_t> popped{0};
+  std::atomic<bool> stopping{false};
+  std::thread writer;
+  CaptureStats stats;
+
+  // The writer thread's
+  bool failed = false;
+  uint64_t encodedFrames = 0;
+  std::vector<uint8_t> previous;
+  std::vector<uint8_t> current;
+  std::vector<uint8_t> delta;
+  std::vector<uint8_t> compressed;
+};
+
+/**
+ * @class CaptureReader
+ * @brief Reads a capture back a record at a time.
+ */
+class CaptureReader {
+ public:
+  enum class Record { Frame, Audio, End };
+
+  /**
+   * @brief Opens a capture and reads its header.
+   *
+   * @return False, with the reason in `error`, if the file is not a capture
+   * of a known version.
+   */
+  bool open(const std::string &path, std::string &error);
+
+  const CaptureFormat &getFormat() const { return format; }
+
+  /**
+   * @brief Decodes the next record into frame() or audio().
+   *
+   * @return False, with the reason in `error`, if the file is damaged.
+   */
+  bool next(Record &record, std::string &error);
+
+  /**
+   * @brief Returns the last frame read, as PPU::getFramebuffer() held it.
+   */
+  std::span<const uint16_t> frame() const { return pixels; }
+
+  /**
+   * @brief Returns the last samples read.
+   */
+  std::span<const int16_t> audio() const { return samples; }
+
+ private:
+  std::ifstream file;
+  CaptureFormat format;
+  bool haveKeyFrame = false;
+  std::vector<uint8_t> block;
+  std::vector<uint8_t> raw;
+  std::vector<uint8_t> previous;
+  std::vector<uint16_t> pixels;
+  std::vector<int16_t> samples;
+};
+
+/**
+ * @brief Encodes 16-bit PCM samples as a WAV file.
+ */
+std::vector<uint8_t> encodeWav(std::span<const int16_t> samples,
+                               uint32_t sampleRate, uint16_t channels);
@@ -0,0 +1,223 @@
+/**
+ * @file cartridge.hpp
+ * @brief Defines the Cartridge class: ROM, external RAM and the memory bank
+ * controller.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "shared_page.hpp"
+
+class StateReader;
+class StateWriter;
+
+/**
+ * @class Cartridge
+ * @brief A cartridge's ROM and RAM and the bank registers of its MBC.
+ *
+ * The cartridge only tracks which banks are selected; the memory bus maps
+ * them by pointing its page table at the banks returned here, so a switch
+ * costs one remap and reads never go through the controller.
+ *
+ * A loaded ROM image is immutable and shared: copies of a cartridge, and
+ * cartridges loaded from the same prepared image, reference one buffer.
+ * RAM banks are copy-on-write pages, so copying a cartridge shares them
+ * until either copy writes; copies are allocated from the PageResource set
+ * with setResource().
+ *
+ * A default-constructed cartridge stands in for an empty slot: 32 KB of
+ * ROM space that accepts writes, so test programs can be stored in place,
+ * and 8 KB of RAM.
+ */
+class Cartridge {
+ public:
+  /**
+   * @brief The supported memory bank controllers.
+   */
+  enum class Controller : uint8_t { None, MBC1, MBC3, MBC5 };
+
+  static constexpr uint16_t kRomBankSize = 0x4000;
+  static constexpr uint16_t kRamBankSize = 0x2000;
+  static constexpr size_t kMaxRamBanks = 16;
+
+  using Image = std::shared_ptr<const std::vector<uint8_t>>;
+
+  Cartridge();
+
+  /**
+   * @brief Pads a ROM image to a power-of-two number of banks, ready to be
+   * shared by any number of cartridges.
+   */
+  static Image prepare(const std::vector<uint8_t> &image);
+
+  /**
+   * @brief Returns the controller for a header cartridge type (byte 0x147).
+   */
+  static Controller controllerOf(uint8_t type);
+
+  /**
+   * @brief Loads a ROM image, taking the controller and RAM size from its
+   * header. Unknown controllers are treated as MBC5, which is a superset of
+   * the others' ROM banking.
+   *
+   * @param image The ROM image.
+   */
+  void load(const std::vector<uint8_t> &image) { load(prepare(image)); }
+
+  /**
+   * @brief Loads a prepared ROM image without copying it.
+   */
+  void load(Image image);
+
+  /**
+   * @brief Whether a ROM has been loaded.
+   */
+  bool isLoaded() const { return loaded; }
+
+  /**
+   * @brief Whether the header marks the ROM as Game Boy Color capable.
+   */
+  bool isCgb() const { return romData()[0x0143] & 0x80; }
+
+  /**
+   * @brief Returns the controller type.
+   */
+  Controller getController() const { return controller; }
+
+  /**
+   * @brief Handles a write to the controller registers (0000-7FFF).
+   *
+   * @return Whether the ROM or RAM mapping changed.
+   */
+  bool writeControl(uint16_t address, uint8_t value);
+
+  /**
+   * @brief Returns the bank mapped at 0000-3FFF.
+   */
+  const uint8_t *romBank0() const {
+    return romData() + lowBank() * kRomBankSize;
+  }
+
+  /**
+   * @brief Returns the bank mapped at 4000-7FFF.
+   */
+  const uint8_t *romBankN() const {
+    return romData() + highBank() * kRomBankSize;
+  }
+
+  /**
+   * @brief Returns the empty slot's writable ROM space, or null once a ROM
+   * is loaded or while the space is shared with another cartridge.
+   */
+  uint8_t *writableRom() { return loaded ? nullptr : slot.writable(); }
+
+  /**
+   * @brief Returns the RAM bank mapped at A000-BFFF, or null while RAM is
+   * disabled or absent.
+   */
+  const uint8_t *ramBank() const {
+    int bank = ramIndex();
+    return bank < 0 ? nullptr : ram[bank].data();
+  }
+
+  /**
+   * @brief Returns the mapped RAM bank for writing, or null while it is
+   * disabled, absent or shared with another cartridge.
+   */
+  uint8_t *writableRamBank() {
+    int bank = ramIndex();
+    return bank < 0 ? nullptr : ram[bank].writable();
+  }
+
+  /**
+   * @brief Takes a private copy of the mapped RAM bank if it is shared.
+   *
+   * @return The bank for writing, or null while RAM is disabled or absent.
+   */
+  uint8_t *unshareRamBank() {
+    int bank = ramIndex();
+    return bank < 0 ? nullptr : ram[bank].unshare(resource);
+  }
+
+  /**
+   * @brief Takes private copies of all shared RAM banks and of the empty
+   * slot's ROM space.
+   */
+  void unshare();
+
+  /**
+   * @brief Sets where copies of shared pages are allocated.
+   */
+  void setResource(PageResource resource) {
+    this->resource = std::move(resource);
+  }
+
+  /**
+   * @brief Returns the number of the bank mapped at 0000-3FFF (non-zero
+   * only in MBC1's advanced banking mode).
+   */
+  uint16_t lowBank() const;
+
+  /**
+   * @brief Returns the number of the bank mapped at 4000-7FFF.
+   */
+  uint16_t highBank() const;
+
+  /**
+   * @brief Returns the ROM image (padded to a power-of-two bank count), or
+   * null for an empty slot.
+   */
+  const Image &getImage() const { return rom; }
+
+  /**
+   * @brief Returns the number of 16 KB ROM banks.
+   */
+  uint16_t romBanks() const {
+    return static_cast<uint16_t>((loaded ? rom->size() : kSlotSize) /
+                                 kRomBankSize);
+  }
+
+  /**
+   * @brief Hashes the ROM, RAM and bank registers.
+   */
+  uint64_t hash() const;
+
+  /**
+   * @brief Saves the RAM and bank registers, with a hash identifying the
+   * ROM (or, for an empty slot, its contents).
+   */
+  void saveState(StateWriter &out) const;
+
+  /**
+   * @brief Restores state saved from a cartridge holding the same ROM.
+   *
+   * @return False if the state is for a different ROM or RAM size.
+   */
+  bool loadState(StateReader &in);
+
+ private:
+  const uint8_t *romData() const { return loaded ? rom->data() : slot.data(); }
+  int ramIndex() const;
+
+  Image rom;
+  static constexpr size_t kSlotSize = 2 * kRomBankSize;
+
+  SharedPage<kSlotSize> slot;  // Empty-slot ROM space
+  std::array<SharedPage<kRamBankSize>, kMaxRamBanks> ram;
+  uint8_t ramBanks = 1;
+  PageResource resource;
+  Controller controller = Controller::None;
+  bool loaded = false;
+
+  // Bank registers as written; lowBank() and highBank() apply the
+  // controller's rules
+  bool ramEnabled = true;
+  uint16_t romSelect = 1;
+  uint8_t ramSelect = 0;
+  bool advancedBanking = false;  // MBC1 mode register
+};
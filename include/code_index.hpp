@@ -0,0 +1,91 @@
+/**
+ * @file code_index.hpp
+ * @brief Static code analysis of a ROM: basic blocks, branch targets and
+ * banked call sites, found before the ROM runs.
+ */
+
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "opcodes.hpp"
+
+/**
+ * @struct RomLocation
+ * @brief An address in a given ROM bank. Bank 0 code (0000-3FFF) always
+ * has bank 0; switchable-bank code (4000-7FFF) has the bank it lives in.
+ */
+struct RomLocation {
+  uint16_t bank = 0;
+  uint16_t address = 0;
+
+  auto operator<=>(const RomLocation &) const = default;
+};
+
+/**
+ * @brief Returns the offset of a location in the ROM image.
+ */
+constexpr size_t romOffset(RomLocation location) {
+  return location.address < 0x4000
+             ? location.address
+             : location.bank * size_t{0x4000} + location.address - 0x4000;
+}
+
+/**
+ * @struct BasicBlock
+ * @brief A straight run of instructions, entered only at its start and
+ * left only at its end.
+ */
+struct BasicBlock {
+  RomLocation start;
+  uint16_t size = 0;  ///< Bytes.
+  uint16_t instructions = 0;
+  Flow exit = Flow::Next;  ///< Flow of the last instruction.
+  // Statically known blocks control can reach next: targets and the
+  // fall-through (for calls, the return address)
+  std::vector<RomLocation> successors;
+};
+
+/**
+ * @struct BankedCall
+ * @brief A CALL or JP into 4000-7FFF after code selected the ROM bank it
+ * goes to, as in `LD A,n8; LD ($2000),A; CALL n16`.
+ */
+struct BankedCall {
+  RomLocation site;
+  RomLocation target;
+};
+
+/**
+ * @struct CodeIndex
+ * @brief Everything the analyzer found. All lists are sorted.
+ */
+struct CodeIndex {
+  std::vector<BasicBlock> blocks;
+  std::vector<RomLocation> branchTargets;  ///< Jump and call targets.
+  std::vector<BankedCall> bankedCalls;
+  // Sites whose target is not indexed: JP HL, jumps into RAM, and jumps
+  // into a switchable bank whose selection the analyzer could not follow
+  std::vector<RomLocation> unresolved;
+
+  /**
+   * @brief Returns the block containing a location, or null.
+   */
+  const BasicBlock *findBlock(RomLocation location) const;
+};
+
+/**
+ * @brief Walks a ROM from its entry point (0100) and interrupt vectors
+ * (0040-0060), following every statically known jump and call, and indexes
+ * the code it reaches.
+ *
+ * Bank switches are followed when the bank number is a constant loaded
+ * right before the write, `LD A,n8` then `LD (2000-3FFF),A`; code reached
+ * through other switches, jump tables or RAM is not indexed.
+ *
+ * @param rom The ROM image.
+ */
+CodeIndex buildCodeIndex(const std::vector<uint8_t> &rom);
@@ -0,0 +1,96 @@
+/**
+ * @file conformance.hpp
+ * @brief Runs test ROMs (Blargg's and Mooneye's) headless and decides
+ * whether they passed.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ppu.hpp"
+
+/**
+ * @brief How a test ROM finished.
+ */
+enum class Verdict : uint8_t {
+  Pass,
+  Fail,
+  Timeout,  ///< Reported nothing within its cycle budget.
+  Error,    ///< Could not be run (e.g. the file could not be read).
+};
+
+/**
+ * @brief Returns "pass", "fail", "timeout" or "error".
+ */
+const char *verdictName(Verdict verdict);
+
+/**
+ * @struct ConformanceResult
+ * @brief The outcome of one test ROM.
+ */
+struct ConformanceResult {
+  std::string name;
+  Verdict verdict = Verdict::Error;
+  uint64_t cycles = 0;
+  double seconds = 0;
+  std::string output;  ///< What the ROM printed, or why it could not run.
+};
+
+/**
+ * @brief The default per-ROM budget: 30 emulated seconds, enough for the
+ * slowest single Blargg test.
+ */
+constexpr uint64_t kDefaultCycleBudget = 30ull * 60 * PPU::kFrameCycles;
+
+/**
+ * @brief Runs a test ROM until it reports a result or exhausts its budget.
+ *
+ * A ROM reports through any of the conventions the common suites use:
+ * - Blargg: "Passed" or "Failed" printed over the serial port, or the
+ *   status byte at A000 once A001-A003 hold the DE B0 61 signature.
+ * - Mooneye: B, C, D, E, H and L set to the Fibonacci numbers 3, 5, 8, 13,
+ *   21, 34 on success or all to 0x42 on failure.
+ *
+ * The result is checked once per frame.
+ *
+ * @param rom The ROM image.
+ * @param cycleBudget The most cycles to run for.
+ */
+ConformanceResult runTestRom(const std::vector<uint8_t> &rom,
+                             uint64_t cycleBudget = kDefaultCycleBudget);
+
+/**
+ * @brief Returns the .gb and .gbc files under a directory, recursively, in
+ * sorted order.
+ */
+std::vector<std::string> findTestRoms(const std::string &directory);
+
+/**
+ * @brief Runs a set of ROM files, spread over worker threads.
+ *
+ * @param directory The suite directory; results are named by their path
+ * relative to it.
+ * @param paths The ROM files.
+ * @param cycleBudget The per-ROM budget.
+ * @param threads Worker threads; 0 for one per hardware thread.
+ * @return One result per path, in the same order.
+ */
+std::vector<ConformanceResult> runConformance(
+    const std::string &directory, const std::vector<std::string> &paths,
+    uint64_t cycleBudget = kDefaultCycleBudget, unsigned threads = 0);
+
+/**
+ * @brief Writes results as a JUnit XML test suite.
+ *
+ * @param out Where to write.
+ * @param results The results; any not passed are failures, or errors for
+ * ROMs that could not run.
+ * @param seconds The suite's wall time.
+ */
+void writeJUnit(std::ostream &out,
+                const std::vector<ConformanceResult> &results,
+                double seconds);
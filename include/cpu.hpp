@@ -5,12 +5,56 @@
 #include <functional>
 
 #include "memory.hpp"
+#include "timing.hpp"
 
-class CPU {
+class Profiler;
+class StateReader;
+class StateWriter;
+
+// The SM83 core. Each timing policy (see timing.hpp) is its own
+// instantiation, so the tiers share the handlers but no runtime checks;
+// `CPU` is the fast tier.
+template <typename Timing>
+class BasicCPU {
  public:
-  CPU(Memory &memory);
+  // A side-effect-free `LD A,(n); CP/AND n8; JR cc` loop polling an address
+  struct IdlePoll {
+    uint16_t address = 0;
+    uint8_t operation = 0;  // 0xFE (CP n8) or 0xE6 (AND n8)
+    uint8_t operand = 0;
+    uint8_t branch = 0;  // JR cc opcode
+    uint8_t iterationCycles = 0;
+  };
+
+  BasicCPU(Memory &memory);
+  BasicCPU(const BasicCPU &) = delete;
+  // Copies the register and timing state; the bus and the opcode table stay
+  // bound to this CPU
+  BasicCPU &operator=(const BasicCPU &other);
   void executeOpcode();
 
+  // executeOpcode() in two halves, for callers that fetch opcodes
+  // themselves: service interrupts and HALT (false if no instruction is
+  // due), then run an opcode whose byte has already been consumed. In the
+  // accurate tier the opcode must have been fetched with fetchByte().
+  bool beginInstruction();
+  void execute(uint8_t opcode);
+
+  // Idle-loop detection: match a polling loop starting at PC, and skip
+  // iterations of it that are known to read the same value
+  bool matchIdlePoll(IdlePoll &poll);
+  bool skipIdlePoll(const IdlePoll &poll, uint32_t iterations);
+
+  // While halted with nothing pending, advance the clock in whole HALT steps
+  // to the first step boundary at or after `time`
+  void skipHalt(uint64_t time);
+
+  // Hash of all architectural and timing state, for determinism checks
+  uint64_t stateHash() const;
+  // The state operator= copies, saved and restored between instructions
+  void saveState(StateWriter &out) const;
+  void loadState(StateReader &in);
+
   // Registers
   uint8_t &F = registers[0];
   uint8_t &A = registers[1];
@@ -23,6 +67,15 @@ class CPU {
 
   uint16_t SP = 0xFFF, PC = 0;
   bool IME = false;
+  bool halted = false;
+
+  // Machine clock in T-cycles, advanced by every executed instruction
+  uint64_t cycles = 0;
+  // Set when the last instruction was a taken backward relative jump
+  bool jumpedBack = false;
+
+  // Told about calls while profiling (see profiler.hpp); not copied
+  Profiler *profiler = nullptr;
 
   // Access and return reference to combined AF using pointer
   uint16_t &AF() {
@@ -104,17 +157,57 @@ class CPU {
     }
   }
 
+  // Evaluates the condition encoded in a JR/JP/CALL/RET cc opcode
+  bool checkCondition(uint8_t opcode) {
+    switch ((opcode >> 3) & 0x03) {
+      case 0:
+        return !getZeroFlag();
+      case 1:
+        return getZeroFlag();
+      case 2:
+        return !getCarryFlag();
+      default:
+        return getCarryFlag();
+    }
+  }
+
  private:
   uint8_t registers[8] = {0};
   uint16_t AF_register = 0;
   uint16_t BC_register = 0;
   uint16_t DE_register = 0;
   uint16_t HL_register = 0;
+  // EI enables interrupts only after the instruction that follows it
+  bool imePending = false;
+  // Accurate tier: when the running instruction ends, once its bus
+  // accesses have clocked themselves
+  uint64_t instructionEnd = 0;
 
   Memory &memory;
   // Lookup tables for opcodes
   std::array<std::function<void()>, 256> opcodeTable{};
 
+  bool serviceInterrupts();
+
+  // Adds to the running instruction's duration, for taken branches
+  void addCycles(uint32_t count) {
+    if constexpr (Timing::kMCycleBus) {
+      instructionEnd += count;
+    } else {
+      cycles += count;
+    }
+  }
+
+  // An M-cycle without a bus access, where it delays the accesses after it
+  // (accurate tier only; the fast tier has no time within an instruction)
+  void internalCycle() {
+    if constexpr (Timing::kMCycleBus) {
+      cycles += 4;
+    }
+  }
+
+  void push(uint16_t value);
+
   // Instruction handlers
   void NOP();
 
@@ -214,3 +307,8 @@ class CPU {
   void DI();
   void EI();
 };
+
+extern template class BasicCPU<FastTiming>;
+extern template class BasicCPU<AccurateTiming>;
+
+using CPU = BasicCPU<FastTiming>;
@@ -0,0 +1,201 @@
+/**
+ * @file debugger.hpp
+ * @brief Debugger core: PC breakpoints, memory watchpoints, conditions and
+ * stepping, driven from code or from text commands.
+ */
+
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gameboy.hpp"
+#include "memory.hpp"
+
+/**
+ * @brief Why Debugger::run() or Debugger::step() returned.
+ */
+enum class StopReason : uint8_t {
+  None,        ///< The cycle budget ran out.
+  Breakpoint,  ///< PC reached a breakpoint; its instruction has not run.
+  Watchpoint,  ///< The last instruction accessed a watched address.
+  Step,        ///< step() finished its instruction.
+};
+
+/**
+ * @brief The kinds of access a watchpoint reports.
+ */
+enum class Access : uint8_t { Read = 1, Write = 2, ReadWrite = 3 };
+
+/**
+ * @struct Stop
+ * @brief Where and why the machine stopped.
+ */
+struct Stop {
+  StopReason reason = StopReason::None;
+  int id = 0;            ///< The breakpoint or watchpoint that fired.
+  uint16_t address = 0;  ///< The breakpoint's PC, or the address accessed.
+  Access access = Access::Read;  ///< Watchpoints: how it was accessed.
+  uint8_t value = 0;             ///< Watchpoints: the byte read or written.
+};
+
+/**
+ * @brief Decides whether a breakpoint or watchpoint stops the machine.
+ *
+ * Called with the machine as it is at the hit: for breakpoints before the
+ * instruction, for watchpoints in the middle of the accessing instruction.
+ */
+using Condition = std::function<bool(const GameBoy &, const Stop &)>;
+
+/**
+ * @brief Parses a condition such as `A == 0x12 && [0xC000] != 0`.
+ *
+ * Each term compares two operands with ==, !=, <, <=, > or >=; terms are
+ * joined with &&. An operand is a register (A F B C D E H L AF BC DE HL SP
+ * PC), a memory byte `[address]`, `value` (the byte a watchpoint saw) or a
+ * number (decimal, 0x or $ hexadecimal).
+ *
+ * @return The condition, or an empty function with `error` set.
+ */
+Condition parseCondition(const std::string &text, std::string &error);
+
+/**
+ * @brief Describes a stop on three lines: what fired (e.g. "watchpoint 2:
+ * write $42 to $C000"), the registers, and the next instruction.
+ */
+std::string describeStop(const GameBoy &gameboy, const Stop &stop);
+
+/**
+ * @class Debugger
+ * @brief Runs a machine instruction by instruction, stopping at breakpoints
+ * and watchpoints.
+ *
+ * Breakpoints live in bitmaps indexed by PC, one for all banks and one per
+ * ROM bank for 4000-7FFF, so a check is a bit test whatever their number.
+ * Watchpoints trap the pages they cover (see Memory::setTraps): accesses to
+ * other pages take the CPU's usual fast path. Machines run without a
+ * debugger (GameBoy::runCycles) pay nothing at all.
+ *
+ * Running under the debugger gives the same machine state, cycle for
+ * cycle, as runCycles(); idle-loop skipping is turned off while breakpoints
+ * are set, since a skipped loop would run past them.
+ */
+class Debugger : private MemoryWatcher {
+ public:
+  static constexpr int kAnyBank = -1;
+
+  explicit Debugger(GameBoy &gameboy);
+  ~Debugger() override;
+  Debugger(const Debugger &) = delete;
+  Debugger &operator=(const Debugger &) = delete;
+
+  /**
+   * @brief Stops before the instruction at `address` runs.
+   *
+   * @param bank For 4000-7FFF, the ROM bank that must be mapped; kAnyBank
+   * for any. Ignored elsewhere.
+   * @param condition Stops only when it holds; empty for always.
+   * @return The breakpoint's id.
+   */
+  int addBreakpoint(uint16_t address, int bank = kAnyBank,
+                    Condition condition = {});
+
+  /**
+   * @brief Stops after an instruction that accesses `first`-`last`.
+   *
+   * Reports the CPU's own accesses, including instruction fetches and
+   * interrupt pushes; not DMA. When an instruction hits several times the
+   * first hit is reported.
+   *
+   * @return The watchpoint's id.
+   */
+  int addWatchpoint(uint16_t first, uint16_t last, Access access,
+                    Condition condition = {});
+
+  /**
+   * @brief Adds a breakpoint or watchpoint from a text command:
+   *
+   *     break ADDRESS [bank N] [if CONDITION]
+   *     watch r|w|rw FIRST[-LAST] [if CONDITION]
+   *     delete ID
+   *
+   * Empty lines and lines starting with '#' are ignored.
+   *
+   * @return False with `error` set if the command is malformed.
+   */
+  bool command(const std::string &line, std::string &error);
+
+  /**
+   * @brief Removes a breakpoint or watchpoint.
+   *
+   * @return False if no such id is set.
+   */
+  bool remove(int id);
+
+  /**
+   * @brief Removes all breakpoints and watchpoints.
+   */
+  void clear();
+
+  /**
+   * @brief Whether any breakpoint or watchpoint is set.
+   */
+  bool empty() const { return breakpoints.empty() && watchpoints.empty(); }
+
+  /**
+   * @brief Runs until at least `count` cycles have elapsed, like
+   * GameBoy::runCycles, or until a breakpoint or watchpoint stops it.
+   *
+   * A run that follows a breakpoint stop executes that instruction rather
+   * than stopping at it again.
+   */
+  Stop run(uint64_t count);
+
+  /**
+   * @brief Executes one instruction (or services one interrupt or HALT
+   * step) and its events. A breakpoint at PC does not stop it.
+   *
+   * @return A Step stop, or a Watchpoint stop if the instruction hit one.
+   */
+  Stop step();
+
+ private:
+  struct Breakpoint {
+    int id;
+    uint16_t address;
+    int bank;
+    Condition condition;
+  };
+  struct Watchpoint {
+    int id;
+    uint16_t first;
+    uint16_t last;
+    Access access;
+    Condition condition;
+  };
+  using AddressBits = std::bitset<0x10000>;
+  using BankBits = std::bitset<0x4000>;  // 4000-7FFF
+
+  Stop execute(uint64_t count, bool single);
+  bool breakpointAt(uint16_t pc, Stop &stop);
+  void rebuild();
+  void watched(uint16_t address, uint8_t value, Access access);
+  void watchedRead(uint16_t address, uint8_t value) override;
+  void watchedWrite(uint16_t address, uint8_t value) override;
+
+  GameBoy &gameboy;
+  int nextId = 1;
+  std::vector<Breakpoint> breakpoints;
+  std::vector<Watchpoint> watchpoints;
+
+  AddressBits anyBank;
+  std::map<uint16_t, BankBits> romBanks;
+
+  Stop pending;  // First watchpoint hit of the current instruction
+  std::optional<uint16_t> resumeFrom;
+};
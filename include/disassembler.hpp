@@ -0,0 +1,63 @@
+/**
+ * @file disassembler.hpp
+ * @brief SM83 disassembler built on the CPU's opcode metadata.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "memory.hpp"
+#include "opcodes.hpp"
+
+/**
+ * @struct Instruction
+ * @brief One decoded instruction.
+ */
+struct Instruction {
+  uint16_t address = 0;
+  uint8_t opcode = 0;     ///< The opcode, or the second byte after 0xCB.
+  bool prefixed = false;  ///< A 0xCB-prefixed opcode.
+  uint8_t length = 1;
+  uint16_t operand = 0;  ///< The n8/n16/a8/e8 immediate, if any.
+  const char *handler = "";
+  uint8_t cycles = 0;
+  uint8_t takenCycles = 0;
+  Flow flow = Flow::Next;
+  // Statically known jump or call target (Jump, Branch and Call flows)
+  bool hasTarget = false;
+  uint16_t target = 0;
+};
+
+/**
+ * @brief Decodes the instruction at the start of `code`.
+ *
+ * @param code The bytes from the instruction on; bytes past its end read as
+ * 0xFF.
+ * @param address The address of the first byte, for relative targets.
+ */
+Instruction decodeInstruction(std::span<const uint8_t> code,
+                              uint16_t address);
+
+/**
+ * @brief Decodes the instruction at an address of a running machine,
+ * without side effects (see Memory::peek).
+ */
+Instruction decodeInstruction(const Memory &memory, uint16_t address);
+
+/**
+ * @brief Formats an instruction, e.g. "JR NZ,$0150" or "BIT 7,(HL)".
+ */
+std::string formatInstruction(const Instruction &instruction);
+
+/**
+ * @brief Decodes `code` from its first byte to its end, one instruction
+ * after another.
+ *
+ * @param address The address of the first byte.
+ */
+std::vector<Instruction> disassemble(std::span<const uint8_t> code,
+                                     uint16_t address);
@@ -0,0 +1,188 @@
+/**
+ * @file gameboy.hpp
+ * @brief Defines the GameBoy class that ties the CPU, memory and devices
+ * together on a shared clock.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "arena.hpp"
+#include "cpu.hpp"
+#include "memory.hpp"
+#include "ppu.hpp"
+#include "scheduler.hpp"
+#include "timing.hpp"
+
+/**
+ * @class BasicGameBoy
+ * @brief A complete machine: CPU, memory and the devices on the bus.
+ *
+ * The CPU's cycle counter is the machine clock. After each instruction every
+ * device event that has fallen due is handled in deadline order; in the
+ * accurate tier also before each device register access.
+ *
+ * `Timing` selects the accuracy tier (see timing.hpp). Both tiers are built
+ * into the library; `GameBoy`, the fast tier, is the one the tools drive,
+ * and `AccurateGameBoy` gives timing-sensitive code M-cycle bus timing.
+ */
+template <typename Timing>
+class BasicGameBoy {
+ public:
+  /**
+   * @brief Constructs a machine with the LCD off.
+   *
+   * @param arena Owns the machine's dynamic memory; null for the global
+   * heap.
+   */
+  explicit BasicGameBoy(std::shared_ptr<Arena> arena = nullptr);
+  BasicGameBoy(const BasicGameBoy &) = delete;
+  BasicGameBoy &operator=(const BasicGameBoy &) = delete;
+
+  /**
+   * @brief Loads a cartridge ROM and points the CPU at its entry point.
+   *
+   * @param rom The ROM image.
+   */
+  void loadRom(const std::vector<uint8_t> &rom);
+
+  /**
+   * @brief Loads a prepared ROM image shared with other machines.
+   */
+  void loadRom(Cartridge::Image rom);
+
+  /**
+   * @brief Starts the loaded cartridge through a boot ROM: maps it over the
+   * cartridge and points the CPU at 0000 with its registers cleared. The
+   * boot ROM unmaps itself through FF50 and hands over at 0100.
+   *
+   * @param image A 256-byte DMG or 2304-byte CGB boot ROM.
+   * @return False, changing nothing, if the image has neither size.
+   */
+  bool runBootRom(const std::vector<uint8_t> &image);
+
+  /**
+   * @brief Starts through a boot ROM image shared with other machines.
+   */
+  bool runBootRom(Cartridge::Image image);
+
+  /**
+   * @brief Skips the boot ROM: installs the CPU and I/O state it leaves at
+   * 0100 for the loaded cartridge's model, in one step instead of the
+   * millions of cycles it takes to run. The logo is not drawn into VRAM.
+   */
+  void fastBoot();
+
+  /**
+   * @brief Creates a copy of this machine that shares its memory pages
+   * copy-on-write (see Memory::fork).
+   *
+   * If this machine has an arena the fork gets its own, of the same chunk
+   * size, for the pages it copies.
+   *
+   * Forks may be taken from several threads at once and run on any thread,
+   * but not while this machine is running.
+   */
+  std::unique_ptr<BasicGameBoy> fork();
+
+  /**
+   * @brief Warm reset: puts this machine in `snapshot`'s state, sharing its
+   * memory pages copy-on-write, without constructing anything.
+   *
+   * Pages this machine copies later come from its own arena. The same
+   * threading rules as fork() apply to `snapshot`.
+   */
+  void resetTo(BasicGameBoy &snapshot);
+
+  /**
+   * @brief Executes one instruction and handles any events that fall due.
+   */
+  void step();
+
+  /**
+   * @brief Runs until at least `count` cycles have elapsed.
+   *
+   * Stops on the first instruction boundary at or past the target, so the
+   * machine state at return never depends on idle-loop skipping.
+   */
+  void runCycles(uint64_t count);
+
+  /**
+   * @brief Runs for one frame's worth of cycles (twice as many CPU cycles
+   * in CGB double speed).
+   */
+  void runFrame() { runCycles(PPU::kFrameCycles << memory.io.speedShift()); }
+
+  /**
+   * @brief Hashes the complete machine state.
+   *
+   * Everything the machine does is a function of this state and the joypad
+   * input: there is no host time or other outside source in the core, and
+   * all timing is taken from the CPU cycle counter. Two machines with equal
+   * hashes given the same input therefore stay equal.
+   *
+   * @return A host-independent hash of CPU, memory and device state.
+   */
+  uint64_t stateHash() const;
+
+  /**
+   * @brief Saves the state stateHash() covers, plus the idle-skip total.
+   *
+   * The ROM itself is not saved, only a hash identifying it: a state is
+   * loaded into a machine with the same ROM loaded. The format is the
+   * magic "GBST", a version and the devices' state, little endian.
+   */
+  std::vector<uint8_t> saveState() const;
+
+  /**
+   * @brief Restores a saved state, which may be read straight from a mapped
+   * file. Between instructions only.
+   *
+   * @return False, with the reason in `error`, if the data is not a
+   * complete state for the loaded ROM. The machine must then be reset
+   * before it is used.
+   */
+  bool loadState(std::span<const uint8_t> data, std::string &error);
+
+  Memory memory;
+  BasicCPU<Timing> cpu{memory};
+  PPU ppu{memory};
+  Scheduler scheduler;
+
+  /**
+   * @brief Whether idle polling loops are fast-forwarded.
+   */
+  bool idleLoopSkipping = true;
+
+  /**
+   * @brief Total cycles the clock was advanced by idle-loop skipping.
+   */
+  uint64_t skippedIdleCycles = 0;
+
+  /**
+   * @brief Returns the arena holding this machine's dynamic memory, or null.
+   */
+  const std::shared_ptr<Arena> &getArena() const { return arena; }
+
+ private:
+  friend class Debugger;
+  friend class VectorEmulator;
+
+  void finishInstruction();
+  void runEvents();
+  void skipIdleLoop();
+
+  uint64_t stopAt = Scheduler::kNever;
+  std::shared_ptr<Arena> arena;
+};
+
+extern template class BasicGameBoy<FastTiming>;
+extern template class BasicGameBoy<AccurateTiming>;
+
+using GameBoy = BasicGameBoy<FastTiming>;
+using AccurateGameBoy = BasicGameBoy<AccurateTiming>;
@@ -0,0 +1,139 @@
+/**
+ * @file gdb_stub.hpp
+ * @brief Defines GdbStub: the GDB remote serial protocol on a local socket.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "debugger.hpp"
+#include "gameboy.hpp"
+
+/**
+ * @class GdbStub
+ * @brief Lets GDB, or any client of its remote protocol, attach to a
+ * machine to inspect registers and memory, set breakpoints and watchpoints,
+ * and step.
+ *
+ * One client at a time connects to a TCP port on 127.0.0.1 or to a Unix
+ * socket. Packets are read and acknowledged on the stub's own thread. The
+ * machine only ever runs on the thread calling runCycles(), which serves
+ * the client's requests while the machine is stopped, between
+ * instructions. A running machine checks one flag per runCycles() call for
+ * a stop request (GDB's ^C, or a new client); with no breakpoints set it
+ * runs GameBoy::runCycles itself, so an attached but idle client costs
+ * nothing.
+ *
+ * Registers are AF, BC, DE, HL, SP and PC, 16 bits little-endian each, in
+ * that order: the start of GDB's z80 layout. Breakpoint addresses above
+ * FFFF select a ROM bank, as bank << 16 | address. Memory accesses go
+ * through Memory::peek and Memory::poke, so ROM cannot be patched.
+ */
+class GdbStub {
+ public:
+  /**
+   * @param gameboy The machine; it must outlive the stub.
+   */
+  explicit GdbStub(GameBoy &gameboy);
+  GdbStub(const GdbStub &) = delete;
+  GdbStub &operator=(const GdbStub &) = delete;
+
+  /**
+   * @brief Closes the sockets and stops the stub's thread. The machine must
+   * not be running.
+   */
+  ~GdbStub();
+
+  /**
+   * @brief Listens on a TCP port of 127.0.0.1.
+   *
+   * @param port The port; 0 picks a free one (see port()).
+   * @return False with `error` set if the socket cannot be opened.
+   */
+  bool listenTcp(uint16_t port, std::string &error);
+
+  /**
+   * @brief Listens on a Unix socket, replacing any file at `path`.
+   */
+  bool listenUnix(const std::string &path, std::string &error);
+
+  /**
+   * @brief Returns the TCP port listened on, or 0.
+   */
+  uint16_t port() const { return tcpPort; }
+
+  /**
+   * @brief Blocks until a client has connected.
+   */
+  void waitForClient();
+
+  /**
+   * @brief Runs the machine for at least `count` cycles, as
+   * GameBoy::runCycles does.
+   *
+   * Blocks, without counting the time, while a client holds the machine
+   * stopped.
+   */
+  void runCycles(uint64_t count);
+
+  /**
+   * @brief Runs for one frame's worth of cycles (see GameBoy::runFrame).
+   */
+  void runFrame() {
+    runCycles(PPU::kFrameCycles << gameboy.memory.io.speedShift());
+  }
+
+ private:
+  // Why the network thread wants the machine stopped
+  enum class Request : uint8_t { None, Attach, Interrupt, Detach };
+
+  // Network thread
+  bool startListening(int socket, std::string &error);
+  void serve();
+  void converse(int client);
+  bool handleLocally(const std::string &packet);
+  void send(const std::string &packet);
+  void forward(std::string packet);
+
+  // Emulation thread
+  void serveStopped();
+  bool handle(const std::string &packet);
+  void reportStop(const Stop &stop);
+  std::string readRegisters() const;
+  std::string setBreakpoint(const std::string &packet);
+
+  GameBoy &gameboy;
+  Debugger debugger;
+  // Z packet type and address of each breakpoint or watchpoint, to its id
+  std::map<std::pair<char, uint32_t>, int> points;
+  std::string lastStop = "S05";
+  uint64_t servedSession = 0;
+
+  int listener = -1;
+  uint16_t tcpPort = 0;
+  std::string unixPath;
+  std::thread thread;
+
+  std::mutex sendMutex;
+  int client = -1;             // Guarded by sendMutex
+  bool acknowledging = true;  // Network thread only
+
+  std::atomic<Request> request{Request::None};
+  // Guards the rest, which the threads share
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<std::string> requests;  // Packets for the emulation thread
+  bool connected = false;
+  uint64_t session = 0;  // Counts clients
+  bool stopped = false;  // The emulation thread is serving requests
+  bool closing = false;
+};
@@ -0,0 +1,104 @@
+/**
+ * @file golden.hpp
+ * @brief Golden-image regression harness: runs ROMs with fixed input and
+ * compares the screen at checkpoints against stored hashes.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct GoldenCheckpoint
+ * @brief The screen after a given frame: its exact framebuffer hash and
+ * its perceptual hash.
+ */
+struct GoldenCheckpoint {
+  uint32_t frame = 0;
+  uint64_t framebufferHash = 0;
+  uint64_t perceptualHash = 0;
+};
+
+/**
+ * @brief Writes golden checkpoints as text: a comment line, then one
+ * "<frame> <hash> <perceptual hash>" line per checkpoint, hashes in hex.
+ *
+ * @return True on success.
+ */
+bool saveGolden(const std::string &path,
+                const std::vector<GoldenCheckpoint> &checkpoints);
+
+/**
+ * @brief Reads golden checkpoints written by saveGolden().
+ *
+ * @return True if the file was read completely.
+ */
+bool loadGolden(const std::string &path,
+                std::vector<GoldenCheckpoint> &checkpoints);
+
+/**
+ * @struct GoldenOptions
+ * @brief How the harness runs each ROM.
+ */
+struct GoldenOptions {
+  // Frames to run when a ROM has no input movie
+  uint32_t frames = 600;
+  // Frames between checkpoints
+  uint32_t interval = 60;
+  // Perceptual hash bits that may differ before a changed frame fails; 0
+  // fails on any change
+  int tolerance = 0;
+  // Record new goldens instead of comparing
+  bool update = false;
+  // Where to write the PNGs of failing frames; empty for beside the ROM
+  std::string imageDirectory;
+};
+
+/**
+ * @struct GoldenResult
+ * @brief The outcome of one ROM.
+ */
+struct GoldenResult {
+  std::string name;
+  bool ok = false;
+  uint32_t checkpoints = 0;
+  uint32_t mismatches = 0;
+  // Largest perceptual distance of any changed checkpoint
+  int worstDistance = 0;
+  std::vector<std::string> images;  ///< PNGs written for failing frames.
+  std::string error;
+  double seconds = 0;
+};
+
+/**
+ * @brief Runs one ROM and checks (or records) its golden checkpoints.
+ *
+ * The golden file is the ROM's path with the extension `.golden`. If the
+ * same path with `.gbmv` holds an input movie, recorded from power-on, its
+ * input is played and it sets the number of frames; otherwise the ROM runs
+ * without input. A checkpoint whose exact hash differs fails unless a
+ * tolerance is set and its perceptual hash is within it; the screen at
+ * each failing checkpoint is written as a PNG.
+ *
+ * @param romPath The ROM file.
+ * @param name The ROM's name in the results and image file names.
+ */
+GoldenResult runGoldenCase(const std::string &romPath,
+                           const std::string &name,
+                           const GoldenOptions &options);
+
+/**
+ * @brief Runs a set of ROMs spread over worker threads.
+ *
+ * @param directory The suite directory; results are named by their path
+ * relative to it.
+ * @param paths The ROM files.
+ * @param threads Worker threads; 0 for one per hardware thread.
+ * @return One result per path, in the same order.
+ */
+std::vector<GoldenResult> runGoldenSuite(const std::string &directory,
+                                         const std::vector<std::string> &paths,
+                                         const GoldenOptions &options,
+                                         unsigned threads = 0);
@@ -0,0 +1,44 @@
+/**
+ * @file hash.hpp
+ * @brief FNV-1a hashing used for state and framebuffer fingerprints.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The FNV-1a 64-bit offset basis, the hash of no bytes.
+ */
+inline constexpr uint64_t kFnvOffsetBasis = 0xCBF29CE484222325ull;
+
+/**
+ * @brief Hashes a byte range with 64-bit FNV-1a.
+ *
+ * The result depends only on the bytes, never on the host, so hashes can be
+ * stored in files and compared across machines.
+ *
+ * @param data The bytes to hash.
+ * @param size The number of bytes.
+ * @param hash The hash to continue from, for hashing several ranges.
+ * @return The updated hash.
+ */
+inline uint64_t fnv1a(const void *data, size_t size,
+                      uint64_t hash = kFnvOffsetBasis) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+/**
+ * @brief Folds an integer into a hash, least significant byte first.
+ */
+inline uint64_t fnv1aValue(uint64_t value, uint64_t hash) {
+  for (int i = 0; i < 8; i++) {
+    hash = (hash ^ ((value >> (i * 8)) & 0xFF)) * 0x100000001B3ull;
+  }
+  return hash;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file image.hpp
+ * @brief RGB images of the screen: capture, PNG encoding and perceptual
+ * hashing.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "gameboy.hpp"
+
+/**
+ * @struct Image
+ * @brief An 8-bit RGB image, row major with no padding.
+ */
+struct Image {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<uint8_t> rgb;
+};
+
+/**
+ * @brief Converts the machine's framebuffer to RGB.
+ *
+ * DMG shades map to four greys from white to black; CGB RGB555 colors are
+ * scaled to eight bits per channel.
+ */
+Image captureScreen(const GameBoy &gameboy);
+
+/**
+ * @brief Converts a framebuffer, such as a recorded one, to RGB as
+ * captureScreen() does.
+ *
+ * @param framebuffer PPU::kScreenWidth by PPU::kScreenHeight pixels.
+ * @param cgb Whether the pixels are CGB colors rather than DMG shades.
+ */
+Image framebufferImage(std::span<const uint16_t> framebuffer, bool cgb);
+
+/**
+ * @brief Encodes an image as a PNG file.
+ *
+ * The encoder has no dependencies: the image data is stored in
+ * uncompressed deflate blocks, so files are about as large as the pixels
+ * but any PNG reader can open them.
+ */
+std::vector<uint8_t> encodePng(const Image &image);
+
+/**
+ * @brief Writes an image to a PNG file.
+ *
+ * @return True on success.
+ */
+bool writePng(const std::string &path, const Image &image);
+
+/**
+ * @brief Returns a 64-bit difference hash (dHash) of an image.
+ *
+ * The image is reduced to 9x8 average luminances and each bit records
+ * whether a cell is darker than its right-hand neighbor, so images that
+ * look alike have hashes a few bits apart even when no pixel is equal.
+ */
+uint64_t perceptualHash(const Image &image);
+
+/**
+ * @brief Returns how many bits differ between two perceptual hashes.
+ */
+int hashDistance(uint64_t a, uint64_t b);
@@ -0,0 +1,303 @@
+/**
+ * @file io.hpp
+ * @brief Defines the IO class: the memory-mapped I/O registers (FF00-FF7F).
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+class Memory;
+class PPU;
+class Scheduler;
+class SerialPeer;
+class StateReader;
+class StateWriter;
+
+/**
+ * @class IO
+ * @brief The I/O register block and the devices without a class of their
+ * own (joypad and timer).
+ *
+ * Every register has a read and a write handler in a constexpr 128-entry
+ * table, so an access is one indexed indirect call. Registers without side
+ * effects use plain storage handlers.
+ *
+ * The timer is derived from the machine clock rather than ticked: DIV and
+ * TIMA are computed from the cycle count when read, and TIMA overflow is a
+ * scheduled event.
+ *
+ * OAM DMA is likewise a single scheduled event: writing DMA locks the CPU
+ * out of the bus, and when the transfer time has elapsed the whole block is
+ * copied at once.
+ *
+ * The serial port shifts a byte out and one in over eight clock periods.
+ * When this machine provides the clock, the end of the transfer is a
+ * scheduled event at which the byte is exchanged with the SerialPeer;
+ * otherwise the peer delivers the incoming byte when the other end clocks
+ * it.
+ *
+ * In CGB mode the block also holds the palette RAM, drives VRAM DMA (HDMA)
+ * and switches the CPU speed. All timing stays in CPU cycles: in double
+ * speed the PPU's durations are doubled while the timer, DIV, OAM DMA and
+ * the serial clock, which are clocked by the CPU, are unchanged.
+ */
+class IO {
+ public:
+  static constexpr uint8_t P1 = 0x00;
+  static constexpr uint8_t SB = 0x01;
+  static constexpr uint8_t SC = 0x02;
+  static constexpr uint8_t DIV = 0x04;
+  static constexpr uint8_t TIMA = 0x05;
+  static constexpr uint8_t TMA = 0x06;
+  static constexpr uint8_t TAC = 0x07;
+  static constexpr uint8_t IF = 0x0F;
+  static constexpr uint8_t LCDC = 0x40;
+  static constexpr uint8_t STAT = 0x41;
+  static constexpr uint8_t LY = 0x44;
+  static constexpr uint8_t DMA = 0x46;
+  static constexpr uint8_t KEY1 = 0x4D;
+  static constexpr uint8_t VBK = 0x4F;
+  static constexpr uint8_t BOOT = 0x50;
+  static constexpr uint8_t HDMA1 = 0x51;
+  static constexpr uint8_t HDMA2 = 0x52;
+  static constexpr uint8_t HDMA3 = 0x53;
+  static constexpr uint8_t HDMA4 = 0x54;
+  static constexpr uint8_t HDMA5 = 0x55;
+  static constexpr uint8_t BCPS = 0x68;
+  static constexpr uint8_t BCPD = 0x69;
+  static constexpr uint8_t OCPS = 0x6A;
+  static constexpr uint8_t OCPD = 0x6B;
+  static constexpr uint8_t SVBK = 0x70;
+
+  /**
+   * @brief Length of an OAM DMA transfer in cycles (160 M-cycles).
+   */
+  static constexpr uint32_t kDmaCycles = 640;
+
+  /**
+   * @brief Cycles per bit of a serial transfer on the internal clock
+   * (8192 Hz), and with the CGB fast clock selected (262144 Hz).
+   */
+  static constexpr uint32_t kSerialBitCycles = 512;
+  static constexpr uint32_t kFastSerialBitCycles = 16;
+
+  using ReadHandler = uint8_t (*)(IO &io, uint8_t index);
+  using WriteHandler = void (*)(IO &io, uint8_t index, uint8_t value);
+
+  /**
+   * @brief The handlers for one register.
+   */
+  struct Register {
+    ReadHandler read;
+    WriteHandler write;
+  };
+
+  IO() = default;
+  IO(const IO &other);
+  IO &operator=(const IO &other);
+
+  /**
+   * @brief Reads a register as the CPU would.
+   *
+   * @param index The register offset from 0xFF00 (0x00-0x7F).
+   */
+  uint8_t read(uint8_t index);
+
+  /**
+   * @brief Writes a register as the CPU would, with its side effects.
+   *
+   * @param index The register offset from 0xFF00 (0x00-0x7F).
+   * @param value The value written.
+   */
+  void write(uint8_t index, uint8_t value);
+
+  /**
+   * @brief Direct access to a register's storage, for devices.
+   *
+   * @param address The register's full address (FF00-FF7F).
+   */
+  uint8_t &reg(uint16_t address) { return registers[address & 0x7F]; }
+
+  /**
+   * @brief Sets the 16-bit counter whose high byte DIV shows, as the boot
+   * ROM leaves it.
+   */
+  void setDivider(uint16_t counter);
+
+  /**
+   * @brief Sets an interrupt request bit in IF.
+   */
+  void requestInterrupt(uint8_t bit) { registers[IF] |= bit; }
+
+  /**
+   * @brief Connects the registers to the machine.
+   *
+   * Until attached the timer does not advance and LCDC writes do not start
+   * or stop the PPU, which is enough for testing the bus on its own.
+   */
+  void attach(uint64_t *clock, Scheduler *scheduler, PPU *ppu);
+
+  /**
+   * @brief Sets the pressed buttons. Safe to call from any thread.
+   *
+   * P1 reads see the new state immediately; the joypad interrupt is raised
+   * on the emulation thread by the next syncJoypad().
+   */
+  void setButtons(uint8_t pressed) {
+    buttons.store(pressed, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the pressed buttons.
+   */
+  uint8_t getButtons() const {
+    return buttons.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Raises the joypad interrupt if a selected button has been
+   * pressed since the last sync. Emulation thread only.
+   */
+  void syncJoypad();
+
+  /**
+   * @brief Handles a TIMA overflow event: reloads TMA and requests the
+   * timer interrupt.
+   *
+   * @param time The cycle count the overflow was scheduled for.
+   */
+  void timerOverflow(uint64_t time);
+
+  /**
+   * @brief Returns 1 in CGB double speed mode, otherwise 0: the shift that
+   * converts PPU dots to CPU cycles.
+   */
+  uint8_t speedShift() const { return registers[KEY1] >> 7; }
+
+  /**
+   * @brief Handles the STOP instruction: in CGB mode with a speed switch
+   * armed through KEY1, toggles double speed.
+   */
+  void stop();
+
+  /**
+   * @brief Called by the PPU as each visible line enters HBlank; copies the
+   * next block of an HBlank DMA.
+   */
+  void hblank();
+
+  /**
+   * @brief Returns the background (false) or object (true) palette RAM:
+   * eight palettes of four little-endian RGB555 colors.
+   */
+  const uint8_t *paletteRam(bool objects) const {
+    return objects ? objectPalettes.data() : backgroundPalettes.data();
+  }
+
+  /**
+   * @brief Handles the end of an OAM DMA: copies the 160 bytes into OAM and
+   * gives the bus back to the CPU.
+   */
+  void finishDma();
+
+  /**
+   * @brief Plugs a device into the serial port, or unplugs it (null).
+   *
+   * With nothing plugged in a transfer shifts in 0xFF. The peer must
+   * outlive the connection, and is not copied with the registers.
+   */
+  void connectSerial(SerialPeer *peer);
+
+  /**
+   * @brief Handles the end of a serial transfer clocked by this machine.
+   *
+   * @param time The cycle count the transfer was scheduled to end at.
+   */
+  void finishSerial(uint64_t time);
+
+  /**
+   * @brief Delivers a byte clocked by the other end of the serial port.
+   *
+   * Completes the transfer if one is waiting on the external clock;
+   * otherwise the byte is lost.
+   */
+  void receiveSerial(uint8_t data);
+
+  /**
+   * @brief Handles a serial synchronization event: calls the peer and
+   * schedules the next one.
+   *
+   * @param time The cycle count the event was scheduled for.
+   */
+  void syncSerial(uint64_t time);
+
+  /**
+   * @brief Hashes the registers and device state.
+   */
+  uint64_t hash() const;
+
+  /**
+   * @brief Saves the registers and device state hash() covers.
+   */
+  void saveState(StateWriter &out) const;
+
+  /**
+   * @brief Restores saved registers and device state. The machine
+   * connections and the serial peer are kept.
+   *
+   * @return False if the VRAM DMA or joypad state is impossible.
+   */
+  bool loadState(StateReader &in);
+
+ private:
+  friend class Memory;
+  friend struct IOHandlers;
+
+  uint64_t now() const { return clock ? *clock : 0; }
+  // Advances the attached clock, for bus accesses that take time
+  void elapse(uint32_t cycles) {
+    if (clock) {
+      *clock += cycles;
+    }
+  }
+  void syncTimer(uint64_t time);
+  void scheduleTimer();
+  void copyVramBlocks(uint8_t blocks);
+  uint8_t *palettes(uint8_t dataIndex) {
+    return dataIndex == BCPD ? backgroundPalettes.data()
+                             : objectPalettes.data();
+  }
+
+  std::array<uint8_t, 128> registers{};
+
+  // Host input; lock-free so another thread can update it at any time
+  std::atomic<uint8_t> buttons{0};
+  static_assert(std::atomic<uint8_t>::is_always_lock_free);
+  uint8_t lastJoypad = 0x0F;
+
+  // Timer: the clock value when DIV was last reset, and the clock value up
+  // to which TIMA has been brought up to date
+  uint64_t divBase = 0;
+  uint64_t timerSync = 0;
+
+  // CGB palette RAM, written through BCPD/OCPD
+  std::array<uint8_t, 64> backgroundPalettes{};
+  std::array<uint8_t, 64> objectPalettes{};
+
+  // HBlank DMA in progress: the next addresses and the blocks left
+  uint16_t hdmaSource = 0;
+  uint16_t hdmaDestination = 0;
+  uint8_t hdmaBlocks = 0;
+
+  SerialPeer *serialPeer = nullptr;
+
+  Memory *memory = nullptr;
+  // Advanced directly while HDMA stalls the CPU, and by each bus access in
+  // the accurate tier
+  uint64_t *clock = nullptr;
+  Scheduler *scheduler = nullptr;
+  PPU *ppu = nullptr;
+};
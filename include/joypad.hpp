@@ -0,0 +1,41 @@
+/**
+ * @file joypad.hpp
+ * @brief Joypad buttons and the P1 (0xFF00) register encoding.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Button bits as used in input movies and host input; 1 = pressed.
+ */
+enum Button : uint8_t {
+  ButtonA = 0x01,
+  ButtonB = 0x02,
+  ButtonSelect = 0x04,
+  ButtonStart = 0x08,
+  ButtonRight = 0x10,
+  ButtonLeft = 0x20,
+  ButtonUp = 0x40,
+  ButtonDown = 0x80,
+};
+
+/**
+ * @brief Computes the value the CPU reads from P1.
+ *
+ * @param select The P1 select bits as last written (bit 4 selects the
+ * d-pad, bit 5 the action buttons; 0 = selected).
+ * @param buttons The pressed buttons.
+ * @return The P1 value, with 0 bits for pressed buttons in selected groups.
+ */
+inline uint8_t joypadRegister(uint8_t select, uint8_t buttons) {
+  uint8_t pressed = 0;
+  if (!(select & 0x10)) {
+    pressed |= buttons >> 4;
+  }
+  if (!(select & 0x20)) {
+    pressed |= buttons & 0x0F;
+  }
+  return 0xC0 | (select & 0x30) | (~pressed & 0x0F);
+}
@@ -0,0 +1,132 @@
+/**
+ * @file link_cable.hpp
+ * @brief Defines LinkCable: an in-process link cable between two machines.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "gameboy.hpp"
+#include "serial.hpp"
+#include "spsc_queue.hpp"
+
+/**
+ * @class LinkCable
+ * @brief Connects the serial ports of two machines, which may run on
+ * separate threads.
+ *
+ * The machines keep their own clocks and synchronize every half of the
+ * maximum skew: each publishes how far it has run and waits (yielding its
+ * thread) while it is ahead of the other by more than that. One machine
+ * therefore never runs more than the maximum skew, plus the length of one
+ * instruction, ahead of the other.
+ *
+ * A byte clocked by one machine is exchanged at the end of its transfer:
+ * the clocking machine takes the last byte the other published in SB, and
+ * its own byte goes through a lock-free queue to the other, which receives
+ * it at its first synchronization at or past the transfer's time. Nothing
+ * is locked and the only waiting is for the skew bound.
+ *
+ * Clocks are counted from when the cable is connected, so machines that
+ * have run for different times can be linked. Exact timing of delivery
+ * depends on thread scheduling; run() steps both machines on one thread in
+ * a fixed order, which is deterministic.
+ */
+class LinkCable {
+ public:
+  // Half a byte at the normal serial clock between synchronizations
+  static constexpr uint64_t kDefaultMaxSkew = 4096;
+
+  // Bounds the bytes in flight, at the fastest serial clock, to what the
+  // queues hold; larger skews are clamped
+  static constexpr uint64_t kMaxSkew = 65536;
+
+  /**
+   * @brief Plugs the cable into two machines.
+   *
+   * @param first,second The machines; both must outlive the cable.
+   * @param maxSkew How many cycles one machine may run ahead of the other
+   * (at most kMaxSkew).
+   */
+  LinkCable(GameBoy &first, GameBoy &second,
+            uint64_t maxSkew = kDefaultMaxSkew);
+  LinkCable(const LinkCable &) = delete;
+  LinkCable &operator=(const LinkCable &) = delete;
+
+  /**
+   * @brief Unplugs the cable. Neither machine may be running.
+   */
+  ~LinkCable();
+
+  /**
+   * @brief Stops synchronizing, releasing a machine waiting for the other.
+   * Safe to call from any thread.
+   *
+   * Afterwards the machines run independently and transfers shift in 0xFF.
+   * Call this before a machine's thread stops running it while the other
+   * still runs.
+   */
+  void disconnect() { connected.store(false, std::memory_order_release); }
+
+  /**
+   * @brief Runs both machines for `cycles` cycles on the calling thread,
+   * alternating between them at each synchronization point.
+   *
+   * Neither machine may be running elsewhere meanwhile.
+   */
+  void run(uint64_t cycles);
+
+  /**
+   * @brief Returns the maximum skew in cycles.
+   */
+  uint64_t maxSkew() const { return 2 * interval; }
+
+  /**
+   * @brief Returns how many synchronizations had to wait for the other
+   * machine.
+   */
+  uint64_t waits() const { return waitCount.load(std::memory_order_relaxed); }
+
+ private:
+  // A byte clocked by one end, stamped with the clocking machine's time
+  struct Transfer {
+    uint64_t time;
+    uint8_t data;
+  };
+
+  class Port : public SerialPeer {
+   public:
+    uint8_t exchange(uint64_t time, uint8_t out) override;
+    void publish(uint8_t data) override;
+    uint64_t syncInterval() const override { return cable->interval; }
+    void synchronize(uint64_t time) override;
+
+    void plug(LinkCable *cable, Port *other, GameBoy *machine);
+    void deliver(uint64_t time);
+
+    LinkCable *cable = nullptr;
+    Port *other = nullptr;
+    GameBoy *machine = nullptr;
+    uint64_t origin = 0;  // The machine's clock when connected
+
+    // Written by this port's thread, read by the other's
+    std::atomic<uint64_t> clock{0};
+    std::atomic<uint8_t> data{0xFF};
+
+    // Written by the other port's thread
+    SpscQueue<Transfer, 1024> inbox;
+  };
+
+  uint64_t interval;
+  std::atomic<bool> connected{true};
+  std::atomic<uint64_t> waitCount{0};
+  std::array<Port, 2> ports;
+
+  // Set while run() alternates the machines, which keeps them in step
+  // without waiting
+  bool lockstep = false;
+  uint64_t position = 0;  // Where run() has brought both machines
+};
@@ -0,0 +1,36 @@
+/**
+ * @file lz.hpp
+ * @brief A small LZ77 block compressor in the style of LZ4, for data that
+ * repeats a lot and must be compressed quickly, such as frame deltas.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Compresses a block.
+ *
+ * The block is a series of sequences, each a token byte holding a literal
+ * count and a match length in its high and low nibbles, any further length
+ * bytes, the literals, then a 2-byte little endian match offset. The last
+ * sequence has only literals. Matches are at least 4 bytes long and at most
+ * 65535 bytes back.
+ *
+ * @param out Replaced with the compressed block.
+ */
+void lzCompress(std::span<const uint8_t> data, std::vector<uint8_t> &out);
+
+/**
+ * @brief Decompresses a block made by lzCompress().
+ *
+ * @param size The size of the uncompressed data.
+ * @param out Replaced with the uncompressed data.
+ * @return False if the block is malformed or does not decompress to `size`
+ * bytes.
+ */
+bool lzDecompress(std::span<const uint8_t> block, size_t size,
+                  std::vector<uint8_t> &out);
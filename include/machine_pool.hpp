@@ -0,0 +1,97 @@
+/**
+ * @file machine_pool.hpp
+ * @brief Defines MachinePool: pre-constructed machines reused across short
+ * jobs.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "gameboy.hpp"
+#include "parallel.hpp"
+
+/**
+ * @class MachinePool
+ * @brief Hands out machines warm-reset to a snapshot, so that a farm of
+ * short jobs does not construct and destroy a machine for each one.
+ *
+ * Constructing a GameBoy allocates its pages and builds the CPU's opcode
+ * table. A warm reset (GameBoy::resetTo) instead takes the snapshot's pages
+ * copy-on-write and copies its CPU, PPU and scheduler state, which takes
+ * microseconds. The snapshot can be any state: a ROM just after
+ * fastBoot(), or one run to its title screen.
+ *
+ * Machines may be acquired and returned from any thread. Each has its own
+ * arena if the snapshot has one.
+ */
+class MachinePool {
+ public:
+  /**
+   * @brief A machine on loan from the pool; destroying the lease returns
+   * it.
+   */
+  class Lease {
+   public:
+    Lease(Lease &&other) = default;
+    Lease &operator=(Lease &&other) = delete;
+    ~Lease();
+
+    GameBoy &operator*() const { return *machine; }
+    GameBoy *operator->() const { return machine.get(); }
+
+   private:
+    friend class MachinePool;
+    Lease(MachinePool &pool, std::unique_ptr<GameBoy> machine)
+        : pool(&pool), machine(std::move(machine)) {}
+
+    MachinePool *pool;
+    std::unique_ptr<GameBoy> machine;
+  };
+
+  /**
+   * @brief Creates a pool of machines reset to `snapshot`.
+   *
+   * The snapshot must outlive the pool and must not run while machines are
+   * being acquired.
+   *
+   * @param size Machines to construct up front. More are constructed when
+   * every machine is on loan.
+   */
+  explicit MachinePool(GameBoy &snapshot, size_t size = 0);
+
+  /**
+   * @brief Returns a machine in the snapshot's state.
+   */
+  Lease acquire();
+
+  /**
+   * @brief Returns the number of machines constructed, on loan or not.
+   */
+  size_t size() const;
+
+ private:
+  std::unique_ptr<GameBoy> construct() const;
+  void release(std::unique_ptr<GameBoy> machine);
+
+  GameBoy &snapshot;
+  mutable std::mutex mutex;
+  std::vector<std::unique_ptr<GameBoy>> idle;
+  size_t constructed = 0;
+};
+
+/**
+ * @brief Calls `job(i, machine)` for every i below `count` on up to
+ * `threads` threads (see parallelFor), each time with a pooled machine
+ * reset to the pool's snapshot.
+ */
+template <typename Job>
+void runJobs(MachinePool &pool, size_t count, unsigned threads, Job job) {
+  parallelFor(count, threads, [&](size_t i) {
+    MachinePool::Lease machine = pool.acquire();
+    job(i, *machine);
+  });
+}
@@ -6,56 +6,512 @@
 #pragma once
 
 #include <array>
+#include <bitset>
 #include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cartridge.hpp"
+#include "io.hpp"
+#include "perf_counters.hpp"
+#include "shared_page.hpp"
+#include "timing.hpp"
+
+class StateReader;
+class StateWriter;
+
+/**
+ * @class MemoryWatcher
+ * @brief Told about the CPU's accesses to trapped pages (see
+ * Memory::setTraps).
+ */
+class MemoryWatcher {
+public:
+    virtual ~MemoryWatcher() = default;
+
+    /**
+     * @brief A read of a trapped page; `value` is the byte read.
+     */
+    virtual void watchedRead(uint16_t address, uint8_t value) = 0;
+
+    /**
+     * @brief A write to a trapped page, reported before it takes effect.
+     */
+    virtual void watchedWrite(uint16_t address, uint8_t value) = 0;
+};
 
 /**
  * @class Memory
  * @brief Represents the memory of the Game Boy.
  * 
  * This class provides methods to read and write bytes and words to the Game Boy's memory.
+ *
+ * Accesses go through tables of 256-byte page pointers, one for reads and
+ * one for writes. Pages backed by plain storage (ROM, VRAM, RAM and the
+ * echo of work RAM) are accessed directly; a null page falls through to the
+ * slow path, which handles MBC registers, disabled cartridge RAM, OAM, the
+ * I/O registers and HRAM.
+ *
+ * Banking never adds work to an access: switching a cartridge, VRAM or work
+ * RAM bank retargets the affected page pointers once.
+ *
+ * VRAM, work RAM and cartridge RAM banks are copy-on-write pages (see
+ * SharedPage), which makes fork() cost a few pointer copies. A shared page
+ * is mapped for reads only, so the first write to it takes the slow path,
+ * copies the page and maps the copy; later writes are direct again.
  */
 class Memory {
 public:
     /**
      * @brief Constructs a new Memory object.
+     * 
+     * @param resource Where RAM pages are allocated once written, such as
+     * the instance's Arena; null for the global heap.
+     */
+    explicit Memory(PageResource resource = nullptr);
+
+    /**
+     * @brief Copies another memory, keeping the I/O block bound to this one.
+     */
+    Memory(const Memory &other);
+
+    /**
+     * @brief Takes over another memory's pages, typically a fork().
+     */
+    Memory(Memory &&other);
+
+    /**
+     * @brief Copies another memory's contents and rebuilds the page table
+     * over this one's storage.
      */
-    Memory();
+    Memory &operator=(const Memory &other);
+
+    /**
+     * @brief Takes over another memory's pages without copying them.
+     */
+    Memory &operator=(Memory &&other);
+
+    /**
+     * @brief Returns a copy that shares every RAM page with this memory
+     * until one of them writes it.
+     * 
+     * Costs one reference per page; only pages written afterwards are
+     * copied, by whichever side writes first. Forks may be taken from
+     * several threads at once and run on any thread, but not while this
+     * memory is being accessed.
+     * 
+     * @return The copy.
+     */
+    Memory fork();
 
     /**
      * @brief Reads a byte from the specified address.
      * 
+     * @tparam Timing The tier of the CPU making the access (see
+     * timing.hpp); with AccurateTiming the access takes an M-cycle of the
+     * attached clock.
      * @param address The address to read from.
      * @return The byte read from the specified address.
      */
+    template <typename Timing = FastTiming>
     uint8_t readByte(uint16_t address);
 
     /**
      * @brief Writes a byte to the specified address.
      * 
+     * @tparam Timing The tier of the CPU making the access.
      * @param address The address to write to.
      * @param value The byte value to write.
      */
+    template <typename Timing = FastTiming>
     void writeByte(uint16_t address, uint8_t value);
 
     /**
      * @brief Reads a word (two bytes) from the specified address.
      * 
+     * @tparam Timing The tier of the CPU making the access.
      * @param address The address to read from.
      * @return The word read from the specified address.
      */
+    template <typename Timing = FastTiming>
     uint16_t readWord(uint16_t address);
 
     /**
      * @brief Writes a word (two bytes) to the specified address.
      * 
+     * @tparam Timing The tier of the CPU making the access.
      * @param address The address to write to.
      * @param value The word value to write.
      */
+    template <typename Timing = FastTiming>
     void writeWord(uint16_t address, uint16_t value);
 
+    /**
+     * @brief Inserts a cartridge and maps its first banks.
+     * 
+     * Also selects CGB mode if the header marks the ROM as CGB capable.
+     * 
+     * @param rom The ROM image.
+     */
+    void loadRom(const std::vector<uint8_t> &rom);
+
+    /**
+     * @brief Inserts a cartridge holding a prepared, shared ROM image (see
+     * Cartridge::prepare).
+     */
+    void loadRom(Cartridge::Image rom);
+
+    /**
+     * @brief Returns the inserted cartridge.
+     */
+    const Cartridge &getCartridge() const { return cartridge; }
+
+    /**
+     * @brief Whether the machine runs in Game Boy Color mode.
+     */
+    bool isCgb() const { return cgb; }
+
+    /**
+     * @brief Selects Game Boy Color mode, which enables the VRAM and work
+     * RAM bank registers and the CGB-only I/O registers.
+     */
+    void setCgb(bool enabled) { cgb = enabled; }
+
+    /**
+     * @brief Maps VRAM bank 0 or 1 at 8000-9FFF.
+     */
+    void selectVramBank(uint8_t bank);
+
+    /**
+     * @brief Maps work RAM bank 1-7 at D000-DFFF (0 selects 1).
+     */
+    void selectWramBank(uint8_t bank);
+
+    /**
+     * @brief Returns an 8 KB VRAM bank, for the PPU.
+     * 
+     * Bank 1 holds the CGB background attribute maps. It cannot be mapped
+     * outside CGB mode, so there it always reads as all-zero attributes.
+     */
+    const uint8_t *videoRam(uint8_t bank) const { return vram[bank].data(); }
+
+    /**
+     * @brief Returns a 4 KB work RAM bank for direct access, first taking a
+     * private copy if it is shared.
+     * 
+     * The bank is then pinned: it keeps its storage for the life of this
+     * memory. Loaded states and assigned memories are copied into it, and
+     * forks and copies take their own.
+     * 
+     * @param bank The bank number, 0-7.
+     */
+    uint8_t *workRam(uint8_t bank);
+
+    /**
+     * @brief Returns object attribute memory (FE00-FE9F), for the PPU.
+     */
+    const uint8_t *objectAttributes() const { return high.data(); }
+
+    /**
+     * @brief Returns the interrupts that are both requested and enabled.
+     * 
+     * This is the CPU's view of IF & IE and is not counted as a bus access.
+     * 
+     * @return The pending interrupt bits (IE & IF & 0x1F).
+     */
+    uint8_t pendingInterrupts() const {
+        return high[0x1FF] & io.registers[IO::IF] & 0x1F;
+    }
+
+    /**
+     * @brief Reads a byte as a device would, with no side effects and
+     * without being counted as a bus access.
+     * 
+     * @param address The address to read from.
+     * @return The stored byte.
+     */
+    uint8_t peek(uint16_t address) const {
+        if (const uint8_t *page = readMap[address >> 8]) {
+            return page[address & 0xFF];
+        }
+        if (address >= 0xFE00) {
+            return isIO(address) ? io.registers[address & 0x7F]
+                                 : high[address - 0xFE00];
+        }
+        return 0xFF;  // Disabled cartridge RAM
+    }
+
+    /**
+     * @brief Returns where a ROM address currently lives in the loaded
+     * image, or null outside ROM or with no cartridge loaded. Machines
+     * sharing an image get equal pointers exactly when they would fetch
+     * the same byte.
+     * 
+     * @param address The address to look up.
+     */
+    const uint8_t *romAt(uint16_t address) const {
+        if (address >= 0x8000 || !cartridge.isLoaded()) {
+            return nullptr;
+        }
+        const uint8_t *page = readMap[address >> 8];
+        return page ? page + (address & 0xFF) : nullptr;
+    }
+
+    /**
+     * @brief Returns the number of the ROM bank mapped at 4000-7FFF.
+     */
+    uint16_t romBank() const { return cartridge.highBank(); }
+
+    /**
+     * @brief Maps a boot ROM over the cartridge until FF50 is written.
+     * 
+     * A DMG boot ROM (256 bytes) covers 0000-00FF. A CGB one (2304 bytes)
+     * also covers 0200-08FF, leaving the cartridge header in between
+     * visible. Boot ROM pages cannot be written.
+     * 
+     * @param image The boot ROM, shared with forks of this memory.
+     * @return False, mapping nothing, if the image has neither size.
+     */
+    bool mapBootRom(Cartridge::Image image);
+
+    /**
+     * @brief Unmaps the boot ROM, as a write to FF50 does: its pages are
+     * pointed back at the cartridge.
+     */
+    void unmapBootRom();
+
+    bool isBootRomMapped() const { return bootRom != nullptr; }
+
+    /**
+     * @brief Writes a byte as a device would, with no side effects and
+     * without being counted as a bus access. A loaded ROM and disabled
+     * cartridge RAM are left unchanged.
+     * 
+     * @param address The address to write to.
+     * @param value The byte value to store.
+     */
+    void poke(uint16_t address, uint8_t value) {
+        if (uint8_t *page = writeMap[address >> 8]) {
+            page[address & 0xFF] = value;
+        } else if (isIO(address)) {
+            io.registers[address & 0x7F] = value;
+        } else if (address >= 0xFE00) {
+            high[address - 0xFE00] = value;
+        } else if (uint8_t *storage = unsharePage(address)) {
+            *storage = value;
+        }
+    }
+
+    /**
+     * @brief Copies a block as a DMA controller would, with no side effects
+     * and without being counted as bus accesses.
+     * 
+     * Runs of plain storage are copied with memcpy, one page at a time;
+     * I/O registers are copied a byte at a time.
+     * 
+     * @param destination The first address written.
+     * @param source The first address read.
+     * @param length The number of bytes to copy.
+     */
+    void transfer(uint16_t destination, uint16_t source, uint16_t length);
+
+    /**
+     * @brief Locks the CPU out of everything below FF00 while an OAM DMA
+     * runs: reads return 0xFF and writes are ignored.
+     * 
+     * Locking swaps the CPU's page table for an empty one, so the unlocked
+     * fast path carries no extra check.
+     * 
+     * @param locked Whether a DMA is in progress.
+     */
+    void lockBus(bool locked);
+
+    /**
+     * @brief Whether an OAM DMA currently holds the bus.
+     */
+    bool isBusLocked() const { return busLocked; }
+
+    /**
+     * @brief Reports the CPU's reads and writes of whole pages to a
+     * watcher.
+     * 
+     * Trapped pages are left out of the CPU's page table, like the bus
+     * lock above, so only their accesses take the slow path; all others
+     * cost what they did. DMA, peek() and poke() are not reported. Traps
+     * belong to this memory and are not copied by assignment or fork().
+     * 
+     * @param watcher Receives the accesses; null removes every trap.
+     * @param reads Pages (address >> 8) whose reads are reported.
+     * @param writes Pages whose writes are reported.
+     */
+    void setTraps(MemoryWatcher *watcher, const std::bitset<0x100> &reads,
+                  const std::bitset<0x100> &writes);
+
+    /**
+     * @brief Sets the pressed joypad buttons (see joypad.hpp).
+     * 
+     * Requests the joypad interrupt if a newly pressed button is in a group
+     * currently selected through P1.
+     * 
+     * @param buttons The pressed buttons; 1 bits are pressed.
+     */
+    void setButtons(uint8_t buttons);
+
+    /**
+     * @brief Returns the pressed joypad buttons.
+     */
+    uint8_t getButtons() const { return io.getButtons(); }
+
+    /**
+     * @brief Hashes the full contents of memory.
+     * 
+     * @return A host-independent FNV-1a hash of all storage, the cartridge
+     * and the bank selection.
+     */
+    uint64_t hash() const;
+
+    /**
+     * @brief Saves the cartridge state, RAM, bank mapping and I/O
+     * registers.
+     */
+    void saveState(StateWriter &out) const;
+
+    /**
+     * @brief Restores saved state over a memory holding the same ROM.
+     * Shared pages are replaced rather than written; pages of zeros are
+     * not allocated.
+     * 
+     * @return False, setting `error`, if the state is for a different
+     * cartridge, is truncated or holds impossible values. The memory is
+     * then left mapped but partly loaded.
+     */
+    bool loadState(StateReader &in, std::string &error);
+
+    /**
+     * @brief Performance counters for this machine (empty unless built with
+     * GB_INSTRUMENTATION).
+     */
+    [[no_unique_address]] Counters counters;
+
+    /**
+     * @brief The I/O registers (FF00-FF7F).
+     */
+    IO io;
+
+    /**
+     * @brief Brings the machine's devices up to the attached clock.
+     * 
+     * Devices are otherwise only updated between instructions. The
+     * accurate tier calls this before each access to OAM and above, or
+     * to anything while DMA holds the bus, so that the access sees every
+     * event due by its M-cycle ("catch-up" scheduling). Not copied.
+     */
+    std::function<void()> catchUp;
+
 private:
     /**
-     * @brief The memory array representing the Game Boy's memory.
+     * @brief Whether an address is in the I/O register block.
+     */
+    static bool isIO(uint16_t address) { return (address & 0xFF80) == 0xFF00; }
+
+    using PageTable = std::array<uint8_t *, 0x100>;
+    using ReadPageTable = std::array<const uint8_t *, 0x100>;
+
+    /**
+     * @brief Points every page at this object's storage.
+     */
+    void mapPages();
+    void mapCartridge();
+    void mapRange(uint16_t start, uint32_t end, const uint8_t *read,
+                  uint8_t *write);
+
+    struct Sharing {};
+    Memory(const Memory &other, Sharing);
+    void share(const Memory &other);
+    void unpinShared(const Memory &other);
+    void unshare();
+    uint8_t *unsharePage(uint16_t address);
+    const uint8_t *readableAt(uint16_t address) const;
+    uint8_t *writableAt(uint16_t address);
+    uint8_t readSlow(uint16_t address);
+    uint8_t readUnmapped(uint16_t address);
+    void writeSlow(uint16_t address, uint8_t value);
+    void applyTraps();
+
+    /**
+     * @brief Whether an access reaches a device register, or the DMA lock.
+     */
+    bool reachesDevice(uint16_t address) const {
+        return address >= 0xFE00 || busLocked;
+    }
+
+    Cartridge cartridge;
+
+    /**
+     * @brief Video RAM: two 8 KB banks.
+     */
+    std::array<SharedPage<0x2000>, 2> vram;
+
+    /**
+     * @brief Work RAM: eight 4 KB banks; bank 0 is fixed at C000.
+     */
+    std::array<SharedPage<0x1000>, 8> wram;
+
+    /**
+     * @brief Work RAM banks handed out by workRam(), one bit per bank.
+     * Their storage is never shared or replaced.
+     */
+    uint8_t pinnedWram = 0;
+
+    /**
+     * @brief FE00-FFFF: OAM, the unusable area, HRAM and IE. The I/O
+     * registers in between live in `io`.
+     */
+    std::array<uint8_t, 0x200> high{};
+
+    uint8_t vramBank = 0;
+    uint8_t wramBank = 1;
+    bool cgb = false;
+
+    /**
+     * @brief The boot ROM while it is mapped, otherwise null.
+     */
+    Cartridge::Image bootRom;
+
+    /**
+     * @brief The memory map: one pointer per 256-byte page, or null for
+     * pages that need the slow path.
+     */
+    ReadPageTable readMap{};
+    PageTable writeMap{};
+
+    /**
+     * @brief The CPU's view of the map: the maps above, or all null while
+     * the bus is locked by DMA.
+     */
+    ReadPageTable readPages{};
+    PageTable writePages{};
+
+    bool busLocked = false;
+
+    /**
+     * @brief Pages left out of the CPU's view so that their accesses reach
+     * `watcher`.
+     */
+    MemoryWatcher *watcher = nullptr;
+    std::bitset<0x100> readTraps;
+    std::bitset<0x100> writeTraps;
+
+    /**
+     * @brief Where this memory's pages are allocated. Forks inherit it;
+     * assignment keeps this memory's own.
+     */
+    PageResource resource;
+
+    /**
+     * @brief Serializes forks of this memory, which remap its pages.
      */
-    std::array<uint8_t, 0x10000> memory{};
+    std::mutex forkMutex;
 };
@@ -0,0 +1,103 @@
+/**
+ * @file movie.hpp
+ * @brief Input movies: per-frame joypad recordings that replay bit-exactly.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gameboy.hpp"
+
+/**
+ * @struct Checkpoint
+ * @brief The expected framebuffer hash after a given frame has run.
+ */
+struct Checkpoint {
+  uint32_t frame = 0;
+  uint64_t framebufferHash = 0;
+};
+
+/**
+ * @struct Movie
+ * @brief A recorded run: the starting state, the joypad state for every
+ * frame, and framebuffer hashes to verify along the way.
+ *
+ * On disk a movie is the magic "GBMV", a version, the initial state hash,
+ * the frame and checkpoint counts, one button byte per frame and then the
+ * checkpoints. All integers are little endian.
+ */
+struct Movie {
+  static constexpr uint32_t kVersion = 1;
+
+  uint64_t initialStateHash = 0;
+  std::vector<uint8_t> inputs;
+  std::vector<Checkpoint> checkpoints;
+
+  /**
+   * @brief Writes the movie to a file.
+   *
+   * @return True on success.
+   */
+  bool save(const std::string &path) const;
+
+  /**
+   * @brief Reads a movie from a file.
+   *
+   * @return True if the file was a complete movie of a known version.
+   */
+  bool load(const std::string &path);
+};
+
+/**
+ * @class MovieRecorder
+ * @brief Runs a machine frame by frame, recording the input it is given.
+ */
+class MovieRecorder {
+ public:
+  /**
+   * @brief Starts a movie from the machine's current state.
+   *
+   * @param gameboy The machine to run.
+   * @param checkpointInterval Frames between framebuffer checkpoints; 0
+   * records none.
+   */
+  MovieRecorder(GameBoy &gameboy, uint32_t checkpointInterval);
+
+  /**
+   * @brief Applies the buttons, runs one frame and records both.
+   */
+  void runFrame(uint8_t buttons);
+
+  const Movie &getMovie() const { return movie; }
+
+ private:
+  GameBoy &gameboy;
+  uint32_t checkpointInterval;
+  Movie movie;
+};
+
+/**
+ * @struct ReplayResult
+ * @brief The outcome of playing a movie back.
+ */
+struct ReplayResult {
+  bool ok = false;
+  uint32_t framesPlayed = 0;
+  uint32_t checkpointsVerified = 0;
+  std::string error;
+};
+
+/**
+ * @brief Plays a movie back on a machine, verifying the initial state hash
+ * and every checkpoint.
+ *
+ * Stops at the first mismatch.
+ *
+ * @param gameboy The machine, in the state the movie was recorded from.
+ * @param movie The movie to play.
+ * @return Whether the run reproduced the recording, and how far it got.
+ */
+ReplayResult playMovie(GameBoy &gameboy, const Movie &movie);
@@ -0,0 +1,309 @@
+/**
+ * @file opcodes.hpp
+ * @brief SM83 opcode metadata shared by the CPU dispatch and the
+ * disassembler.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief How an instruction affects control flow.
+ */
+enum class Flow : uint8_t {
+  Next,          ///< Falls through to the next instruction.
+  Jump,          ///< Always jumps to its target (JP n16, JR e8).
+  Branch,        ///< Jumps to its target or falls through (JP/JR cc).
+  Call,          ///< Calls its target and returns after (CALL, RST).
+  Return,        ///< Returns (RET, RETI).
+  ReturnIf,      ///< Returns or falls through (RET cc).
+  JumpIndirect,  ///< Jumps to a computed address (JP HL).
+  Invalid,       ///< Locks up the CPU.
+};
+
+/**
+ * @struct OpcodeInfo
+ * @brief Everything static about one primary opcode.
+ *
+ * Mnemonics use n8/n16 for immediates, a8 for a high-page address and e8
+ * for a signed offset, which the disassembler substitutes.
+ */
+struct OpcodeInfo {
+  const char *handler;   ///< CPU handler naming, e.g. "LD_r16_n16".
+  const char *mnemonic;  ///< e.g. "LD BC,n16".
+  uint8_t length;        ///< Bytes including the opcode.
+  uint8_t cycles;        ///< T-cycles; not taken, for conditionals.
+  uint8_t takenCycles;   ///< T-cycles when a conditional is taken, else 0.
+  Flow flow;
+};
+
+/**
+ * @brief Metadata of every primary opcode. 0xCB is the prefix of a second
+ * table, decoded by the disassembler.
+ */
+inline constexpr std::array<OpcodeInfo, 256> kOpcodes = {{
+    {"NOP", "NOP", 1, 4, 0, Flow::Next},                          // 0x00
+    {"LD_r16_n16", "LD BC,n16", 3, 12, 0, Flow::Next},            // 0x01
+    {"LD_r16_A", "LD (BC),A", 1, 8, 0, Flow::Next},               // 0x02
+    {"INC_r16", "INC BC", 1, 8, 0, Flow::Next},                   // 0x03
+    {"INC_r8", "INC B", 1, 4, 0, Flow::Next},                     // 0x04
+    {"DEC_r8", "DEC B", 1, 4, 0, Flow::Next},                     // 0x05
+    {"LD_r8_n8", "LD B,n8", 2, 8, 0, Flow::Next},                 // 0x06
+    {"RLCA", "RLCA", 1, 4, 0, Flow::Next},                        // 0x07
+    {"LD_n16_SP", "LD (n16),SP", 3, 20, 0, Flow::Next},           // 0x08
+    {"ADD_HL_r16", "ADD HL,BC", 1, 8, 0, Flow::Next},             // 0x09
+    {"LD_A_r16", "LD A,(BC)", 1, 8, 0, Flow::Next},               // 0x0A
+    {"DEC_r16", "DEC BC", 1, 8, 0, Flow::Next},                   // 0x0B
+    {"INC_r8", "INC C", 1, 4, 0, Flow::Next},                     // 0x0C
+    {"DEC_r8", "DEC C", 1, 4, 0, Flow::Next},                     // 0x0D
+    {"LD_r8_n8", "LD C,n8", 2, 8, 0, Flow::Next},                 // 0x0E
+    {"RRCA", "RRCA", 1, 4, 0, Flow::Next},                        // 0x0F
+    {"STOP", "STOP", 2, 4, 0, Flow::Next},                        // 0x10
+    {"LD_r16_n16", "LD DE,n16", 3, 12, 0, Flow::Next},            // 0x11
+    {"LD_r16_A", "LD (DE),A", 1, 8, 0, Flow::Next},               // 0x12
+    {"INC_r16", "INC DE", 1, 8, 0, Flow::Next},                   // 0x13
+    {"INC_r8", "INC D", 1, 4, 0, Flow::Next},                     // 0x14
+    {"DEC_r8", "DEC D", 1, 4, 0, Flow::Next},                     // 0x15
+    {"LD_r8_n8", "LD D,n8", 2, 8, 0, Flow::Next},                 // 0x16
+    {"RLA", "RLA", 1, 4, 0, Flow::Next},                          // 0x17
+    {"JR_n8", "JR e8", 2, 12, 0, Flow::Jump},                     // 0x18
+    {"ADD_HL_r16", "ADD HL,DE", 1, 8, 0, Flow::Next},             // 0x19
+    {"LD_A_r16", "LD A,(DE)", 1, 8, 0, Flow::Next},               // 0x1A
+    {"DEC_r16", "DEC DE", 1, 8, 0, Flow::Next},                   // 0x1B
+    {"INC_r8", "INC E", 1, 4, 0, Flow::Next},                     // 0x1C
+    {"DEC_r8", "DEC E", 1, 4, 0, Flow::Next},                     // 0x1D
+    {"LD_r8_n8", "LD E,n8", 2, 8, 0, Flow::Next},                 // 0x1E
+    {"RRA", "RRA", 1, 4, 0, Flow::Next},                          // 0x1F
+    {"JR_con_n8", "JR NZ,e8", 2, 8, 12, Flow::Branch},            // 0x20
+    {"LD_r16_n16", "LD HL,n16", 3, 12, 0, Flow::Next},            // 0x21
+    {"LD_HLI_A", "LD (HL+),A", 1, 8, 0, Flow::Next},              // 0x22
+    {"INC_r16", "INC HL", 1, 8, 0, Flow::Next},                   // 0x23
+    {"INC_r8", "INC H", 1, 4, 0, Flow::Next},                     // 0x24
+    {"DEC_r8", "DEC H", 1, 4, 0, Flow::Next},                     // 0x25
+    {"LD_r8_n8", "LD H,n8", 2, 8, 0, Flow::Next},                 // 0x26
+    {"DAA", "DAA", 1, 4, 0, Flow::Next},                          // 0x27
+    {"JR_con_n8", "JR Z,e8", 2, 8, 12, Flow::Branch},             // 0x28
+    {"ADD_HL_r16", "ADD HL,HL", 1, 8, 0, Flow::Next},             // 0x29
+    {"LD_A_HLI", "LD A,(HL+)", 1, 8, 0, Flow::Next},              // 0x2A
+    {"DEC_r16", "DEC HL", 1, 8, 0, Flow::Next},                   // 0x2B
+    {"INC_r8", "INC L", 1, 4, 0, Flow::Next},                     // 0x2C
+    {"DEC_r8", "DEC L", 1, 4, 0, Flow::Next},                     // 0x2D
+    {"LD_r8_n8", "LD L,n8", 2, 8, 0, Flow::Next},                 // 0x2E
+    {"CPL", "CPL", 1, 4, 0, Flow::Next},                          // 0x2F
+    {"JR_con_n8", "JR NC,e8", 2, 8, 12, Flow::Branch},            // 0x30
+    {"LD_r16_n16", "LD SP,n16", 3, 12, 0, Flow::Next},            // 0x31
+    {"LD_HLD_A", "LD (HL-),A", 1, 8, 0, Flow::Next},              // 0x32
+    {"INC_r16", "INC SP", 1, 8, 0, Flow::Next},                   // 0x33
+    {"INC_HL", "INC (HL)", 1, 12, 0, Flow::Next},                 // 0x34
+    {"DEC_HL", "DEC (HL)", 1, 12, 0, Flow::Next},                 // 0x35
+    {"LD_r16_n8", "LD (HL),n8", 2, 12, 0, Flow::Next},            // 0x36
+    {"SCF", "SCF", 1, 4, 0, Flow::Next},                          // 0x37
+    {"JR_con_n8", "JR C,e8", 2, 8, 12, Flow::Branch},             // 0x38
+    {"ADD_HL_r16", "ADD HL,SP", 1, 8, 0, Flow::Next},             // 0x39
+    {"LD_A_HLD", "LD A,(HL-)", 1, 8, 0, Flow::Next},              // 0x3A
+    {"DEC_r16", "DEC SP", 1, 8, 0, Flow::Next},                   // 0x3B
+    {"INC_r8", "INC A", 1, 4, 0, Flow::Next},                     // 0x3C
+    {"DEC_r8", "DEC A", 1, 4, 0, Flow::Next},                     // 0x3D
+    {"LD_r8_n8", "LD A,n8", 2, 8, 0, Flow::Next},                 // 0x3E
+    {"CCF", "CCF", 1, 4, 0, Flow::Next},                          // 0x3F
+    {"LD_r8_r8", "LD B,B", 1, 4, 0, Flow::Next},                  // 0x40
+    {"LD_r8_r8", "LD B,C", 1, 4, 0, Flow::Next},                  // 0x41
+    {"LD_r8_r8", "LD B,D", 1, 4, 0, Flow::Next},                  // 0x42
+    {"LD_r8_r8", "LD B,E", 1, 4, 0, Flow::Next},                  // 0x43
+    {"LD_r8_r8", "LD B,H", 1, 4, 0, Flow::Next},                  // 0x44
+    {"LD_r8_r8", "LD B,L", 1, 4, 0, Flow::Next},                  // 0x45
+    {"LD_r8_r16", "LD B,(HL)", 1, 8, 0, Flow::Next},              // 0x46
+    {"LD_r8_r8", "LD B,A", 1, 4, 0, Flow::Next},                  // 0x47
+    {"LD_r8_r8", "LD C,B", 1, 4, 0, Flow::Next},                  // 0x48
+    {"LD_r8_r8", "LD C,C", 1, 4, 0, Flow::Next},                  // 0x49
+    {"LD_r8_r8", "LD C,D", 1, 4, 0, Flow::Next},                  // 0x4A
+    {"LD_r8_r8", "LD C,E", 1, 4, 0, Flow::Next},                  // 0x4B
+    {"LD_r8_r8", "LD C,H", 1, 4, 0, Flow::Next},                  // 0x4C
+    {"LD_r8_r8", "LD C,L", 1, 4, 0, Flow::Next},                  // 0x4D
+    {"LD_r8_r16", "LD C,(HL)", 1, 8, 0, Flow::Next},              // 0x4E
+    {"LD_r8_r8", "LD C,A", 1, 4, 0, Flow::Next},                  // 0x4F
+    {"LD_r8_r8", "LD D,B", 1, 4, 0, Flow::Next},                  // 0x50
+    {"LD_r8_r8", "LD D,C", 1, 4, 0, Flow::Next},                  // 0x51
+    {"LD_r8_r8", "LD D,D", 1, 4, 0, Flow::Next},                  // 0x52
+    {"LD_r8_r8", "LD D,E", 1, 4, 0, Flow::Next},                  // 0x53
+    {"LD_r8_r8", "LD D,H", 1, 4, 0, Flow::Next},                  // 0x54
+    {"LD_r8_r8", "LD D,L", 1, 4, 0, Flow::Next},                  // 0x55
+    {"LD_r8_r16", "LD D,(HL)", 1, 8, 0, Flow::Next},              // 0x56
+    {"LD_r8_r8", "LD D,A", 1, 4, 0, Flow::Next},                  // 0x57
+    {"LD_r8_r8", "LD E,B", 1, 4, 0, Flow::Next},                  // 0x58
+    {"LD_r8_r8", "LD E,C", 1, 4, 0, Flow::Next},                  // 0x59
+    {"LD_r8_r8", "LD E,D", 1, 4, 0, Flow::Next},                  // 0x5A
+    {"LD_r8_r8", "LD E,E", 1, 4, 0, Flow::Next},                  // 0x5B
+    {"LD_r8_r8", "LD E,H", 1, 4, 0, Flow::Next},                  // 0x5C
+    {"LD_r8_r8", "LD E,L", 1, 4, 0, Flow::Next},                  // 0x5D
+    {"LD_r8_r16", "LD E,(HL)", 1, 8, 0, Flow::Next},              // 0x5E
+    {"LD_r8_r8", "LD E,A", 1, 4, 0, Flow::Next},                  // 0x5F
+    {"LD_r8_r8", "LD H,B", 1, 4, 0, Flow::Next},                  // 0x60
+    {"LD_r8_r8", "LD H,C", 1, 4, 0, Flow::Next},                  // 0x61
+    {"LD_r8_r8", "LD H,D", 1, 4, 0, Flow::Next},                  // 0x62
+    {"LD_r8_r8", "LD H,E", 1, 4, 0, Flow::Next},                  // 0x63
+    {"LD_r8_r8", "LD H,H", 1, 4, 0, Flow::Next},                  // 0x64
+    {"LD_r8_r8", "LD H,L", 1, 4, 0, Flow::Next},                  // 0x65
+    {"LD_r8_r16", "LD H,(HL)", 1, 8, 0, Flow::Next},              // 0x66
+    {"LD_r8_r8", "LD H,A", 1, 4, 0, Flow::Next},                  // 0x67
+    {"LD_r8_r8", "LD L,B", 1, 4, 0, Flow::Next},                  // 0x68
+    {"LD_r8_r8", "LD L,C", 1, 4, 0, Flow::Next},                  // 0x69
+    {"LD_r8_r8", "LD L,D", 1, 4, 0, Flow::Next},                  // 0x6A
+    {"LD_r8_r8", "LD L,E", 1, 4, 0, Flow::Next},                  // 0x6B
+    {"LD_r8_r8", "LD L,H", 1, 4, 0, Flow::Next},                  // 0x6C
+    {"LD_r8_r8", "LD L,L", 1, 4, 0, Flow::Next},                  // 0x6D
+    {"LD_r8_r16", "LD L,(HL)", 1, 8, 0, Flow::Next},              // 0x6E
+    {"LD_r8_r8", "LD L,A", 1, 4, 0, Flow::Next},                  // 0x6F
+    {"LD_r16_r8", "LD (HL),B", 1, 8, 0, Flow::Next},              // 0x70
+    {"LD_r16_r8", "LD (HL),C", 1, 8, 0, Flow::Next},              // 0x71
+    {"LD_r16_r8", "LD (HL),D", 1, 8, 0, Flow::Next},              // 0x72
+    {"LD_r16_r8", "LD (HL),E", 1, 8, 0, Flow::Next},              // 0x73
+    {"LD_r16_r8", "LD (HL),H", 1, 8, 0, Flow::Next},              // 0x74
+    {"LD_r16_r8", "LD (HL),L", 1, 8, 0, Flow::Next},              // 0x75
+    {"HALT", "HALT", 1, 4, 0, Flow::Next},                        // 0x76
+    {"LD_r16_r8", "LD (HL),A", 1, 8, 0, Flow::Next},              // 0x77
+    {"LD_r8_r8", "LD A,B", 1, 4, 0, Flow::Next},                  // 0x78
+    {"LD_r8_r8", "LD A,C", 1, 4, 0, Flow::Next},                  // 0x79
+    {"LD_r8_r8", "LD A,D", 1, 4, 0, Flow::Next},                  // 0x7A
+    {"LD_r8_r8", "LD A,E", 1, 4, 0, Flow::Next},                  // 0x7B
+    {"LD_r8_r8", "LD A,H", 1, 4, 0, Flow::Next},                  // 0x7C
+    {"LD_r8_r8", "LD A,L", 1, 4, 0, Flow::Next},                  // 0x7D
+    {"LD_r8_r16", "LD A,(HL)", 1, 8, 0, Flow::Next},              // 0x7E
+    {"LD_r8_r8", "LD A,A", 1, 4, 0, Flow::Next},                  // 0x7F
+    {"ADD_A_r8", "ADD A,B", 1, 4, 0, Flow::Next},                 // 0x80
+    {"ADD_A_r8", "ADD A,C", 1, 4, 0, Flow::Next},                 // 0x81
+    {"ADD_A_r8", "ADD A,D", 1, 4, 0, Flow::Next},                 // 0x82
+    {"ADD_A_r8", "ADD A,E", 1, 4, 0, Flow::Next},                 // 0x83
+    {"ADD_A_r8", "ADD A,H", 1, 4, 0, Flow::Next},                 // 0x84
+    {"ADD_A_r8", "ADD A,L", 1, 4, 0, Flow::Next},                 // 0x85
+    {"ADD_A_r16", "ADD A,(HL)", 1, 8, 0, Flow::Next},             // 0x86
+    {"ADD_A_r8", "ADD A,A", 1, 4, 0, Flow::Next},                 // 0x87
+    {"ADC_A_r8", "ADC A,B", 1, 4, 0, Flow::Next},                 // 0x88
+    {"ADC_A_r8", "ADC A,C", 1, 4, 0, Flow::Next},                 // 0x89
+    {"ADC_A_r8", "ADC A,D", 1, 4, 0, Flow::Next},                 // 0x8A
+    {"ADC_A_r8", "ADC A,E", 1, 4, 0, Flow::Next},                 // 0x8B
+    {"ADC_A_r8", "ADC A,H", 1, 4, 0, Flow::Next},                 // 0x8C
+    {"ADC_A_r8", "ADC A,L", 1, 4, 0, Flow::Next},                 // 0x8D
+    {"ADC_A_r16", "ADC A,(HL)", 1, 8, 0, Flow::Next},             // 0x8E
+    {"ADC_A_r8", "ADC A,A", 1, 4, 0, Flow::Next},                 // 0x8F
+    {"SUB_A_r8", "SUB A,B", 1, 4, 0, Flow::Next},                 // 0x90
+    {"SUB_A_r8", "SUB A,C", 1, 4, 0, Flow::Next},                 // 0x91
+    {"SUB_A_r8", "SUB A,D", 1, 4, 0, Flow::Next},                 // 0x92
+    {"SUB_A_r8", "SUB A,E", 1, 4, 0, Flow::Next},                 // 0x93
+    {"SUB_A_r8", "SUB A,H", 1, 4, 0, Flow::Next},                 // 0x94
+    {"SUB_A_r8", "SUB A,L", 1, 4, 0, Flow::Next},                 // 0x95
+    {"SUB_A_r16", "SUB A,(HL)", 1, 8, 0, Flow::Next},             // 0x96
+    {"SUB_A_r8", "SUB A,A", 1, 4, 0, Flow::Next},                 // 0x97
+    {"SBC_A_r8", "SBC A,B", 1, 4, 0, Flow::Next},                 // 0x98
+    {"SBC_A_r8", "SBC A,C", 1, 4, 0, Flow::Next},                 // 0x99
+    {"SBC_A_r8", "SBC A,D", 1, 4, 0, Flow::Next},                 // 0x9A
+    {"SBC_A_r8", "SBC A,E", 1, 4, 0, Flow::Next},                 // 0x9B
+    {"SBC_A_r8", "SBC A,H", 1, 4, 0, Flow::Next},                 // 0x9C
+    {"SBC_A_r8", "SBC A,L", 1, 4, 0, Flow::Next},                 // 0x9D
+    {"SBC_A_r16", "SBC A,(HL)", 1, 8, 0, Flow::Next},             // 0x9E
+    {"SBC_A_r8", "SBC A,A", 1, 4, 0, Flow::Next},                 // 0x9F
+    {"AND_A_r8", "AND A,B", 1, 4, 0, Flow::Next},                 // 0xA0
+    {"AND_A_r8", "AND A,C", 1, 4, 0, Flow::Next},                 // 0xA1
+    {"AND_A_r8", "AND A,D", 1, 4, 0, Flow::Next},                 // 0xA2
+    {"AND_A_r8", "AND A,E", 1, 4, 0, Flow::Next},                 // 0xA3
+    {"AND_A_r8", "AND A,H", 1, 4, 0, Flow::Next},                 // 0xA4
+    {"AND_A_r8", "AND A,L", 1, 4, 0, Flow::Next},                 // 0xA5
+    {"AND_A_r16", "AND A,(HL)", 1, 8, 0, Flow::Next},             // 0xA6
+    {"AND_A_r8", "AND A,A", 1, 4, 0, Flow::Next},                 // 0xA7
+    {"XOR_A_r8", "XOR A,B", 1, 4, 0, Flow::Next},                 // 0xA8
+    {"XOR_A_r8", "XOR A,C", 1, 4, 0, Flow::Next},                 // 0xA9
+    {"XOR_A_r8", "XOR A,D", 1, 4, 0, Flow::Next},                 // 0xAA
+    {"XOR_A_r8", "XOR A,E", 1, 4, 0, Flow::Next},                 // 0xAB
+    {"XOR_A_r8", "XOR A,H", 1, 4, 0, Flow::Next},                 // 0xAC
+    {"XOR_A_r8", "XOR A,L", 1, 4, 0, Flow::Next},                 // 0xAD
+    {"XOR_A_r16", "XOR A,(HL)", 1, 8, 0, Flow::Next},             // 0xAE
+    {"XOR_A_r8", "XOR A,A", 1, 4, 0, Flow::Next},                 // 0xAF
+    {"OR_A_r8", "OR A,B", 1, 4, 0, Flow::Next},                   // 0xB0
+    {"OR_A_r8", "OR A,C", 1, 4, 0, Flow::Next},                   // 0xB1
+    {"OR_A_r8", "OR A,D", 1, 4, 0, Flow::Next},                   // 0xB2
+    {"OR_A_r8", "OR A,E", 1, 4, 0, Flow::Next},                   // 0xB3
+    {"OR_A_r8", "OR A,H", 1, 4, 0, Flow::Next},                   // 0xB4
+    {"OR_A_r8", "OR A,L", 1, 4, 0, Flow::Next},                   // 0xB5
+    {"OR_A_r16", "OR A,(HL)", 1, 8, 0, Flow::Next},               // 0xB6
+    {"OR_A_r8", "OR A,A", 1, 4, 0, Flow::Next},                   // 0xB7
+    {"CP_A_r8", "CP A,B", 1, 4, 0, Flow::Next},                   // 0xB8
+    {"CP_A_r8", "CP A,C", 1, 4, 0, Flow::Next},                   // 0xB9
+    {"CP_A_r8", "CP A,D", 1, 4, 0, Flow::Next},                   // 0xBA
+    {"CP_A_r8", "CP A,E", 1, 4, 0, Flow::Next},                   // 0xBB
+    {"CP_A_r8", "CP A,H", 1, 4, 0, Flow::Next},                   // 0xBC
+    {"CP_A_r8", "CP A,L", 1, 4, 0, Flow::Next},                   // 0xBD
+    {"CP_A_r16", "CP A,(HL)", 1, 8, 0, Flow::Next},               // 0xBE
+    {"CP_A_r8", "CP A,A", 1, 4, 0, Flow::Next},                   // 0xBF
+    {"RET_con", "RET NZ", 1, 8, 20, Flow::ReturnIf},              // 0xC0
+    {"POP_r16", "POP BC", 1, 12, 0, Flow::Next},                  // 0xC1
+    {"JP_con_n16", "JP NZ,n16", 3, 12, 16, Flow::Branch},         // 0xC2
+    {"JP_n16", "JP n16", 3, 16, 0, Flow::Jump},                   // 0xC3
+    {"CALL_con_n16", "CALL NZ,n16", 3, 12, 24, Flow::Call},       // 0xC4
+    {"PUSH_r16", "PUSH BC", 1, 16, 0, Flow::Next},                // 0xC5
+    {"ADD_A_n8", "ADD A,n8", 2, 8, 0, Flow::Next},                // 0xC6
+    {"RST", "RST $00", 1, 16, 0, Flow::Call},                     // 0xC7
+    {"RET_con", "RET Z", 1, 8, 20, Flow::ReturnIf},               // 0xC8
+    {"RET", "RET", 1, 16, 0, Flow::Return},                       // 0xC9
+    {"JP_con_n16", "JP Z,n16", 3, 12, 16, Flow::Branch},          // 0xCA
+    {"PREFIX", "PREFIX", 2, 4, 0, Flow::Next},                    // 0xCB
+    {"CALL_con_n16", "CALL Z,n16", 3, 12, 24, Flow::Call},        // 0xCC
+    {"CALL_n16", "CALL n16", 3, 24, 0, Flow::Call},               // 0xCD
+    {"ADC_A_n8", "ADC A,n8", 2, 8, 0, Flow::Next},                // 0xCE
+    {"RST", "RST $08", 1, 16, 0, Flow::Call},                     // 0xCF
+    {"RET_con", "RET NC", 1, 8, 20, Flow::ReturnIf},              // 0xD0
+    {"POP_r16", "POP DE", 1, 12, 0, Flow::Next},                  // 0xD1
+    {"JP_con_n16", "JP NC,n16", 3, 12, 16, Flow::Branch},         // 0xD2
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xD3
+    {"CALL_con_n16", "CALL NC,n16", 3, 12, 24, Flow::Call},       // 0xD4
+    {"PUSH_r16", "PUSH DE", 1, 16, 0, Flow::Next},                // 0xD5
+    {"SUB_A_n8", "SUB A,n8", 2, 8, 0, Flow::Next},                // 0xD6
+    {"RST", "RST $10", 1, 16, 0, Flow::Call},                     // 0xD7
+    {"RET_con", "RET C", 1, 8, 20, Flow::ReturnIf},               // 0xD8
+    {"RETI", "RETI", 1, 16, 0, Flow::Return},                     // 0xD9
+    {"JP_con_n16", "JP C,n16", 3, 12, 16, Flow::Branch},          // 0xDA
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xDB
+    {"CALL_con_n16", "CALL C,n16", 3, 12, 24, Flow::Call},        // 0xDC
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xDD
+    {"SBC_A_n8", "SBC A,n8", 2, 8, 0, Flow::Next},                // 0xDE
+    {"RST", "RST $18", 1, 16, 0, Flow::Call},                     // 0xDF
+    {"LDH_n8_A", "LDH (a8),A", 2, 12, 0, Flow::Next},             // 0xE0
+    {"POP_r16", "POP HL", 1, 12, 0, Flow::Next},                  // 0xE1
+    {"LDH_C_A", "LDH (C),A", 1, 8, 0, Flow::Next},                // 0xE2
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xE3
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xE4
+    {"PUSH_r16", "PUSH HL", 1, 16, 0, Flow::Next},                // 0xE5
+    {"AND_A_n8", "AND A,n8", 2, 8, 0, Flow::Next},                // 0xE6
+    {"RST", "RST $20", 1, 16, 0, Flow::Call},                     // 0xE7
+    {"ADD_SP_n8", "ADD SP,e8", 2, 16, 0, Flow::Next},             // 0xE8
+    {"JP_HL", "JP HL", 1, 4, 0, Flow::JumpIndirect},              // 0xE9
+    {"LD_n16_A", "LD (n16),A", 3, 16, 0, Flow::Next},             // 0xEA
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xEB
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xEC
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xED
+    {"XOR_A_n8", "XOR A,n8", 2, 8, 0, Flow::Next},                // 0xEE
+    {"RST", "RST $28", 1, 16, 0, Flow::Call},                     // 0xEF
+    {"LDH_A_n8", "LDH A,(a8)", 2, 12, 0, Flow::Next},             // 0xF0
+    {"POP_r16", "POP AF", 1, 12, 0, Flow::Next},                  // 0xF1
+    {"LDH_A_r8", "LDH A,(C)", 1, 8, 0, Flow::Next},               // 0xF2
+    {"DI", "DI", 1, 4, 0, Flow::Next},                            // 0xF3
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xF4
+    {"PUSH_r16", "PUSH AF", 1, 16, 0, Flow::Next},                // 0xF5
+    {"OR_A_n8", "OR A,n8", 2, 8, 0, Flow::Next},                  // 0xF6
+    {"RST", "RST $30", 1, 16, 0, Flow::Call},                     // 0xF7
+    {"LD_HL_SP_n8", "LD HL,SP+e8", 2, 12, 0, Flow::Next},         // 0xF8
+    {"LD_SP_HL", "LD SP,HL", 1, 8, 0, Flow::Next},                // 0xF9
+    {"LD_A_n16", "LD A,(n16)", 3, 16, 0, Flow::Next},             // 0xFA
+    {"EI", "EI", 1, 4, 0, Flow::Next},                            // 0xFB
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xFC
+    {"INVALID", "INVALID", 1, 4, 0, Flow::Invalid},               // 0xFD
+    {"CP_A_n8", "CP A,n8", 2, 8, 0, Flow::Next},                  // 0xFE
+    {"RST", "RST $38", 1, 16, 0, Flow::Call},                     // 0xFF
+}};
+
+/**
+ * @brief Whether an instruction with this flow ends a basic block: any
+ * possible transfer of control, calls included.
+ */
+constexpr bool endsBlock(Flow flow) { return flow != Flow::Next; }
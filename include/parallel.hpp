@@ -0,0 +1,46 @@
+/**
+ * @file parallel.hpp
+ * @brief Defines parallelFor: runs independent jobs on a pool of threads.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Calls `job(i)` for every i below `count`, on up to `threads`
+ * threads including the caller's.
+ *
+ * Jobs are handed out one at a time as threads finish their last one, so
+ * jobs of very different lengths still keep every thread busy.
+ *
+ * @param threads The thread count; 0 for one per hardware thread.
+ */
+template <typename Job>
+void parallelFor(size_t count, unsigned threads, Job job) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = static_cast<unsigned>(
+      std::min<size_t>(threads, std::max<size_t>(count, 1)));
+
+  std::atomic<size_t> next{0};
+  auto worker = [&] {
+    size_t i;
+    while ((i = next.fetch_add(1, std::memory_order_relaxed)) < count) {
+      job(i);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (unsigned i = 1; i < threads; i++) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+}
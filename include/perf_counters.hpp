@@ -0,0 +1,111 @@
+/**
+ * @file perf_counters.hpp
+ * @brief Compile-time switchable performance counters for the CPU and bus.
+ *
+ * Configure with -DGB_INSTRUMENTATION=ON to enable them. When disabled the
+ * CPU and Memory hold a NullCounters instead, whose methods are empty
+ * inline functions, so the counting calls compile away entirely.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+
+#ifdef GB_INSTRUMENTATION
+inline constexpr bool kInstrumentation = true;
+#else
+inline constexpr bool kInstrumentation = false;
+#endif
+
+/**
+ * @brief The regions of the Game Boy memory map.
+ */
+enum class Region : uint8_t {
+  Rom,          ///< 0000-7FFF
+  VRam,         ///< 8000-9FFF
+  ExternalRam,  ///< A000-BFFF
+  WRam,         ///< C000-DFFF
+  Echo,         ///< E000-FDFF
+  Oam,          ///< FE00-FE9F
+  Unusable,     ///< FEA0-FEFF
+  IO,           ///< FF00-FF7F
+  HRam,         ///< FF80-FFFE
+  IE,           ///< FFFF
+  Count
+};
+
+/**
+ * @brief Returns the memory map region containing an address.
+ */
+Region regionOf(uint16_t address);
+
+/**
+ * @brief Returns a short lowercase name for a region.
+ */
+const char *regionName(Region region);
+
+/**
+ * @struct PerfCounters
+ * @brief Event counts collected while the machine runs.
+ */
+struct PerfCounters {
+  static constexpr size_t kRegions = static_cast<size_t>(Region::Count);
+
+  std::array<uint64_t, 256> opcodeCount{};
+  std::array<uint64_t, 256> opcodeCycles{};
+  std::array<uint64_t, kRegions> reads{};
+  std::array<uint64_t, kRegions> writes{};
+  uint64_t bankSwitches = 0;
+  uint64_t haltCycles = 0;
+
+  void countOpcode(uint8_t opcode, uint64_t cycles) {
+    opcodeCount[opcode]++;
+    opcodeCycles[opcode] += cycles;
+  }
+
+  void countRead(uint16_t address) {
+    reads[static_cast<size_t>(regionOf(address))]++;
+  }
+
+  void countWrite(uint16_t address) {
+    writes[static_cast<size_t>(regionOf(address))]++;
+  }
+
+  void countBankSwitch() { bankSwitches++; }
+
+  void countHalt(uint64_t cycles) { haltCycles += cycles; }
+
+  void reset() { *this = PerfCounters(); }
+};
+
+/**
+ * @struct NullCounters
+ * @brief Stand-in for PerfCounters when instrumentation is compiled out.
+ */
+struct NullCounters {
+  void countOpcode(uint8_t, uint64_t) {}
+  void countRead(uint16_t) {}
+  void countWrite(uint16_t) {}
+  void countBankSwitch() {}
+  void countHalt(uint64_t) {}
+  void reset() {}
+};
+
+/**
+ * @brief The counter type held by the CPU and bus in this build.
+ */
+using Counters =
+    std::conditional_t<kInstrumentation, PerfCounters, NullCounters>;
+
+/**
+ * @brief Writes the counters as a JSON object.
+ */
+void writeCountersJson(std::ostream &out, const PerfCounters &counters);
+
+/**
+ * @brief Writes the counters as CSV rows of `category,name,count,cycles`.
+ */
+void writeCountersCsv(std::ostream &out, const PerfCounters &counters);
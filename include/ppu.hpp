@@ -0,0 +1,145 @@
+/**
+ * @file ppu.hpp
+ * @brief Defines the PPU class for the Game Boy emulator.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "memory.hpp"
+
+/**
+ * @class PPU
+ * @brief Models the Game Boy's picture processing unit timing.
+ *
+ * The PPU is event driven: rather than being ticked every cycle it is asked
+ * to advance one mode at a time, and reports how many cycles remain until
+ * its next mode change so the caller can schedule it.
+ */
+class PPU {
+ public:
+  static constexpr uint16_t LCDC = 0xFF40;
+  static constexpr uint16_t STAT = 0xFF41;
+  static constexpr uint16_t LY = 0xFF44;
+  static constexpr uint16_t SCY = 0xFF42;
+  static constexpr uint16_t SCX = 0xFF43;
+  static constexpr uint16_t LYC = 0xFF45;
+  static constexpr uint16_t BGP = 0xFF47;
+  static constexpr uint16_t OBP0 = 0xFF48;
+  static constexpr uint16_t OBP1 = 0xFF49;
+  static constexpr uint16_t WY = 0xFF4A;
+  static constexpr uint16_t WX = 0xFF4B;
+  static constexpr uint16_t IF = 0xFF0F;
+
+  static constexpr uint32_t kScreenWidth = 160;
+  static constexpr uint32_t kScreenHeight = 144;
+
+  static constexpr uint32_t kOamScanCycles = 80;
+  static constexpr uint32_t kTransferCycles = 172;
+  static constexpr uint32_t kHBlankCycles = 204;
+  static constexpr uint32_t kLineCycles = 456;
+  static constexpr uint32_t kVisibleLines = 144;
+  static constexpr uint32_t kTotalLines = 154;
+  static constexpr uint32_t kFrameCycles = kLineCycles * kTotalLines;
+
+  /**
+   * @brief The four PPU modes, as reported in the low bits of STAT.
+   */
+  enum Mode : uint8_t { HBlank = 0, VBlank = 1, OamScan = 2, Transfer = 3 };
+
+  /**
+   * @brief Constructs a PPU at the start of line 0.
+   *
+   * @param memory The memory holding the LCD registers.
+   */
+  PPU(Memory &memory);
+  PPU(const PPU &) = delete;
+
+  /**
+   * @brief Copies another PPU's position and framebuffer; this one stays
+   * bound to its own memory.
+   */
+  PPU &operator=(const PPU &other);
+
+  /**
+   * @brief Publishes LY and STAT for the current position to memory.
+   *
+   * @return The number of cycles until the first mode change.
+   */
+  uint32_t reset();
+
+  /**
+   * @brief Stops the PPU when the LCD is switched off: LY reads 0 and STAT
+   * reports HBlank until reset() starts it again.
+   */
+  void disable();
+
+  /**
+   * @brief Moves to the next mode, updating LY, STAT and interrupt requests.
+   *
+   * @return The number of cycles until the following mode change.
+   */
+  uint32_t advanceMode();
+
+  /**
+   * @brief Returns the current mode.
+   */
+  Mode getMode() const { return mode; }
+
+  /**
+   * @brief Returns the current scanline.
+   */
+  uint8_t getLine() const { return line; }
+
+  /**
+   * @brief The rendered image, one pixel per entry, row major. Each line is
+   * drawn as it enters HBlank.
+   *
+   * In DMG mode a pixel is a shade from 0 (white) to 3 (black); in CGB mode
+   * it is an RGB555 color (red in the low bits).
+   */
+  const std::array<uint16_t, kScreenWidth * kScreenHeight> &getFramebuffer()
+      const {
+    return framebuffer;
+  }
+
+  /**
+   * @brief Hashes the framebuffer.
+   *
+   * @return A host-independent FNV-1a hash of the framebuffer.
+   */
+  uint64_t framebufferHash() const;
+
+  /**
+   * @brief Hashes the PPU's internal state, including the framebuffer.
+   */
+  uint64_t stateHash() const;
+
+  /**
+   * @brief Saves the position and framebuffer, as operator= copies them.
+   */
+  void saveState(StateWriter &out) const;
+
+  /**
+   * @brief Restores a saved position and framebuffer.
+   *
+   * @return False if the position is one the PPU never reaches; it is then
+   * left where it was.
+   */
+  bool loadState(StateReader &in);
+
+ private:
+  void updateStat();
+  void renderLine();
+  void renderSprites(uint16_t *pixels, const uint8_t *backgroundColors,
+                     const uint8_t *backgroundAttributes);
+
+  Memory &memory;
+  Mode mode = OamScan;
+  uint8_t line = 0;
+  uint8_t windowLine = 0;
+  bool statLine = false;
+  std::array<uint16_t, kScreenWidth * kScreenHeight> framebuffer{};
+};
@@ -0,0 +1,158 @@
+/**
+ * @file profiler.hpp
+ * @brief Defines Profiler: a sampling profiler for the code a machine runs.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "code_index.hpp"
+#include "gameboy.hpp"
+
+/**
+ * @class Profiler
+ * @brief Samples a machine's PC, ROM bank and call stack every so many
+ * cycles, for hot-spot lists and flame graphs.
+ *
+ * Samples come from a scheduler event, so they land on instruction
+ * boundaries and see time spent in HALT and in skipped idle loops at the
+ * instruction doing it. The call stack is a shadow stack pushed by CALL,
+ * RST and interrupt dispatch. Returns are recognized by the stack pointer
+ * rising above a frame's return address, which also drops frames that code
+ * unwinds by hand (POP, LD SP). Between samples the only cost is a null
+ * check on each call.
+ *
+ * A profiler belongs to one machine and is only touched by the thread
+ * running it, so it takes no locks; profiles of machines run on several
+ * threads are combined with merge() afterwards. Profiling does not change
+ * what the machine does or its state hash.
+ */
+class Profiler {
+ public:
+  // About 4 samples a frame, which keeps the overhead under 2%
+  static constexpr uint64_t kDefaultInterval = 16384;
+  // Deeper calls are attributed to the deepest recorded frame
+  static constexpr size_t kMaxDepth = 64;
+
+  /**
+   * @brief Starts profiling a machine, which must outlive the profiler and
+   * have no other profiler.
+   *
+   * @param interval Cycles between samples.
+   */
+  explicit Profiler(GameBoy &gameboy, uint64_t interval = kDefaultInterval);
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  /**
+   * @brief Stops profiling. The machine must not be running.
+   */
+  ~Profiler();
+
+  /**
+   * @brief Records a call, after the return address was pushed. Inline, as
+   * it runs on every call.
+   *
+   * @param target The address called.
+   * @param returnSlot The stack address of the return address (SP).
+   */
+  void enter(uint16_t target, uint16_t returnSlot) {
+    unwind(returnSlot + 1u);  // Frames at or below the new one are gone
+    if (depth < kMaxDepth) {
+      frames[depth++] = {locate(target), returnSlot};
+      stackVersion++;
+    }
+  }
+
+  /**
+   * @brief Takes a sample of the machine's state.
+   */
+  void sample();
+
+  uint64_t interval() const { return sampleInterval; }
+  uint64_t samples() const { return total; }
+
+  /**
+   * @brief Returns the sampled PCs with their sample counts, most sampled
+   * first.
+   */
+  std::vector<std::pair<RomLocation, uint64_t>> hotSpots() const;
+
+  /**
+   * @brief Returns the ROM banks mapped at 4000-7FFF when sampled, with
+   * their sample counts, most sampled first.
+   */
+  std::vector<std::pair<uint16_t, uint64_t>> hotBanks() const;
+
+  /**
+   * @brief Writes the call stacks in the collapsed format of flame graph
+   * tools: one line per stack, `main;00:0150;02:4000 <samples>`, where
+   * each frame is the bank and address of a called routine.
+   */
+  void writeCollapsed(std::ostream &out) const;
+
+  /**
+   * @brief Adds another profile's samples to this one's.
+   */
+  void merge(const Profiler &other);
+
+  /**
+   * @brief Discards the samples taken so far.
+   */
+  void reset();
+
+ private:
+  struct Frame {
+    uint32_t function;  // Packed RomLocation
+    uint16_t returnSlot;
+  };
+  struct StackHash {
+    size_t operator()(const std::vector<uint32_t> &stack) const;
+  };
+
+  /**
+   * @brief Packs the ROM location of an address: switchable-bank addresses
+   * get the mapped bank, all others bank 0.
+   */
+  uint32_t locate(uint16_t address) const {
+    uint16_t bank = address >= Cartridge::kRomBankSize && address < 0x8000
+                        ? gameboy.memory.romBank()
+                        : 0;
+    return static_cast<uint32_t>(bank) << 16 | address;
+  }
+
+  /**
+   * @brief Drops the frames whose return address lies below `stackPointer`:
+   * they have returned, or their stack was unwound.
+   */
+  void unwind(uint32_t stackPointer) {
+    while (depth > 0 && frames[depth - 1].returnSlot < stackPointer) {
+      depth--;
+      stackVersion++;
+    }
+  }
+
+  GameBoy &gameboy;
+  uint64_t sampleInterval;
+
+  std::array<Frame, kMaxDepth> frames;
+  size_t depth = 0;
+  // Bumped whenever the frames change, so that a sample of an unchanged
+  // stack skips the lookup
+  uint64_t stackVersion = 0;
+  uint64_t sampledVersion = ~uint64_t{0};
+  uint64_t *sampledCount = nullptr;
+
+  uint64_t total = 0;
+  std::unordered_map<std::vector<uint32_t>, uint64_t, StackHash> stacks;
+  std::unordered_map<uint32_t, uint64_t> pcs;
+  std::vector<uint64_t> banks;    // Indexed by bank
+  std::vector<uint32_t> scratch;  // The stack being sampled
+};
@@ -0,0 +1,86 @@
+/**
+ * @file save_state.hpp
+ * @brief Defines StateWriter and StateReader: the byte streams machine
+ * state is saved to and restored from.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class StateWriter
+ * @brief Appends state to a byte buffer. Integers are little endian, so
+ * saved states can be loaded on any host.
+ */
+class StateWriter {
+ public:
+  template <typename T>
+  void write(T value) {
+    static_assert(std::is_integral_v<T>);
+    for (size_t i = 0; i < sizeof(T); i++) {
+      buffer.push_back(static_cast<uint8_t>(
+          static_cast<uint64_t>(value) >> (i * 8)));
+    }
+  }
+
+  void write(const uint8_t *data, size_t size) {
+    size_t offset = buffer.size();
+    buffer.resize(offset + size);
+    std::copy_n(data, size, buffer.begin() + offset);
+  }
+
+  std::vector<uint8_t> &data() { return buffer; }
+
+ private:
+  std::vector<uint8_t> buffer;
+};
+
+/**
+ * @class StateReader
+ * @brief Reads state written by a StateWriter from a byte range, which may
+ * be a mapped file.
+ *
+ * Reads past the end return zeros and mark the reader failed, so a loader
+ * can read everything and check ok() once.
+ */
+class StateReader {
+ public:
+  explicit StateReader(std::span<const uint8_t> data) : data(data) {}
+
+  template <typename T>
+  T read() {
+    static_assert(std::is_integral_v<T>);
+    const uint8_t *bytes = take(sizeof(T));
+    uint64_t value = 0;
+    for (size_t i = 0; bytes && i < sizeof(T); i++) {
+      value |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+    }
+    return static_cast<T>(value);
+  }
+
+  /**
+   * @brief Returns the next `size` bytes in place, or null past the end.
+   */
+  const uint8_t *take(size_t size) {
+    if (failed || data.size() - offset < size) {
+      failed = true;
+      return nullptr;
+    }
+    offset += size;
+    return data.data() + offset - size;
+  }
+
+  bool ok() const { return !failed; }
+  bool atEnd() const { return offset == data.size(); }
+
+ private:
+  std::span<const uint8_t> data;
+  size_t offset = 0;
+  bool failed = false;
+};
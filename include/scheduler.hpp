@@ -0,0 +1,98 @@
+/**
+ * @file scheduler.hpp
+ * @brief Defines the event Scheduler that drives the emulated devices.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief The kinds of event a device can schedule on the machine clock.
+ */
+enum class Event : uint8_t {
+  PPU,    ///< PPU mode change (OAM scan, transfer, HBlank, VBlank line).
+  Timer,  ///< TIMA overflow.
+  Dma,    ///< End of an OAM DMA transfer.
+  Serial, ///< End of a serial transfer clocked by this machine.
+  Link,   ///< Synchronization with a linked machine.
+  Profile, ///< Profiler sample; not part of the machine state.
+  Count
+};
+
+/**
+ * @class Scheduler
+ * @brief Tracks when each device next needs attention, in CPU cycles.
+ *
+ * Each event kind has at most one pending deadline, so the queue is a small
+ * fixed array rather than a heap. The earliest deadline is cached so that the
+ * per-instruction "is anything due?" check is a single comparison.
+ */
+class Scheduler {
+ public:
+  static constexpr uint64_t kNever = std::numeric_limits<uint64_t>::max();
+
+  Scheduler() { deadlines.fill(kNever); }
+
+  /**
+   * @brief Schedules (or reschedules) an event at an absolute cycle count.
+   */
+  void schedule(Event event, uint64_t time) {
+    deadlines[static_cast<size_t>(event)] = time;
+    updateNext();
+  }
+
+  /**
+   * @brief Removes any pending deadline for the event.
+   */
+  void cancel(Event event) { schedule(event, kNever); }
+
+  /**
+   * @brief Returns the cycle count of the earliest pending event.
+   */
+  uint64_t nextEventTime() const { return next; }
+
+  /**
+   * @brief Returns the deadline of a single event, or kNever.
+   */
+  uint64_t eventTime(Event event) const {
+    return deadlines[static_cast<size_t>(event)];
+  }
+
+  /**
+   * @brief Pops the earliest event that is due at or before `now`.
+   *
+   * @param now The current cycle count.
+   * @param event Receives the event kind.
+   * @param time Receives the cycle count the event was scheduled for.
+   * @return True if an event was due.
+   */
+  bool popDue(uint64_t now, Event &event, uint64_t &time) {
+    if (next > now) {
+      return false;
+    }
+    for (size_t i = 0; i < deadlines.size(); i++) {
+      if (deadlines[i] == next) {
+        event = static_cast<Event>(i);
+        time = next;
+        deadlines[i] = kNever;
+        updateNext();
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  void updateNext() {
+    next = kNever;
+    for (uint64_t deadline : deadlines) {
+      next = deadline < next ? deadline : next;
+    }
+  }
+
+  std::array<uint64_t, static_cast<size_t>(Event::Count)> deadlines{};
+  uint64_t next = kNever;
+};
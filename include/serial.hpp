@@ -0,0 +1,80 @@
+/**
+ * @file serial.hpp
+ * @brief Defines SerialPeer, the device plugged into a machine's serial
+ * port, and SerialLog, a peer that records what the machine sends.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @class SerialPeer
+ * @brief What is at the other end of a machine's serial port.
+ *
+ * The port exchanges whole bytes: the machine clocking a transfer calls
+ * exchange() when its eight bits have been shifted. A machine waiting on an
+ * external clock is handed its byte through IO::receiveSerial().
+ *
+ * A peer that must stay in step with something outside the machine asks
+ * for a synchronize() call every syncInterval() cycles. Every call is made
+ * on the thread running the machine.
+ */
+class SerialPeer {
+ public:
+  virtual ~SerialPeer() = default;
+
+  /**
+   * @brief Completes a transfer clocked by the machine.
+   *
+   * @param time The cycle count at which the last bit was shifted.
+   * @param out The byte shifted out.
+   * @return The byte shifted in.
+   */
+  virtual uint8_t exchange(uint64_t time, uint8_t out) = 0;
+
+  /**
+   * @brief Called whenever the machine's SB changes: the byte a transfer
+   * clocked by the other end would shift in.
+   */
+  virtual void publish(uint8_t) {}
+
+  /**
+   * @brief Cycles between synchronize() calls, or 0 for none.
+   */
+  virtual uint64_t syncInterval() const { return 0; }
+
+  /**
+   * @brief Called every syncInterval() cycles, at the scheduled time.
+   */
+  virtual void synchronize(uint64_t) {}
+};
+
+/**
+ * @class SerialLog
+ * @brief A peer that records every byte the machine clocks out and answers
+ * with 0xFF, as an unconnected port reads.
+ *
+ * Test ROMs (Blargg's among them) print their results this way.
+ */
+class SerialLog : public SerialPeer {
+ public:
+  uint8_t exchange(uint64_t, uint8_t out) override {
+    text += static_cast<char>(out);
+    return 0xFF;
+  }
+
+  /**
+   * @brief Returns the bytes sent so far.
+   */
+  const std::string &output() const { return text; }
+
+  /**
+   * @brief Forgets the bytes sent so far.
+   */
+  void clear() { text.clear(); }
+
+ private:
+  std::string text;
+};
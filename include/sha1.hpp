@@ -0,0 +1,23 @@
+/**
+ * @file sha1.hpp
+ * @brief SHA-1, for identifying ROM images the way ROM databases do.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using Sha1Digest = std::array<uint8_t, 20>;
+
+/**
+ * @brief Computes the SHA-1 digest of a byte range.
+ */
+Sha1Digest sha1(const void *data, size_t size);
+
+/**
+ * @brief Formats a digest as 40 lowercase hex digits.
+ */
+std::string toHex(const Sha1Digest &digest);
@@ -0,0 +1,127 @@
+/**
+ * @file shared_page.hpp
+ * @brief Defines SharedPage: a reference-counted, copy-on-write block of
+ * storage.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+/**
+ * @brief Where an instance allocates its pages; null for the global heap.
+ */
+using PageResource = std::shared_ptr<std::pmr::memory_resource>;
+
+/**
+ * @class SharedPage
+ * @brief A fixed-size block of bytes that copies share until one of them
+ * writes.
+ *
+ * Copying a page only adds a reference. The count is atomic, so copies may
+ * be held and written on different threads: a holder that finds the block
+ * shared takes a private copy before writing, and the last holder frees it.
+ *
+ * New pages all share one block of zeros, so storage that is never written
+ * is never allocated. Copies are allocated from the writer's PageResource,
+ * which each block keeps alive for as long as it is referenced.
+ */
+template <size_t Size>
+class SharedPage {
+ public:
+  SharedPage() : SharedPage(zeros()) {}
+
+  SharedPage(const SharedPage &other) : SharedPage(other.block) {}
+
+  SharedPage &operator=(const SharedPage &other) {
+    SharedPage copy(other);
+    std::swap(block, copy.block);
+    return *this;
+  }
+
+  ~SharedPage() { release(); }
+
+  /**
+   * @brief Returns the bytes for reading.
+   */
+  const uint8_t *data() const { return block->bytes.data(); }
+
+  /**
+   * @brief Returns the bytes for writing, or null while they are shared.
+   */
+  uint8_t *writable() { return isShared() ? nullptr : block->bytes.data(); }
+
+  /**
+   * @brief Returns the bytes for writing, first taking a private copy if
+   * they are shared.
+   *
+   * @param resource Where to allocate the copy.
+   */
+  uint8_t *unshare(const PageResource &resource = nullptr) {
+    if (isShared()) {
+      Block *copy = create(resource);
+      release();
+      block = copy;
+    }
+    return block->bytes.data();
+  }
+
+  /**
+   * @brief Whether another page references the same bytes.
+   */
+  bool isShared() const {
+    return block->references.load(std::memory_order_acquire) > 1;
+  }
+
+ private:
+  struct Block {
+    Block() = default;
+    Block(const std::array<uint8_t, Size> &bytes, PageResource owner)
+        : bytes(bytes), owner(std::move(owner)) {}
+
+    std::atomic<uint32_t> references{1};
+    std::array<uint8_t, Size> bytes{};
+    PageResource owner;
+  };
+
+  explicit SharedPage(Block *block) : block(block) {
+    block->references.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Never freed: it holds a reference of its own
+  static Block *zeros() {
+    static Block *block = new Block;
+    return block;
+  }
+
+  Block *create(const PageResource &resource) const {
+    if (!resource) {
+      return new Block(block->bytes, nullptr);
+    }
+    void *storage = resource->allocate(sizeof(Block), alignof(Block));
+    return ::new (storage) Block(block->bytes, resource);
+  }
+
+  void release() {
+    if (block->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    // The block may hold the last reference to its resource
+    PageResource owner = std::move(block->owner);
+    if (!owner) {
+      delete block;
+      return;
+    }
+    block->~Block();
+    owner->deallocate(block, sizeof(Block), alignof(Block));
+  }
+
+  Block *block;
+};
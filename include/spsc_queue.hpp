@@ -0,0 +1,92 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief Defines SpscQueue: a bounded lock-free queue between two threads.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class SpscQueue
+ * @brief A fixed-capacity ring buffer for one producer thread and one
+ * consumer thread.
+ *
+ * Each side owns one index and only reads the other's, so no operation
+ * waits or retries. The indices sit on separate cache lines so that the two
+ * sides do not contend for one.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+  static_assert(Capacity && !(Capacity & (Capacity - 1)),
+                "Capacity must be a power of two");
+
+ public:
+  /**
+   * @brief Appends a value. Producer only.
+   *
+   * @return False, leaving the queue unchanged, if it is full.
+   */
+  bool push(const T &value) {
+    size_t back = tail.load(std::memory_order_relaxed);
+    if (back - head.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    slots[back % Capacity] = value;
+    tail.store(back + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Returns the slot the next value goes in, for filling in place
+   * before commit(), or null if the queue is full. Producer only.
+   *
+   * Saves push()'s copy for large values.
+   */
+  T *back() {
+    size_t back = tail.load(std::memory_order_relaxed);
+    if (back - head.load(std::memory_order_acquire) == Capacity) {
+      return nullptr;
+    }
+    return &slots[back % Capacity];
+  }
+
+  /**
+   * @brief Appends the value filled in through back(), which must have
+   * returned a slot. Producer only.
+   */
+  void commit() {
+    tail.store(tail.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+  }
+
+  /**
+   * @brief Returns the oldest value, or null if the queue is empty.
+   * Consumer only.
+   */
+  const T *front() const {
+    size_t front = head.load(std::memory_order_relaxed);
+    if (front == tail.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &slots[front % Capacity];
+  }
+
+  /**
+   * @brief Removes the oldest value; the queue must not be empty. Consumer
+   * only.
+   */
+  void pop() {
+    head.store(head.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+  }
+
+ private:
+  static constexpr size_t kLine = 64;
+
+  alignas(kLine) std::atomic<size_t> head{0};
+  alignas(kLine) std::atomic<size_t> tail{0};
+  alignas(kLine) std::array<T, Capacity> slots{};
+};
@@ -0,0 +1,144 @@
+/**
+ * @file state_cache.hpp
+ * @brief Defines StateCache: an on-disk cache of saved states keyed by the
+ * ROM and the input that reached them.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+#include "gameboy.hpp"
+#include "sha1.hpp"
+
+/**
+ * @struct StateKey
+ * @brief Identifies a machine state by how it was reached: the ROM, the
+ * state the run started from and the buttons held in each frame since.
+ */
+struct StateKey {
+  Sha1Digest rom{};
+  uint64_t inputs = 0;  ///< Hash of the starting state and every input.
+  uint32_t frame = 0;   ///< Frames run since the starting state.
+
+  /**
+   * @brief Returns the key of a run's starting state.
+   */
+  static StateKey start(const Sha1Digest &rom, uint64_t initialStateHash);
+
+  /**
+   * @brief Extends the key by a frame run with `buttons` held.
+   */
+  void advance(uint8_t buttons);
+
+  /**
+   * @brief Returns the cache file name, `<ROM SHA-1>-<inputs>-<frame>.gbs`.
+   */
+  std::string fileName() const;
+};
+
+/**
+ * @struct StateCacheStats
+ * @brief What a cache has saved a process so far.
+ */
+struct StateCacheStats {
+  uint64_t lookups = 0;
+  uint64_t hits = 0;
+  uint64_t stores = 0;
+  uint64_t evictions = 0;
+  uint64_t framesRestored = 0;  ///< Frames hits saved re-emulating.
+  double restoreSeconds = 0;    ///< Time spent loading hits.
+
+  double hitRate() const {
+    return lookups ? static_cast<double>(hits) / lookups : 0;
+  }
+};
+
+/**
+ * @class StateCache
+ * @brief A directory of saved states, content addressed by StateKey, that
+ * lets a run resume from the deepest state an earlier run with the same
+ * input prefix left behind.
+ *
+ * States are written to a temporary file and renamed into place, so
+ * processes sharing a directory never see a partial file, and are read by
+ * mapping the file and loading straight from the mapping. The directory is
+ * kept under a size cap by evicting the least recently used states;
+ * recency is the file modification time, which hits refresh, so it carries
+ * over between processes. The index is built by open(): states other
+ * processes store later are seen from the next open().
+ *
+ * A cache object is used from one thread.
+ */
+class StateCache {
+ public:
+  static constexpr uint64_t kDefaultCapacity = uint64_t{256} << 20;
+
+  /**
+   * @brief Opens a cache directory, creating it if needed, and indexes the
+   * states already in it.
+   *
+   * @param capacity The size cap in bytes.
+   * @return False, with the reason in `error`, if the directory cannot be
+   * used.
+   */
+  bool open(const std::string &directory, uint64_t capacity,
+            std::string &error);
+
+  /**
+   * @brief Restores the deepest cached state along a run.
+   *
+   * Tries the states reached after each prefix of `inputs`, longest first.
+   * A state that fails to load is deleted and the search goes on.
+   *
+   * @param start The key of the machine's current state.
+   * @param inputs The buttons for each frame the run has still to go.
+   * @return The number of those frames the restored state has run; 0 on a
+   * miss, with the machine unchanged.
+   */
+  uint32_t restore(GameBoy &gameboy, const StateKey &start,
+                   std::span<const uint8_t> inputs);
+
+  /**
+   * @brief Stores the machine's state under a key, unless it is already
+   * cached, evicting old states to stay under the cap.
+   *
+   * @return False if the state could not be written.
+   */
+  bool store(const GameBoy &gameboy, const StateKey &key);
+
+  /**
+   * @brief Returns whether a state is cached under a key.
+   */
+  bool contains(const StateKey &key) const {
+    return entries.contains(key.fileName());
+  }
+
+  /**
+   * @brief Returns the total size of the cached states.
+   */
+  uint64_t size() const { return totalBytes; }
+
+  const StateCacheStats &getStats() const { return stats; }
+
+ private:
+  struct Entry {
+    uint64_t bytes;
+    uint64_t lastUse;
+  };
+
+  bool load(GameBoy &gameboy, const std::string &name);
+  void touch(const std::string &name);
+  void remove(const std::string &name);
+  void evict();
+
+  std::string directory;
+  uint64_t capacity = kDefaultCapacity;
+  std::unordered_map<std::string, Entry> entries;
+  uint64_t totalBytes = 0;
+  uint64_t useCounter = 0;
+  StateCacheStats stats;
+};
@@ -0,0 +1,36 @@
+/**
+ * @file timing.hpp
+ * @brief Defines the timing policies that select a core's accuracy tier.
+ */
+
+#pragma once
+
+/**
+ * @brief The fast tier: instruction-level timing.
+ *
+ * An instruction's whole duration is added to the clock before it runs, so
+ * all of its bus accesses happen at the same time, its end. Nothing a device
+ * does can be observed part way through an instruction.
+ */
+struct FastTiming {
+  static constexpr const char *kName = "fast";
+  static constexpr bool kMCycleBus = false;
+};
+
+/**
+ * @brief The accurate tier: M-cycle bus timing.
+ *
+ * Every bus access, opcode fetches included, advances the clock by one
+ * M-cycle as it happens, and internal M-cycles that come before an access
+ * (such as the one ahead of a push) delay it. The rest of an instruction's
+ * internal cycles are added when it completes, leaving its total duration
+ * what the fast tier gives.
+ *
+ * Devices are still updated lazily: an access to a device register first
+ * runs every event due by its M-cycle (see Memory::catchUp), so a register
+ * read mid-instruction sees the device as it is at that time.
+ */
+struct AccurateTiming {
+  static constexpr const char *kName = "accurate";
+  static constexpr bool kMCycleBus = true;
+};
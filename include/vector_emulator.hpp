@@ -0,0 +1,97 @@
+/**
+ * @file vector_emulator.hpp
+ * @brief Defines VectorEmulator: many machines running one ROM in lockstep.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "gameboy.hpp"
+
+/**
+ * @brief What a machine shows after a step.
+ */
+struct Observation {
+  const uint16_t *framebuffer = nullptr;  ///< PPU::getFramebuffer() pixels.
+  uint64_t cycles = 0;                    ///< The machine's clock.
+};
+
+/**
+ * @class VectorEmulator
+ * @brief Runs N copies of one ROM with different inputs, one frame per step.
+ *
+ * All machines share a single ROM image. Machines whose PC points at the
+ * same byte of it (same address, same mapped bank) are stepped together as
+ * a group: the opcode is fetched once from the shared ROM and then executed
+ * on each member.
+ * The lockstep scheduler keeps the per-machine values it groups by in
+ * structure-of-arrays form. Groups split as their members' inputs send
+ * them down different paths, and a machine left on its own (or running
+ * code from RAM, which may differ between machines) finishes the frame
+ * with the ordinary scalar loop.
+ *
+ * Every machine ends each step in exactly the state a standalone GameBoy
+ * would reach with the same inputs. Each machine's pages live in its own
+ * Arena.
+ */
+class VectorEmulator {
+ public:
+  /**
+   * @brief Creates `count` machines with `rom` loaded.
+   */
+  VectorEmulator(const std::vector<uint8_t> &rom, size_t count);
+
+  /**
+   * @brief Returns the number of machines.
+   */
+  size_t size() const { return machines.size(); }
+
+  /**
+   * @brief Runs one frame on every machine.
+   *
+   * @param actions The buttons each machine holds for the frame (see
+   * joypad.hpp); one entry per machine.
+   * @param observations Filled with each machine's result; one entry per
+   * machine.
+   */
+  void step(std::span<const uint8_t> actions,
+            std::span<Observation> observations);
+
+  /**
+   * @brief Returns one of the machines.
+   */
+  GameBoy &machine(size_t index) { return *machines[index]; }
+
+  /**
+   * @brief Instructions executed from a fetch shared with other machines.
+   */
+  uint64_t sharedDecodes = 0;
+
+  /**
+   * @brief Frames (or rests of frames) a machine ran on its own.
+   */
+  uint64_t scalarFallbacks = 0;
+
+ private:
+  // Widest group stepped in lockstep. Every member's state is touched on
+  // each instruction, so wider groups fall out of cache.
+  static constexpr size_t kGroupWidth = 8;
+
+  const uint8_t *groupKey(uint32_t index) const;
+  void runGroup(std::vector<uint32_t> &group);
+  void runScalar(uint32_t index);
+
+  std::vector<std::unique_ptr<GameBoy>> machines;
+
+  // Lockstep scheduler state, one entry per machine
+  std::vector<const uint8_t *> keys;
+  std::vector<uint64_t> targets;
+  std::vector<uint32_t> order;
+
+  // Groups waiting to run, as ranges of machine indices
+  std::vector<std::vector<uint32_t>> pending;
+};
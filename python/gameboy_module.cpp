@@ -0,0 +1,196 @@
+/**
+ * @file gameboy_module.cpp
+ * @brief Python bindings: the fast-tier machine, its CPU and memory, and a
+ * frame loop that runs without the GIL.
+ *
+ * The framebuffer and work RAM come back as NumPy arrays over the
+ * machine's own storage, so reading them after a step copies nothing. Each
+ * array holds a reference to the machine it views.
+ */
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/gameboy.hpp"
+#include "../include/joypad.hpp"
+
+namespace py = pybind11;
+using namespace py::literals;
+
+namespace {
+
+using Actions = py::array_t<uint8_t, py::array::c_style | py::array::forcecast>;
+
+// The bytes of a buffer, valid while `info` is
+std::span<const uint8_t> bytesOf(const py::buffer_info &info) {
+  return {static_cast<const uint8_t *>(info.ptr),
+          static_cast<size_t>(info.size * info.itemsize)};
+}
+
+// Runs frames with the GIL released, pressing each frame's buttons if
+// there are any
+void runFrames(GameBoy &gameboy, uint64_t frames, const uint8_t *actions) {
+  py::gil_scoped_release release;
+  for (uint64_t frame = 0; frame < frames; frame++) {
+    if (actions) {
+      gameboy.memory.setButtons(actions[frame]);
+    }
+    gameboy.runFrame();
+  }
+}
+
+void step(GameBoy &gameboy, uint64_t frames, const py::object &actions) {
+  if (actions.is_none()) {
+    runFrames(gameboy, frames, nullptr);
+  } else if (py::isinstance<py::int_>(actions)) {
+    gameboy.memory.setButtons(actions.cast<uint8_t>());
+    runFrames(gameboy, frames, nullptr);
+  } else {
+    // Holds the converted array, if any, until the frames have run
+    Actions array = Actions::ensure(actions);
+    if (!array || array.ndim() != 1 ||
+        static_cast<uint64_t>(array.size()) != frames) {
+      throw py::value_error(
+          "actions must be None, an int or one button byte per frame");
+    }
+    runFrames(gameboy, frames, array.data());
+  }
+}
+
+// A read-only view of the framebuffer, keeping `owner` alive
+py::array framebufferView(const GameBoy &gameboy, py::handle owner) {
+  constexpr py::ssize_t kWidth = PPU::kScreenWidth;
+  constexpr py::ssize_t kHeight = PPU::kScreenHeight;
+  constexpr py::ssize_t kPixel = sizeof(uint16_t);
+  py::array_t<uint16_t> view({kHeight, kWidth}, {kWidth * kPixel, kPixel},
+                             gameboy.ppu.getFramebuffer().data(), owner);
+  view.attr("setflags")("write"_a = false);
+  return view;
+}
+
+}  // namespace
+
+PYBIND11_MODULE(gameboy, m) {
+  m.doc() = "Game Boy emulator core: fast-tier machines stepped by frames";
+
+  const std::pair<const char *, Button> buttons[] = {
+      {"BUTTON_A", ButtonA},         {"BUTTON_B", ButtonB},
+      {"BUTTON_SELECT", ButtonSelect}, {"BUTTON_START", ButtonStart},
+      {"BUTTON_RIGHT", ButtonRight}, {"BUTTON_LEFT", ButtonLeft},
+      {"BUTTON_UP", ButtonUp},       {"BUTTON_DOWN", ButtonDown},
+  };
+  for (const auto &[name, bit] : buttons) {
+    m.attr(name) = static_cast<uint8_t>(bit);
+  }
+
+  py::class_<CPU> cpu(m, "CPU", "The SM83 registers and clock");
+  struct Register {
+    const char *name;
+    uint8_t &(*get)(CPU &);
+  };
+  const Register registers[] = {
+      {"A", [](CPU &c) -> uint8_t & { return c.A; }},
+      {"F", [](CPU &c) -> uint8_t & { return c.F; }},
+      {"B", [](CPU &c) -> uint8_t & { return c.B; }},
+      {"C", [](CPU &c) -> uint8_t & { return c.C; }},
+      {"D", [](CPU &c) -> uint8_t & { return c.D; }},
+      {"E", [](CPU &c) -> uint8_t & { return c.E; }},
+      {"H", [](CPU &c) -> uint8_t & { return c.H; }},
+      {"L", [](CPU &c) -> uint8_t & { return c.L; }},
+  };
+  for (const Register &reg : registers) {
+    auto get = reg.get;
+    cpu.def_property(
+        reg.name, [get](CPU &c) { return get(c); },
+        [get](CPU &c, uint8_t value) { get(c) = value; });
+  }
+  cpu.def_readwrite("SP", &CPU::SP)
+      .def_readwrite("PC", &CPU::PC)
+      .def_readwrite("IME", &CPU::IME)
+      .def_readonly("halted", &CPU::halted)
+      .def_readonly("cycles", &CPU::cycles, "T-cycles run since power-on");
+
+  py::class_<Memory>(m, "Memory", "The CPU's 64 KB address space")
+      .def("read", &Memory::peek, "address"_a,
+           "Reads a byte without side effects")
+      .def("write", &Memory::poke, "address"_a, "value"_a,
+           "Writes a byte without side effects; ROM is left unchanged")
+      .def(
+          "wram",
+          [](py::object self, uint8_t bank) {
+            if (bank > 7) {
+              throw py::index_error("work RAM banks are 0-7");
+            }
+            uint8_t *bytes = self.cast<Memory &>().workRam(bank);
+            return py::array_t<uint8_t>(0x1000, bytes, self);
+          },
+          "bank"_a,
+          "Returns a writable view of a 4 KB work RAM bank: bank 0 is "
+          "C000-CFFF, bank 1 (or the CGB's selected bank) D000-DFFF. "
+          "The bank keeps its storage from then on, so views stay valid "
+          "and see loaded states.")
+      .def_property_readonly("cgb", &Memory::isCgb);
+
+  py::class_<GameBoy>(m, "GameBoy", "A fast-tier machine")
+      .def(py::init([](const py::buffer &rom, bool fastBoot) {
+             py::buffer_info info = rom.request();
+             std::span<const uint8_t> bytes = bytesOf(info);
+             auto gameboy = std::make_unique<GameBoy>();
+             gameboy->loadRom(std::vector<uint8_t>(bytes.begin(), bytes.end()));
+             if (fastBoot) {
+               gameboy->fastBoot();
+             }
+             return gameboy;
+           }),
+           "rom"_a, "fast_boot"_a = true,
+           "Loads a ROM image, starting at the state the boot ROM leaves "
+           "unless fast_boot is False")
+      .def_property_readonly(
+          "cpu", [](GameBoy &gameboy) -> CPU & { return gameboy.cpu; },
+          py::return_value_policy::reference_internal)
+      .def_property_readonly(
+          "memory", [](GameBoy &gameboy) -> Memory & { return gameboy.memory; },
+          py::return_value_policy::reference_internal)
+      .def_property_readonly(
+          "framebuffer",
+          [](py::object self) {
+            return framebufferView(self.cast<const GameBoy &>(), self);
+          },
+          "A read-only (144, 160) view of the screen: DMG shades 0-3, or "
+          "CGB RGB555 colors")
+      .def("step", &step, "n_frames"_a, "actions"_a = py::none(),
+           "Runs frames without holding the GIL. actions is None to keep "
+           "the buttons held, an int of BUTTON_* bits to hold for every "
+           "frame, or one such byte per frame. A machine must not be "
+           "stepped from two threads at once.")
+      .def("state_hash", &GameBoy::stateHash)
+      .def("save_state",
+           [](const GameBoy &gameboy) {
+             std::vector<uint8_t> state = gameboy.saveState();
+             return py::bytes(reinterpret_cast<const char *>(state.data()),
+                              state.size());
+           })
+      .def(
+          "load_state",
+          [](GameBoy &gameboy, const py::buffer &state) {
+            // A state can fail after loading part of itself
+            std::vector<uint8_t> backup = gameboy.saveState();
+            py::buffer_info info = state.request();
+            std::string error;
+            if (!gameboy.loadState(bytesOf(info), error)) {
+              std::string ignored;
+              gameboy.loadState(backup, ignored);
+              throw py::value_error(error);
+            }
+          },
+          "state"_a,
+          "Restores a state from save_state(), or raises ValueError and "
+          "leaves the machine as it was");
+}
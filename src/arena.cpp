@@ -0,0 +1,62 @@
+/**
+ * @file arena.cpp
+ * @brief Implementation of the Arena memory resource.
+ */
+
+#include "../include/arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+// Free blocks store the link to the next one in place
+size_t blockSize(size_t bytes) { return std::max(bytes, sizeof(void *)); }
+
+}  // namespace
+
+Arena::Arena(size_t chunkSize)
+    : firstChunk(chunkSize), chunks(chunkSize), freeLists(&chunks) {}
+
+size_t Arena::bytesInUse() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return inUse;
+}
+
+void *Arena::do_allocate(size_t bytes, size_t alignment) {
+  size_t size = blockSize(bytes);
+  std::lock_guard<std::mutex> lock(mutex);
+  inUse += size;
+  FreeList &list = freeList(size);
+  void *block = list.head;
+  if (block && reinterpret_cast<uintptr_t>(block) % alignment == 0) {
+    list.head = *static_cast<void **>(block);
+    return block;
+  }
+  return chunks.allocate(size, std::max(alignment, alignof(void *)));
+}
+
+void Arena::do_deallocate(void *pointer, size_t bytes, size_t) {
+  size_t size = blockSize(bytes);
+  std::lock_guard<std::mutex> lock(mutex);
+  inUse -= size;
+  FreeList &list = freeList(size);
+  *static_cast<void **>(pointer) = list.head;
+  list.head = pointer;
+}
+
+/**
+ * @brief Returns the free list for a block size, adding it on first use.
+ *
+ * An instance allocates only a few distinct sizes (its page sizes and
+ * buffer types), so a linear search beats hashing.
+ */
+Arena::FreeList &Arena::freeList(size_t size) {
+  for (FreeList &list : freeLists) {
+    if (list.size == size) {
+      return list;
+    }
+  }
+  freeLists.push_back({size, nullptr});
+  return freeLists.back();
+}
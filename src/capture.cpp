@@ -0,0 +1,330 @@
+/**
+ * @file capture.cpp
+ * @brief Implementation of the capture writer and reader.
+ */
+
+#include "../include/capture.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "../include/lz.hpp"
+#include "../include/save_state.hpp"
+
+namespace {
+
+constexpr char kMagic[4] = {'G', 'B', 'C', 'V'};
+constexpr size_t kHeaderSize = 18;
+constexpr size_t kRecordHeaderSize = 9;
+
+enum RecordKind : uint8_t { kKeyFrame, kDeltaFrame, kAudio };
+
+void writeBytes(std::ofstream &file, std::span<const uint8_t> data) {
+  file.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+bool readBytes(std::ifstream &file, std::vector<uint8_t> &data,
+               size_t size) {
+  data.resize(size);
+  file.read(reinterpret_cast<char *>(data.data()), size);
+  return static_cast<size_t>(file.gcount()) == size;
+}
+
+}  // namespace
+
+CaptureWriter::~CaptureWriter() {
+  std::string error;
+  close(error);
+}
+
+bool CaptureWriter::open(const std::string &path, const CaptureFormat &format,
+                         std::string &error) {
+  file.open(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    error = path + ": " + std::strerror(errno);
+    return false;
+  }
+  this->path = path;
+  this->format = format;
+  StateWriter header;
+  header.write(reinterpret_cast<const uint8_t *>(kMagic), sizeof(kMagic));
+  header.write(kVersion);
+  header.write(static_cast<uint16_t>(PPU::kScreenWidth));
+  header.write(static_cast<uint16_t>(PPU::kScreenHeight));
+  header.write(format.bytesPerPixel);
+  header.write(format.channels);
+  header.write(format.sampleRate);
+  writeBytes(file, header.data());
+
+  queue = std::make_unique<SpscQueue<Packet, 16>>();
+  stopping.store(false);
+  stats = {};
+  failed = false;
+  encodedFrames = 0;
+  writer = std::thread(&CaptureWriter::run, this);
+  return true;
+}
+
+void CaptureWriter::pushFrame(std::span<const uint16_t> framebuffer) {
+  Packet &packet = claim();
+  packet.audio = false;
+  packet.count = kPixels;
+  std::copy_n(framebuffer.begin(), kPixels, packet.values.begin());
+  publish();
+  stats.frames++;
+}
+
+void CaptureWriter::pushAudio(std::span<const int16_t> samples) {
+  while (!samples.empty()) {
+    size_t count = std::min(samples.size(), kPixels);
+    Packet &packet = claim();
+    packet.audio = true;
+    packet.count = static_cast<uint32_t>(count);
+    std::copy_n(samples.begin(), count, packet.values.begin());
+    publish();
+    samples = samples.subspan(count);
+    stats.audioSamples += count;
+  }
+}
+
+bool CaptureWriter::close(std::string &error) {
+  if (!writer.joinable()) {
+    return true;
+  }
+  stopping.store(true, std::memory_order_release);
+  pushed.fetch_add(1, std::memory_order_release);
+  pushed.notify_one();
+  writer.join();
+  file.close();
+  if (failed || !file) {
+    error = path + ": write failed";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Returns the next free slot, waiting for the writer if there is
+ * none.
+ */
+CaptureWriter::Packet &CaptureWriter::claim() {
+  bool stalled = false;
+  for (;;) {
+    uint32_t seen = popped.load(std::memory_order_acquire);
+    if (Packet *packet = queue->back()) {
+      return *packet;
+    }
+    if (!stalled) {
+      stats.stalls++;
+      stalled = true;
+    }
+    popped.wait(seen, std::memory_order_acquire);
+  }
+}
+
+void CaptureWriter::publish() {
+  queue->commit();
+  pushed.fetch_add(1, std::memory_order_release);
+  pushed.notify_one();
+}
+
+/**
+ * @brief The writer thread: encodes packets until close() and the queue is
+ * drained.
+ */
+void CaptureWriter::run() {
+  for (;;) {
+    // Read before the queue, so nothing pushed before close() is missed
+    bool stop = stopping.load(std::memory_order_acquire);
+    uint32_t seen = pushed.load(std::memory_order_acquire);
+    const Packet *packet = queue->front();
+    if (!packet) {
+      if (stop) {
+        break;
+      }
+      pushed.wait(seen, std::memory_order_acquire);
+      continue;
+    }
+    encode(*packet);
+    queue->pop();
+    popped.fetch_add(1, std::memory_order_release);
+    popped.notify_one();
+  }
+  file.flush();
+}
+
+void CaptureWriter::encode(const Packet &packet) {
+  if (packet.audio) {
+    current.resize(packet.count * 2);
+    for (uint32_t i = 0; i < packet.count; i++) {
+      current[2 * i] = static_cast<uint8_t>(packet.values[i]);
+      current[2 * i + 1] = static_cast<uint8_t>(packet.values[i] >> 8);
+    }
+    writeRecord(kAudio, current);
+    return;
+  }
+
+  if (format.bytesPerPixel == 2) {
+    current.resize(kPixels * 2);
+    for (size_t i = 0; i < kPixels; i++) {
+      current[2 * i] = static_cast<uint8_t>(packet.values[i]);
+      current[2 * i + 1] = static_cast<uint8_t>(packet.values[i] >> 8);
+    }
+  } else {
+    current.resize(kPixels);
+    for (size_t i = 0; i < kPixels; i++) {
+      current[i] = static_cast<uint8_t>(packet.values[i]);
+    }
+  }
+  if (encodedFrames++ % kKeyInterval == 0) {
+    writeRecord(kKeyFrame, current);
+    stats.keyFrames++;
+  } else {
+    delta.resize(current.size());
+    for (size_t i = 0; i < current.size(); i++) {
+      delta[i] = current[i] ^ previous[i];
+    }
+    writeRecord(kDeltaFrame, delta);
+  }
+  previous.swap(current);
+}
+
+void CaptureWriter::writeRecord(uint8_t kind, std::span<const uint8_t> raw) {
+  lzCompress(raw, compressed);
+  StateWriter header;
+  header.write(kind);
+  header.write(static_cast<uint32_t>(raw.size()));
+  header.write(static_cast<uint32_t>(compressed.size()));
+  if (!failed) {
+    writeBytes(file, header.data());
+    writeBytes(file, compressed);
+    failed = !file;
+  }
+  stats.rawBytes += raw.size();
+  stats.compressedBytes += kRecordHeaderSize + compressed.size();
+}
+
+bool CaptureReader::open(const std::string &path, std::string &error) {
+  file.close();
+  file.clear();
+  file.open(path, std::ios::binary);
+  if (!file) {
+    error = path + ": " + std::strerror(errno);
+    return false;
+  }
+  if (!readBytes(file, block, kHeaderSize) ||
+      !std::equal(std::begin(kMagic), std::end(kMagic), block.begin())) {
+    error = "not a capture";
+    return false;
+  }
+  StateReader header(std::span<const uint8_t>(block).subspan(4));
+  uint32_t version = header.read<uint32_t>();
+  uint16_t width = header.read<uint16_t>();
+  uint16_t height = header.read<uint16_t>();
+  format.bytesPerPixel = header.read<uint8_t>();
+  format.channels = header.read<uint8_t>();
+  format.sampleRate = header.read<uint32_t>();
+  if (version != CaptureWriter::kVersion) {
+    error = "unsupported capture version";
+    return false;
+  }
+  if (width != PPU::kScreenWidth || height != PPU::kScreenHeight ||
+      format.bytesPerPixel < 1 || format.bytesPerPixel > 2 ||
+      format.channels < 1 || format.channels > 2) {
+    error = "unsupported capture format";
+    return false;
+  }
+  haveKeyFrame = false;
+  return true;
+}
+
+bool CaptureReader::next(Record &record, std::string &error) {
+  if (!readBytes(file, block, kRecordHeaderSize)) {
+    if (file.gcount() == 0) {
+      record = Record::End;
+      return true;
+    }
+    error = "truncated capture";
+    return false;
+  }
+  StateReader header(block);
+  uint8_t kind = header.read<uint8_t>();
+  uint32_t rawSize = header.read<uint32_t>();
+  uint32_t compressedSize = header.read<uint32_t>();
+
+  size_t frameSize = PPU::kScreenWidth * PPU::kScreenHeight *
+                     format.bytesPerPixel;
+  size_t maxSize = PPU::kScreenWidth * PPU::kScreenHeight * 2;
+  bool sizeOk = kind == kAudio ? rawSize % 2 == 0 && rawSize <= maxSize
+                               : kind <= kDeltaFrame && rawSize == frameSize;
+  // lzCompress() adds at most a length byte per 255 literals and a token
+  if (!sizeOk || compressedSize > rawSize + rawSize / 255 + 16) {
+    error = "corrupt capture record";
+    return false;
+  }
+  if (!readBytes(file, block, compressedSize)) {
+    error = "truncated capture";
+    return false;
+  }
+  if (!lzDecompress(block, rawSize, raw)) {
+    error = "corrupt capture record";
+    return false;
+  }
+
+  if (kind == kAudio) {
+    samples.resize(rawSize / 2);
+    for (size_t i = 0; i < samples.size(); i++) {
+      samples[i] = static_cast<int16_t>(raw[2 * i] | raw[2 * i + 1] << 8);
+    }
+    record = Record::Audio;
+    return true;
+  }
+
+  if (kind == kDeltaFrame) {
+    if (!haveKeyFrame) {
+      error = "delta frame before the first key frame";
+      return false;
+    }
+    for (size_t i = 0; i < raw.size(); i++) {
+      raw[i] ^= previous[i];
+    }
+  }
+  haveKeyFrame = true;
+  previous.swap(raw);
+  pixels.resize(PPU::kScreenWidth * PPU::kScreenHeight);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = format.bytesPerPixel == 2
+                    ? static_cast<uint16_t>(previous[2 * i] |
+                                            previous[2 * i + 1] << 8)
+                    : previous[i];
+  }
+  record = Record::Frame;
+  return true;
+}
+
+std::vector<uint8_t> encodeWav(std::span<const int16_t> samples,
+                               uint32_t sampleRate, uint16_t channels) {
+  uint32_t dataSize = static_cast<uint32_t>(samples.size() * 2);
+  StateWriter wav;
+  auto tag = [&wav](const char *text) {
+    wav.write(reinterpret_cast<const uint8_t *>(text), 4);
+  };
+  tag("RIFF");
+  wav.write<uint32_t>(36 + dataSize);
+  tag("WAVE");
+  tag("fmt ");
+  wav.write<uint32_t>(16);
+  wav.write<uint16_t>(1);  // PCM
+  wav.write(channels);
+  wav.write(sampleRate);
+  wav.write<uint32_t>(sampleRate * channels * 2);  // Bytes per second
+  wav.write<uint16_t>(channels * 2);               // Bytes per frame
+  wav.write<uint16_t>(16);                         // Bits per sample
+  tag("data");
+  wav.write(dataSize);
+  for (int16_t sample : samples) {
+    wav.write(sample);
+  }
+  return std::move(wav.data());
+}
@@ -0,0 +1,226 @@
+/**
+ * @file cartridge.cpp
+ * @brief Implementation of the Cartridge class and its bank controllers.
+ */
+
+#include "../include/cartridge.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "../include/hash.hpp"
+#include "../include/save_state.hpp"
+
+namespace {
+
+// External RAM sizes indexed by header byte 0x149
+constexpr uint32_t kRamSizes[6] = {0, 0x800, 0x2000, 0x8000, 0x20000, 0x10000};
+
+}  // namespace
+
+Cartridge::Controller Cartridge::controllerOf(uint8_t type) {
+  switch (type) {
+    case 0x00:
+    case 0x08:
+    case 0x09:
+      return Controller::None;
+    case 0x01:
+    case 0x02:
+    case 0x03:
+      return Controller::MBC1;
+    case 0x0F:
+    case 0x10:
+    case 0x11:
+    case 0x12:
+    case 0x13:
+      return Controller::MBC3;
+    default:
+      return Controller::MBC5;
+  }
+}
+
+Cartridge::Cartridge() = default;
+
+Cartridge::Image Cartridge::prepare(const std::vector<uint8_t> &image) {
+  size_t banks = std::bit_ceil(
+      std::max<size_t>((image.size() + kRomBankSize - 1) / kRomBankSize, 2));
+  std::vector<uint8_t> padded(banks * kRomBankSize, 0xFF);
+  std::copy(image.begin(), image.end(), padded.begin());
+  return std::make_shared<const std::vector<uint8_t>>(std::move(padded));
+}
+
+void Cartridge::load(Image image) {
+  rom = std::move(image);
+  slot = SharedPage<kSlotSize>();
+
+  controller = controllerOf((*rom)[0x0147]);
+  uint8_t ramCode = (*rom)[0x0149];
+  uint32_t ramSize = ramCode < 6 ? kRamSizes[ramCode] : 0;
+  // 2 KB chips are rounded up to a full bank
+  ram.fill(SharedPage<kRamBankSize>());
+  ramBanks = static_cast<uint8_t>((ramSize + kRamBankSize - 1) / kRamBankSize);
+  loaded = true;
+
+  ramEnabled = false;
+  romSelect = 1;
+  ramSelect = 0;
+  advancedBanking = false;
+}
+
+bool Cartridge::writeControl(uint16_t address, uint8_t value) {
+  if (!loaded) {
+    // Empty slot: the ROM area is plain storage, mapped for writing once
+    // this cartridge has its own copy
+    bool shared = slot.isShared();
+    slot.unshare(resource)[address] = value;
+    return shared;
+  }
+
+  uint16_t romBefore = highBank();
+  uint16_t lowBefore = lowBank();
+  int ramBefore = ramIndex();
+  switch (controller) {
+    case Controller::None:
+      return false;
+    case Controller::MBC1:
+      if (address < 0x2000) {
+        ramEnabled = (value & 0x0F) == 0x0A;
+      } else if (address < 0x4000) {
+        romSelect = (romSelect & 0x60) | std::max(value & 0x1F, 1);
+      } else if (address < 0x6000) {
+        romSelect = (romSelect & 0x1F) | ((value & 0x03) << 5);
+        ramSelect = value & 0x03;
+      } else {
+        advancedBanking = value & 0x01;
+      }
+      break;
+    case Controller::MBC3:
+      if (address < 0x2000) {
+        ramEnabled = (value & 0x0F) == 0x0A;
+      } else if (address < 0x4000) {
+        romSelect = std::max(value & 0x7F, 1);
+      } else if (address < 0x6000) {
+        ramSelect = value;  // 08-0C select the (unemulated) RTC registers
+      }
+      break;
+    case Controller::MBC5:
+      if (address < 0x2000) {
+        ramEnabled = (value & 0x0F) == 0x0A;
+      } else if (address < 0x3000) {
+        romSelect = (romSelect & 0x100) | value;
+      } else if (address < 0x4000) {
+        romSelect = (romSelect & 0xFF) | ((value & 0x01) << 8);
+      } else if (address < 0x6000) {
+        ramSelect = value & 0x0F;
+      }
+      break;
+  }
+  return highBank() != romBefore || lowBank() != lowBefore ||
+         ramIndex() != ramBefore;
+}
+
+void Cartridge::unshare() {
+  if (!loaded) {
+    slot.unshare(resource);
+  }
+  for (uint8_t bank = 0; bank < ramBanks; bank++) {
+    ram[bank].unshare(resource);
+  }
+}
+
+/**
+ * @brief Returns the index of the mapped RAM bank, or -1 while RAM is
+ * disabled or absent.
+ */
+int Cartridge::ramIndex() const {
+  if (!ramEnabled || ramBanks == 0) {
+    return -1;
+  }
+  uint8_t bank = ramSelect;
+  if (controller == Controller::MBC1 && !advancedBanking) {
+    bank = 0;
+  } else if (controller == Controller::MBC3 && ramSelect > 0x03) {
+    return -1;
+  }
+  return bank % ramBanks;
+}
+
+uint16_t Cartridge::highBank() const {
+  uint16_t mask = romBanks() - 1;
+  if (!loaded || controller == Controller::None) {
+    return 1;
+  }
+  return romSelect & mask;
+}
+
+uint16_t Cartridge::lowBank() const {
+  uint16_t mask = romBanks() - 1;
+  if (controller == Controller::MBC1 && advancedBanking) {
+    return (romSelect & 0x60) & mask;
+  }
+  return 0;
+}
+
+uint64_t Cartridge::hash() const {
+  uint64_t hash = fnv1a(romData(), romBanks() * kRomBankSize);
+  for (uint8_t bank = 0; bank < ramBanks; bank++) {
+    hash = fnv1a(ram[bank].data(), kRamBankSize, hash);
+  }
+  uint64_t registers = ramEnabled | (advancedBanking << 1) |
+                       (ramSelect << 8) | (romSelect << 16);
+  return fnv1aValue(registers, hash);
+}
+
+void Cartridge::saveState(StateWriter &out) const {
+  out.write<uint8_t>(loaded);
+  if (loaded) {
+    out.write(fnv1a(rom->data(), rom->size()));
+  } else {
+    out.write(slot.data(), kSlotSize);
+  }
+  out.write(ramBanks);
+  for (uint8_t bank = 0; bank < ramBanks; bank++) {
+    out.write(ram[bank].data(), kRamBankSize);
+  }
+  out.write<uint8_t>(ramEnabled);
+  out.write(romSelect);
+  out.write(ramSelect);
+  out.write<uint8_t>(advancedBanking);
+}
+
+/**
+ * @brief Restores the RAM and bank registers. Banks of zeros go back to
+ * the shared zero page rather than being allocated.
+ */
+bool Cartridge::loadState(StateReader &in) {
+  if (in.read<uint8_t>() != loaded) {
+    return false;
+  }
+  if (loaded) {
+    if (in.read<uint64_t>() != fnv1a(rom->data(), rom->size())) {
+      return false;
+    }
+  } else if (const uint8_t *bytes = in.take(kSlotSize)) {
+    std::copy(bytes, bytes + kSlotSize, slot.unshare(resource));
+  }
+  if (in.read<uint8_t>() != ramBanks) {
+    return false;
+  }
+  for (uint8_t bank = 0; bank < ramBanks; bank++) {
+    const uint8_t *bytes = in.take(kRamBankSize);
+    if (!bytes) {
+      return false;
+    }
+    if (std::all_of(bytes, bytes + kRamBankSize,
+                    [](uint8_t byte) { return byte == 0; })) {
+      ram[bank] = SharedPage<kRamBankSize>();
+    } else {
+      std::copy(bytes, bytes + kRamBankSize, ram[bank].unshare(resource));
+    }
+  }
+  ramEnabled = in.read<uint8_t>();
+  romSelect = in.read<uint16_t>();
+  ramSelect = in.read<uint8_t>();
+  advancedBanking = in.read<uint8_t>();
+  return in.ok();
+}
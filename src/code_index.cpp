@@ -0,0 +1,247 @@
+/**
+ * @file code_index.cpp
+ * @brief Implementation of the static ROM analyzer.
+ */
+
+#include "../include/code_index.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <set>
+#include <span>
+#include <tuple>
+#include <utility>
+
+#include "../include/cartridge.hpp"
+#include "../include/disassembler.hpp"
+
+namespace {
+
+constexpr uint16_t kEntryPoint = 0x0100;
+constexpr uint16_t kInterruptVectors[] = {0x40, 0x48, 0x50, 0x58, 0x60};
+constexpr int kUnknownBank = -1;
+
+// Recursive-descent walk over the ROM, remembering which bank is mapped at
+// 4000-7FFF along each path
+class Walker {
+ public:
+  explicit Walker(const std::vector<uint8_t> &rom) : rom(rom) {
+    // Bank numbers wrap at the padded size (see Cartridge::prepare)
+    bankCount = std::bit_ceil(std::max<size_t>(
+        (rom.size() + Cartridge::kRomBankSize - 1) / Cartridge::kRomBankSize,
+        2));
+    uint8_t type = rom.size() > 0x0147 ? rom[0x0147] : 0;
+    controller = Cartridge::controllerOf(type);
+  }
+
+  void run() {
+    // At power-on the controller maps bank 1; interrupts can come at any
+    // time, with any bank
+    push({0, kEntryPoint}, 1);
+    for (uint16_t vector : kInterruptVectors) {
+      push({0, vector}, kUnknownBank);
+    }
+    while (!work.empty()) {
+      auto [location, bank] = work.back();
+      work.pop_back();
+      walk(location, bank);
+    }
+  }
+
+  CodeIndex result() const {
+    CodeIndex index;
+    for (RomLocation leader : leaders) {
+      if (decoded.count(leader)) {
+        index.blocks.push_back(buildBlock(leader));
+      }
+    }
+    index.branchTargets.assign(targets.begin(), targets.end());
+    index.bankedCalls = bankedCalls;
+    std::sort(index.bankedCalls.begin(), index.bankedCalls.end(),
+              [](const BankedCall &a, const BankedCall &b) {
+                return std::tie(a.site, a.target) < std::tie(b.site, b.target);
+              });
+    index.unresolved.assign(unresolved.begin(), unresolved.end());
+    return index;
+  }
+
+ private:
+  void push(RomLocation location, int bank) {
+    leaders.insert(location);
+    if (!decoded.count(location)) {
+      work.emplace_back(location, bank);
+    }
+  }
+
+  // The image offset of a location, or the image size if it is outside
+  size_t offsetOf(RomLocation location) const {
+    return std::min(romOffset(location), rom.size());
+  }
+
+  // The ROM location of an address given the mapped bank, if it has one
+  bool locate(uint16_t address, int bank, RomLocation &location) const {
+    if (address < Cartridge::kRomBankSize) {
+      location = {0, address};
+      return true;
+    }
+    if (address < 0x8000 && bank != kUnknownBank) {
+      location = {static_cast<uint16_t>(bank), address};
+      return true;
+    }
+    return false;  // RAM, or an unknown bank
+  }
+
+  // The bank a write of `value` to 2000-3FFF maps at 4000-7FFF
+  int selectBank(uint8_t value) const {
+    int bank;
+    switch (controller) {
+      case Cartridge::Controller::None:
+        return 1;
+      case Cartridge::Controller::MBC1:
+        bank = std::max(value & 0x1F, 1);
+        break;
+      case Cartridge::Controller::MBC3:
+        bank = std::max(value & 0x7F, 1);
+        break;
+      default:
+        bank = value;
+        break;
+    }
+    return bank % static_cast<int>(bankCount);
+  }
+
+  void walk(RomLocation location, int bank) {
+    int constantA = -1;  // A after an `LD A,n8` just before
+    while (!decoded.count(location)) {
+      size_t offset = offsetOf(location);
+      if (offset >= rom.size()) {
+        return;
+      }
+      std::span<const uint8_t> code(rom.data() + offset,
+                                    std::min<size_t>(3, rom.size() - offset));
+      Instruction instruction = decodeInstruction(code, location.address);
+      decoded.emplace(location, instruction);
+
+      bool plain = !instruction.prefixed;
+      if (plain && instruction.opcode == 0xEA && constantA >= 0 &&
+          instruction.operand >= 0x2000 && instruction.operand < 0x4000) {
+        bank = selectBank(static_cast<uint8_t>(constantA));
+      }
+      constantA = plain && instruction.opcode == 0x3E ? instruction.operand
+                                                      : -1;
+
+      follow(location, instruction, bank);
+
+      Flow flow = instruction.flow;
+      uint32_t next = location.address + instruction.length;
+      bool fallsThrough = flow == Flow::Next || flow == Flow::Branch ||
+                          flow == Flow::Call || flow == Flow::ReturnIf;
+      // Bank 0 code does not run on into the switchable bank
+      if (!fallsThrough || next >= 0x8000 ||
+          (location.address < Cartridge::kRomBankSize &&
+           next >= Cartridge::kRomBankSize)) {
+        return;
+      }
+      if (flow == Flow::Call && location.address < Cartridge::kRomBankSize) {
+        bank = kUnknownBank;  // The callee may have switched
+      }
+      location.address = static_cast<uint16_t>(next);
+      if (endsBlock(flow)) {
+        push(location, bank);
+        return;
+      }
+    }
+  }
+
+  // Records and queues the target of a jump or call
+  void follow(RomLocation site, const Instruction &instruction, int bank) {
+    if (instruction.flow == Flow::JumpIndirect) {
+      unresolved.insert(site);
+    }
+    if (!instruction.hasTarget) {
+      return;
+    }
+    RomLocation target;
+    if (!locate(instruction.target, bank, target)) {
+      unresolved.insert(site);
+      return;
+    }
+    resolved[site] = target;
+    targets.insert(target);
+    if (target.address >= Cartridge::kRomBankSize &&
+        site.address < Cartridge::kRomBankSize && instruction.length == 3) {
+      bankedCalls.push_back({site, target});
+    }
+    push(target, bank);
+  }
+
+  BasicBlock buildBlock(RomLocation start) const {
+    BasicBlock block;
+    block.start = start;
+    RomLocation location = start;
+    while (true) {
+      const Instruction &instruction = decoded.at(location);
+      block.size += instruction.length;
+      block.instructions++;
+      block.exit = instruction.flow;
+
+      RomLocation next{location.bank,
+                       static_cast<uint16_t>(location.address +
+                                             instruction.length)};
+      bool fallsThrough = decoded.count(next) != 0;
+      if (!endsBlock(instruction.flow) && fallsThrough &&
+          !leaders.count(next)) {
+        location = next;
+        continue;
+      }
+
+      if (auto target = resolved.find(location); target != resolved.end()) {
+        block.successors.push_back(target->second);
+      }
+      Flow flow = instruction.flow;
+      if (fallsThrough && flow != Flow::Jump && flow != Flow::Return &&
+          flow != Flow::JumpIndirect && flow != Flow::Invalid) {
+        block.successors.push_back(next);
+      }
+      return block;
+    }
+  }
+
+  const std::vector<uint8_t> &rom;
+  size_t bankCount = 2;
+  Cartridge::Controller controller = Cartridge::Controller::None;
+
+  std::vector<std::pair<RomLocation, int>> work;
+  std::map<RomLocation, Instruction> decoded;
+  std::set<RomLocation> leaders;
+  std::map<RomLocation, RomLocation> resolved;
+  std::set<RomLocation> targets;
+  std::set<RomLocation> unresolved;
+  std::vector<BankedCall> bankedCalls;
+};
+
+}  // namespace
+
+const BasicBlock *CodeIndex::findBlock(RomLocation location) const {
+  auto after = std::upper_bound(
+      blocks.begin(), blocks.end(), location,
+      [](RomLocation value, const BasicBlock &block) {
+        return value < block.start;
+      });
+  if (after == blocks.begin()) {
+    return nullptr;
+  }
+  const BasicBlock &block = *(after - 1);
+  if (block.start.bank != location.bank ||
+      location.address >= block.start.address + block.size) {
+    return nullptr;
+  }
+  return &block;
+}
+
+CodeIndex buildCodeIndex(const std::vector<uint8_t> &rom) {
+  Walker walker(rom);
+  walker.run();
+  return walker.result();
+}
@@ -0,0 +1,232 @@
+/**
+ * @file conformance.cpp
+ * @brief Implementation of the test-ROM conformance runner.
+ */
+
+#include "../include/conformance.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "../include/gameboy.hpp"
+#include "../include/parallel.hpp"
+#include "../include/serial.hpp"
+
+namespace {
+
+// Blargg's signature in cartridge RAM, at A001-A003
+constexpr uint8_t kBlarggSignature[] = {0xDE, 0xB0, 0x61};
+constexpr uint8_t kBlarggRunning = 0x80;
+
+// Mooneye's result registers, in the order B, C, D, E, H, L
+constexpr uint8_t kMooneyePass[] = {3, 5, 8, 13, 21, 34};
+constexpr uint8_t kMooneyeFail[] = {0x42, 0x42, 0x42, 0x42, 0x42, 0x42};
+
+/**
+ * @brief Looks for a reported result, filling in the verdict and output.
+ *
+ * @return True once the ROM has reported.
+ */
+bool checkResult(const GameBoy &gameboy, const SerialLog &serial,
+                 ConformanceResult &result) {
+  const std::string &text = serial.output();
+  if (text.find("Passed") != std::string::npos ||
+      text.find("Failed") != std::string::npos) {
+    result.verdict = text.find("Failed") == std::string::npos ? Verdict::Pass
+                                                              : Verdict::Fail;
+    result.output = text;
+    return true;
+  }
+
+  const CPU &cpu = gameboy.cpu;
+  const uint8_t registers[] = {cpu.B, cpu.C, cpu.D, cpu.E, cpu.H, cpu.L};
+  if (std::ranges::equal(registers, kMooneyePass) ||
+      std::ranges::equal(registers, kMooneyeFail)) {
+    result.verdict = registers[0] == kMooneyePass[0] ? Verdict::Pass
+                                                     : Verdict::Fail;
+    result.output = text;
+    return true;
+  }
+
+  const Memory &memory = gameboy.memory;
+  for (uint16_t i = 0; i < std::size(kBlarggSignature); i++) {
+    if (memory.peek(0xA001 + i) != kBlarggSignature[i]) {
+      return false;
+    }
+  }
+  uint8_t status = memory.peek(0xA000);
+  if (status == kBlarggRunning) {
+    return false;
+  }
+  result.verdict = status == 0 ? Verdict::Pass : Verdict::Fail;
+  result.output.clear();
+  for (uint16_t address = 0xA004; address < 0xC000; address++) {
+    uint8_t byte = memory.peek(address);
+    if (!byte) {
+      break;
+    }
+    result.output += static_cast<char>(byte);
+  }
+  return true;
+}
+
+ConformanceResult runTestFile(const std::string &path, uint64_t cycleBudget) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    ConformanceResult result;
+    result.output = "could not read " + path;
+    return result;
+  }
+  std::vector<uint8_t> rom(std::istreambuf_iterator<char>(file), {});
+  return runTestRom(rom, cycleBudget);
+}
+
+// Escapes text for an XML attribute or element; control characters other
+// than tab and newline, which XML cannot carry, are written as \xNN
+std::string escapeXml(const std::string &text) {
+  std::string escaped;
+  for (char c : text) {
+    switch (c) {
+      case '&':
+        escaped += "&amp;";
+        break;
+      case '<':
+        escaped += "&lt;";
+        break;
+      case '>':
+        escaped += "&gt;";
+        break;
+      case '"':
+        escaped += "&quot;";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20 && c != '\n' && c != '\t') {
+          char hex[5];
+          std::snprintf(hex, sizeof(hex), "\\x%02X",
+                        static_cast<unsigned char>(c));
+          escaped += hex;
+        } else {
+          escaped += c;
+        }
+    }
+  }
+  return escaped;
+}
+
+}  // namespace
+
+const char *verdictName(Verdict verdict) {
+  switch (verdict) {
+    case Verdict::Pass:
+      return "pass";
+    case Verdict::Fail:
+      return "fail";
+    case Verdict::Timeout:
+      return "timeout";
+    case Verdict::Error:
+      return "error";
+  }
+  return "error";
+}
+
+ConformanceResult runTestRom(const std::vector<uint8_t> &rom,
+                             uint64_t cycleBudget) {
+  auto start = std::chrono::steady_clock::now();
+  ConformanceResult result;
+  result.verdict = Verdict::Timeout;
+
+  GameBoy gameboy;
+  gameboy.loadRom(rom);
+  SerialLog serial;
+  gameboy.memory.io.connectSerial(&serial);
+  bool reported = false;
+  while (!reported && gameboy.cpu.cycles < cycleBudget) {
+    uint64_t remaining = cycleBudget - gameboy.cpu.cycles;
+    gameboy.runCycles(std::min<uint64_t>(PPU::kFrameCycles, remaining));
+    reported = checkResult(gameboy, serial, result);
+  }
+  if (!reported) {
+    result.output = serial.output();
+  }
+  gameboy.memory.io.connectSerial(nullptr);
+
+  result.cycles = gameboy.cpu.cycles;
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
+
+std::vector<std::string> findTestRoms(const std::string &directory) {
+  std::vector<std::string> paths;
+  std::error_code error;
+  for (const std::filesystem::directory_entry &entry :
+       std::filesystem::recursive_directory_iterator(directory, error)) {
+    std::string extension = entry.path().extension().string();
+    if (entry.is_regular_file() &&
+        (extension == ".gb" || extension == ".gbc")) {
+      paths.push_back(entry.path().string());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+std::vector<ConformanceResult> runConformance(
+    const std::string &directory, const std::vector<std::string> &paths,
+    uint64_t cycleBudget, unsigned threads) {
+  std::vector<ConformanceResult> results(paths.size());
+  parallelFor(paths.size(), threads, [&](size_t i) {
+    results[i] = runTestFile(paths[i], cycleBudget);
+    results[i].name = std::filesystem::path(paths[i])
+                          .lexically_relative(directory)
+                          .string();
+  });
+  return results;
+}
+
+void writeJUnit(std::ostream &out,
+                const std::vector<ConformanceResult> &results,
+                double seconds) {
+  size_t failures = 0;
+  size_t errors = 0;
+  for (const ConformanceResult &result : results) {
+    failures += result.verdict == Verdict::Fail ||
+                result.verdict == Verdict::Timeout;
+    errors += result.verdict == Verdict::Error;
+  }
+
+  out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<testsuite name=\"conformance\" tests=\"" << results.size()
+      << "\" failures=\"" << failures << "\" errors=\"" << errors
+      << "\" time=\"" << seconds << "\">\n";
+  for (const ConformanceResult &result : results) {
+    out << "  <testcase classname=\"conformance\" name=\""
+        << escapeXml(result.name) << "\" time=\"" << result.seconds << "\">\n";
+    switch (result.verdict) {
+      case Verdict::Pass:
+        break;
+      case Verdict::Fail:
+        out << "    <failure message=\"reported failure\"/>\n";
+        break;
+      case Verdict::Timeout:
+        out << "    <failure message=\"no result within " << result.cycles
+            << " cycles\"/>\n";
+        break;
+      case Verdict::Error:
+        out << "    <error message=\"" << escapeXml(result.output)
+            << "\"/>\n";
+        break;
+    }
+    if (!result.output.empty() && result.verdict != Verdict::Error) {
+      out << "    <system-out>" << escapeXml(result.output)
+          << "</system-out>\n";
+    }
+    out << "  </testcase>\n";
+  }
+  out << "</testsuite>\n";
+}
@@ -0,0 +1,129 @@
+/**
+ * @file conformance_main.cpp
+ * @brief Conformance runner: runs a directory of test ROMs in parallel and
+ * reports which passed.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../include/conformance.hpp"
+
+namespace {
+
+struct Options {
+  std::string directory;
+  uint64_t maxCycles = kDefaultCycleBudget;
+  unsigned threads = 0;
+  std::string junitPath;
+  std::string knownFailuresPath;
+};
+
+void printUsage(const char *program) {
+  std::cerr << "Usage: " << program << " <rom directory> [options]\n"
+            << "  --max-cycles N      Cycle budget per ROM (default "
+            << kDefaultCycleBudget << ")\n"
+            << "  --threads N         Worker threads (default: all cores)\n"
+            << "  --junit PATH        Write a JUnit XML summary\n"
+            << "  --known-failures PATH\n"
+            << "                      ROMs, one relative path per line, that\n"
+            << "                      are expected not to pass yet\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(arg, "--max-cycles") == 0 && hasValue) {
+      options.maxCycles = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+      options.threads = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--junit") == 0 && hasValue) {
+      options.junitPath = argv[++i];
+    } else if (std::strcmp(arg, "--known-failures") == 0 && hasValue) {
+      options.knownFailuresPath = argv[++i];
+    } else if (arg[0] != '-' && options.directory.empty()) {
+      options.directory = arg;
+    } else {
+      return false;
+    }
+  }
+  return !options.directory.empty();
+}
+
+bool readKnownFailures(const std::string &path, std::set<std::string> &names) {
+  std::ifstream file(path);
+  if (!file) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line[0] != '#') {
+      names.insert(line);
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::set<std::string> knownFailures;
+  if (!options.knownFailuresPath.empty() &&
+      !readKnownFailures(options.knownFailuresPath, knownFailures)) {
+    std::cerr << "Failed to read " << options.knownFailuresPath << "\n";
+    return 1;
+  }
+
+  std::vector<std::string> paths = findTestRoms(options.directory);
+  if (paths.empty()) {
+    std::cerr << "No test ROMs found in " << options.directory << "\n";
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<ConformanceResult> results = runConformance(
+      options.directory, paths, options.maxCycles, options.threads);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  size_t passed = 0;
+  size_t unexpected = 0;
+  for (const ConformanceResult &result : results) {
+    bool known = knownFailures.count(result.name) != 0;
+    if (result.verdict == Verdict::Pass) {
+      passed++;
+    } else if (!known) {
+      unexpected++;
+    }
+    std::cout << verdictName(result.verdict)
+              << (known && result.verdict != Verdict::Pass ? " (known)" : "")
+              << "  " << result.name << "  " << result.cycles << " cycles, "
+              << result.seconds << " s\n";
+  }
+  std::cout << passed << "/" << results.size() << " passed, " << unexpected
+            << " unexpected failures, " << seconds << " s\n";
+
+  if (!options.junitPath.empty()) {
+    std::ofstream out(options.junitPath);
+    writeJUnit(out, results, seconds);
+    if (!out) {
+      std::cerr << "Failed to write " << options.junitPath << "\n";
+      return 1;
+    }
+  }
+  return unexpected ? 1 : 0;
+}
@@ -4,329 +4,595 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <iterator>
+
+#include "../include/hash.hpp"
+#include "../include/opcodes.hpp"
+#include "../include/profiler.hpp"
+#include "../include/save_state.hpp"
+
+namespace {
+
+// Base duration of each primary opcode in T-cycles, packed from the opcode
+// metadata. Conditional jumps, calls and returns list their not-taken
+// duration; the handlers add the rest.
+constexpr std::array<uint8_t, 256> kOpcodeCycles = [] {
+  std::array<uint8_t, 256> cycles{};
+  for (size_t opcode = 0; opcode < cycles.size(); opcode++) {
+    cycles[opcode] = kOpcodes[opcode].cycles;
+  }
+  return cycles;
+}();
+
+// Addresses whose value only changes when the PPU changes mode, which is
+// always a scheduled event, so polling them between events is idempotent
+bool isIdlePollAddress(uint16_t address) {
+  return address == 0xFF41 || address == 0xFF44;  // STAT, LY
+}
+
+}  // namespace
 
-CPU::CPU(Memory &memory) : memory(memory) {
+template <typename Timing>
+BasicCPU<Timing>::BasicCPU(Memory &memory) : memory(memory) {
   // Default all opcodes to NOP to prevent crashes
   opcodeTable.fill([&]() { NOP(); });
 
-  // Map primary opcodes
-  opcodeTable[0x00] = std::bind(&CPU::NOP, this);
-  opcodeTable[0x01] = std::bind(&CPU::LD_r16_n16, this, std::ref(BC()));
-  opcodeTable[0x02] = std::bind(&CPU::LD_HL_r8, this, std::ref(A));
-  opcodeTable[0x03] = std::bind(&CPU::INC_r16, this, std::ref(BC()));
-  opcodeTable[0x04] = std::bind(&CPU::INC_r8, this, std::ref(B));
-  opcodeTable[0x05] = std::bind(&CPU::DEC_r8, this, std::ref(B));
-
-  opcodeTable[0x06] = std::bind(&CPU::LD_r8_n8, this, std::ref(B));
-  opcodeTable[0x07] = std::bind(&CPU::RLCA, this);
-  opcodeTable[0x08] = std::bind(&CPU::LD_n16_SP, this);
-  opcodeTable[0x09] = std::bind(&CPU::ADD_HL_r16, this, std::ref(BC()));
-
-  opcodeTable[0x0A] = std::bind(&CPU::LD_A_r16, this, std::ref(BC()));
-  opcodeTable[0x0B] = std::bind(&CPU::DEC_r16, this, std::ref(BC()));
-  opcodeTable[0x0C] = std::bind(&CPU::INC_r8, this, std::ref(C));
-  opcodeTable[0x0D] = std::bind(&CPU::DEC_r8, this, std::ref(C));
-  opcodeTable[0x0E] = std::bind(&CPU::LD_r8_n8, this, std::ref(C));
-  opcodeTable[0x0F] = std::bind(&CPU::RRCA, this);
-
-  opcodeTable[0x11] = std::bind(&CPU::LD_r16_n16, this, std::ref(DE()));
-  opcodeTable[0x12] = std::bind(&CPU::LD_HL_r8, this, std::ref(A));
-  opcodeTable[0x13] = std::bind(&CPU::INC_r16, this, std::ref(DE()));
-
-  opcodeTable[0x16] = std::bind(&CPU::LD_r8_n8, this, std::ref(D));
-  opcodeTable[0x17] = std::bind(&CPU::RLA, this);
-  opcodeTable[0x18] = std::bind(&CPU::JR_n8, this);
-  opcodeTable[0x19] = std::bind(&CPU::ADD_HL_r16, this, std::ref(DE()));
-  opcodeTable[0x1A] = std::bind(&CPU::LD_A_r16, this, std::ref(DE()));
-  opcodeTable[0x1E] = std::bind(&CPU::LD_r8_n8, this, std::ref(E));
-  opcodeTable[0x1F] = std::bind(&CPU::RRA, this);
-
-  opcodeTable[0x21] = std::bind(&CPU::LD_r16_n16, this, std::ref(HL()));
-  opcodeTable[0x22] =
-      std::bind(&CPU::LD_r16_r8, this, std::ref(HL()), std::ref(A));
-  opcodeTable[0x23] = std::bind(&CPU::INC_r16, this, std::ref(HL()));
-  opcodeTable[0x24] = std::bind(&CPU::INC_r8, this, std::ref(H));
-  opcodeTable[0x25] = std::bind(&CPU::DEC_r8, this, std::ref(H));
-  opcodeTable[0x26] = std::bind(&CPU::LD_r8_n8, this, std::ref(H));
-  opcodeTable[0x27] = std::bind(&CPU::DAA, this);
-  opcodeTable[0x28] = std::bind(&CPU::JR_con_n8, this, true);
-  opcodeTable[0x29] = std::bind(&CPU::ADD_HL_r16, this, std::ref(HL()));
-  opcodeTable[0x2A] = std::bind(&CPU::LD_A_r16, this, std::ref(HL()));
-  opcodeTable[0x2B] = std::bind(&CPU::DEC_r16, this, std::ref(HL()));
-  opcodeTable[0x2C] = std::bind(&CPU::INC_r8, this, std::ref(L));
-  opcodeTable[0x2D] = std::bind(&CPU::DEC_r8, this, std::ref(L));
-  opcodeTable[0x2E] = std::bind(&CPU::LD_r8_n8, this, std::ref(L));
-  opcodeTable[0x2F] = std::bind(&CPU::CPL, this);
-
-  opcodeTable[0x31] = std::bind(&CPU::LD_r16_n16, this, std::ref(SP));
-  opcodeTable[0x32] =
-      std::bind(&CPU::LD_r16_r8, this, std::ref(HL()), std::ref(A));
-  opcodeTable[0x33] = std::bind(&CPU::INC_r16, this, std::ref(SP));
-  opcodeTable[0x34] = std::bind(&CPU::INC_r16, this, std::ref(HL()));
-  opcodeTable[0x35] = std::bind(&CPU::DEC_r16, this, std::ref(HL()));
-  opcodeTable[0x36] = std::bind(&CPU::LD_r16_n8, this, std::ref(HL()));
-  opcodeTable[0x37] = std::bind(&CPU::SCF, this);
-  opcodeTable[0x38] = std::bind(&CPU::JR_con_n8, this, getCarryFlag());
-  opcodeTable[0x39] = std::bind(&CPU::ADD_HL_r16, this, std::ref(SP));
-  opcodeTable[0x3A] = std::bind(&CPU::LD_A_r16, this, std::ref(HL()));
-  opcodeTable[0x3D] = std::bind(&CPU::DEC_r8, this, std::ref(A));
-  opcodeTable[0x3E] = std::bind(&CPU::LD_r8_n8, this, std::ref(A));
-  opcodeTable[0x3F] = std::bind(&CPU::CCF, this);
-
-  opcodeTable[0x40] = std::bind(&CPU::LD_r8_r8, this, std::ref(B), std::ref(B));
-  opcodeTable[0x41] = std::bind(&CPU::LD_r8_r8, this, std::ref(B), std::ref(C));
-  opcodeTable[0x42] = std::bind(&CPU::LD_r8_r8, this, std::ref(B), std::ref(D));
-  opcodeTable[0x43] = std::bind(&CPU::LD_r8_r8, this, std::ref(B), std::ref(E));
-  opcodeTable[0x44] = std::bind(&CPU::LD_r8_r8, this, std::ref(B), std::ref(H));
-  opcodeTable[0x45] = std::bind(&CPU::LD_r8_r8, this, std::ref(B), std::ref(L));
-  opcodeTable[0x46] =
-      std::bind(&CPU::LD_r8_r16, this, std::ref(B), std::ref(HL()));
-  opcodeTable[0x47] = std::bind(&CPU::LD_r8_r8, this, std::ref(B), std::ref(A));
-
-  opcodeTable[0x48] = std::bind(&CPU::LD_r8_r8, this, std::ref(C), std::ref(B));
-  opcodeTable[0x49] = std::bind(&CPU::LD_r8_r8, this, std::ref(C), std::ref(C));
-  opcodeTable[0x4A] = std::bind(&CPU::LD_r8_r8, this, std::ref(C), std::ref(D));
-  opcodeTable[0x4B] = std::bind(&CPU::LD_r8_r8, this, std::ref(C), std::ref(E));
-  opcodeTable[0x4C] = std::bind(&CPU::LD_r8_r8, this, std::ref(C), std::ref(H));
-  opcodeTable[0x4D] = std::bind(&CPU::LD_r8_r8, this, std::ref(C), std::ref(L));
-  opcodeTable[0x4E] =
-      std::bind(&CPU::LD_r8_r16, this, std::ref(C), std::ref(HL()));
-  opcodeTable[0x4F] = std::bind(&CPU::LD_r8_r8, this, std::ref(C), std::ref(A));
-
-  opcodeTable[0x50] = std::bind(&CPU::LD_r8_r8, this, std::ref(D), std::ref(B));
-  opcodeTable[0x51] = std::bind(&CPU::LD_r8_r8, this, std::ref(D), std::ref(C));
-  opcodeTable[0x52] = std::bind(&CPU::LD_r8_r8, this, std::ref(D), std::ref(D));
-  opcodeTable[0x53] = std::bind(&CPU::LD_r8_r8, this, std::ref(D), std::ref(E));
-  opcodeTable[0x54] = std::bind(&CPU::LD_r8_r8, this, std::ref(D), std::ref(H));
-  opcodeTable[0x55] = std::bind(&CPU::LD_r8_r8, this, std::ref(D), std::ref(L));
-  opcodeTable[0x56] =
-      std::bind(&CPU::LD_r8_r16, this, std::ref(D), std::ref(HL()));
-  opcodeTable[0x57] = std::bind(&CPU::LD_r8_r8, this, std::ref(D), std::ref(A));
-
-  opcodeTable[0x58] = std::bind(&CPU::LD_r8_r8, this, std::ref(E), std::ref(B));
-  opcodeTable[0x59] = std::bind(&CPU::LD_r8_r8, this, std::ref(E), std::ref(C));
-  opcodeTable[0x5A] = std::bind(&CPU::LD_r8_r8, this, std::ref(E), std::ref(D));
-  opcodeTable[0x5B] = std::bind(&CPU::LD_r8_r8, this, std::ref(E), std::ref(E));
-  opcodeTable[0x5C] = std::bind(&CPU::LD_r8_r8, this, std::ref(E), std::ref(H));
-  opcodeTable[0x5D] = std::bind(&CPU::LD_r8_r8, this, std::ref(E), std::ref(L));
-  opcodeTable[0x5E] =
-      std::bind(&CPU::LD_r8_r16, this, std::ref(E), std::ref(HL()));
-  opcodeTable[0x5F] = std::bind(&CPU::LD_r8_r8, this, std::ref(E), std::ref(A));
-
-  opcodeTable[0x60] = std::bind(&CPU::LD_r8_r8, this, std::ref(H), std::ref(B));
-  opcodeTable[0x61] = std::bind(&CPU::LD_r8_r8, this, std::ref(H), std::ref(C));
-  opcodeTable[0x62] = std::bind(&CPU::LD_r8_r8, this, std::ref(H), std::ref(D));
-  opcodeTable[0x63] = std::bind(&CPU::LD_r8_r8, this, std::ref(H), std::ref(E));
-  opcodeTable[0x64] = std::bind(&CPU::LD_r8_r8, this, std::ref(H), std::ref(H));
-  opcodeTable[0x65] = std::bind(&CPU::LD_r8_r8, this, std::ref(H), std::ref(L));
-  opcodeTable[0x66] =
-      std::bind(&CPU::LD_r8_r16, this, std::ref(H), std::ref(HL()));
-  opcodeTable[0x67] = std::bind(&CPU::LD_r8_r8, this, std::ref(H), std::ref(A));
-
-  opcodeTable[0x68] = std::bind(&CPU::LD_r8_r8, this, std::ref(L), std::ref(B));
-  opcodeTable[0x69] = std::bind(&CPU::LD_r8_r8, this, std::ref(L), std::ref(C));
-  opcodeTable[0x6A] = std::bind(&CPU::LD_r8_r8, this, std::ref(L), std::ref(D));
-  opcodeTable[0x6B] = std::bind(&CPU::LD_r8_r8, this, std::ref(L), std::ref(E));
-  opcodeTable[0x6C] = std::bind(&CPU::LD_r8_r8, this, std::ref(L), std::ref(H));
-  opcodeTable[0x6D] = std::bind(&CPU::LD_r8_r8, this, std::ref(L), std::ref(L));
-  opcodeTable[0x6E] =
-      std::bind(&CPU::LD_r8_r16, this, std::ref(L), std::ref(HL()));
-  opcodeTable[0x6F] = std::bind(&CPU::LD_r8_r8, this, std::ref(L), std::ref(A));
-
-  opcodeTable[0x70] =
-      std::bind(&CPU::LD_r16_r8, this, std::ref(HL()), std::ref(B));
-  opcodeTable[0x71] =
-      std::bind(&CPU::LD_r16_r8, this, std::ref(HL()), std::ref(C));
-  opcodeTable[0x72] =
-      std::bind(&CPU::LD_r16_r8, this, std::ref(HL()), std::ref(D));
-  opcodeTable[0x73] =
-      std::bind(&CPU::LD_r16_r8, this, std::ref(HL()), std::ref(E));
-  opcodeTable[0x74] =
-      std::bind(&CPU::LD_r16_r8, this, std::ref(HL()), std::ref(H));
-  opcodeTable[0x75] =
-      std::bind(&CPU::LD_r16_r8, this, std::ref(HL()), std::ref(L));
-  opcodeTable[0x76] = std::bind(&CPU::HALT, this);  // ToDo: Implement HALT
-  opcodeTable[0x77] =
-      std::bind(&CPU::LD_r16_r8, this, std::ref(HL()), std::ref(A));
-
-  opcodeTable[0x78] = std::bind(&CPU::LD_r8_r8, this, std::ref(A), std::ref(B));
-  opcodeTable[0x79] = std::bind(&CPU::LD_r8_r8, this, std::ref(A), std::ref(C));
-  opcodeTable[0x7A] = std::bind(&CPU::LD_r8_r8, this, std::ref(A), std::ref(D));
-  opcodeTable[0x7B] = std::bind(&CPU::LD_r8_r8, this, std::ref(A), std::ref(E));
-  opcodeTable[0x7C] = std::bind(&CPU::LD_r8_r8, this, std::ref(A), std::ref(H));
-  opcodeTable[0x7D] = std::bind(&CPU::LD_r8_r8, this, std::ref(A), std::ref(L));
-  opcodeTable[0x7E] =
-      std::bind(&CPU::LD_r8_r16, this, std::ref(A), std::ref(HL()));
-  opcodeTable[0x7F] = std::bind(&CPU::LD_r8_r8, this, std::ref(A), std::ref(A));
-  opcodeTable[0x80] = std::bind(&CPU::ADD_A_r8, this, std::ref(B));
-  opcodeTable[0x81] = std::bind(&CPU::ADD_A_r8, this, std::ref(C));
-  opcodeTable[0x82] = std::bind(&CPU::ADD_A_r8, this, std::ref(D));
-  opcodeTable[0x83] = std::bind(&CPU::ADD_A_r8, this, std::ref(E));
-  opcodeTable[0x84] = std::bind(&CPU::ADD_A_r8, this, std::ref(H));
-  opcodeTable[0x85] = std::bind(&CPU::ADD_A_r8, this, std::ref(L));
-
-  opcodeTable[0x86] = std::bind(&CPU::ADD_A_r16, this, std::ref(HL()));
-  opcodeTable[0x87] = std::bind(&CPU::ADD_A_r8, this, std::ref(A));
-  opcodeTable[0x88] = std::bind(&CPU::ADC_A_r8, this, std::ref(B));
-  opcodeTable[0x89] = std::bind(&CPU::ADC_A_r8, this, std::ref(C));
-  opcodeTable[0x8A] = std::bind(&CPU::ADC_A_r8, this, std::ref(D));
-  opcodeTable[0x8B] = std::bind(&CPU::ADC_A_r8, this, std::ref(E));
-  opcodeTable[0x8C] = std::bind(&CPU::ADC_A_r8, this, std::ref(H));
-  opcodeTable[0x8D] = std::bind(&CPU::ADC_A_r8, this, std::ref(L));
-  opcodeTable[0x8E] = std::bind(&CPU::ADC_A_r16, this, std::ref(HL()));
-  opcodeTable[0x8F] = std::bind(&CPU::ADC_A_r8, this, std::ref(A));
-
-  opcodeTable[0x90] = std::bind(&CPU::SUB_A_r8, this, std::ref(B));
-  opcodeTable[0x91] = std::bind(&CPU::SUB_A_r8, this, std::ref(C));
-  opcodeTable[0x92] = std::bind(&CPU::SUB_A_r8, this, std::ref(D));
-  opcodeTable[0x93] = std::bind(&CPU::SUB_A_r8, this, std::ref(E));
-  opcodeTable[0x94] = std::bind(&CPU::SUB_A_r8, this, std::ref(H));
-  opcodeTable[0x95] = std::bind(&CPU::SUB_A_r8, this, std::ref(L));
-  opcodeTable[0x96] = std::bind(&CPU::SUB_A_r16, this, std::ref(HL()));
-  opcodeTable[0x97] = std::bind(&CPU::SUB_A_r8, this, std::ref(A));
-
-  opcodeTable[0x98] = std::bind(&CPU::SBC_A_r8, this, std::ref(B));
-  opcodeTable[0x99] = std::bind(&CPU::SBC_A_r8, this, std::ref(C));
-  opcodeTable[0x9A] = std::bind(&CPU::SBC_A_r8, this, std::ref(D));
-  opcodeTable[0x9B] = std::bind(&CPU::SBC_A_r8, this, std::ref(E));
-  opcodeTable[0x9C] = std::bind(&CPU::SBC_A_r8, this, std::ref(H));
-  opcodeTable[0x9D] = std::bind(&CPU::SBC_A_r8, this, std::ref(L));
-  opcodeTable[0x9E] = std::bind(&CPU::SBC_A_r16, this, std::ref(HL()));
-  opcodeTable[0x9F] = std::bind(&CPU::SBC_A_r8, this, std::ref(A));
-
-  opcodeTable[0xA0] = std::bind(&CPU::AND_A_r8, this, std::ref(B));
-  opcodeTable[0xA1] = std::bind(&CPU::AND_A_r8, this, std::ref(C));
-  opcodeTable[0xA2] = std::bind(&CPU::AND_A_r8, this, std::ref(D));
-  opcodeTable[0xA3] = std::bind(&CPU::AND_A_r8, this, std::ref(E));
-  opcodeTable[0xA4] = std::bind(&CPU::AND_A_r8, this, std::ref(H));
-  opcodeTable[0xA5] = std::bind(&CPU::AND_A_r8, this, std::ref(L));
-  opcodeTable[0xA6] = std::bind(&CPU::AND_A_r16, this, std::ref(HL()));
-  opcodeTable[0xA7] = std::bind(&CPU::AND_A_r8, this, std::ref(A));
-
-  opcodeTable[0xA8] = std::bind(&CPU::XOR_A_r8, this, std::ref(B));
-  opcodeTable[0xA9] = std::bind(&CPU::XOR_A_r8, this, std::ref(C));
-  opcodeTable[0xAA] = std::bind(&CPU::XOR_A_r8, this, std::ref(D));
-  opcodeTable[0xAB] = std::bind(&CPU::XOR_A_r8, this, std::ref(E));
-  opcodeTable[0xAC] = std::bind(&CPU::XOR_A_r8, this, std::ref(H));
-  opcodeTable[0xAD] = std::bind(&CPU::XOR_A_r8, this, std::ref(L));
-  opcodeTable[0xAE] = std::bind(&CPU::XOR_A_r16, this, std::ref(HL()));
-  opcodeTable[0xAF] = std::bind(&CPU::XOR_A_r8, this, std::ref(A));
-
-  opcodeTable[0xB0] = std::bind(&CPU::OR_A_r8, this, std::ref(B));
-  opcodeTable[0xB1] = std::bind(&CPU::OR_A_r8, this, std::ref(C));
-  opcodeTable[0xB2] = std::bind(&CPU::OR_A_r8, this, std::ref(D));
-  opcodeTable[0xB3] = std::bind(&CPU::OR_A_r8, this, std::ref(E));
-  opcodeTable[0xB4] = std::bind(&CPU::OR_A_r8, this, std::ref(H));
-  opcodeTable[0xB5] = std::bind(&CPU::OR_A_r8, this, std::ref(L));
-  opcodeTable[0xB6] = std::bind(&CPU::OR_A_r16, this, std::ref(HL()));
-  opcodeTable[0xB7] = std::bind(&CPU::OR_A_r8, this, std::ref(A));
-
-  opcodeTable[0xB8] = std::bind(&CPU::CP_A_r8, this, std::ref(B));
-  opcodeTable[0xB9] = std::bind(&CPU::CP_A_r8, this, std::ref(C));
-  opcodeTable[0xBA] = std::bind(&CPU::CP_A_r8, this, std::ref(D));
-  opcodeTable[0xBB] = std::bind(&CPU::CP_A_r8, this, std::ref(E));
-  opcodeTable[0xBC] = std::bind(&CPU::CP_A_r8, this, std::ref(H));
-  opcodeTable[0xBD] = std::bind(&CPU::CP_A_r8, this, std::ref(L));
-  opcodeTable[0xBE] = std::bind(&CPU::CP_A_r16, this, std::ref(HL()));
-  opcodeTable[0xBF] = std::bind(&CPU::CP_A_r8, this, std::ref(A));
-
-  opcodeTable[0xC0] = std::bind(&CPU::RET_con, this, !getZeroFlag());
-  opcodeTable[0xC1] = std::bind(&CPU::POP_r16, this, std::ref(BC()));
-  opcodeTable[0xC2] = std::bind(&CPU::JP_con_n16, this, !getZeroFlag());
-  opcodeTable[0xC3] = std::bind(&CPU::JP_n16, this);
-  opcodeTable[0xC4] = std::bind(&CPU::CALL_con_n16, this, !getZeroFlag());
-  opcodeTable[0xC5] = std::bind(&CPU::PUSH_r16, this, std::ref(BC()));
-  opcodeTable[0xC6] = std::bind(&CPU::ADD_A_n8, this);
-  opcodeTable[0xC7] = std::bind(&CPU::RST, this, 0x00);
-  opcodeTable[0xC8] = std::bind(&CPU::RET_con, this, getZeroFlag());
-  opcodeTable[0xC9] = std::bind(&CPU::RET, this);
-  opcodeTable[0xCA] = std::bind(&CPU::JP_con_n16, this, getZeroFlag());
-  // opcodeTable[0xCB] = std::bind(&CPU::PREFIX, this);
-  opcodeTable[0xCC] = std::bind(&CPU::CALL_con_n16, this, getZeroFlag());
-  opcodeTable[0xCD] = std::bind(&CPU::CALL_n16, this);
-  opcodeTable[0xCE] = std::bind(&CPU::ADC_A_n8, this);
-  opcodeTable[0xCF] = std::bind(&CPU::RST, this, 0x08);
-  opcodeTable[0xD0] = std::bind(&CPU::RET_con, this, !getCarryFlag());
-  opcodeTable[0xD1] = std::bind(&CPU::POP_r16, this, std::ref(DE()));
-  opcodeTable[0xD2] = std::bind(&CPU::JP_con_n16, this, !getCarryFlag());
-  opcodeTable[0xD4] = std::bind(&CPU::CALL_con_n16, this, !getCarryFlag());
-  opcodeTable[0xD5] = std::bind(&CPU::PUSH_r16, this, std::ref(DE()));
-  opcodeTable[0xD6] = std::bind(&CPU::SUB_A_n8, this);
-  opcodeTable[0xD7] = std::bind(&CPU::RST, this, 0x10);
-  opcodeTable[0xD8] = std::bind(&CPU::RET_con, this, getCarryFlag());
-  opcodeTable[0xD9] = std::bind(&CPU::RETI, this);
-  opcodeTable[0xDA] = std::bind(&CPU::JP_con_n16, this, getCarryFlag());
-  opcodeTable[0xDC] = std::bind(&CPU::CALL_con_n16, this, getCarryFlag());
-  opcodeTable[0xDE] = std::bind(&CPU::SBC_A_n8, this);
-  opcodeTable[0xDF] = std::bind(&CPU::RST, this, 0x18);
-  opcodeTable[0xE0] = std::bind(&CPU::LDH_n8_A, this);
-  opcodeTable[0xE1] = std::bind(&CPU::POP_r16, this, std::ref(HL()));
-  opcodeTable[0xE2] = std::bind(&CPU::LDH_C_A, this);
-  opcodeTable[0xE5] = std::bind(&CPU::PUSH_r16, this, std::ref(HL()));
-  opcodeTable[0xE6] = std::bind(&CPU::AND_A_n8, this);
-  opcodeTable[0xE7] = std::bind(&CPU::RST, this, 0x20);
-  opcodeTable[0xE8] = std::bind(&CPU::ADD_SP_n8, this);
-  opcodeTable[0xE9] = std::bind(&CPU::JP_HL, this);
-  opcodeTable[0xEA] = std::bind(&CPU::LD_n16_A, this);
-  opcodeTable[0xEE] = std::bind(&CPU::XOR_A_n8, this);
-  opcodeTable[0xEF] = std::bind(&CPU::RST, this, 0x28);
-  opcodeTable[0xF0] = std::bind(&CPU::LDH_A_n8, this);
-  opcodeTable[0xF1] = std::bind(&CPU::POP_r16, this, std::ref(AF()));
-  opcodeTable[0xF2] = std::bind(&CPU::LDH_A_r8, this, std::ref(C));
-  opcodeTable[0xF3] = std::bind(&CPU::DI, this);
-
-  // opcodeTable[0xF4] = std::bind(&CPU::CALL_con_n16, this, false);
-  opcodeTable[0xF5] = std::bind(&CPU::PUSH_r16, this, std::ref(AF()));
-  opcodeTable[0xF6] = std::bind(&CPU::OR_A_n8, this);
-  opcodeTable[0xF7] = std::bind(&CPU::RST, this, 0x30);
-  opcodeTable[0xF8] = std::bind(&CPU::LD_HL_SP_n8, this);
-  opcodeTable[0xF9] = std::bind(&CPU::LD_SP_HL, this);
-  opcodeTable[0xFA] = std::bind(&CPU::LD_A_n16, this);
-  opcodeTable[0xFB] = std::bind(&CPU::EI, this);
-  opcodeTable[0xFE] = std::bind(&CPU::CP_A_n8, this);
-  opcodeTable[0xFF] = std::bind(&CPU::RST, this, 0x38);
-}
-
-void CPU::executeOpcode() {
-  uint8_t opcode = fetchByte();
-  opcodeTable[opcode]();
-}
-
-void CPU::NOP() { /* No operation */ }
-
-uint8_t CPU::fetchByte() { return memory.readByte(PC++); }
-
-uint16_t CPU::fetchWord() {
+  // Map primary opcodes. Conditional opcodes use lambdas so that the flags
+  // are tested when the opcode executes, not when the table is built.
+  opcodeTable[0x00] = [this]() { NOP(); };
+  opcodeTable[0x01] = [this]() { LD_r16_n16(BC()); };
+  opcodeTable[0x02] = [this]() { LD_HL_r8(A); };
+  opcodeTable[0x03] = [this]() { INC_r16(BC()); };
+  opcodeTable[0x04] = [this]() { INC_r8(B); };
+  opcodeTable[0x05] = [this]() { DEC_r8(B); };
+
+  opcodeTable[0x06] = [this]() { LD_r8_n8(B); };
+  opcodeTable[0x07] = [this]() { RLCA(); };
+  opcodeTable[0x08] = [this]() { LD_n16_SP(); };
+  opcodeTable[0x09] = [this]() { ADD_HL_r16(BC()); };
+
+  opcodeTable[0x0A] = [this]() { LD_A_r16(BC()); };
+  opcodeTable[0x0B] = [this]() { DEC_r16(BC()); };
+  opcodeTable[0x0C] = [this]() { INC_r8(C); };
+  opcodeTable[0x0D] = [this]() { DEC_r8(C); };
+  opcodeTable[0x0E] = [this]() { LD_r8_n8(C); };
+  opcodeTable[0x0F] = [this]() { RRCA(); };
+
+  opcodeTable[0x10] = [this]() { STOP(); };
+  opcodeTable[0x11] = [this]() { LD_r16_n16(DE()); };
+  opcodeTable[0x12] = [this]() { LD_HL_r8(A); };
+  opcodeTable[0x13] = [this]() { INC_r16(DE()); };
+
+  opcodeTable[0x16] = [this]() { LD_r8_n8(D); };
+  opcodeTable[0x17] = [this]() { RLA(); };
+  opcodeTable[0x18] = [this]() { JR_n8(); };
+  opcodeTable[0x19] = [this]() { ADD_HL_r16(DE()); };
+  opcodeTable[0x1A] = [this]() { LD_A_r16(DE()); };
+  opcodeTable[0x1E] = [this]() { LD_r8_n8(E); };
+  opcodeTable[0x1F] = [this]() { RRA(); };
+
+  opcodeTable[0x20] = [this]() { JR_con_n8(checkCondition(0x20)); };
+  opcodeTable[0x21] = [this]() { LD_r16_n16(HL()); };
+  opcodeTable[0x22] = [this]() { LD_r16_r8(HL(), A); };
+  opcodeTable[0x23] = [this]() { INC_r16(HL()); };
+  opcodeTable[0x24] = [this]() { INC_r8(H); };
+  opcodeTable[0x25] = [this]() { DEC_r8(H); };
+  opcodeTable[0x26] = [this]() { LD_r8_n8(H); };
+  opcodeTable[0x27] = [this]() { DAA(); };
+  opcodeTable[0x28] = [this]() { JR_con_n8(checkCondition(0x28)); };
+  opcodeTable[0x29] = [this]() { ADD_HL_r16(HL()); };
+  opcodeTable[0x2A] = [this]() { LD_A_r16(HL()); };
+  opcodeTable[0x2B] = [this]() { DEC_r16(HL()); };
+  opcodeTable[0x2C] = [this]() { INC_r8(L); };
+  opcodeTable[0x2D] = [this]() { DEC_r8(L); };
+  opcodeTable[0x2E] = [this]() { LD_r8_n8(L); };
+  opcodeTable[0x2F] = [this]() { CPL(); };
+
+  opcodeTable[0x30] = [this]() { JR_con_n8(checkCondition(0x30)); };
+  opcodeTable[0x31] = [this]() { LD_r16_n16(SP); };
+  opcodeTable[0x32] = [this]() { LD_r16_r8(HL(), A); };
+  opcodeTable[0x33] = [this]() { INC_r16(SP); };
+  opcodeTable[0x34] = [this]() { INC_r16(HL()); };
+  opcodeTable[0x35] = [this]() { DEC_r16(HL()); };
+  opcodeTable[0x36] = [this]() { LD_r16_n8(HL()); };
+  opcodeTable[0x37] = [this]() { SCF(); };
+  opcodeTable[0x38] = [this]() { JR_con_n8(checkCondition(0x38)); };
+  opcodeTable[0x39] = [this]() { ADD_HL_r16(SP); };
+  opcodeTable[0x3A] = [this]() { LD_A_r16(HL()); };
+  opcodeTable[0x3D] = [this]() { DEC_r8(A); };
+  opcodeTable[0x3E] = [this]() { LD_r8_n8(A); };
+  opcodeTable[0x3F] = [this]() { CCF(); };
+
+  opcodeTable[0x40] = [this]() { LD_r8_r8(B, B); };
+  opcodeTable[0x41] = [this]() { LD_r8_r8(B, C); };
+  opcodeTable[0x42] = [this]() { LD_r8_r8(B, D); };
+  opcodeTable[0x43] = [this]() { LD_r8_r8(B, E); };
+  opcodeTable[0x44] = [this]() { LD_r8_r8(B, H); };
+  opcodeTable[0x45] = [this]() { LD_r8_r8(B, L); };
+  opcodeTable[0x46] = [this]() { LD_r8_r16(B, HL()); };
+  opcodeTable[0x47] = [this]() { LD_r8_r8(B, A); };
+
+  opcodeTable[0x48] = [this]() { LD_r8_r8(C, B); };
+  opcodeTable[0x49] = [this]() { LD_r8_r8(C, C); };
+  opcodeTable[0x4A] = [this]() { LD_r8_r8(C, D); };
+  opcodeTable[0x4B] = [this]() { LD_r8_r8(C, E); };
+  opcodeTable[0x4C] = [this]() { LD_r8_r8(C, H); };
+  opcodeTable[0x4D] = [this]() { LD_r8_r8(C, L); };
+  opcodeTable[0x4E] = [this]() { LD_r8_r16(C, HL()); };
+  opcodeTable[0x4F] = [this]() { LD_r8_r8(C, A); };
+
+  opcodeTable[0x50] = [this]() { LD_r8_r8(D, B); };
+  opcodeTable[0x51] = [this]() { LD_r8_r8(D, C); };
+  opcodeTable[0x52] = [this]() { LD_r8_r8(D, D); };
+  opcodeTable[0x53] = [this]() { LD_r8_r8(D, E); };
+  opcodeTable[0x54] = [this]() { LD_r8_r8(D, H); };
+  opcodeTable[0x55] = [this]() { LD_r8_r8(D, L); };
+  opcodeTable[0x56] = [this]() { LD_r8_r16(D, HL()); };
+  opcodeTable[0x57] = [this]() { LD_r8_r8(D, A); };
+
+  opcodeTable[0x58] = [this]() { LD_r8_r8(E, B); };
+  opcodeTable[0x59] = [this]() { LD_r8_r8(E, C); };
+  opcodeTable[0x5A] = [this]() { LD_r8_r8(E, D); };
+  opcodeTable[0x5B] = [this]() { LD_r8_r8(E, E); };
+  opcodeTable[0x5C] = [this]() { LD_r8_r8(E, H); };
+  opcodeTable[0x5D] = [this]() { LD_r8_r8(E, L); };
+  opcodeTable[0x5E] = [this]() { LD_r8_r16(E, HL()); };
+  opcodeTable[0x5F] = [this]() { LD_r8_r8(E, A); };
+
+  opcodeTable[0x60] = [this]() { LD_r8_r8(H, B); };
+  opcodeTable[0x61] = [this]() { LD_r8_r8(H, C); };
+  opcodeTable[0x62] = [this]() { LD_r8_r8(H, D); };
+  opcodeTable[0x63] = [this]() { LD_r8_r8(H, E); };
+  opcodeTable[0x64] = [this]() { LD_r8_r8(H, H); };
+  opcodeTable[0x65] = [this]() { LD_r8_r8(H, L); };
+  opcodeTable[0x66] = [this]() { LD_r8_r16(H, HL()); };
+  opcodeTable[0x67] = [this]() { LD_r8_r8(H, A); };
+
+  opcodeTable[0x68] = [this]() { LD_r8_r8(L, B); };
+  opcodeTable[0x69] = [this]() { LD_r8_r8(L, C); };
+  opcodeTable[0x6A] = [this]() { LD_r8_r8(L, D); };
+  opcodeTable[0x6B] = [this]() { LD_r8_r8(L, E); };
+  opcodeTable[0x6C] = [this]() { LD_r8_r8(L, H); };
+  opcodeTable[0x6D] = [this]() { LD_r8_r8(L, L); };
+  opcodeTable[0x6E] = [this]() { LD_r8_r16(L, HL()); };
+  opcodeTable[0x6F] = [this]() { LD_r8_r8(L, A); };
+
+  opcodeTable[0x70] = [this]() { LD_r16_r8(HL(), B); };
+  opcodeTable[0x71] = [this]() { LD_r16_r8(HL(), C); };
+  opcodeTable[0x72] = [this]() { LD_r16_r8(HL(), D); };
+  opcodeTable[0x73] = [this]() { LD_r16_r8(HL(), E); };
+  opcodeTable[0x74] = [this]() { LD_r16_r8(HL(), H); };
+  opcodeTable[0x75] = [this]() { LD_r16_r8(HL(), L); };
+  opcodeTable[0x76] = [this]() { HALT(); };
+  opcodeTable[0x77] = [this]() { LD_r16_r8(HL(), A); };
+
+  opcodeTable[0x78] = [this]() { LD_r8_r8(A, B); };
+  opcodeTable[0x79] = [this]() { LD_r8_r8(A, C); };
+  opcodeTable[0x7A] = [this]() { LD_r8_r8(A, D); };
+  opcodeTable[0x7B] = [this]() { LD_r8_r8(A, E); };
+  opcodeTable[0x7C] = [this]() { LD_r8_r8(A, H); };
+  opcodeTable[0x7D] = [this]() { LD_r8_r8(A, L); };
+  opcodeTable[0x7E] = [this]() { LD_r8_r16(A, HL()); };
+  opcodeTable[0x7F] = [this]() { LD_r8_r8(A, A); };
+  opcodeTable[0x80] = [this]() { ADD_A_r8(B); };
+  opcodeTable[0x81] = [this]() { ADD_A_r8(C); };
+  opcodeTable[0x82] = [this]() { ADD_A_r8(D); };
+  opcodeTable[0x83] = [this]() { ADD_A_r8(E); };
+  opcodeTable[0x84] = [this]() { ADD_A_r8(H); };
+  opcodeTable[0x85] = [this]() { ADD_A_r8(L); };
+
+  opcodeTable[0x86] = [this]() { ADD_A_r16(HL()); };
+  opcodeTable[0x87] = [this]() { ADD_A_r8(A); };
+  opcodeTable[0x88] = [this]() { ADC_A_r8(B); };
+  opcodeTable[0x89] = [this]() { ADC_A_r8(C); };
+  opcodeTable[0x8A] = [this]() { ADC_A_r8(D); };
+  opcodeTable[0x8B] = [this]() { ADC_A_r8(E); };
+  opcodeTable[0x8C] = [this]() { ADC_A_r8(H); };
+  opcodeTable[0x8D] = [this]() { ADC_A_r8(L); };
+  opcodeTable[0x8E] = [this]() { ADC_A_r16(HL()); };
+  opcodeTable[0x8F] = [this]() { ADC_A_r8(A); };
+
+  opcodeTable[0x90] = [this]() { SUB_A_r8(B); };
+  opcodeTable[0x91] = [this]() { SUB_A_r8(C); };
+  opcodeTable[0x92] = [this]() { SUB_A_r8(D); };
+  opcodeTable[0x93] = [this]() { SUB_A_r8(E); };
+  opcodeTable[0x94] = [this]() { SUB_A_r8(H); };
+  opcodeTable[0x95] = [this]() { SUB_A_r8(L); };
+  opcodeTable[0x96] = [this]() { SUB_A_r16(HL()); };
+  opcodeTable[0x97] = [this]() { SUB_A_r8(A); };
+
+  opcodeTable[0x98] = [this]() { SBC_A_r8(B); };
+  opcodeTable[0x99] = [this]() { SBC_A_r8(C); };
+  opcodeTable[0x9A] = [this]() { SBC_A_r8(D); };
+  opcodeTable[0x9B] = [this]() { SBC_A_r8(E); };
+  opcodeTable[0x9C] = [this]() { SBC_A_r8(H); };
+  opcodeTable[0x9D] = [this]() { SBC_A_r8(L); };
+  opcodeTable[0x9E] = [this]() { SBC_A_r16(HL()); };
+  opcodeTable[0x9F] = [this]() { SBC_A_r8(A); };
+
+  opcodeTable[0xA0] = [this]() { AND_A_r8(B); };
+  opcodeTable[0xA1] = [this]() { AND_A_r8(C); };
+  opcodeTable[0xA2] = [this]() { AND_A_r8(D); };
+  opcodeTable[0xA3] = [this]() { AND_A_r8(E); };
+  opcodeTable[0xA4] = [this]() { AND_A_r8(H); };
+  opcodeTable[0xA5] = [this]() { AND_A_r8(L); };
+  opcodeTable[0xA6] = [this]() { AND_A_r16(HL()); };
+  opcodeTable[0xA7] = [this]() { AND_A_r8(A); };
+
+  opcodeTable[0xA8] = [this]() { XOR_A_r8(B); };
+  opcodeTable[0xA9] = [this]() { XOR_A_r8(C); };
+  opcodeTable[0xAA] = [this]() { XOR_A_r8(D); };
+  opcodeTable[0xAB] = [this]() { XOR_A_r8(E); };
+  opcodeTable[0xAC] = [this]() { XOR_A_r8(H); };
+  opcodeTable[0xAD] = [this]() { XOR_A_r8(L); };
+  opcodeTable[0xAE] = [this]() { XOR_A_r16(HL()); };
+  opcodeTable[0xAF] = [this]() { XOR_A_r8(A); };
+
+  opcodeTable[0xB0] = [this]() { OR_A_r8(B); };
+  opcodeTable[0xB1] = [this]() { OR_A_r8(C); };
+  opcodeTable[0xB2] = [this]() { OR_A_r8(D); };
+  opcodeTable[0xB3] = [this]() { OR_A_r8(E); };
+  opcodeTable[0xB4] = [this]() { OR_A_r8(H); };
+  opcodeTable[0xB5] = [this]() { OR_A_r8(L); };
+  opcodeTable[0xB6] = [this]() { OR_A_r16(HL()); };
+  opcodeTable[0xB7] = [this]() { OR_A_r8(A); };
+
+  opcodeTable[0xB8] = [this]() { CP_A_r8(B); };
+  opcodeTable[0xB9] = [this]() { CP_A_r8(C); };
+  opcodeTable[0xBA] = [this]() { CP_A_r8(D); };
+  opcodeTable[0xBB] = [this]() { CP_A_r8(E); };
+  opcodeTable[0xBC] = [this]() { CP_A_r8(H); };
+  opcodeTable[0xBD] = [this]() { CP_A_r8(L); };
+  opcodeTable[0xBE] = [this]() { CP_A_r16(HL()); };
+  opcodeTable[0xBF] = [this]() { CP_A_r8(A); };
+
+  opcodeTable[0xC0] = [this]() { RET_con(checkCondition(0xC0)); };
+  opcodeTable[0xC1] = [this]() { POP_r16(BC()); };
+  opcodeTable[0xC2] = [this]() { JP_con_n16(checkCondition(0xC2)); };
+  opcodeTable[0xC3] = [this]() { JP_n16(); };
+  opcodeTable[0xC4] = [this]() { CALL_con_n16(checkCondition(0xC4)); };
+  opcodeTable[0xC5] = [this]() { PUSH_r16(BC()); };
+  opcodeTable[0xC6] = [this]() { ADD_A_n8(); };
+  opcodeTable[0xC7] = [this]() { RST(0x00); };
+  opcodeTable[0xC8] = [this]() { RET_con(checkCondition(0xC8)); };
+  opcodeTable[0xC9] = [this]() { RET(); };
+  opcodeTable[0xCA] = [this]() { JP_con_n16(checkCondition(0xCA)); };
+  // opcodeTable[0xCB] = [this]() { PREFIX(); };
+  opcodeTable[0xCC] = [this]() { CALL_con_n16(checkCondition(0xCC)); };
+  opcodeTable[0xCD] = [this]() { CALL_n16(); };
+  opcodeTable[0xCE] = [this]() { ADC_A_n8(); };
+  opcodeTable[0xCF] = [this]() { RST(0x08); };
+  opcodeTable[0xD0] = [this]() { RET_con(checkCondition(0xD0)); };
+  opcodeTable[0xD1] = [this]() { POP_r16(DE()); };
+  opcodeTable[0xD2] = [this]() { JP_con_n16(checkCondition(0xD2)); };
+  opcodeTable[0xD4] = [this]() { CALL_con_n16(checkCondition(0xD4)); };
+  opcodeTable[0xD5] = [this]() { PUSH_r16(DE()); };
+  opcodeTable[0xD6] = [this]() { SUB_A_n8(); };
+  opcodeTable[0xD7] = [this]() { RST(0x10); };
+  opcodeTable[0xD8] = [this]() { RET_con(checkCondition(0xD8)); };
+  opcodeTable[0xD9] = [this]() { RETI(); };
+  opcodeTable[0xDA] = [this]() { JP_con_n16(checkCondition(0xDA)); };
+  opcodeTable[0xDC] = [this]() { CALL_con_n16(checkCondition(0xDC)); };
+  opcodeTable[0xDE] = [this]() { SBC_A_n8(); };
+  opcodeTable[0xDF] = [this]() { RST(0x18); };
+  opcodeTable[0xE0] = [this]() { LDH_n8_A(); };
+  opcodeTable[0xE1] = [this]() { POP_r16(HL()); };
+  opcodeTable[0xE2] = [this]() { LDH_C_A(); };
+  opcodeTable[0xE5] = [this]() { PUSH_r16(HL()); };
+  opcodeTable[0xE6] = [this]() { AND_A_n8(); };
+  opcodeTable[0xE7] = [this]() { RST(0x20); };
+  opcodeTable[0xE8] = [this]() { ADD_SP_n8(); };
+  opcodeTable[0xE9] = [this]() { JP_HL(); };
+  opcodeTable[0xEA] = [this]() { LD_n16_A(); };
+  opcodeTable[0xEE] = [this]() { XOR_A_n8(); };
+  opcodeTable[0xEF] = [this]() { RST(0x28); };
+  opcodeTable[0xF0] = [this]() { LDH_A_n8(); };
+  opcodeTable[0xF1] = [this]() { POP_r16(AF()); };
+  opcodeTable[0xF2] = [this]() { LDH_A_r8(C); };
+  opcodeTable[0xF3] = [this]() { DI(); };
+
+  // opcodeTable[0xF4] = [this]() { CALL_con_n16(false); };
+  opcodeTable[0xF5] = [this]() { PUSH_r16(AF()); };
+  opcodeTable[0xF6] = [this]() { OR_A_n8(); };
+  opcodeTable[0xF7] = [this]() { RST(0x30); };
+  opcodeTable[0xF8] = [this]() { LD_HL_SP_n8(); };
+  opcodeTable[0xF9] = [this]() { LD_SP_HL(); };
+  opcodeTable[0xFA] = [this]() { LD_A_n16(); };
+  opcodeTable[0xFB] = [this]() { EI(); };
+  opcodeTable[0xFE] = [this]() { CP_A_n8(); };
+  opcodeTable[0xFF] = [this]() { RST(0x38); };
+}
+
+template <typename Timing>
+BasicCPU<Timing> &BasicCPU<Timing>::operator=(const BasicCPU &other) {
+  std::copy(std::begin(other.registers), std::end(other.registers),
+            std::begin(registers));
+  SP = other.SP;
+  PC = other.PC;
+  IME = other.IME;
+  halted = other.halted;
+  cycles = other.cycles;
+  jumpedBack = other.jumpedBack;
+  imePending = other.imePending;
+  return *this;
+}
+
+template <typename Timing>
+void BasicCPU<Timing>::saveState(StateWriter &out) const {
+  out.write(registers, sizeof(registers));
+  out.write(SP);
+  out.write(PC);
+  out.write<uint8_t>(IME | (imePending << 1) | (halted << 2) |
+                     (jumpedBack << 3));
+  out.write(cycles);
+}
+
+template <typename Timing>
+void BasicCPU<Timing>::loadState(StateReader &in) {
+  if (const uint8_t *bytes = in.take(sizeof(registers))) {
+    std::copy(bytes, bytes + sizeof(registers), registers);
+  }
+  SP = in.read<uint16_t>();
+  PC = in.read<uint16_t>();
+  uint8_t flags = in.read<uint8_t>();
+  IME = flags & 0x01;
+  imePending = flags & 0x02;
+  halted = flags & 0x04;
+  jumpedBack = flags & 0x08;
+  cycles = in.read<uint64_t>();
+}
+
+template <typename Timing>
+void BasicCPU<Timing>::executeOpcode() {
+  if (beginInstruction()) {
+    execute(fetchByte());
+  }
+}
+
+template <typename Timing>
+bool BasicCPU<Timing>::beginInstruction() {
+  jumpedBack = false;
+  if (serviceInterrupts()) {
+    return false;
+  }
+  if (halted) {
+    cycles += 4;
+    memory.counters.countHalt(4);
+    return false;
+  }
+  return true;
+}
+
+template <typename Timing>
+void BasicCPU<Timing>::execute(uint8_t opcode) {
+  bool enableInterrupts = imePending;
+  uint64_t start = cycles;
+  if constexpr (Timing::kMCycleBus) {
+    start -= 4;  // The opcode fetch has clocked itself
+    instructionEnd = start + kOpcodeCycles[opcode];
+    opcodeTable[opcode]();
+    cycles = std::max(cycles, instructionEnd);  // Internal cycles
+  } else {
+    cycles += kOpcodeCycles[opcode];
+    opcodeTable[opcode]();
+  }
+  memory.counters.countOpcode(opcode, cycles - start);
+
+  // An EI before this instruction takes effect now, unless it was a DI
+  if (enableInterrupts && imePending) {
+    IME = true;
+    imePending = false;
+  }
+}
+
+/**
+ * Wakes from HALT on any pending interrupt and, if IME is set, dispatches
+ * the highest priority one. Returns true if an interrupt was dispatched.
+ */
+template <typename Timing>
+bool BasicCPU<Timing>::serviceInterrupts() {
+  uint8_t pending = memory.pendingInterrupts();
+  if (pending == 0) {
+    return false;
+  }
+  halted = false;
+  if (!IME) {
+    return false;
+  }
+
+  uint8_t interrupt = std::countr_zero(pending);
+  uint64_t start = cycles;
+  IME = false;
+  memory.io.reg(0xFF0F) &= ~(1 << interrupt);
+  internalCycle();  // Two wait M-cycles, the second in push()
+  push(PC);
+  PC = 0x40 + interrupt * 8;
+  cycles = std::max(cycles, start + 20);
+  if (profiler) {
+    profiler->enter(PC, SP);
+  }
+  return true;
+}
+
+/**
+ * Pushes a word as CALL, RST, PUSH and interrupt dispatch do. In the
+ * accurate tier that is an internal M-cycle, then the high byte and the low
+ * byte in M-cycles of their own; the fast tier writes both at once.
+ */
+template <typename Timing>
+void BasicCPU<Timing>::push(uint16_t value) {
+  if constexpr (Timing::kMCycleBus) {
+    internalCycle();
+    memory.writeByte<Timing>(--SP, value >> 8);
+    memory.writeByte<Timing>(--SP, value & 0xFF);
+  } else {
+    SP -= 2;
+    memory.writeWord(SP, value);
+  }
+}
+
+template <typename Timing>
+void BasicCPU<Timing>::skipHalt(uint64_t time) {
+  if (!halted || time <= cycles || memory.pendingInterrupts() != 0) {
+    return;
+  }
+  uint64_t skipped = (time - cycles + 3) & ~uint64_t{3};
+  cycles += skipped;
+  memory.counters.countHalt(skipped);
+}
+
+/**
+ * Matches `LDH A,(n8)` / `LDH A,(C)` / `LD A,(n16)`, then `CP n8` or
+ * `AND n8`, then a `JR cc` back to PC. Each iteration only writes A and F,
+ * and both are a pure function of the polled value, so as long as that
+ * value cannot change, running the loop again leaves the machine unchanged
+ * apart from the clock. The code is peeked, so matching is invisible to
+ * counters and watchpoints.
+ */
+template <typename Timing>
+bool BasicCPU<Timing>::matchIdlePoll(IdlePoll &poll) {
+  if (memory.isBusLocked()) {
+    return false;  // The CPU would fetch 0xFF outside HRAM
+  }
+  if ((IME || imePending) && memory.pendingInterrupts() != 0) {
+    return false;  // Dispatched before the next iteration, or after an EI
+  }
+  uint8_t load = memory.peek(PC);
+  uint16_t length = 0;
+  uint8_t loadCycles = 0;
+  switch (load) {
+    case 0xF0:  // LDH A,(n8)
+      poll.address = 0xFF00 + memory.peek(PC + 1);
+      length = 2;
+      loadCycles = 12;
+      break;
+    case 0xF2:  // LDH A,(C)
+      poll.address = 0xFF00 + C;
+      length = 1;
+      loadCycles = 8;
+      break;
+    case 0xFA:  // LD A,(n16)
+      poll.address = memory.peek(PC + 1) | memory.peek(PC + 2) << 8;
+      length = 3;
+      loadCycles = 16;
+      break;
+    default:
+      return false;
+  }
+  if (!isIdlePollAddress(poll.address)) {
+    return false;
+  }
+
+  poll.operation = memory.peek(PC + length);
+  if (poll.operation != 0xFE && poll.operation != 0xE6) {
+    return false;
+  }
+  poll.operand = memory.peek(PC + length + 1);
+  poll.branch = memory.peek(PC + length + 2);
+  if ((poll.branch & 0xE7) != 0x20) {  // JR NZ/Z/NC/C
+    return false;
+  }
+  int8_t offset = memory.peek(PC + length + 3);
+  if (offset != -(length + 4)) {
+    return false;
+  }
+
+  poll.iterationCycles = loadCycles + 8 + 12;
+  return true;
+}
+
+/**
+ * Advances the clock past `iterations` runs of a matched polling loop and
+ * leaves A and F as the last of them would have. Returns false, without
+ * touching any state, if the polled value would make the loop exit.
+ */
+template <typename Timing>
+bool BasicCPU<Timing>::skipIdlePoll(const IdlePoll &poll,
+                                    uint32_t iterations) {
+  uint8_t previousA = A;
+  uint8_t previousF = F;
+
+  // As the loop's load reads it, but not counted or trapped
+  A = memory.io.read(poll.address & 0x7F);
+  if (poll.operation == 0xFE) {
+    CP_A_r8(poll.operand);
+  } else {
+    AND_A_r8(poll.operand);
+  }
+  if (!checkCondition(poll.branch)) {
+    A = previousA;
+    F = previousF;
+    return false;
+  }
+
+  cycles += static_cast<uint64_t>(iterations) * poll.iterationCycles;
+  return true;
+}
+
+template <typename Timing>
+uint64_t BasicCPU<Timing>::stateHash() const {
+  uint64_t hash = fnv1a(registers, sizeof(registers));
+  hash = fnv1aValue(SP, hash);
+  hash = fnv1aValue(PC, hash);
+  hash = fnv1aValue(IME | (imePending << 1) | (halted << 2), hash);
+  return fnv1aValue(cycles, hash);
+}
+
+template <typename Timing>
+void BasicCPU<Timing>::NOP() { /* No operation */ }
+
+template <typename Timing>
+uint8_t BasicCPU<Timing>::fetchByte() {
+  return memory.readByte<Timing>(PC++);
+}
+
+template <typename Timing>
+uint16_t BasicCPU<Timing>::fetchWord() {
   uint16_t lo = fetchByte();
   uint16_t hi = fetchByte();
   return (hi << 8) | lo;
 }
 
-void CPU::LD_r8_r8(uint8_t &destinationRegister, uint8_t sourceRegister) {
+template <typename Timing>
+void BasicCPU<Timing>::LD_r8_r8(uint8_t &destinationRegister,
+                                uint8_t sourceRegister) {
   destinationRegister = sourceRegister;
 }
 
-void CPU::LD_r8_n8(uint8_t &destinationRegister) {
+template <typename Timing>
+void BasicCPU<Timing>::LD_r8_n8(uint8_t &destinationRegister) {
   destinationRegister = fetchByte();
 }
 
-void CPU::LD_r16_n16(uint16_t &destination) { destination = fetchWord(); }
+template <typename Timing>
+void BasicCPU<Timing>::LD_r16_n16(uint16_t &destination) {
+  destination = fetchWord();
+}
 
-void CPU::LD_r16_A(uint16_t &registerPair) {
-  memory.writeByte(registerPair, A);
+template <typename Timing>
+void BasicCPU<Timing>::LD_r16_A(uint16_t &registerPair) {
+  memory.writeByte<Timing>(registerPair, A);
 }
 
-void CPU::LD_A_r16(uint16_t &registerPair) {
-  A = memory.readByte(registerPair);
+template <typename Timing>
+void BasicCPU<Timing>::LD_A_r16(uint16_t &registerPair) {
+  A = memory.readByte<Timing>(registerPair);
 }
 
-void CPU::LD_n16_SP() { memory.writeWord(fetchWord(), SP); }
+template <typename Timing>
+void BasicCPU<Timing>::LD_n16_SP() {
+  memory.writeWord<Timing>(fetchWord(), SP);
+}
 
-void CPU::INC_r16(uint16_t &registerPair) { registerPair++; }
+template <typename Timing>
+void BasicCPU<Timing>::INC_r16(uint16_t &registerPair) { registerPair++; }
 
-void CPU::DEC_r16(uint16_t &registerPair) { registerPair--; }
+template <typename Timing>
+void BasicCPU<Timing>::DEC_r16(uint16_t &registerPair) { registerPair--; }
 
-void CPU::ADD_HL_r16(uint16_t &registerPair) {
+template <typename Timing>
+void BasicCPU<Timing>::ADD_HL_r16(uint16_t &registerPair) {
   uint16_t result = (HL() + registerPair);
   bool halfCarry = (HL() & 0x0FFF) + (registerPair & 0x0FFF) > 0x0FFF;
   bool carry = result < HL();
@@ -342,7 +608,8 @@ void CPU::ADD_HL_r16(uint16_t &registerPair) {
   HL() = result & 0xFFFF;
 }
 
-void CPU::INC_r8(uint8_t &registerPair) {
+template <typename Timing>
+void BasicCPU<Timing>::INC_r8(uint8_t &registerPair) {
   bool halfCarry = (registerPair & 0x0F) == 0x0F;
   registerPair++;
   setZeroFlag(registerPair == 0);
@@ -350,7 +617,8 @@ void CPU::INC_r8(uint8_t &registerPair) {
   setHalfCarryFlag(halfCarry);
 }
 
-void CPU::DEC_r8(uint8_t &registerPair) {
+template <typename Timing>
+void BasicCPU<Timing>::DEC_r8(uint8_t &registerPair) {
   bool halfCarry = (registerPair & 0x0F) == 0x00;
   registerPair--;
   setZeroFlag(registerPair == 0);
@@ -358,7 +626,8 @@ void CPU::DEC_r8(uint8_t &registerPair) {
   setHalfCarryFlag(halfCarry);
 }
 
-void CPU::ADD_A_r8(uint8_t value) {
+template <typename Timing>
+void BasicCPU<Timing>::ADD_A_r8(uint8_t value) {
   bool halfCarry = (A & 0x0F) + (value & 0x0F) > 0x0F;
   bool carry = A + value > 0xFF;
 
@@ -371,12 +640,14 @@ void CPU::ADD_A_r8(uint8_t value) {
   A += value;
 }
 
-void CPU::ADD_A_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::ADD_A_n8() {
   uint8_t value = fetchByte();
   ADD_A_r8(value);
 }
 
-void CPU::ADC_A_r8(uint8_t value) {
+template <typename Timing>
+void BasicCPU<Timing>::ADC_A_r8(uint8_t value) {
   uint8_t carry = getCarryFlag() ? 1 : 0;
   bool halfCarry = (A & 0x0F) + (value & 0x0F) + carry > 0x0F;
   bool carryFlag = A + value + carry > 0xFF;
@@ -390,12 +661,14 @@ void CPU::ADC_A_r8(uint8_t value) {
   A += value + carry;
 }
 
-void CPU::ADC_A_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::ADC_A_n8() {
   uint8_t value = fetchByte();
   ADC_A_r8(value);
 }
 
-void CPU::SUB_A_r8(uint8_t value) {
+template <typename Timing>
+void BasicCPU<Timing>::SUB_A_r8(uint8_t value) {
   bool halfCarry = (A & 0x0F) < (value & 0x0F);
   bool carry = A < value;
 
@@ -408,12 +681,14 @@ void CPU::SUB_A_r8(uint8_t value) {
   A -= value;
 }
 
-void CPU::SUB_A_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::SUB_A_n8() {
   uint8_t value = fetchByte();
   SUB_A_r8(value);
 }
 
-void CPU::SBC_A_r8(uint8_t value) {
+template <typename Timing>
+void BasicCPU<Timing>::SBC_A_r8(uint8_t value) {
   uint8_t carry = getCarryFlag() ? 1 : 0;
   bool halfCarry = (A & 0x0F) < (value & 0x0F) + carry;
   bool carryFlag = A < value + carry;
@@ -427,12 +702,14 @@ void CPU::SBC_A_r8(uint8_t value) {
   A -= value + carry;
 }
 
-void CPU::SBC_A_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::SBC_A_n8() {
   uint8_t value = fetchByte();
   SBC_A_r8(value);
 }
 
-void CPU::AND_A_r8(uint8_t value) {
+template <typename Timing>
+void BasicCPU<Timing>::AND_A_r8(uint8_t value) {
   A &= value;
   resetFlags();
   setZeroFlag(A == 0);
@@ -441,34 +718,40 @@ void CPU::AND_A_r8(uint8_t value) {
   setCarryFlag(false);
 }
 
-void CPU::AND_A_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::AND_A_n8() {
   uint8_t value = fetchByte();
   AND_A_r8(value);
 }
 
-void CPU::XOR_A_r8(uint8_t value) {
+template <typename Timing>
+void BasicCPU<Timing>::XOR_A_r8(uint8_t value) {
   A ^= value;
   resetFlags();
   setZeroFlag(A == 0);
 }
 
-void CPU::XOR_A_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::XOR_A_n8() {
   uint8_t value = fetchByte();
   XOR_A_r8(value);
 }
 
-void CPU::OR_A_r8(uint8_t value) {
+template <typename Timing>
+void BasicCPU<Timing>::OR_A_r8(uint8_t value) {
   A |= value;
   resetFlags();
   setZeroFlag(A == 0);
 }
 
-void CPU::OR_A_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::OR_A_n8() {
   uint8_t value = fetchByte();
   OR_A_r8(value);
 }
 
-void CPU::CP_A_r8(uint8_t value) {
+template <typename Timing>
+void BasicCPU<Timing>::CP_A_r8(uint8_t value) {
   uint8_t result = A - value;
   bool halfCarry = (A & 0x0F) < (value & 0x0F);
   bool carry = A < value;
@@ -480,12 +763,14 @@ void CPU::CP_A_r8(uint8_t value) {
   setCarryFlag(carry);
 }
 
-void CPU::CP_A_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::CP_A_n8() {
   uint8_t value = fetchByte();
   CP_A_r8(value);
 }
 
-void CPU::ADD_SP_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::ADD_SP_n8() {
   int8_t value = fetchByte();
   bool halfCarry = (SP & 0x0F) + (value & 0x0F) > 0x0F;
   bool carry = (SP & 0xFF) + value > 0xFF;
@@ -499,7 +784,8 @@ void CPU::ADD_SP_n8() {
   SP += value;
 }
 
-void CPU::LD_HL_SP_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::LD_HL_SP_n8() {
   int8_t value = fetchByte();
   bool halfCarry = (SP & 0x0F) + (value & 0x0F) > 0x0F;
   bool carry = (SP & 0xFF) + value > 0xFF;
@@ -513,92 +799,113 @@ void CPU::LD_HL_SP_n8() {
   HL() = SP + value;
 }
 
-void CPU::JP_n16() { PC = fetchWord(); }
+template <typename Timing>
+void BasicCPU<Timing>::JP_n16() { PC = fetchWord(); }
 
-void CPU::JP_HL() { PC = HL(); }
+template <typename Timing>
+void BasicCPU<Timing>::JP_HL() { PC = HL(); }
 
-void CPU::CALL_n16() {
+template <typename Timing>
+void BasicCPU<Timing>::CALL_n16() {
   uint16_t address = fetchWord();
-  SP -= 2;
-  memory.writeWord(SP, PC);
+  push(PC);
   PC = address;
+  if (profiler) {
+    profiler->enter(PC, SP);
+  }
 }
 
-void CPU::RET() {
-  PC = memory.readWord(SP);
+template <typename Timing>
+void BasicCPU<Timing>::RET() {
+  PC = memory.readWord<Timing>(SP);
   SP += 2;
 }
 
-void CPU::RETI() {
-  PC = memory.readWord(SP);
+template <typename Timing>
+void BasicCPU<Timing>::RETI() {
+  PC = memory.readWord<Timing>(SP);
   SP += 2;
   IME = true;
 }
 
-void CPU::PUSH_r16(uint16_t &registerPair) {
-  SP -= 2;
-  memory.writeWord(SP, registerPair);
+template <typename Timing>
+void BasicCPU<Timing>::PUSH_r16(uint16_t &registerPair) {
+  push(registerPair);
 }
 
-void CPU::POP_r16(uint16_t &registerPair) {
+template <typename Timing>
+void BasicCPU<Timing>::POP_r16(uint16_t &registerPair) {
   SP += 2;
-  registerPair = memory.readWord(SP);
+  registerPair = memory.readWord<Timing>(SP);
 }
 
-void CPU::LDH_n8_A() {
+template <typename Timing>
+void BasicCPU<Timing>::LDH_n8_A() {
   uint8_t address = fetchByte();
-  memory.writeByte(0xFF00 + address, A);
+  memory.writeByte<Timing>(0xFF00 + address, A);
 }
 
-void CPU::LDH_A_n8() {
+template <typename Timing>
+void BasicCPU<Timing>::LDH_A_n8() {
   uint8_t address = fetchByte();
-  A = memory.readByte(0xFF00 + address);
+  A = memory.readByte<Timing>(0xFF00 + address);
 }
 
-void CPU::LD_n16_A() {
+template <typename Timing>
+void BasicCPU<Timing>::LD_n16_A() {
   uint16_t address = fetchWord();
-  memory.writeByte(address, A);
+  memory.writeByte<Timing>(address, A);
 }
 
-void CPU::LD_A_n16() {
+template <typename Timing>
+void BasicCPU<Timing>::LD_A_n16() {
   uint16_t address = fetchWord();
-  A = memory.readByte(address);
+  A = memory.readByte<Timing>(address);
 }
 
-void CPU::LD_SP_HL() { SP = HL(); }
+template <typename Timing>
+void BasicCPU<Timing>::LD_SP_HL() { SP = HL(); }
 
-void CPU::DI() {  // IME = false;
+template <typename Timing>
+void BasicCPU<Timing>::DI() {
+  IME = false;
+  imePending = false;
 }
 
-void CPU::EI() {  // IME = true;
-}
+template <typename Timing>
+void BasicCPU<Timing>::EI() { imePending = true; }
 
-void CPU::RLCA() {
+template <typename Timing>
+void BasicCPU<Timing>::RLCA() {
   bool carry = (A & 0x80) == 0x80;
   A = (A << 1) | carry;
   resetFlags();
   setCarryFlag(carry);
 }
 
-void CPU::LD_HL_r8(uint8_t &registerPair) {
-  memory.writeByte(HL(), registerPair);
+template <typename Timing>
+void BasicCPU<Timing>::LD_HL_r8(uint8_t &registerPair) {
+  memory.writeByte<Timing>(HL(), registerPair);
 }
 
-void CPU::RLA() {
+template <typename Timing>
+void BasicCPU<Timing>::RLA() {
   bool carry = (A & 0x80) == 0x80;
   A = (A << 1) | getCarryFlag();
   resetFlags();
   setCarryFlag(carry);
 }
 
-void CPU::RRA() {
+template <typename Timing>
+void BasicCPU<Timing>::RRA() {
   bool carry = (A & 0x01) == 0x01;
   A = (A >> 1) | (getCarryFlag() << 7);
   resetFlags();
   setCarryFlag(carry);
 }
 
-void CPU::DAA() {
+template <typename Timing>
+void BasicCPU<Timing>::DAA() {
   uint8_t correction = 0;
   if (getHalfCarryFlag() || (!getSubtractFlag() && (A & 0x0F) > 9)) {
     correction |= 0x06;
@@ -612,127 +919,163 @@ void CPU::DAA() {
   setHalfCarryFlag(false);
 }
 
-void CPU::CPL() {
+template <typename Timing>
+void BasicCPU<Timing>::CPL() {
   A = ~A;
   setSubtractFlag(true);
   setHalfCarryFlag(true);
 }
 
-void CPU::SCF() {
+template <typename Timing>
+void BasicCPU<Timing>::SCF() {
   setSubtractFlag(false);
   setHalfCarryFlag(false);
   setCarryFlag(true);
 }
 
-void CPU::CCF() {
+template <typename Timing>
+void BasicCPU<Timing>::CCF() {
   setSubtractFlag(false);
   setHalfCarryFlag(false);
   setCarryFlag(!getCarryFlag());
 }
 
-void CPU::HALT() {
-  //   if (IME) {
-  //     HALTed = true;
-  //   } else {
-  //     HALTbug = true;
-  //   }
-}
+template <typename Timing>
+void BasicCPU<Timing>::HALT() { halted = true; }
 
-void CPU::STOP() {
-  //   STOPped = true;
-  //   PC++;
+template <typename Timing>
+void BasicCPU<Timing>::STOP() {
+  // Low-power mode is not emulated; in CGB mode STOP performs a speed
+  // switch armed through KEY1
+  PC++;
+  memory.io.stop();
 }
 
-void CPU::LD_r16_n8(uint16_t &destinationRegister) {
+template <typename Timing>
+void BasicCPU<Timing>::LD_r16_n8(uint16_t &destinationRegister) {
   uint8_t value = fetchByte();
-  memory.writeByte(destinationRegister, value);
+  memory.writeByte<Timing>(destinationRegister, value);
 }
 
-void CPU::RRCA() {
+template <typename Timing>
+void BasicCPU<Timing>::RRCA() {
   bool carry = (A & 0x01) == 0x01;
   A = (A >> 1) | (carry << 7);
   resetFlags();
   setCarryFlag(carry);
 }
 
-void CPU::LD_r16_r8(uint16_t &destinationRegister, uint8_t sourceRegister) {
-  memory.writeByte(destinationRegister, sourceRegister);
+template <typename Timing>
+void BasicCPU<Timing>::LD_r16_r8(uint16_t &destinationRegister,
+                                 uint8_t sourceRegister) {
+  memory.writeByte<Timing>(destinationRegister, sourceRegister);
 }
 
-void CPU::LD_r8_r16(uint8_t &destinationRegister, uint16_t sourceRegister) {
-  destinationRegister = memory.readByte(sourceRegister);
+template <typename Timing>
+void BasicCPU<Timing>::LD_r8_r16(uint8_t &destinationRegister,
+                                 uint16_t sourceRegister) {
+  destinationRegister = memory.readByte<Timing>(sourceRegister);
 }
 
-void CPU::JR_n8() { PC += fetchByte(); }
+template <typename Timing>
+void BasicCPU<Timing>::JR_n8() { PC += fetchByte(); }
 
-void CPU::JR_con_n8(bool condition) {
+template <typename Timing>
+void BasicCPU<Timing>::JR_con_n8(bool condition) {
   int8_t value = fetchByte();
   if (condition) {
     PC += value;
+    addCycles(4);
+    jumpedBack = value < 0;
   }
 }
 
-void CPU::ADD_A_r16(uint16_t &registerPair) {
-  ADD_A_r8(memory.readByte(registerPair));
+template <typename Timing>
+void BasicCPU<Timing>::ADD_A_r16(uint16_t &registerPair) {
+  ADD_A_r8(memory.readByte<Timing>(registerPair));
 }
 
-void CPU::ADC_A_r16(uint16_t &registerPair) {
-  ADC_A_r8(memory.readByte(registerPair));
+template <typename Timing>
+void BasicCPU<Timing>::ADC_A_r16(uint16_t &registerPair) {
+  ADC_A_r8(memory.readByte<Timing>(registerPair));
 }
 
-void CPU::SUB_A_r16(uint16_t &registerPair) {
-  SUB_A_r8(memory.readByte(registerPair));
+template <typename Timing>
+void BasicCPU<Timing>::SUB_A_r16(uint16_t &registerPair) {
+  SUB_A_r8(memory.readByte<Timing>(registerPair));
 }
 
-void CPU::SBC_A_r16(uint16_t &registerPair) {
-  SBC_A_r8(memory.readByte(registerPair));
+template <typename Timing>
+void BasicCPU<Timing>::SBC_A_r16(uint16_t &registerPair) {
+  SBC_A_r8(memory.readByte<Timing>(registerPair));
 }
 
-void CPU::AND_A_r16(uint16_t &registerPair) {
-  AND_A_r8(memory.readByte(registerPair));
+template <typename Timing>
+void BasicCPU<Timing>::AND_A_r16(uint16_t &registerPair) {
+  AND_A_r8(memory.readByte<Timing>(registerPair));
 }
 
-void CPU::XOR_A_r16(uint16_t &registerPair) {
-  XOR_A_r8(memory.readByte(registerPair));
+template <typename Timing>
+void BasicCPU<Timing>::XOR_A_r16(uint16_t &registerPair) {
+  XOR_A_r8(memory.readByte<Timing>(registerPair));
 }
 
-void CPU::OR_A_r16(uint16_t &registerPair) {
-  OR_A_r8(memory.readByte(registerPair));
+template <typename Timing>
+void BasicCPU<Timing>::OR_A_r16(uint16_t &registerPair) {
+  OR_A_r8(memory.readByte<Timing>(registerPair));
 }
 
-void CPU::CP_A_r16(uint16_t &registerPair) {
-  CP_A_r8(memory.readByte(registerPair));
+template <typename Timing>
+void BasicCPU<Timing>::CP_A_r16(uint16_t &registerPair) {
+  CP_A_r8(memory.readByte<Timing>(registerPair));
 }
 
-void CPU::RET_con(bool condition) {
+template <typename Timing>
+void BasicCPU<Timing>::RET_con(bool condition) {
   if (condition) {
+    internalCycle();  // Testing the condition delays the pops
     RET();
+    addCycles(12);
   }
 }
 
-void CPU::JP_con_n16(bool condition) {
+template <typename Timing>
+void BasicCPU<Timing>::JP_con_n16(bool condition) {
   uint16_t address = fetchWord();
   if (condition) {
     PC = address;
+    addCycles(4);
   }
 }
 
-void CPU::CALL_con_n16(bool condition) {
+template <typename Timing>
+void BasicCPU<Timing>::CALL_con_n16(bool condition) {
   if (condition) {
     CALL_n16();
+    addCycles(12);
   } else {
     fetchWord();
   }
 }
 
-void CPU::RST(uint16_t target) {
-  SP -= 2;
-  memory.writeWord(SP, PC);
+template <typename Timing>
+void BasicCPU<Timing>::RST(uint16_t target) {
+  push(PC);
   PC = target;
+  if (profiler) {
+    profiler->enter(PC, SP);
+  }
 }
 
-void CPU::LDH_C_A() { memory.writeByte(0xFF00 + C, A); }
+template <typename Timing>
+void BasicCPU<Timing>::LDH_C_A() {
+  memory.writeByte<Timing>(0xFF00 + C, A);
+}
+
+template <typename Timing>
+void BasicCPU<Timing>::LDH_A_r8(uint8_t &registerPair) {
+  A = memory.readByte<Timing>(0xFF00 + registerPair);
+}
 
-void CPU::LDH_A_r8(uint8_t &registerPair) {
-  A = memory.readByte(0xFF00 + registerPair);
-}
\ No newline at end of file
+template class BasicCPU<FastTiming>;
+template class BasicCPU<AccurateTiming>;
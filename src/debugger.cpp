@@ -0,0 +1,530 @@
+/**
+ * @file debugger.cpp
+ * @brief Implementation of the debugger core and its text commands.
+ */
+
+#include "../include/debugger.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <sstream>
+#include <utility>
+
+#include "../include/disassembler.hpp"
+
+namespace {
+
+using Operand = std::function<unsigned(const GameBoy &, const Stop &)>;
+
+bool inSwitchableBank(uint16_t address) {
+  return address >= 0x4000 && address < 0x8000;
+}
+
+bool allows(Access watched, Access access) {
+  return static_cast<uint8_t>(watched) & static_cast<uint8_t>(access);
+}
+
+// Parses a whole string as a decimal, 0x or $ hexadecimal number
+bool parseNumber(const std::string &text, uint32_t &value) {
+  size_t start = 0;
+  int base = 10;
+  if (text.starts_with("0x") || text.starts_with("0X")) {
+    start = 2;
+    base = 16;
+  } else if (text.starts_with("$")) {
+    start = 1;
+    base = 16;
+  }
+  if (start == text.size() || text.size() - start > 8) {
+    return false;
+  }
+  value = 0;
+  for (size_t i = start; i < text.size(); i++) {
+    int c = std::tolower(static_cast<unsigned char>(text[i]));
+    int digit = c >= '0' && c <= '9'   ? c - '0'
+                : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                                       : base;
+    if (digit >= base) {
+      return false;
+    }
+    value = value * base + digit;
+  }
+  return true;
+}
+
+bool parseAddress(const std::string &text, uint16_t &address) {
+  uint32_t value;
+  if (!parseNumber(text, value) || value > 0xFFFF) {
+    return false;
+  }
+  address = static_cast<uint16_t>(value);
+  return true;
+}
+
+Operand registerOperand(const std::string &name) {
+  static const std::pair<const char *, Operand> kRegisters[] = {
+      {"A", [](const GameBoy &g, const Stop &) { return +g.cpu.A; }},
+      {"F", [](const GameBoy &g, const Stop &) { return +g.cpu.F; }},
+      {"B", [](const GameBoy &g, const Stop &) { return +g.cpu.B; }},
+      {"C", [](const GameBoy &g, const Stop &) { return +g.cpu.C; }},
+      {"D", [](const GameBoy &g, const Stop &) { return +g.cpu.D; }},
+      {"E", [](const GameBoy &g, const Stop &) { return +g.cpu.E; }},
+      {"H", [](const GameBoy &g, const Stop &) { return +g.cpu.H; }},
+      {"L", [](const GameBoy &g, const Stop &) { return +g.cpu.L; }},
+      {"AF",
+       [](const GameBoy &g, const Stop &) { return g.cpu.A << 8 | g.cpu.F; }},
+      {"BC",
+       [](const GameBoy &g, const Stop &) { return g.cpu.B << 8 | g.cpu.C; }},
+      {"DE",
+       [](const GameBoy &g, const Stop &) { return g.cpu.D << 8 | g.cpu.E; }},
+      {"HL",
+       [](const GameBoy &g, const Stop &) { return g.cpu.H << 8 | g.cpu.L; }},
+      {"SP", [](const GameBoy &g, const Stop &) { return +g.cpu.SP; }},
+      {"PC", [](const GameBoy &g, const Stop &) { return +g.cpu.PC; }},
+      {"VALUE", [](const GameBoy &, const Stop &s) { return +s.value; }},
+  };
+  std::string upper = name;
+  for (char &c : upper) {
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  }
+  for (const auto &[registerName, operand] : kRegisters) {
+    if (upper == registerName) {
+      return operand;
+    }
+  }
+  return {};
+}
+
+// Recursive-descent parser for `operand op operand [&& ...]`
+class ConditionParser {
+ public:
+  explicit ConditionParser(const std::string &text) : text(text) {}
+
+  Condition parse(std::string &error) {
+    Condition condition;
+    do {
+      Condition term = parseTerm();
+      if (!term) {
+        break;
+      }
+      if (!condition) {
+        condition = std::move(term);
+      } else {
+        condition = [first = std::move(condition), second = std::move(term)](
+                        const GameBoy &gameboy, const Stop &stop) {
+          return first(gameboy, stop) && second(gameboy, stop);
+        };
+      }
+    } while (accept("&&"));
+    skipSpace();
+    if (condition && at < text.size()) {
+      problem = "unexpected '" + text.substr(at) + "'";
+    }
+    if (!problem.empty()) {
+      error = "bad condition: " + problem;
+      return {};
+    }
+    return condition;
+  }
+
+ private:
+  Condition parseTerm() {
+    Operand left = parseOperand();
+    if (!left) {
+      return {};
+    }
+    static const char *kOperators[] = {"==", "!=", "<=", ">=", "<", ">"};
+    int op = -1;
+    for (int i = 0; i < 6 && op < 0; i++) {
+      if (accept(kOperators[i])) {
+        op = i;
+      }
+    }
+    if (op < 0) {
+      fail("expected a comparison");
+      return {};
+    }
+    Operand right = parseOperand();
+    if (!right) {
+      return {};
+    }
+    return [left = std::move(left), right = std::move(right), op](
+               const GameBoy &gameboy, const Stop &stop) {
+      unsigned a = left(gameboy, stop);
+      unsigned b = right(gameboy, stop);
+      switch (op) {
+        case 0:
+          return a == b;
+        case 1:
+          return a != b;
+        case 2:
+          return a <= b;
+        case 3:
+          return a >= b;
+        case 4:
+          return a < b;
+        default:
+          return a > b;
+      }
+    };
+  }
+
+  Operand parseOperand() {
+    skipSpace();
+    if (accept("[")) {
+      skipSpace();
+      uint16_t address;
+      if (!parseAddress(word(), address)) {
+        fail("expected an address after '['");
+        return {};
+      }
+      if (!accept("]")) {
+        fail("expected ']'");
+        return {};
+      }
+      return [address](const GameBoy &gameboy, const Stop &) {
+        return +gameboy.memory.peek(address);
+      };
+    }
+    std::string name = word();
+    if (Operand operand = registerOperand(name)) {
+      return operand;
+    }
+    uint32_t number;
+    if (!parseNumber(name, number)) {
+      fail(name.empty() ? "expected an operand" : "unknown operand '" + name +
+                                                      "'");
+      return {};
+    }
+    return [number](const GameBoy &, const Stop &) { return number; };
+  }
+
+  // The next run of letters, digits, '$' and '_'
+  std::string word() {
+    skipSpace();
+    size_t start = at;
+    while (at < text.size() &&
+           (std::isalnum(static_cast<unsigned char>(text[at])) ||
+            text[at] == '$' || text[at] == '_')) {
+      at++;
+    }
+    return text.substr(start, at - start);
+  }
+
+  bool accept(const char *token) {
+    skipSpace();
+    if (text.compare(at, std::char_traits<char>::length(token), token) != 0) {
+      return false;
+    }
+    at += std::char_traits<char>::length(token);
+    return true;
+  }
+
+  void skipSpace() {
+    while (at < text.size() &&
+           std::isspace(static_cast<unsigned char>(text[at]))) {
+      at++;
+    }
+  }
+
+  void fail(const std::string &message) {
+    if (problem.empty()) {
+      problem = message;
+    }
+  }
+
+  const std::string &text;
+  size_t at = 0;
+  std::string problem;
+};
+
+std::string hex(unsigned value, int digits) {
+  char buffer[8];
+  std::snprintf(buffer, sizeof(buffer), "$%0*X", digits, value);
+  return buffer;
+}
+
+}  // namespace
+
+Condition parseCondition(const std::string &text, std::string &error) {
+  Condition condition = ConditionParser(text).parse(error);
+  if (!condition && error.empty()) {
+    error = "empty condition";
+  }
+  return condition;
+}
+
+std::string describeStop(const GameBoy &gameboy, const Stop &stop) {
+  std::string text;
+  switch (stop.reason) {
+    case StopReason::None:
+      text = "ran out of cycles";
+      break;
+    case StopReason::Breakpoint:
+      text = "breakpoint " + std::to_string(stop.id) + " at " +
+             hex(stop.address, 4);
+      break;
+    case StopReason::Watchpoint:
+      text = "watchpoint " + std::to_string(stop.id) + ": " +
+             (stop.access == Access::Write ? "write " : "read ") +
+             hex(stop.value, 2) +
+             (stop.access == Access::Write ? " to " : " from ") +
+             hex(stop.address, 4);
+      break;
+    case StopReason::Step:
+      text = "step";
+      break;
+  }
+
+  const CPU &cpu = gameboy.cpu;
+  char registers[96];
+  std::snprintf(registers, sizeof(registers),
+                "\n  A=%02X F=%02X B=%02X C=%02X D=%02X E=%02X H=%02X L=%02X "
+                "SP=%04X PC=%04X",
+                cpu.A, cpu.F, cpu.B, cpu.C, cpu.D, cpu.E, cpu.H, cpu.L, cpu.SP,
+                cpu.PC);
+  text += registers;
+  text += " cycle " + std::to_string(cpu.cycles);
+  text += "\n  " + hex(cpu.PC, 4) + ": " +
+          formatInstruction(decodeInstruction(gameboy.memory, cpu.PC));
+  return text;
+}
+
+Debugger::Debugger(GameBoy &gameboy) : gameboy(gameboy) {}
+
+Debugger::~Debugger() { gameboy.memory.setTraps(nullptr, {}, {}); }
+
+int Debugger::addBreakpoint(uint16_t address, int bank, Condition condition) {
+  if (!inSwitchableBank(address)) {
+    bank = kAnyBank;
+  }
+  breakpoints.push_back({nextId, address, bank, std::move(condition)});
+  rebuild();
+  return nextId++;
+}
+
+int Debugger::addWatchpoint(uint16_t first, uint16_t last, Access access,
+                            Condition condition) {
+  if (last < first) {
+    std::swap(first, last);
+  }
+  watchpoints.push_back({nextId, first, last, access, std::move(condition)});
+  rebuild();
+  return nextId++;
+}
+
+bool Debugger::command(const std::string &line, std::string &error) {
+  std::string head = line;
+  std::string conditionText;
+  if (size_t at = line.find(" if "); at != std::string::npos) {
+    head = line.substr(0, at);
+    conditionText = line.substr(at + 4);
+  }
+  std::istringstream words(head);
+  std::string verb;
+  if (!(words >> verb) || verb.starts_with("#")) {
+    return true;
+  }
+
+  Condition condition;
+  if (!conditionText.empty() &&
+      !(condition = parseCondition(conditionText, error))) {
+    return false;
+  }
+
+  std::vector<std::string> arguments;
+  for (std::string argument; words >> argument;) {
+    arguments.push_back(argument);
+  }
+
+  if (verb == "break") {
+    uint16_t address;
+    uint32_t bank = 0;
+    bool banked = arguments.size() == 3 && arguments[1] == "bank";
+    if ((arguments.size() != 1 && !banked) ||
+        !parseAddress(arguments[0], address) ||
+        (banked && (!parseNumber(arguments[2], bank) || bank > 0x1FF))) {
+      error = "usage: break ADDRESS [bank N] [if CONDITION]";
+      return false;
+    }
+    addBreakpoint(address, banked ? static_cast<int>(bank) : kAnyBank,
+                  std::move(condition));
+    return true;
+  }
+
+  if (verb == "watch") {
+    static const std::pair<const char *, Access> kAccesses[] = {
+        {"r", Access::Read}, {"w", Access::Write}, {"rw", Access::ReadWrite}};
+    const Access *access = nullptr;
+    for (const auto &[name, value] : kAccesses) {
+      if (arguments.size() == 2 && arguments[0] == name) {
+        access = &value;
+      }
+    }
+    std::string range = arguments.size() == 2 ? arguments[1] : "";
+    size_t dash = range.find('-');
+    uint16_t first, last;
+    if (!access || !parseAddress(range.substr(0, dash), first) ||
+        !parseAddress(dash == std::string::npos ? range.substr(0, dash)
+                                                : range.substr(dash + 1),
+                      last)) {
+      error = "usage: watch r|w|rw FIRST[-LAST] [if CONDITION]";
+      return false;
+    }
+    addWatchpoint(first, last, *access, std::move(condition));
+    return true;
+  }
+
+  if (verb == "delete") {
+    uint32_t id;
+    if (arguments.size() != 1 || !parseNumber(arguments[0], id) ||
+        !remove(static_cast<int>(id))) {
+      error = "usage: delete ID (of a breakpoint or watchpoint)";
+      return false;
+    }
+    return true;
+  }
+
+  error = "unknown command '" + verb + "'";
+  return false;
+}
+
+bool Debugger::remove(int id) {
+  size_t count = breakpoints.size() + watchpoints.size();
+  std::erase_if(breakpoints,
+                [id](const Breakpoint &point) { return point.id == id; });
+  std::erase_if(watchpoints,
+                [id](const Watchpoint &point) { return point.id == id; });
+  if (breakpoints.size() + watchpoints.size() == count) {
+    return false;
+  }
+  rebuild();
+  return true;
+}
+
+void Debugger::clear() {
+  breakpoints.clear();
+  watchpoints.clear();
+  rebuild();
+}
+
+Stop Debugger::run(uint64_t count) { return execute(count, false); }
+
+Stop Debugger::step() { return execute(0, true); }
+
+/**
+ * @brief GameBoy::runCycles with a breakpoint check before each instruction
+ * and a watchpoint check after it.
+ */
+Stop Debugger::execute(uint64_t count, bool single) {
+  CPU &cpu = gameboy.cpu;
+  // Skipped iterations would pass breakpoints and hide watched accesses
+  bool idleLoopSkipping = gameboy.idleLoopSkipping;
+  gameboy.idleLoopSkipping = idleLoopSkipping && empty();
+  if (!single) {
+    gameboy.stopAt = cpu.cycles + count;
+  }
+  gameboy.memory.io.syncJoypad();
+  std::optional<uint16_t> resume = std::exchange(resumeFrom, std::nullopt);
+  pending = {};
+
+  Stop stop;
+  while (single || cpu.cycles < gameboy.stopAt) {
+    if (cpu.beginInstruction()) {
+      if (!single && !breakpoints.empty() && cpu.PC != resume &&
+          breakpointAt(cpu.PC, stop)) {
+        resumeFrom = cpu.PC;
+        break;
+      }
+      cpu.execute(cpu.fetchByte());
+    }
+    resume.reset();
+    gameboy.finishInstruction();
+    if (pending.reason != StopReason::None) {
+      stop = std::exchange(pending, {});
+      break;
+    }
+    if (single) {
+      stop = {StopReason::Step, 0, cpu.PC};
+      break;
+    }
+  }
+
+  gameboy.stopAt = Scheduler::kNever;
+  gameboy.idleLoopSkipping = idleLoopSkipping;
+  return stop;
+}
+
+bool Debugger::breakpointAt(uint16_t pc, Stop &stop) {
+  bool hit = anyBank[pc];
+  if (!hit && inSwitchableBank(pc) && !romBanks.empty()) {
+    auto bank = romBanks.find(gameboy.memory.romBank());
+    hit = bank != romBanks.end() && bank->second[pc - 0x4000];
+  }
+  if (!hit) {
+    return false;
+  }
+  for (const Breakpoint &point : breakpoints) {
+    if (point.address != pc ||
+        (point.bank != kAnyBank && point.bank != gameboy.memory.romBank())) {
+      continue;
+    }
+    Stop candidate{StopReason::Breakpoint, point.id, pc};
+    if (!point.condition || point.condition(gameboy, candidate)) {
+      stop = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Rebuilds the breakpoint bitmaps and the trapped pages.
+ */
+void Debugger::rebuild() {
+  anyBank.reset();
+  romBanks.clear();
+  for (const Breakpoint &point : breakpoints) {
+    if (point.bank == kAnyBank) {
+      anyBank.set(point.address);
+    } else {
+      romBanks[static_cast<uint16_t>(point.bank)].set(point.address - 0x4000);
+    }
+  }
+
+  std::bitset<0x100> reads, writes;
+  for (const Watchpoint &point : watchpoints) {
+    for (unsigned page = point.first >> 8; page <= point.last >> 8u; page++) {
+      reads[page] = reads[page] || allows(point.access, Access::Read);
+      writes[page] = writes[page] || allows(point.access, Access::Write);
+    }
+  }
+  gameboy.memory.setTraps(watchpoints.empty() ? nullptr : this, reads,
+                          writes);
+}
+
+void Debugger::watched(uint16_t address, uint8_t value, Access access) {
+  if (pending.reason != StopReason::None) {
+    return;
+  }
+  for (const Watchpoint &point : watchpoints) {
+    if (address < point.first || address > point.last ||
+        !allows(point.access, access)) {
+      continue;
+    }
+    Stop candidate{StopReason::Watchpoint, point.id, address, access, value};
+    if (!point.condition || point.condition(gameboy, candidate)) {
+      pending = candidate;
+      return;
+    }
+  }
+}
+
+void Debugger::watchedRead(uint16_t address, uint8_t value) {
+  watched(address, value, Access::Read);
+}
+
+void Debugger::watchedWrite(uint16_t address, uint8_t value) {
+  watched(address, value, Access::Write);
+}
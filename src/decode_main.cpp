@@ -0,0 +1,141 @@
+/**
+ * @file decode_main.cpp
+ * @brief Capture decoder: exports a capture written by the runner's
+ * --capture as a PNG sequence and a WAV file.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/capture.hpp"
+#include "../include/image.hpp"
+
+namespace {
+
+struct Options {
+  std::string capturePath;
+  std::string pngDirectory;
+  std::string wavPath;
+  uint64_t first = 0;
+  uint64_t count = UINT64_MAX;
+};
+
+void printUsage(const char *program) {
+  std::cerr << "Usage: " << program << " <capture.gbv> [options]\n"
+            << "  --png DIR           Write frames as DIR/frame_NNNNNN.png\n"
+            << "  --wav PATH          Write the sound as a WAV file\n"
+            << "  --first N           First frame to write (default 0)\n"
+            << "  --count N           Frames to write (default all)\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(arg, "--png") == 0 && hasValue) {
+      options.pngDirectory = argv[++i];
+    } else if (std::strcmp(arg, "--wav") == 0 && hasValue) {
+      options.wavPath = argv[++i];
+    } else if (std::strcmp(arg, "--first") == 0 && hasValue) {
+      options.first = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--count") == 0 && hasValue) {
+      options.count = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg[0] != '-' && options.capturePath.empty()) {
+      options.capturePath = arg;
+    } else {
+      return false;
+    }
+  }
+  return !options.capturePath.empty();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  CaptureReader reader;
+  std::string error;
+  if (!reader.open(options.capturePath, error)) {
+    std::cerr << "Failed to read " << options.capturePath << ": " << error
+              << "\n";
+    return 1;
+  }
+  const CaptureFormat &format = reader.getFormat();
+  if (!options.pngDirectory.empty()) {
+    std::error_code code;
+    std::filesystem::create_directories(options.pngDirectory, code);
+    if (code) {
+      std::cerr << options.pngDirectory << ": " << code.message() << "\n";
+      return 1;
+    }
+  }
+
+  uint64_t frames = 0, written = 0;
+  std::vector<int16_t> samples;
+  for (CaptureReader::Record record;;) {
+    if (!reader.next(record, error)) {
+      std::cerr << options.capturePath << ": " << error << " after "
+                << frames << " frames\n";
+      return 1;
+    }
+    if (record == CaptureReader::Record::End) {
+      break;
+    }
+    if (record == CaptureReader::Record::Audio) {
+      if (!options.wavPath.empty()) {
+        samples.insert(samples.end(), reader.audio().begin(),
+                       reader.audio().end());
+      }
+      continue;
+    }
+    uint64_t frame = frames++;
+    if (options.pngDirectory.empty() || frame < options.first ||
+        frame - options.first >= options.count) {
+      continue;
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "frame_%06llu.png",
+                  static_cast<unsigned long long>(frame));
+    std::string path =
+        (std::filesystem::path(options.pngDirectory) / name).string();
+    if (!writePng(path, framebufferImage(reader.frame(),
+                                         format.bytesPerPixel == 2))) {
+      std::cerr << "Failed to write " << path << "\n";
+      return 1;
+    }
+    written++;
+  }
+
+  if (!options.wavPath.empty()) {
+    if (format.sampleRate == 0) {
+      std::cerr << options.capturePath << " has no sound\n";
+      return 1;
+    }
+    std::vector<uint8_t> wav =
+        encodeWav(samples, format.sampleRate, format.channels);
+    std::ofstream file(options.wavPath, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(wav.data()), wav.size());
+    if (!file) {
+      std::cerr << "Failed to write " << options.wavPath << "\n";
+      return 1;
+    }
+  }
+  std::cout << frames << " frames";
+  if (format.sampleRate) {
+    std::cout << ", " << samples.size() / format.channels << " samples at "
+              << format.sampleRate << " Hz";
+  }
+  std::cout << "; wrote " << written << " PNGs\n";
+  return 0;
+}
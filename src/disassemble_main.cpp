@@ -0,0 +1,111 @@
+/**
+ * @file disassemble_main.cpp
+ * @brief ROM disassembler: lists the code the static analyzer reaches,
+ * block by block.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../include/code_index.hpp"
+#include "../include/disassembler.hpp"
+
+namespace {
+
+struct Options {
+  std::string romPath;
+  bool summaryOnly = false;
+};
+
+void printUsage(const char *program) {
+  std::cerr << "Usage: " << program << " <rom.gb> [options]\n"
+            << "  --summary           Only print the index totals\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    if (std::strcmp(arg, "--summary") == 0) {
+      options.summaryOnly = true;
+    } else if (arg[0] != '-' && options.romPath.empty()) {
+      options.romPath = arg;
+    } else {
+      return false;
+    }
+  }
+  return !options.romPath.empty();
+}
+
+std::string locationName(RomLocation location) {
+  char name[16];
+  std::snprintf(name, sizeof(name), "%02X:%04X", location.bank,
+                location.address);
+  return name;
+}
+
+void printBlock(const std::vector<uint8_t> &rom, const BasicBlock &block) {
+  std::cout << locationName(block.start) << ":";
+  for (RomLocation successor : block.successors) {
+    std::cout << "  -> " << locationName(successor);
+  }
+  std::cout << "\n";
+
+  size_t offset = romOffset(block.start);
+  std::span<const uint8_t> code(
+      rom.data() + offset, std::min<size_t>(block.size, rom.size() - offset));
+  for (const Instruction &instruction :
+       disassemble(code, block.start.address)) {
+    char bytes[16] = "";
+    size_t used = 0;
+    for (uint8_t i = 0; i < instruction.length; i++) {
+      size_t at = instruction.address - block.start.address + i;
+      used += std::snprintf(bytes + used, sizeof(bytes) - used, "%02X ",
+                            at < code.size() ? code[at] : 0xFF);
+    }
+    std::printf("  %04X  %-10s%s\n", instruction.address, bytes,
+                formatInstruction(instruction).c_str());
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::ifstream file(options.romPath, std::ios::binary);
+  if (!file) {
+    std::cerr << "Failed to read " << options.romPath << "\n";
+    return 1;
+  }
+  std::vector<uint8_t> rom(std::istreambuf_iterator<char>(file), {});
+  CodeIndex index = buildCodeIndex(rom);
+
+  if (!options.summaryOnly) {
+    for (const BasicBlock &block : index.blocks) {
+      printBlock(rom, block);
+    }
+    for (const BankedCall &call : index.bankedCalls) {
+      std::cout << "banked call " << locationName(call.site) << " -> "
+                << locationName(call.target) << "\n";
+    }
+    for (RomLocation site : index.unresolved) {
+      std::cout << "unresolved " << locationName(site) << "\n";
+    }
+  }
+  std::cout << index.blocks.size() << " blocks, "
+            << index.branchTargets.size() << " branch targets, "
+            << index.bankedCalls.size() << " banked calls, "
+            << index.unresolved.size() << " unresolved\n";
+  return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file disassembler.cpp
+ * @brief Implementation of the SM83 disassembler.
+ */
+
+#include "../include/disassembler.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+constexpr const char *kRegisters[] = {"B", "C", "D",    "E",
+                                     "H", "L", "(HL)", "A"};
+
+// The 0xCB table is regular: bits 7-6 (and 5-3 below 0x40) pick the
+// operation, bits 5-3 the bit number, bits 2-0 the register
+constexpr const char *kShiftNames[] = {"RLC", "RRC", "RL",   "RR",
+                                       "SLA", "SRA", "SWAP", "SRL"};
+constexpr const char *kBitNames[] = {"BIT", "RES", "SET"};
+constexpr const char *kShiftHandlers[2][8] = {
+    {"RLC_r8", "RRC_r8", "RL_r8", "RR_r8", "SLA_r8", "SRA_r8", "SWAP_r8",
+     "SRL_r8"},
+    {"RLC_HL", "RRC_HL", "RL_HL", "RR_HL", "SLA_HL", "SRA_HL", "SWAP_HL",
+     "SRL_HL"}};
+constexpr const char *kBitHandlers[2][3] = {
+    {"BIT_u3_r8", "RES_u3_r8", "SET_u3_r8"},
+    {"BIT_u3_HL", "RES_u3_HL", "SET_u3_HL"}};
+
+void decodePrefixed(Instruction &instruction, uint8_t opcode) {
+  bool memoryOperand = (opcode & 0x07) == 6;
+  instruction.opcode = opcode;
+  instruction.prefixed = true;
+  instruction.length = 2;
+  if (opcode < 0x40) {
+    instruction.handler = kShiftHandlers[memoryOperand][opcode >> 3];
+    instruction.cycles = memoryOperand ? 16 : 8;
+  } else {
+    size_t operation = (opcode >> 6) - 1;
+    instruction.handler = kBitHandlers[memoryOperand][operation];
+    // BIT only reads (HL)
+    instruction.cycles = !memoryOperand ? 8 : operation == 0 ? 12 : 16;
+  }
+}
+
+// Replaces the first `placeholder` in `text`, if any
+bool substitute(std::string &text, const char *placeholder,
+                const std::string &value) {
+  size_t at = text.find(placeholder);
+  if (at == std::string::npos) {
+    return false;
+  }
+  text.replace(at, std::char_traits<char>::length(placeholder), value);
+  return true;
+}
+
+std::string hex(unsigned value, int digits) {
+  char buffer[8];
+  std::snprintf(buffer, sizeof(buffer), "$%0*X", digits, value);
+  return buffer;
+}
+
+}  // namespace
+
+Instruction decodeInstruction(std::span<const uint8_t> code,
+                              uint16_t address) {
+  auto byte = [&](size_t i) -> uint8_t {
+    return i < code.size() ? code[i] : 0xFF;
+  };
+
+  Instruction instruction;
+  instruction.address = address;
+  instruction.opcode = byte(0);
+  if (instruction.opcode == 0xCB) {
+    decodePrefixed(instruction, byte(1));
+    return instruction;
+  }
+
+  const OpcodeInfo &info = kOpcodes[instruction.opcode];
+  instruction.length = info.length;
+  instruction.handler = info.handler;
+  instruction.cycles = info.cycles;
+  instruction.takenCycles = info.takenCycles;
+  instruction.flow = info.flow;
+  if (info.length == 2) {
+    instruction.operand = byte(1);
+  } else if (info.length == 3) {
+    instruction.operand = byte(1) | byte(2) << 8;
+  }
+
+  switch (info.flow) {
+    case Flow::Jump:
+    case Flow::Branch:
+    case Flow::Call:
+      instruction.hasTarget = true;
+      if (info.length == 2) {  // JR: relative to the next instruction
+        instruction.target = static_cast<uint16_t>(
+            address + 2 + static_cast<int8_t>(instruction.operand));
+      } else if (info.length == 3) {
+        instruction.target = instruction.operand;
+      } else {  // RST
+        instruction.target = instruction.opcode & 0x38;
+      }
+      break;
+    default:
+      break;
+  }
+  return instruction;
+}
+
+Instruction decodeInstruction(const Memory &memory, uint16_t address) {
+  std::array<uint8_t, 3> bytes;
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] = memory.peek(static_cast<uint16_t>(address + i));
+  }
+  return decodeInstruction(bytes, address);
+}
+
+std::string formatInstruction(const Instruction &instruction) {
+  if (instruction.prefixed) {
+    uint8_t opcode = instruction.opcode;
+    std::string reg = kRegisters[opcode & 0x07];
+    if (opcode < 0x40) {
+      return std::string(kShiftNames[opcode >> 3]) + " " + reg;
+    }
+    return std::string(kBitNames[(opcode >> 6) - 1]) + " " +
+           std::to_string((opcode >> 3) & 0x07) + "," + reg;
+  }
+
+  std::string text = kOpcodes[instruction.opcode].mnemonic;
+  if (substitute(text, "n16", hex(instruction.operand, 4)) ||
+      substitute(text, "n8", hex(instruction.operand, 2)) ||
+      substitute(text, "a8", hex(0xFF00 | instruction.operand, 4))) {
+    return text;
+  }
+  if (instruction.hasTarget) {
+    substitute(text, "e8", hex(instruction.target, 4));
+    return text;
+  }
+  int offset = static_cast<int8_t>(instruction.operand);
+  std::string sign = offset < 0 ? "-" : "+";
+  if (!substitute(text, "+e8", sign + std::to_string(std::abs(offset)))) {
+    substitute(text, "e8", sign + std::to_string(std::abs(offset)));
+  }
+  return text;
+}
+
+std::vector<Instruction> disassemble(std::span<const uint8_t> code,
+                                     uint16_t address) {
+  std::vector<Instruction> instructions;
+  size_t offset = 0;
+  while (offset < code.size()) {
+    Instruction instruction = decodeInstruction(
+        code.subspan(offset), static_cast<uint16_t>(address + offset));
+    offset += instruction.length;
+    instructions.push_back(instruction);
+  }
+  return instructions;
+}
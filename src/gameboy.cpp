@@ -0,0 +1,301 @@
+/**
+ * @file gameboy.cpp
+ * @brief Implementation of the GameBoy class for the Game Boy emulator.
+ */
+
+#include "../include/gameboy.hpp"
+
+#include <algorithm>
+
+#include "../include/hash.hpp"
+#include "../include/profiler.hpp"
+#include "../include/save_state.hpp"
+
+namespace {
+
+constexpr char kStateMagic[4] = {'G', 'B', 'S', 'T'};
+constexpr uint32_t kStateVersion = 1;
+
+/**
+ * @brief An I/O register and the value the boot ROM leaves in it.
+ */
+struct PostBootRegister {
+  uint8_t index;
+  uint8_t value;
+};
+
+// Written in order through the handlers, so LCDC turns the LCD on
+constexpr PostBootRegister kPostBootRegisters[] = {
+    {IO::P1, 0xCF}, {IO::TAC, 0xF8}, {IO::IF, 0xE1},
+    // Sound, NR10-NR52
+    {0x10, 0x80}, {0x11, 0xBF}, {0x12, 0xF3}, {0x13, 0xFF}, {0x14, 0xBF},
+    {0x16, 0x3F}, {0x18, 0xFF}, {0x19, 0xBF}, {0x1A, 0x7F}, {0x1B, 0xFF},
+    {0x1C, 0x9F}, {0x1D, 0xFF}, {0x1E, 0xBF}, {0x20, 0xFF}, {0x23, 0xBF},
+    {0x24, 0x77}, {0x25, 0xF3}, {0x26, 0xF1},
+    {IO::LCDC, 0x91}, {0x47, 0xFC},  // BGP
+};
+
+}  // namespace
+
+template <typename Timing>
+BasicGameBoy<Timing>::BasicGameBoy(std::shared_ptr<Arena> arena)
+    : memory(arena), arena(std::move(arena)) {
+  // The LCD starts off; enabling it through LCDC schedules the PPU
+  memory.io.attach(&cpu.cycles, &scheduler, &ppu);
+  ppu.disable();
+  if constexpr (Timing::kMCycleBus) {
+    memory.catchUp = [this] { runEvents(); };
+  }
+}
+
+template <typename Timing>
+void BasicGameBoy<Timing>::loadRom(const std::vector<uint8_t> &rom) {
+  loadRom(Cartridge::prepare(rom));
+}
+
+template <typename Timing>
+void BasicGameBoy<Timing>::loadRom(Cartridge::Image rom) {
+  memory.loadRom(std::move(rom));
+  cpu.PC = 0x0100;  // Cartridge entry point
+  cpu.SP = 0xFFFE;
+}
+
+template <typename Timing>
+bool BasicGameBoy<Timing>::runBootRom(const std::vector<uint8_t> &image) {
+  return runBootRom(std::make_shared<const std::vector<uint8_t>>(image));
+}
+
+template <typename Timing>
+bool BasicGameBoy<Timing>::runBootRom(Cartridge::Image image) {
+  if (!memory.mapBootRom(std::move(image))) {
+    return false;
+  }
+  cpu.setAF(0);
+  cpu.setBC(0);
+  cpu.setDE(0);
+  cpu.setHL(0);
+  cpu.SP = 0;
+  cpu.PC = 0;
+  return true;
+}
+
+template <typename Timing>
+void BasicGameBoy<Timing>::fastBoot() {
+  memory.unmapBootRom();
+  if (memory.isCgb()) {
+    cpu.setAF(0x1180);
+    cpu.setBC(0x0000);
+    cpu.setDE(0xFF56);
+    cpu.setHL(0x000D);
+  } else {
+    // H and C are set unless the header checksum is zero
+    cpu.setAF(memory.peek(0x014D) ? 0x01B0 : 0x0180);
+    cpu.setBC(0x0013);
+    cpu.setDE(0x00D8);
+    cpu.setHL(0x014D);
+  }
+  cpu.SP = 0xFFFE;
+  cpu.PC = 0x0100;
+
+  IO &io = memory.io;
+  for (const PostBootRegister &entry : kPostBootRegisters) {
+    io.write(entry.index, entry.value);
+  }
+  io.reg(0xFF00 | IO::DMA) = 0xFF;  // Written directly: no transfer
+  // The CGB boot ROM's length depends on the header; this is typical
+  io.setDivider(memory.isCgb() ? 0x1EA0 : 0xABCC);
+}
+
+template <typename Timing>
+std::unique_ptr<BasicGameBoy<Timing>> BasicGameBoy<Timing>::fork() {
+  auto child = std::make_unique<BasicGameBoy>(
+      arena ? std::make_shared<Arena>(arena->chunkSize()) : nullptr);
+  child->resetTo(*this);
+  return child;
+}
+
+template <typename Timing>
+void BasicGameBoy<Timing>::resetTo(BasicGameBoy &snapshot) {
+  memory = snapshot.memory.fork();
+  cpu = snapshot.cpu;
+  ppu = snapshot.ppu;
+  scheduler = snapshot.scheduler;
+  idleLoopSkipping = snapshot.idleLoopSkipping;
+  skippedIdleCycles = snapshot.skippedIdleCycles;
+}
+
+template <typename Timing>
+uint64_t BasicGameBoy<Timing>::stateHash() const {
+  uint64_t hash = fnv1aValue(cpu.stateHash(), kFnvOffsetBasis);
+  hash = fnv1aValue(memory.hash(), hash);
+  hash = fnv1aValue(ppu.stateHash(), hash);
+  // Profiling must not change the hash
+  uint64_t nextEvent = Scheduler::kNever;
+  for (size_t i = 0; i < static_cast<size_t>(Event::Count); i++) {
+    Event event = static_cast<Event>(i);
+    if (event != Event::Profile) {
+      nextEvent = std::min(nextEvent, scheduler.eventTime(event));
+    }
+  }
+  return fnv1aValue(nextEvent, hash);
+}
+
+template <typename Timing>
+std::vector<uint8_t> BasicGameBoy<Timing>::saveState() const {
+  StateWriter out;
+  out.write(reinterpret_cast<const uint8_t *>(kStateMagic),
+            sizeof(kStateMagic));
+  out.write(kStateVersion);
+  memory.saveState(out);
+  cpu.saveState(out);
+  ppu.saveState(out);
+  for (size_t i = 0; i < static_cast<size_t>(Event::Count); i++) {
+    Event event = static_cast<Event>(i);
+    out.write(event == Event::Profile ? Scheduler::kNever
+                                      : scheduler.eventTime(event));
+  }
+  out.write(skippedIdleCycles);
+  return std::move(out.data());
+}
+
+template <typename Timing>
+bool BasicGameBoy<Timing>::loadState(std::span<const uint8_t> data,
+                                     std::string &error) {
+  StateReader in(data);
+  const uint8_t *magic = in.take(sizeof(kStateMagic));
+  if (!magic || !std::equal(kStateMagic, kStateMagic + sizeof(kStateMagic),
+                            reinterpret_cast<const char *>(magic))) {
+    error = "not a saved state";
+    return false;
+  }
+  if (in.read<uint32_t>() != kStateVersion) {
+    error = "unsupported state version";
+    return false;
+  }
+  if (!memory.loadState(in, error)) {
+    return false;
+  }
+  cpu.loadState(in);
+  bool valid = ppu.loadState(in);
+  for (size_t i = 0; i < static_cast<size_t>(Event::Count); i++) {
+    Event event = static_cast<Event>(i);
+    uint64_t time = in.read<uint64_t>();
+    if (event != Event::Profile) {
+      scheduler.schedule(event, time);
+    }
+  }
+  skippedIdleCycles = in.read<uint64_t>();
+  if (!in.ok() || !in.atEnd()) {
+    error = in.ok() ? "trailing data after state" : "truncated state";
+    return false;
+  }
+  if (!valid) {
+    error = "corrupt state";
+    return false;
+  }
+  return true;
+}
+
+template <typename Timing>
+void BasicGameBoy<Timing>::step() {
+  cpu.executeOpcode();
+  finishInstruction();
+}
+
+/**
+ * @brief Everything that follows an instruction: HALT fast-forwarding,
+ * device events and idle-loop skipping.
+ */
+template <typename Timing>
+void BasicGameBoy<Timing>::finishInstruction() {
+  if (cpu.halted) {
+    // Nothing can wake the CPU before the next event
+    cpu.skipHalt(std::min(scheduler.nextEventTime(), stopAt));
+  }
+  runEvents();
+  if (idleLoopSkipping && cpu.jumpedBack) {
+    skipIdleLoop();
+  }
+}
+
+template <typename Timing>
+void BasicGameBoy<Timing>::runCycles(uint64_t count) {
+  stopAt = cpu.cycles + count;
+  memory.io.syncJoypad();  // Input may have changed on another thread
+  while (cpu.cycles < stopAt) {
+    step();
+  }
+  stopAt = Scheduler::kNever;
+}
+
+template <typename Timing>
+void BasicGameBoy<Timing>::runEvents() {
+  Event event;
+  uint64_t time;
+  while (scheduler.popDue(cpu.cycles, event, time)) {
+    switch (event) {
+      case Event::PPU: {
+        uint32_t dots = ppu.advanceMode();
+        scheduler.schedule(Event::PPU, time + (dots << memory.io.speedShift()));
+        break;
+      }
+      case Event::Timer:
+        memory.io.timerOverflow(time);
+        break;
+      case Event::Dma:
+        memory.io.finishDma();
+        break;
+      case Event::Serial:
+        memory.io.finishSerial(time);
+        break;
+      case Event::Link:
+        memory.io.syncSerial(time);
+        break;
+      case Event::Profile:
+        if (cpu.profiler) {
+          cpu.profiler->sample();
+          scheduler.schedule(Event::Profile, time + cpu.profiler->interval());
+        }
+        break;
+      case Event::Count:
+        break;
+    }
+  }
+}
+
+/**
+ * @brief Fast-forwards a polling loop that has just jumped back to its head.
+ *
+ * The loop reads the polled value once per iteration, at the start of the
+ * iteration. Every iteration that starts before the next event (or the end
+ * of the current run) reads the same value, so all but the last of them can
+ * be replaced by advancing the clock; the last one runs normally, ending the
+ * skip strictly before anything else can happen. Nothing is skipped while an
+ * enabled interrupt is pending, as it would be dispatched first.
+ */
+template <typename Timing>
+void BasicGameBoy<Timing>::skipIdleLoop() {
+  typename BasicCPU<Timing>::IdlePoll poll;
+  if (!cpu.matchIdlePoll(poll)) {
+    return;
+  }
+
+  uint64_t horizon = std::min(scheduler.nextEventTime(), stopAt);
+  if (horizon <= cpu.cycles) {
+    return;
+  }
+  uint64_t iterations = (horizon - cpu.cycles - 1) / poll.iterationCycles;
+  if (iterations == 0) {
+    return;
+  }
+
+  // kNever horizons (LCD and timer off) are cut to what the count can hold
+  iterations = std::min<uint64_t>(iterations, UINT32_MAX);
+  uint64_t before = cpu.cycles;
+  if (cpu.skipIdlePoll(poll, static_cast<uint32_t>(iterations))) {
+    skippedIdleCycles += cpu.cycles - before;
+  }
+}
+
+template class BasicGameBoy<FastTiming>;
+template class BasicGameBoy<AccurateTiming>;
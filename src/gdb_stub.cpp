@@ -0,0 +1,659 @@
+/**
+ * @file gdb_stub.cpp
+ * @brief Implementation of the GDB remote serial protocol stub.
+ */
+
+#include "../include/gdb_stub.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Registers in `g` packets, each 16 bits little-endian
+constexpr size_t kRegisterCount = 6;  // AF BC DE HL SP PC
+
+// Longest `m` reply, in bytes of memory
+constexpr uint32_t kMaxReadLength = 0x800;
+
+uint8_t checksum(const std::string &payload) {
+  uint8_t sum = 0;
+  for (char c : payload) {
+    sum += static_cast<uint8_t>(c);
+  }
+  return sum;
+}
+
+int hexDigit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+// Parses hex digits from `at` up to `end` (or the end of `text`), which
+// must be at least one and at most eight
+bool parseHex(const std::string &text, size_t at, size_t end,
+              uint32_t &value) {
+  end = std::min(end, text.size());
+  if (at >= end || end - at > 8) {
+    return false;
+  }
+  value = 0;
+  for (; at < end; at++) {
+    int digit = hexDigit(text[at]);
+    if (digit < 0) {
+      return false;
+    }
+    value = value << 4 | digit;
+  }
+  return true;
+}
+
+void appendHexByte(std::string &text, uint8_t value) {
+  static const char kDigits[] = "0123456789abcdef";
+  text += kDigits[value >> 4];
+  text += kDigits[value & 0x0F];
+}
+
+bool parseHexByte(const std::string &text, size_t at, uint8_t &value) {
+  uint32_t parsed;
+  if (!parseHex(text, at, at + 2, parsed) || at + 2 > text.size()) {
+    return false;
+  }
+  value = static_cast<uint8_t>(parsed);
+  return true;
+}
+
+void sendAll(int socket, const std::string &data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t count = ::send(socket, data.data() + sent, data.size() - sent,
+                           MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return;  // The reader notices the broken connection
+    }
+    sent += count;
+  }
+}
+
+std::string socketError(const char *what) {
+  return std::string(what) + ": " + std::strerror(errno);
+}
+
+}  // namespace
+
+GdbStub::GdbStub(GameBoy &gameboy) : gameboy(gameboy), debugger(gameboy) {}
+
+GdbStub::~GdbStub() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    closing = true;
+  }
+  wake.notify_all();
+  if (listener >= 0) {
+    ::shutdown(listener, SHUT_RDWR);  // Wakes accept()
+  }
+  {
+    std::lock_guard<std::mutex> lock(sendMutex);
+    if (client >= 0) {
+      ::shutdown(client, SHUT_RDWR);  // Wakes recv()
+    }
+  }
+  if (thread.joinable()) {
+    thread.join();
+  }
+  if (listener >= 0) {
+    ::close(listener);
+  }
+  if (!unixPath.empty()) {
+    ::unlink(unixPath.c_str());
+  }
+}
+
+bool GdbStub::listenTcp(uint16_t port, std::string &error) {
+  int socket = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (socket < 0) {
+    error = socketError("socket");
+    return false;
+  }
+  int reuse = 1;
+  ::setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  if (::bind(socket, reinterpret_cast<sockaddr *>(&address), length) < 0 ||
+      ::getsockname(socket, reinterpret_cast<sockaddr *>(&address),
+                    &length) < 0) {
+    error = socketError("bind");
+    ::close(socket);
+    return false;
+  }
+  tcpPort = ntohs(address.sin_port);
+  return startListening(socket, error);
+}
+
+bool GdbStub::listenUnix(const std::string &path, std::string &error) {
+  sockaddr_un address{};
+  if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+    error = "bad socket path " + path;
+    return false;
+  }
+  int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket < 0) {
+    error = socketError("socket");
+    return false;
+  }
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, path.c_str(), path.size());
+  ::unlink(path.c_str());
+  if (::bind(socket, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) < 0) {
+    error = socketError("bind");
+    ::close(socket);
+    return false;
+  }
+  unixPath = path;
+  return startListening(socket, error);
+}
+
+bool GdbStub::startListening(int socket, std::string &error) {
+  if (thread.joinable()) {
+    error = "already listening";
+    ::close(socket);
+    return false;
+  }
+  if (::listen(socket, 1) < 0) {
+    error = socketError("listen");
+    ::close(socket);
+    return false;
+  }
+  listener = socket;
+  thread = std::thread(&GdbStub::serve, this);
+  return true;
+}
+
+void GdbStub::waitForClient() {
+  std::unique_lock<std::mutex> lock(mutex);
+  wake.wait(lock, [this] { return connected || closing; });
+}
+
+/**
+ * @brief The stub's thread: accepts clients one after another.
+ */
+void GdbStub::serve() {
+  while (true) {
+    int socket = ::accept(listener, nullptr, nullptr);
+    if (socket < 0) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (closing || (errno != EINTR && errno != ECONNABORTED)) {
+        return;
+      }
+      continue;
+    }
+    // Packets are small and each waits for an answer (fails harmlessly on
+    // Unix sockets)
+    int noDelay = 1;
+    ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    {
+      std::lock_guard<std::mutex> lock(sendMutex);
+      client = socket;
+      acknowledging = true;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      connected = true;
+      session++;
+      requests.clear();
+      // A client expects the machine stopped when it attaches
+      request.store(Request::Attach, std::memory_order_release);
+    }
+    wake.notify_all();
+
+    converse(socket);
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      connected = false;
+      request.store(Request::Detach, std::memory_order_release);
+      wake.notify_all();
+      // Let the emulation thread see this client go before the next comes
+      wake.wait(lock, [this] { return !stopped || closing; });
+    }
+    std::lock_guard<std::mutex> lock(sendMutex);
+    ::close(socket);
+    client = -1;
+  }
+}
+
+/**
+ * @brief Reads packets from a client until it disconnects.
+ */
+void GdbStub::converse(int socket) {
+  std::string buffer;
+  char chunk[4096];
+  while (true) {
+    ssize_t count = ::recv(socket, chunk, sizeof(chunk), 0);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return;
+    }
+    buffer.append(chunk, count);
+
+    size_t at = 0;
+    while (at < buffer.size()) {
+      if (buffer[at] == '\x03') {  // ^C: stop the machine
+        request.store(Request::Interrupt, std::memory_order_release);
+        at++;
+        continue;
+      }
+      if (buffer[at] != '$') {
+        at++;  // Acknowledgements, which are not acted on
+        continue;
+      }
+      size_t hash = buffer.find('#', at);
+      if (hash == std::string::npos || hash + 3 > buffer.size()) {
+        break;  // Wait for the rest
+      }
+      std::string payload = buffer.substr(at + 1, hash - at - 1);
+      uint8_t sum;
+      bool valid = parseHexByte(buffer, hash + 1, sum) &&
+                   sum == checksum(payload);
+      at = hash + 3;
+      if (acknowledging) {
+        std::lock_guard<std::mutex> lock(sendMutex);
+        sendAll(socket, valid ? "+" : "-");
+      }
+      if (valid && !handleLocally(payload)) {
+        forward(std::move(payload));
+      }
+    }
+    buffer.erase(0, at);
+  }
+}
+
+/**
+ * @brief Answers the packets that do not involve the machine.
+ *
+ * @return False if the packet is for the emulation thread.
+ */
+bool GdbStub::handleLocally(const std::string &packet) {
+  if (packet.starts_with("qSupported")) {
+    send("PacketSize=1000;QStartNoAckMode+");
+  } else if (packet == "QStartNoAckMode") {
+    send("OK");
+    acknowledging = false;
+  } else if (packet == "qAttached") {
+    send("1");
+  } else if (packet == "qC") {
+    send("QC1");
+  } else if (packet == "qfThreadInfo") {
+    send("m1");
+  } else if (packet == "qsThreadInfo") {
+    send("l");
+  } else if (packet.starts_with("H") || packet.starts_with("T")) {
+    send("OK");  // There is one thread
+  } else if (packet.empty() ||
+             std::strchr("?gGpPmMcsZzDk", packet[0]) == nullptr) {
+    send("");  // Not supported
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void GdbStub::send(const std::string &packet) {
+  char trailer[4];
+  std::snprintf(trailer, sizeof(trailer), "#%02x", checksum(packet));
+  std::lock_guard<std::mutex> lock(sendMutex);
+  if (client >= 0) {
+    sendAll(client, "$" + packet + trailer);
+  }
+}
+
+/**
+ * @brief Queues a packet for the emulation thread, stopping the machine if
+ * it is running.
+ */
+void GdbStub::forward(std::string packet) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    requests.push_back(std::move(packet));
+    Request none = Request::None;
+    if (!stopped) {
+      request.compare_exchange_strong(none, Request::Attach);
+    }
+  }
+  wake.notify_all();
+}
+
+void GdbStub::runCycles(uint64_t count) {
+  uint64_t end = gameboy.cpu.cycles + count;
+  while (gameboy.cpu.cycles < end) {
+    switch (request.exchange(Request::None, std::memory_order_acquire)) {
+      case Request::Attach:
+        serveStopped();
+        continue;
+      case Request::Interrupt:
+        lastStop = "S02";  // SIGINT
+        send(lastStop);
+        serveStopped();
+        continue;
+      case Request::Detach:
+        debugger.clear();
+        points.clear();
+        continue;
+      case Request::None:
+        break;
+    }
+    if (debugger.empty()) {
+      gameboy.runCycles(end - gameboy.cpu.cycles);
+      return;
+    }
+    Stop stop = debugger.run(end - gameboy.cpu.cycles);
+    if (stop.reason != StopReason::None) {
+      reportStop(stop);
+      serveStopped();
+    }
+  }
+}
+
+/**
+ * @brief Serves the client's requests until it resumes the machine or
+ * goes away.
+ */
+void GdbStub::serveStopped() {
+  std::unique_lock<std::mutex> lock(mutex);
+  stopped = true;
+  // Requests to stop made before this are answered by this stop
+  Request expected = Request::Attach;
+  request.compare_exchange_strong(expected, Request::None);
+  expected = Request::Interrupt;
+  request.compare_exchange_strong(expected, Request::None);
+  if (servedSession != session) {
+    // A new client starts afresh, whether or not the last one's detach
+    // was seen
+    servedSession = session;
+    debugger.clear();
+    points.clear();
+    lastStop = "S05";
+  }
+
+  while (true) {
+    wake.wait(lock, [this] { return !requests.empty() || !connected; });
+    if (requests.empty()) {  // The client went away
+      debugger.clear();
+      points.clear();
+      break;
+    }
+    std::string packet = std::move(requests.front());
+    requests.pop_front();
+    lock.unlock();
+    bool resume = handle(packet);
+    lock.lock();
+    if (resume) {
+      break;
+    }
+  }
+  stopped = false;
+  lock.unlock();
+  wake.notify_all();
+}
+
+/**
+ * @brief Handles a packet on the emulation thread, with the machine
+ * stopped.
+ *
+ * @return True if the machine should run on.
+ */
+bool GdbStub::handle(const std::string &packet) {
+  CPU &cpu = gameboy.cpu;
+  switch (packet[0]) {
+    case '?':
+      send(lastStop);
+      return false;
+
+    case 'g':
+      send(readRegisters());
+      return false;
+
+    case 'G': {
+      uint8_t bytes[kRegisterCount * 2];
+      for (size_t i = 0; i < sizeof(bytes); i++) {
+        if (!parseHexByte(packet, 1 + i * 2, bytes[i])) {
+          send("E01");
+          return false;
+        }
+      }
+      cpu.F = bytes[0] & 0xF0;
+      cpu.A = bytes[1];
+      cpu.setBC(bytes[3] << 8 | bytes[2]);
+      cpu.setDE(bytes[5] << 8 | bytes[4]);
+      cpu.setHL(bytes[7] << 8 | bytes[6]);
+      cpu.SP = bytes[9] << 8 | bytes[8];
+      cpu.PC = bytes[11] << 8 | bytes[10];
+      send("OK");
+      return false;
+    }
+
+    case 'p': {
+      uint32_t index;
+      if (!parseHex(packet, 1, packet.size(), index)) {
+        send("E01");
+      } else if (index >= kRegisterCount) {
+        send("xxxx");  // Unavailable
+      } else {
+        send(readRegisters().substr(index * 4, 4));
+      }
+      return false;
+    }
+
+    case 'P': {
+      size_t equals = packet.find('=');
+      uint32_t index;
+      uint8_t low, high;
+      if (equals == std::string::npos ||
+          !parseHex(packet, 1, equals, index) || index >= kRegisterCount ||
+          !parseHexByte(packet, equals + 1, low) ||
+          !parseHexByte(packet, equals + 3, high)) {
+        send("E01");
+        return false;
+      }
+      uint16_t value = high << 8 | low;
+      switch (index) {
+        case 0:
+          cpu.A = value >> 8;
+          cpu.F = value & 0xF0;
+          break;
+        case 1:
+          cpu.setBC(value);
+          break;
+        case 2:
+          cpu.setDE(value);
+          break;
+        case 3:
+          cpu.setHL(value);
+          break;
+        case 4:
+          cpu.SP = value;
+          break;
+        default:
+          cpu.PC = value;
+          break;
+      }
+      send("OK");
+      return false;
+    }
+
+    case 'm':
+    case 'M': {
+      size_t comma = packet.find(',');
+      size_t colon = packet.find(':');
+      uint32_t address, length;
+      if (comma == std::string::npos ||
+          !parseHex(packet, 1, comma, address) ||
+          !parseHex(packet, comma + 1, colon, length) || address > 0xFFFF ||
+          (packet[0] == 'm' && length > kMaxReadLength) ||
+          (packet[0] == 'M' && (colon == std::string::npos ||
+                                packet.size() - colon - 1 != length * 2))) {
+        send("E01");
+        return false;
+      }
+      std::string reply;
+      for (uint32_t i = 0; i < length; i++) {
+        uint16_t at = static_cast<uint16_t>(address + i);
+        if (packet[0] == 'm') {
+          appendHexByte(reply, gameboy.memory.peek(at));
+        } else {
+          uint8_t value;
+          if (!parseHexByte(packet, colon + 1 + i * 2, value)) {
+            send("E01");
+            return false;
+          }
+          gameboy.memory.poke(at, value);
+        }
+      }
+      send(packet[0] == 'm' ? reply : "OK");
+      return false;
+    }
+
+    case 'c':
+    case 's': {
+      uint32_t address;
+      if (packet.size() > 1 && parseHex(packet, 1, packet.size(), address)) {
+        cpu.PC = static_cast<uint16_t>(address);
+      }
+      if (packet[0] == 'c') {
+        return true;
+      }
+      reportStop(debugger.step());
+      return false;
+    }
+
+    case 'Z':
+    case 'z':
+      send(setBreakpoint(packet));
+      return false;
+
+    case 'D':
+      send("OK");
+      [[fallthrough]];
+    case 'k':
+      debugger.clear();
+      points.clear();
+      return true;
+
+    default:
+      send("");
+      return false;
+  }
+}
+
+void GdbStub::reportStop(const Stop &stop) {
+  lastStop = "S05";  // SIGTRAP
+  if (stop.reason == StopReason::Watchpoint) {
+    const char *kind = "awatch";
+    for (const auto &[point, id] : points) {
+      if (id == stop.id) {
+        kind = point.first == '2' ? "watch" : point.first == '3' ? "rwatch"
+                                                                 : "awatch";
+      }
+    }
+    char reply[32];
+    std::snprintf(reply, sizeof(reply), "T05%s:%x;", kind, stop.address);
+    lastStop = reply;
+  }
+  send(lastStop);
+}
+
+std::string GdbStub::readRegisters() const {
+  const CPU &cpu = gameboy.cpu;
+  const uint16_t registers[kRegisterCount] = {
+      static_cast<uint16_t>(cpu.A << 8 | cpu.F),
+      static_cast<uint16_t>(cpu.B << 8 | cpu.C),
+      static_cast<uint16_t>(cpu.D << 8 | cpu.E),
+      static_cast<uint16_t>(cpu.H << 8 | cpu.L),
+      cpu.SP,
+      cpu.PC};
+  std::string text;
+  for (uint16_t value : registers) {
+    appendHexByte(text, value & 0xFF);
+    appendHexByte(text, value >> 8);
+  }
+  return text;
+}
+
+/**
+ * @brief Handles `Z` and `z` packets: type,address,length.
+ */
+std::string GdbStub::setBreakpoint(const std::string &packet) {
+  size_t first = packet.find(',');
+  size_t second = packet.find(',', first + 1);
+  uint32_t address, length;
+  if (packet.size() < 2 || first != 2 || second == std::string::npos ||
+      !parseHex(packet, first + 1, second, address) ||
+      !parseHex(packet, second + 1, packet.find(';'), length)) {
+    return "E01";
+  }
+  char type = packet[1];
+  if (type < '0' || type > '4') {
+    return "";
+  }
+  auto key = std::make_pair(type, address);
+  auto existing = points.find(key);
+  if (packet[0] == 'z') {
+    if (existing != points.end()) {
+      debugger.remove(existing->second);
+      points.erase(existing);
+    }
+    return "OK";
+  }
+  if (existing != points.end()) {
+    return "OK";
+  }
+
+  int id;
+  if (type == '0' || type == '1') {
+    if (address > 0x1FFFFFF) {
+      return "E01";
+    }
+    id = debugger.addBreakpoint(
+        static_cast<uint16_t>(address),
+        address > 0xFFFF ? static_cast<int>(address >> 16)
+                         : Debugger::kAnyBank);
+  } else {
+    if (address > 0xFFFF || length == 0 || address + length > 0x10000) {
+      return "E01";
+    }
+    Access access = type == '2'   ? Access::Write
+                    : type == '3' ? Access::Read
+                                  : Access::ReadWrite;
+    id = debugger.addWatchpoint(static_cast<uint16_t>(address),
+                                static_cast<uint16_t>(address + length - 1),
+                                access);
+  }
+  points[key] = id;
+  return "OK";
+}
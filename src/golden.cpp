@@ -0,0 +1,186 @@
+/**
+ * @file golden.cpp
+ * @brief Implementation of the golden-image regression harness.
+ */
+
+#include "../include/golden.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "../include/gameboy.hpp"
+#include "../include/image.hpp"
+#include "../include/movie.hpp"
+#include "../include/parallel.hpp"
+
+namespace {
+
+constexpr const char *kCheckpointsChanged =
+    "checkpoints differ from the golden file (frames or interval changed?)";
+
+// Where a failing frame's PNG goes: in the image directory, named after
+// the ROM with its directories flattened, or else beside the ROM
+std::string imagePath(const std::string &romPath, const std::string &name,
+                      const GoldenOptions &options, uint32_t frame) {
+  std::string suffix = ".frame" + std::to_string(frame) + ".png";
+  if (options.imageDirectory.empty()) {
+    return romPath + suffix;
+  }
+  std::string flat = name;
+  std::replace(flat.begin(), flat.end(), '/', '_');
+  return (std::filesystem::path(options.imageDirectory) / (flat + suffix))
+      .string();
+}
+
+}  // namespace
+
+bool saveGolden(const std::string &path,
+                const std::vector<GoldenCheckpoint> &checkpoints) {
+  std::ofstream file(path);
+  file << "# frame framebuffer-hash perceptual-hash\n" << std::hex;
+  for (const GoldenCheckpoint &checkpoint : checkpoints) {
+    file << std::dec << checkpoint.frame << std::hex << ' '
+         << checkpoint.framebufferHash << ' ' << checkpoint.perceptualHash
+         << '\n';
+  }
+  return static_cast<bool>(file);
+}
+
+bool loadGolden(const std::string &path,
+                std::vector<GoldenCheckpoint> &checkpoints) {
+  std::ifstream file(path);
+  if (!file) {
+    return false;
+  }
+  std::vector<GoldenCheckpoint> loaded;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    GoldenCheckpoint checkpoint;
+    if (!(fields >> checkpoint.frame >> std::hex >>
+          checkpoint.framebufferHash >> checkpoint.perceptualHash)) {
+      return false;
+    }
+    loaded.push_back(checkpoint);
+  }
+  checkpoints = std::move(loaded);
+  return true;
+}
+
+GoldenResult runGoldenCase(const std::string &romPath,
+                           const std::string &name,
+                           const GoldenOptions &options) {
+  auto start = std::chrono::steady_clock::now();
+  GoldenResult result;
+  result.name = name;
+  auto finish = [&] {
+    result.ok = result.error.empty() && result.mismatches == 0;
+    result.seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    return result;
+  };
+
+  std::ifstream file(romPath, std::ios::binary);
+  if (!file) {
+    result.error = "could not read " + romPath;
+    return finish();
+  }
+  std::vector<uint8_t> rom(std::istreambuf_iterator<char>(file), {});
+  GameBoy gameboy;
+  gameboy.loadRom(rom);
+
+  std::filesystem::path base(romPath);
+  std::string moviePath = base.replace_extension(".gbmv").string();
+  std::string goldenPath = base.replace_extension(".golden").string();
+
+  Movie movie;
+  bool hasMovie = std::filesystem::exists(moviePath);
+  if (hasMovie && !movie.load(moviePath)) {
+    result.error = "could not read " + moviePath;
+    return finish();
+  }
+  if (hasMovie && movie.initialStateHash != gameboy.stateHash()) {
+    result.error = "the movie was not recorded from power-on";
+    return finish();
+  }
+
+  std::vector<GoldenCheckpoint> golden;
+  if (!options.update && !loadGolden(goldenPath, golden)) {
+    result.error = "no golden file (record one with --update)";
+    return finish();
+  }
+
+  std::vector<GoldenCheckpoint> actual;
+  uint32_t frames =
+      hasMovie ? static_cast<uint32_t>(movie.inputs.size()) : options.frames;
+  for (uint32_t frame = 0; frame < frames; frame++) {
+    gameboy.memory.setButtons(hasMovie ? movie.inputs[frame] : 0);
+    gameboy.runFrame();
+    if (options.interval == 0 || (frame + 1) % options.interval != 0) {
+      continue;
+    }
+
+    Image screen = captureScreen(gameboy);
+    GoldenCheckpoint checkpoint{frame, gameboy.ppu.framebufferHash(),
+                                perceptualHash(screen)};
+    actual.push_back(checkpoint);
+    result.checkpoints++;
+    if (options.update) {
+      continue;
+    }
+
+    size_t index = actual.size() - 1;
+    if (index >= golden.size() || golden[index].frame != frame) {
+      result.error = kCheckpointsChanged;
+      return finish();
+    }
+    if (checkpoint.framebufferHash == golden[index].framebufferHash) {
+      continue;
+    }
+    int distance =
+        hashDistance(checkpoint.perceptualHash, golden[index].perceptualHash);
+    result.worstDistance = std::max(result.worstDistance, distance);
+    if (options.tolerance == 0 || distance > options.tolerance) {
+      result.mismatches++;
+      std::string path = imagePath(romPath, name, options, frame);
+      if (writePng(path, screen)) {
+        result.images.push_back(path);
+      }
+    }
+  }
+
+  if (options.update) {
+    if (!saveGolden(goldenPath, actual)) {
+      result.error = "could not write " + goldenPath;
+    }
+  } else if (actual.size() != golden.size()) {
+    result.error = kCheckpointsChanged;
+  }
+  return finish();
+}
+
+std::vector<GoldenResult> runGoldenSuite(const std::string &directory,
+                                         const std::vector<std::string> &paths,
+                                         const GoldenOptions &options,
+                                         unsigned threads) {
+  if (!options.imageDirectory.empty()) {
+    std::error_code error;
+    std::filesystem::create_directories(options.imageDirectory, error);
+  }
+  std::vector<GoldenResult> results(paths.size());
+  parallelFor(paths.size(), threads, [&](size_t i) {
+    std::string name = std::filesystem::path(paths[i])
+                           .lexically_relative(directory)
+                           .string();
+    results[i] = runGoldenCase(paths[i], name, options);
+  });
+  return results;
+}
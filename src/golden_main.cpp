@@ -0,0 +1,108 @@
+/**
+ * @file golden_main.cpp
+ * @brief Golden-image regression runner: checks a directory of ROMs
+ * against their recorded screens, in parallel.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/conformance.hpp"
+#include "../include/golden.hpp"
+
+namespace {
+
+struct Options {
+  std::string directory;
+  GoldenOptions golden;
+  unsigned threads = 0;
+};
+
+void printUsage(const char *program) {
+  std::cerr << "Usage: " << program << " <rom directory> [options]\n"
+            << "  --frames N          Frames to run a ROM without a movie\n"
+            << "                      (default 600)\n"
+            << "  --interval N        Frames between checkpoints (default "
+               "60)\n"
+            << "  --tolerance BITS    Perceptual hash bits a changed frame\n"
+            << "                      may differ by and still pass "
+               "(default 0)\n"
+            << "  --images DIR        Write failing frames here (default:\n"
+            << "                      beside each ROM)\n"
+            << "  --threads N         Worker threads (default: all cores)\n"
+            << "  --update            Record new golden files\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(arg, "--frames") == 0 && hasValue) {
+      options.golden.frames = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--interval") == 0 && hasValue) {
+      options.golden.interval = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--tolerance") == 0 && hasValue) {
+      options.golden.tolerance = std::atoi(argv[++i]);
+    } else if (std::strcmp(arg, "--images") == 0 && hasValue) {
+      options.golden.imageDirectory = argv[++i];
+    } else if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+      options.threads = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--update") == 0) {
+      options.golden.update = true;
+    } else if (arg[0] != '-' && options.directory.empty()) {
+      options.directory = arg;
+    } else {
+      return false;
+    }
+  }
+  return !options.directory.empty();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::vector<std::string> paths = findTestRoms(options.directory);
+  if (paths.empty()) {
+    std::cerr << "No ROMs found in " << options.directory << "\n";
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<GoldenResult> results = runGoldenSuite(
+      options.directory, paths, options.golden, options.threads);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  size_t failed = 0;
+  for (const GoldenResult &result : results) {
+    failed += !result.ok;
+    std::cout << (result.ok ? "ok    " : "FAIL  ") << result.name << "  "
+              << result.checkpoints << " checkpoints";
+    if (result.mismatches) {
+      std::cout << ", " << result.mismatches << " changed (perceptual "
+                << "distance up to " << result.worstDistance << ")";
+    }
+    if (!result.error.empty()) {
+      std::cout << ", " << result.error;
+    }
+    std::cout << "  " << result.seconds << " s\n";
+    for (const std::string &image : result.images) {
+      std::cout << "      wrote " << image << "\n";
+    }
+  }
+  std::cout << (options.golden.update ? "Recorded " : "Checked ")
+            << results.size() << " ROMs, " << failed << " failed, wall time "
+            << seconds << " s\n";
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file image.cpp
+ * @brief Implementation of screen capture, the PNG encoder and the
+ * perceptual hash.
+ */
+
+#include "../include/image.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <fstream>
+
+namespace {
+
+constexpr uint8_t kDmgShades[4] = {0xFF, 0xAA, 0x55, 0x00};
+
+constexpr std::array<uint32_t, 256> kCrcTable = [] {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t n = 0; n < 256; n++) {
+    uint32_t c = n;
+    for (int k = 0; k < 8; k++) {
+      c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    }
+    table[n] = c;
+  }
+  return table;
+}();
+
+uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0) {
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++) {
+    crc = kCrcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+void putBigEndian(std::vector<uint8_t> &out, uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void putChunk(std::vector<uint8_t> &out, const char type[4],
+              const std::vector<uint8_t> &data) {
+  putBigEndian(out, static_cast<uint32_t>(data.size()));
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  putBigEndian(out, crc32(&out[start], out.size() - start));
+}
+
+// Wraps bytes in a zlib stream of stored (uncompressed) deflate blocks
+std::vector<uint8_t> zlibStore(const std::vector<uint8_t> &data) {
+  constexpr size_t kMaxBlock = 0xFFFF;
+  std::vector<uint8_t> out = {0x78, 0x01};
+  size_t offset = 0;
+  do {
+    size_t length = std::min(kMaxBlock, data.size() - offset);
+    bool last = offset + length == data.size();
+    out.push_back(last ? 0x01 : 0x00);
+    out.push_back(static_cast<uint8_t>(length));
+    out.push_back(static_cast<uint8_t>(length >> 8));
+    out.push_back(static_cast<uint8_t>(~length));
+    out.push_back(static_cast<uint8_t>(~length >> 8));
+    out.insert(out.end(), data.begin() + offset,
+               data.begin() + offset + length);
+    offset += length;
+  } while (offset < data.size());
+
+  uint32_t a = 1, b = 0;  // Adler-32
+  for (uint8_t byte : data) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  putBigEndian(out, b << 16 | a);
+  return out;
+}
+
+}  // namespace
+
+Image captureScreen(const GameBoy &gameboy) {
+  return framebufferImage(gameboy.ppu.getFramebuffer(),
+                          gameboy.memory.isCgb());
+}
+
+Image framebufferImage(std::span<const uint16_t> framebuffer, bool cgb) {
+  Image image;
+  image.width = PPU::kScreenWidth;
+  image.height = PPU::kScreenHeight;
+  image.rgb.reserve(image.width * image.height * 3);
+  for (uint16_t pixel : framebuffer) {
+    if (cgb) {
+      for (int shift = 0; shift < 15; shift += 5) {
+        image.rgb.push_back(static_cast<uint8_t>(((pixel >> shift) & 0x1F) *
+                                                 255 / 31));
+      }
+    } else {
+      uint8_t shade = kDmgShades[pixel & 0x03];
+      image.rgb.insert(image.rgb.end(), 3, shade);
+    }
+  }
+  return image;
+}
+
+std::vector<uint8_t> encodePng(const Image &image) {
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+  std::vector<uint8_t> header;
+  putBigEndian(header, image.width);
+  putBigEndian(header, image.height);
+  header.insert(header.end(), {8, 2, 0, 0, 0});  // 8-bit RGB, no interlace
+  putChunk(png, "IHDR", header);
+
+  // Every row starts with filter type 0 (none)
+  size_t stride = image.width * 3;
+  std::vector<uint8_t> rows;
+  rows.reserve((stride + 1) * image.height);
+  for (uint32_t y = 0; y < image.height; y++) {
+    rows.push_back(0);
+    rows.insert(rows.end(), image.rgb.begin() + y * stride,
+                image.rgb.begin() + (y + 1) * stride);
+  }
+  putChunk(png, "IDAT", zlibStore(rows));
+  putChunk(png, "IEND", {});
+  return png;
+}
+
+bool writePng(const std::string &path, const Image &image) {
+  std::vector<uint8_t> png = encodePng(image);
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(png.data()), png.size());
+  return static_cast<bool>(file);
+}
+
+uint64_t perceptualHash(const Image &image) {
+  constexpr uint32_t kColumns = 9;
+  constexpr uint32_t kRows = 8;
+  std::array<uint32_t, kColumns * kRows> cells{};
+  for (uint32_t row = 0; row < kRows; row++) {
+    uint32_t top = row * image.height / kRows;
+    uint32_t bottom = (row + 1) * image.height / kRows;
+    for (uint32_t column = 0; column < kColumns; column++) {
+      uint32_t left = column * image.width / kColumns;
+      uint32_t right = (column + 1) * image.width / kColumns;
+      uint64_t sum = 0;
+      for (uint32_t y = top; y < bottom; y++) {
+        const uint8_t *pixel = &image.rgb[(y * image.width + left) * 3];
+        for (uint32_t x = left; x < right; x++, pixel += 3) {
+          // Integer Rec. 601 luma
+          sum += 299 * pixel[0] + 587 * pixel[1] + 114 * pixel[2];
+        }
+      }
+      uint64_t area = std::max<uint64_t>((bottom - top) * (right - left), 1);
+      cells[row * kColumns + column] = static_cast<uint32_t>(sum / area);
+    }
+  }
+
+  uint64_t hash = 0;
+  for (uint32_t row = 0; row < kRows; row++) {
+    for (uint32_t column = 0; column + 1 < kColumns; column++) {
+      const uint32_t *cell = &cells[row * kColumns + column];
+      hash = hash << 1 | (cell[0] < cell[1]);
+    }
+  }
+  return hash;
+}
+
+int hashDistance(uint64_t a, uint64_t b) { return std::popcount(a ^ b); }
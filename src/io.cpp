@@ -0,0 +1,522 @@
+/**
+ * @file io.cpp
+ * @brief Implementation of the I/O registers, joypad and timer.
+ */
+
+#include "../include/io.hpp"
+
+#include <algorithm>
+
+#include "../include/hash.hpp"
+#include "../include/joypad.hpp"
+#include "../include/memory.hpp"
+#include "../include/ppu.hpp"
+#include "../include/save_state.hpp"
+#include "../include/scheduler.hpp"
+#include "../include/serial.hpp"
+
+namespace {
+
+// TIMA increment period in cycles for each TAC clock select value
+constexpr uint32_t kTimerPeriods[4] = {1024, 16, 64, 256};
+
+// CPU cycles a VRAM DMA stalls the CPU for per 16-byte block, at normal
+// speed (twice as many in double speed)
+constexpr uint32_t kHdmaBlockCycles = 32;
+
+}  // namespace
+
+/**
+ * @brief The register handlers. A struct rather than free functions so the
+ * handlers can be friends of IO.
+ */
+struct IOHandlers {
+  static uint8_t readPlain(IO &io, uint8_t index) {
+    return io.registers[index];
+  }
+
+  static void writePlain(IO &io, uint8_t index, uint8_t value) {
+    io.registers[index] = value;
+  }
+
+  static void writeReadOnly(IO &, uint8_t, uint8_t) {}
+
+  static uint8_t readJoypad(IO &io, uint8_t) {
+    io.syncJoypad();
+    return joypadRegister(io.registers[IO::P1], io.getButtons());
+  }
+
+  static void writeJoypad(IO &io, uint8_t, uint8_t value) {
+    io.registers[IO::P1] = value & 0x30;  // Only the select bits
+    io.syncJoypad();
+  }
+
+  static uint8_t readDivider(IO &io, uint8_t) {
+    return static_cast<uint8_t>((io.now() - io.divBase) >> 8);
+  }
+
+  static void writeDivider(IO &io, uint8_t, uint8_t) {
+    uint64_t now = io.now();
+    io.syncTimer(now);
+    io.divBase = now;
+    io.scheduleTimer();
+  }
+
+  static uint8_t readCounter(IO &io, uint8_t) {
+    io.syncTimer(io.now());
+    return io.registers[IO::TIMA];
+  }
+
+  static void writeTimer(IO &io, uint8_t index, uint8_t value) {
+    io.syncTimer(io.now());
+    io.registers[index] = index == IO::TAC ? (value & 0x07) : value;
+    io.scheduleTimer();
+  }
+
+  static void writeSerialData(IO &io, uint8_t, uint8_t value) {
+    io.registers[IO::SB] = value;
+    if (io.serialPeer) {
+      io.serialPeer->publish(value);
+    }
+  }
+
+  static uint8_t readSerialControl(IO &io, uint8_t) {
+    // The clock speed bit exists only on the CGB
+    return io.registers[IO::SC] | (io.memory->isCgb() ? 0x7C : 0x7E);
+  }
+
+  static void writeSerialControl(IO &io, uint8_t, uint8_t value) {
+    io.registers[IO::SC] = value & (io.memory->isCgb() ? 0x83 : 0x81);
+    if ((value & 0x81) != 0x81) {
+      // Stopped, or waiting for the other end to provide the clock
+      if (io.scheduler) {
+        io.scheduler->cancel(Event::Serial);
+      }
+      return;
+    }
+    if (!io.scheduler) {
+      io.finishSerial(io.now());
+      return;
+    }
+    uint32_t bitCycles = (io.registers[IO::SC] & 0x02)
+                             ? IO::kFastSerialBitCycles
+                             : IO::kSerialBitCycles;
+    io.scheduler->schedule(Event::Serial, io.now() + 8 * bitCycles);
+  }
+
+  static uint8_t readInterruptFlags(IO &io, uint8_t) {
+    return io.registers[IO::IF] | 0xE0;
+  }
+
+  static void writeLcdControl(IO &io, uint8_t, uint8_t value) {
+    uint8_t previous = io.registers[IO::LCDC];
+    io.registers[IO::LCDC] = value;
+    if (!io.ppu || !((previous ^ value) & 0x80)) {
+      return;
+    }
+    if (value & 0x80) {
+      io.scheduler->schedule(Event::PPU,
+                             io.now() + (io.ppu->reset() << io.speedShift()));
+    } else {
+      io.scheduler->cancel(Event::PPU);
+      io.ppu->disable();
+    }
+  }
+
+  static uint8_t readLcdStatus(IO &io, uint8_t) {
+    return io.registers[IO::STAT] | 0x80;
+  }
+
+  static void writeLcdStatus(IO &io, uint8_t, uint8_t value) {
+    // Mode and coincidence bits are owned by the PPU
+    io.registers[IO::STAT] = (io.registers[IO::STAT] & 0x07) | (value & 0x78);
+  }
+
+  static uint8_t readSpeed(IO &io, uint8_t) {
+    return io.memory->isCgb() ? io.registers[IO::KEY1] | 0x7E : 0xFF;
+  }
+
+  static void writeSpeed(IO &io, uint8_t, uint8_t value) {
+    // Only the switch-armed bit is writable; STOP performs the switch
+    io.registers[IO::KEY1] = (io.registers[IO::KEY1] & 0x80) | (value & 0x01);
+  }
+
+  static uint8_t readVramBank(IO &io, uint8_t) {
+    return io.memory->isCgb() ? io.registers[IO::VBK] | 0xFE : 0xFF;
+  }
+
+  static void writeVramBank(IO &io, uint8_t, uint8_t value) {
+    if (io.memory->isCgb()) {
+      io.registers[IO::VBK] = value & 0x01;
+      io.memory->selectVramBank(value);
+    }
+  }
+
+  static uint8_t readWramBank(IO &io, uint8_t) {
+    return io.memory->isCgb() ? io.registers[IO::SVBK] | 0xF8 : 0xFF;
+  }
+
+  static void writeWramBank(IO &io, uint8_t, uint8_t value) {
+    if (io.memory->isCgb()) {
+      io.registers[IO::SVBK] = value & 0x07;
+      io.memory->selectWramBank(value);
+    }
+  }
+
+  static uint8_t readWriteOnly(IO &, uint8_t) { return 0xFF; }
+
+  static uint8_t readHdmaStatus(IO &io, uint8_t) {
+    if (!io.memory->isCgb()) {
+      return 0xFF;
+    }
+    // Blocks left minus one; bit 7 clear while an HBlank DMA is running
+    return io.hdmaBlocks ? io.hdmaBlocks - 1 : 0xFF;
+  }
+
+  static void writeHdma(IO &io, uint8_t, uint8_t value) {
+    if (!io.memory->isCgb()) {
+      return;
+    }
+    if (io.hdmaBlocks && !(value & 0x80)) {
+      io.hdmaBlocks = 0;  // Cancels the HBlank DMA
+      return;
+    }
+    io.hdmaSource = (io.registers[IO::HDMA1] << 8 | io.registers[IO::HDMA2]) &
+                    0xFFF0;
+    io.hdmaDestination =
+        0x8000 |
+        ((io.registers[IO::HDMA3] << 8 | io.registers[IO::HDMA4]) & 0x1FF0);
+    uint8_t blocks = (value & 0x7F) + 1;
+    if (value & 0x80) {
+      io.hdmaBlocks = blocks;
+    } else {
+      io.copyVramBlocks(blocks);
+    }
+  }
+
+  static uint8_t readPaletteIndex(IO &io, uint8_t index) {
+    return io.memory->isCgb() ? io.registers[index] | 0x40 : 0xFF;
+  }
+
+  static void writePaletteIndex(IO &io, uint8_t index, uint8_t value) {
+    io.registers[index] = value & 0xBF;
+  }
+
+  static uint8_t readPaletteData(IO &io, uint8_t index) {
+    if (!io.memory->isCgb()) {
+      return 0xFF;
+    }
+    uint8_t select = io.registers[index - 1];
+    return io.palettes(index)[select & 0x3F];
+  }
+
+  static void writePaletteData(IO &io, uint8_t index, uint8_t value) {
+    if (!io.memory->isCgb()) {
+      return;
+    }
+    uint8_t &select = io.registers[index - 1];
+    io.palettes(index)[select & 0x3F] = value;
+    if (select & 0x80) {
+      select = 0x80 | ((select + 1) & 0x3F);
+    }
+  }
+
+  static void writeBootRom(IO &io, uint8_t, uint8_t value) {
+    if (value & 0x01) {
+      io.memory->unmapBootRom();  // Until the next power on
+    }
+  }
+
+  static void writeDma(IO &io, uint8_t, uint8_t value) {
+    io.registers[IO::DMA] = value;
+    if (!io.scheduler) {
+      io.finishDma();
+      return;
+    }
+    io.memory->lockBus(true);
+    io.scheduler->schedule(Event::Dma, io.now() + IO::kDmaCycles);
+  }
+};
+
+namespace {
+
+constexpr std::array<IO::Register, 128> kRegisters = [] {
+  std::array<IO::Register, 128> table{};
+  for (IO::Register &entry : table) {
+    entry = {IOHandlers::readPlain, IOHandlers::writePlain};
+  }
+  table[IO::P1] = {IOHandlers::readJoypad, IOHandlers::writeJoypad};
+  table[IO::SB] = {IOHandlers::readPlain, IOHandlers::writeSerialData};
+  table[IO::SC] = {IOHandlers::readSerialControl,
+                   IOHandlers::writeSerialControl};
+  table[IO::DIV] = {IOHandlers::readDivider, IOHandlers::writeDivider};
+  table[IO::TIMA] = {IOHandlers::readCounter, IOHandlers::writeTimer};
+  table[IO::TMA] = {IOHandlers::readPlain, IOHandlers::writeTimer};
+  table[IO::TAC] = {IOHandlers::readPlain, IOHandlers::writeTimer};
+  table[IO::IF] = {IOHandlers::readInterruptFlags, IOHandlers::writePlain};
+  table[IO::LCDC] = {IOHandlers::readPlain, IOHandlers::writeLcdControl};
+  table[IO::STAT] = {IOHandlers::readLcdStatus, IOHandlers::writeLcdStatus};
+  table[IO::LY] = {IOHandlers::readPlain, IOHandlers::writeReadOnly};
+  table[IO::DMA] = {IOHandlers::readPlain, IOHandlers::writeDma};
+  table[IO::KEY1] = {IOHandlers::readSpeed, IOHandlers::writeSpeed};
+  table[IO::VBK] = {IOHandlers::readVramBank, IOHandlers::writeVramBank};
+  table[IO::BOOT] = {IOHandlers::readWriteOnly, IOHandlers::writeBootRom};
+  for (uint8_t index = IO::HDMA1; index < IO::HDMA5; index++) {
+    table[index] = {IOHandlers::readWriteOnly, IOHandlers::writePlain};
+  }
+  table[IO::HDMA5] = {IOHandlers::readHdmaStatus, IOHandlers::writeHdma};
+  table[IO::BCPS] = {IOHandlers::readPaletteIndex,
+                     IOHandlers::writePaletteIndex};
+  table[IO::BCPD] = {IOHandlers::readPaletteData, IOHandlers::writePaletteData};
+  table[IO::OCPS] = {IOHandlers::readPaletteIndex,
+                     IOHandlers::writePaletteIndex};
+  table[IO::OCPD] = {IOHandlers::readPaletteData, IOHandlers::writePaletteData};
+  table[IO::SVBK] = {IOHandlers::readWramBank, IOHandlers::writeWramBank};
+  return table;
+}();
+
+}  // namespace
+
+IO::IO(const IO &other) { *this = other; }
+
+IO &IO::operator=(const IO &other) {
+  registers = other.registers;
+  buttons.store(other.getButtons(), std::memory_order_relaxed);
+  lastJoypad = other.lastJoypad;
+  divBase = other.divBase;
+  timerSync = other.timerSync;
+  backgroundPalettes = other.backgroundPalettes;
+  objectPalettes = other.objectPalettes;
+  hdmaSource = other.hdmaSource;
+  hdmaDestination = other.hdmaDestination;
+  hdmaBlocks = other.hdmaBlocks;
+  // `memory` is the owning bus and is set by it, and the clock, scheduler
+  // and PPU belong to the machine this block is attached to: never copied
+  return *this;
+}
+
+uint8_t IO::read(uint8_t index) { return kRegisters[index].read(*this, index); }
+
+void IO::write(uint8_t index, uint8_t value) {
+  kRegisters[index].write(*this, index, value);
+}
+
+/**
+ * @brief Moves DIV's base so that the counter reads `counter` now. The
+ * subtraction may wrap, which the timer's differences tolerate.
+ */
+void IO::setDivider(uint16_t counter) {
+  uint64_t now = this->now();
+  syncTimer(now);
+  divBase = now - counter;
+  scheduleTimer();
+}
+
+void IO::attach(uint64_t *clock, Scheduler *scheduler, PPU *ppu) {
+  this->clock = clock;
+  this->scheduler = scheduler;
+  this->ppu = ppu;
+  divBase = timerSync = now();
+  scheduleTimer();
+}
+
+void IO::syncJoypad() {
+  uint8_t joypad = joypadRegister(registers[P1], getButtons()) & 0x0F;
+  if (lastJoypad & ~joypad) {
+    requestInterrupt(0x10);
+  }
+  lastJoypad = joypad;
+}
+
+void IO::timerOverflow(uint64_t time) {
+  syncTimer(time);
+  registers[TIMA] = registers[TMA];
+  requestInterrupt(0x04);
+  scheduleTimer();
+}
+
+void IO::finishDma() {
+  uint8_t page = registers[DMA];
+  if (page >= 0xE0) {
+    page -= 0x20;  // The DMA unit sees work RAM above DFFF, like the echo
+  }
+  memory->transfer(0xFE00, page << 8, 0xA0);
+  memory->lockBus(false);
+}
+
+void IO::connectSerial(SerialPeer *peer) {
+  serialPeer = peer;
+  if (peer) {
+    peer->publish(registers[SB]);
+  }
+  if (!scheduler) {
+    return;
+  }
+  if (peer && peer->syncInterval()) {
+    scheduler->schedule(Event::Link, now() + peer->syncInterval());
+  } else {
+    scheduler->cancel(Event::Link);
+  }
+}
+
+void IO::finishSerial(uint64_t time) {
+  if (!(registers[SC] & 0x80)) {
+    return;
+  }
+  uint8_t out = registers[SB];
+  registers[SB] = serialPeer ? serialPeer->exchange(time, out) : 0xFF;
+  registers[SC] &= 0x7F;
+  requestInterrupt(0x08);
+  if (serialPeer) {
+    serialPeer->publish(registers[SB]);
+  }
+}
+
+void IO::receiveSerial(uint8_t data) {
+  if ((registers[SC] & 0x81) != 0x80) {
+    return;
+  }
+  registers[SB] = data;
+  registers[SC] &= 0x7F;
+  requestInterrupt(0x08);
+  if (serialPeer) {
+    serialPeer->publish(data);
+  }
+}
+
+void IO::syncSerial(uint64_t time) {
+  // A fork inherits the event but not the peer
+  if (!serialPeer || !serialPeer->syncInterval()) {
+    return;
+  }
+  serialPeer->synchronize(time);
+  scheduler->schedule(Event::Link, time + serialPeer->syncInterval());
+}
+
+void IO::stop() {
+  if (!memory->isCgb() || !(registers[KEY1] & 0x01)) {
+    return;
+  }
+  registers[KEY1] = (registers[KEY1] ^ 0x80) & 0x80;
+
+  // The PPU keeps its pace in real time, so the cycles left in its current
+  // mode are rescaled to the new CPU speed
+  if (!scheduler) {
+    return;
+  }
+  uint64_t deadline = scheduler->eventTime(Event::PPU);
+  if (deadline != Scheduler::kNever && deadline > now()) {
+    uint64_t remaining = deadline - now();
+    remaining = speedShift() ? remaining * 2 : remaining / 2;
+    scheduler->schedule(Event::PPU, now() + remaining);
+  }
+}
+
+void IO::hblank() {
+  if (hdmaBlocks) {
+    copyVramBlocks(1);
+    hdmaBlocks--;
+  }
+}
+
+/**
+ * @brief Copies 16-byte blocks from the VRAM DMA source to VRAM, stalling
+ * the CPU for the duration.
+ */
+void IO::copyVramBlocks(uint8_t blocks) {
+  uint16_t length = blocks * 16;
+  memory->transfer(hdmaDestination, hdmaSource, length);
+  hdmaSource += length;
+  hdmaDestination = 0x8000 | ((hdmaDestination + length) & 0x1FFF);
+  if (clock) {
+    *clock += (blocks * kHdmaBlockCycles) << speedShift();
+  }
+}
+
+uint64_t IO::hash() const {
+  uint64_t hash = fnv1a(registers.data(), registers.size());
+  hash = fnv1a(backgroundPalettes.data(), backgroundPalettes.size(), hash);
+  hash = fnv1a(objectPalettes.data(), objectPalettes.size(), hash);
+  hash = fnv1aValue(hdmaSource | (hdmaDestination << 16) |
+                        (static_cast<uint64_t>(hdmaBlocks) << 32),
+                    hash);
+  hash = fnv1aValue(getButtons() | (lastJoypad << 8), hash);
+  hash = fnv1aValue(divBase, hash);
+  return fnv1aValue(timerSync, hash);
+}
+
+void IO::saveState(StateWriter &out) const {
+  out.write(registers.data(), registers.size());
+  out.write(getButtons());
+  out.write(lastJoypad);
+  out.write(divBase);
+  out.write(timerSync);
+  out.write(backgroundPalettes.data(), backgroundPalettes.size());
+  out.write(objectPalettes.data(), objectPalettes.size());
+  out.write(hdmaSource);
+  out.write(hdmaDestination);
+  out.write(hdmaBlocks);
+}
+
+bool IO::loadState(StateReader &in) {
+  if (const uint8_t *bytes = in.take(registers.size())) {
+    std::copy(bytes, bytes + registers.size(), registers.begin());
+  }
+  setButtons(in.read<uint8_t>());
+  lastJoypad = in.read<uint8_t>();
+  divBase = in.read<uint64_t>();
+  timerSync = in.read<uint64_t>();
+  if (const uint8_t *bytes = in.take(backgroundPalettes.size())) {
+    std::copy(bytes, bytes + backgroundPalettes.size(),
+              backgroundPalettes.begin());
+  }
+  if (const uint8_t *bytes = in.take(objectPalettes.size())) {
+    std::copy(bytes, bytes + objectPalettes.size(), objectPalettes.begin());
+  }
+  hdmaSource = in.read<uint16_t>();
+  hdmaDestination = in.read<uint16_t>();
+  hdmaBlocks = in.read<uint8_t>();
+  // A running HBlank DMA is as writeHdma() and copyVramBlocks() leave it
+  bool valid = lastJoypad <= 0x0F && hdmaBlocks <= 0x80 &&
+               (!hdmaBlocks || ((hdmaSource & 0x0F) == 0 &&
+                                (hdmaDestination & 0xE00F) == 0x8000));
+  if (!valid) {
+    lastJoypad = 0x0F;
+    hdmaBlocks = 0;
+  }
+  return valid;
+}
+
+/**
+ * @brief Brings TIMA up to date with the clock.
+ *
+ * TIMA counts falling edges of one bit of the divider, so the number of
+ * increments is the number of period boundaries crossed since the last
+ * sync. The overflow event fires at the boundary that wraps TIMA, so when
+ * the timer is attached this never crosses an overflow.
+ */
+void IO::syncTimer(uint64_t time) {
+  if (registers[TAC] & 0x04) {
+    uint32_t period = kTimerPeriods[registers[TAC] & 0x03];
+    uint64_t ticks = (time - divBase) / period - (timerSync - divBase) / period;
+    registers[TIMA] = static_cast<uint8_t>(registers[TIMA] + ticks);
+  }
+  timerSync = time;
+}
+
+/**
+ * @brief Schedules the next TIMA overflow from the last sync point.
+ */
+void IO::scheduleTimer() {
+  if (!scheduler) {
+    return;
+  }
+  if (!(registers[TAC] & 0x04)) {
+    scheduler->cancel(Event::Timer);
+    return;
+  }
+  uint32_t period = kTimerPeriods[registers[TAC] & 0x03];
+  uint64_t boundary = (timerSync - divBase) / period;
+  uint64_t remaining = 0x100 - registers[TIMA];
+  scheduler->schedule(Event::Timer, divBase + (boundary + remaining) * period);
+}
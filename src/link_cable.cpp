@@ -0,0 +1,95 @@
+/**
+ * @file link_cable.cpp
+ * @brief Implementation of the in-process LinkCable.
+ */
+
+#include "../include/link_cable.hpp"
+
+#include <algorithm>
+#include <thread>
+
+LinkCable::LinkCable(GameBoy &first, GameBoy &second, uint64_t maxSkew)
+    : interval(std::clamp<uint64_t>(maxSkew, 2, kMaxSkew) / 2) {
+  ports[0].plug(this, &ports[1], &first);
+  ports[1].plug(this, &ports[0], &second);
+}
+
+LinkCable::~LinkCable() {
+  for (Port &port : ports) {
+    port.machine->memory.io.connectSerial(nullptr);
+  }
+}
+
+void LinkCable::run(uint64_t cycles) {
+  lockstep = true;
+  uint64_t end = position + cycles;
+  while (position < end) {
+    // Both machines reach each synchronization point before either passes
+    // it
+    uint64_t next = std::min(end, (position / interval + 1) * interval);
+    for (Port &port : ports) {
+      uint64_t target = port.origin + next;
+      uint64_t now = port.machine->cpu.cycles;
+      if (target > now) {
+        port.machine->runCycles(target - now);
+      }
+    }
+    position = next;
+  }
+  lockstep = false;
+}
+
+void LinkCable::Port::plug(LinkCable *cable, Port *other, GameBoy *machine) {
+  this->cable = cable;
+  this->other = other;
+  this->machine = machine;
+  origin = machine->cpu.cycles;
+  machine->memory.io.connectSerial(this);
+}
+
+uint8_t LinkCable::Port::exchange(uint64_t time, uint8_t out) {
+  if (!cable->connected.load(std::memory_order_acquire)) {
+    return 0xFF;
+  }
+  // Within the skew bound the queue cannot fill; if it ever did, the other
+  // end would miss this byte as if it had not been listening
+  other->inbox.push({time - origin, out});
+  return other->data.load(std::memory_order_acquire);
+}
+
+void LinkCable::Port::publish(uint8_t data) {
+  this->data.store(data, std::memory_order_release);
+}
+
+void LinkCable::Port::synchronize(uint64_t time) {
+  if (!cable->connected.load(std::memory_order_acquire)) {
+    return;
+  }
+  uint64_t local = time - origin;
+  clock.store(local, std::memory_order_release);
+
+  auto ahead = [&] {
+    return other->clock.load(std::memory_order_acquire) + cable->interval <
+           local;
+  };
+  if (!cable->lockstep && ahead()) {
+    cable->waitCount.fetch_add(1, std::memory_order_relaxed);
+    do {
+      deliver(local);
+      std::this_thread::yield();
+    } while (cable->connected.load(std::memory_order_acquire) && ahead());
+  }
+  deliver(local);
+}
+
+/**
+ * @brief Hands the machine every byte the other end clocked at or before
+ * `time`.
+ */
+void LinkCable::Port::deliver(uint64_t time) {
+  const Transfer *transfer;
+  while ((transfer = inbox.front()) && transfer->time <= time) {
+    machine->memory.io.receiveSerial(transfer->data);
+    inbox.pop();
+  }
+}
@@ -0,0 +1,167 @@
+/**
+ * @file lz.cpp
+ * @brief Implementation of the LZ block compressor.
+ */
+
+#include "../include/lz.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kMaxOffset = 0xFFFF;
+constexpr int kHashBits = 12;
+
+uint32_t load32(const uint8_t *bytes) {
+  uint32_t value;
+  std::memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+uint64_t load64(const uint8_t *bytes) {
+  uint64_t value;
+  std::memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+// Returns how far two byte ranges match, up to `limit` bytes, comparing
+// eight bytes at a time
+size_t matchLength(const uint8_t *a, const uint8_t *b, size_t limit) {
+  size_t length = 0;
+  for (; length + 8 <= limit; length += 8) {
+    uint64_t difference = load64(a + length) ^ load64(b + length);
+    if (difference) {
+      return length + (std::endian::native == std::endian::little
+                           ? std::countr_zero(difference)
+                           : std::countl_zero(difference)) /
+                          8;
+    }
+  }
+  while (length < limit && a[length] == b[length]) {
+    length++;
+  }
+  return length;
+}
+
+// Writes the part of a length that does not fit its nibble
+void putLength(std::vector<uint8_t> &out, size_t length) {
+  for (; length >= 0xFF; length -= 0xFF) {
+    out.push_back(0xFF);
+  }
+  out.push_back(static_cast<uint8_t>(length));
+}
+
+bool getLength(std::span<const uint8_t> block, size_t &offset,
+               size_t &length) {
+  uint8_t byte;
+  do {
+    if (offset == block.size()) {
+      return false;
+    }
+    byte = block[offset++];
+    length += byte;
+  } while (byte == 0xFF);
+  return true;
+}
+
+// Writes a sequence; a match length of 0 means there is no match
+void putSequence(std::vector<uint8_t> &out, const uint8_t *literals,
+                 size_t literalCount, size_t offset, size_t matchLength) {
+  size_t extra = matchLength ? matchLength - kMinMatch : 0;
+  out.push_back(static_cast<uint8_t>(std::min<size_t>(literalCount, 15) << 4 |
+                                     std::min<size_t>(extra, 15)));
+  if (literalCount >= 15) {
+    putLength(out, literalCount - 15);
+  }
+  out.insert(out.end(), literals, literals + literalCount);
+  if (matchLength) {
+    out.push_back(static_cast<uint8_t>(offset));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (extra >= 15) {
+      putLength(out, extra - 15);
+    }
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Greedy matching against the last position each 4-byte hash was
+ * seen at.
+ */
+void lzCompress(std::span<const uint8_t> data, std::vector<uint8_t> &out) {
+  out.clear();
+  const uint8_t *bytes = data.data();
+  size_t size = data.size();
+  std::array<uint32_t, size_t{1} << kHashBits> table{};
+
+  size_t anchor = 0;
+  for (size_t position = 0; position + kMinMatch <= size;) {
+    uint32_t sequence = load32(bytes + position);
+    uint32_t hash = (sequence * 2654435761u) >> (32 - kHashBits);
+    size_t candidate = table[hash];
+    table[hash] = static_cast<uint32_t>(position);
+    if (candidate >= position || position - candidate > kMaxOffset ||
+        load32(bytes + candidate) != sequence) {
+      position++;
+      continue;
+    }
+    size_t length =
+        kMinMatch + matchLength(bytes + candidate + kMinMatch,
+                                bytes + position + kMinMatch,
+                                size - position - kMinMatch);
+    putSequence(out, bytes + anchor, position - anchor, position - candidate,
+                length);
+    position += length;
+    anchor = position;
+  }
+  putSequence(out, bytes + anchor, size - anchor, 0, 0);
+}
+
+bool lzDecompress(std::span<const uint8_t> block, size_t size,
+                  std::vector<uint8_t> &out) {
+  out.clear();
+  out.reserve(size);
+  size_t offset = 0;
+  while (offset < block.size()) {
+    uint8_t token = block[offset++];
+    size_t literalCount = token >> 4;
+    if (literalCount == 15 && !getLength(block, offset, literalCount)) {
+      return false;
+    }
+    if (block.size() - offset < literalCount ||
+        size - out.size() < literalCount) {
+      return false;
+    }
+    out.insert(out.end(), block.begin() + offset,
+               block.begin() + offset + literalCount);
+    offset += literalCount;
+    if (offset == block.size()) {
+      break;
+    }
+
+    if (block.size() - offset < 2) {
+      return false;
+    }
+    size_t distance = block[offset] | block[offset + 1] << 8;
+    offset += 2;
+    size_t length = (token & 0x0F) + kMinMatch;
+    if ((token & 0x0F) == 15 && !getLength(block, offset, length)) {
+      return false;
+    }
+    if (distance == 0 || distance > out.size() ||
+        size - out.size() < length) {
+      return false;
+    }
+    // Byte by byte: a match may overlap the bytes it produces
+    size_t from = out.size() - distance;
+    for (size_t i = 0; i < length; i++) {
+      out.push_back(out[from + i]);
+    }
+  }
+  return out.size() == size;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file machine_pool.cpp
+ * @brief Implementation of the machine pool.
+ */
+
+#include "../include/machine_pool.hpp"
+
+MachinePool::Lease::~Lease() {
+  if (machine) {
+    pool->release(std::move(machine));
+  }
+}
+
+MachinePool::MachinePool(GameBoy &snapshot, size_t size)
+    : snapshot(snapshot) {
+  idle.reserve(size);
+  for (size_t i = 0; i < size; i++) {
+    idle.push_back(construct());
+  }
+  constructed = size;
+}
+
+/**
+ * @brief Takes an idle machine, or constructs one if there is none, and
+ * resets it outside the lock.
+ */
+MachinePool::Lease MachinePool::acquire() {
+  std::unique_ptr<GameBoy> machine;
+  {
+    std::lock_guard lock(mutex);
+    if (!idle.empty()) {
+      machine = std::move(idle.back());
+      idle.pop_back();
+    } else {
+      constructed++;
+    }
+  }
+  if (!machine) {
+    machine = construct();
+  }
+  machine->resetTo(snapshot);
+  return Lease(*this, std::move(machine));
+}
+
+size_t MachinePool::size() const {
+  std::lock_guard lock(mutex);
+  return constructed;
+}
+
+std::unique_ptr<GameBoy> MachinePool::construct() const {
+  const std::shared_ptr<Arena> &arena = snapshot.getArena();
+  return std::make_unique<GameBoy>(
+      arena ? std::make_shared<Arena>(arena->chunkSize()) : nullptr);
+}
+
+void MachinePool::release(std::unique_ptr<GameBoy> machine) {
+  std::lock_guard lock(mutex);
+  idle.push_back(std::move(machine));
+}
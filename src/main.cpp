@@ -1 +1,621 @@
-int main() { return 0; }
\ No newline at end of file
+/**
+ * @file main.cpp
+ * @brief Headless runner: loads a ROM and runs it for a number of frames.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/capture.hpp"
+#include "../include/debugger.hpp"
+#include "../include/gameboy.hpp"
+#include "../include/gdb_stub.hpp"
+#include "../include/movie.hpp"
+#include "../include/profiler.hpp"
+#include "../include/sha1.hpp"
+#include "../include/state_cache.hpp"
+
+namespace {
+
+struct Options {
+  std::string romPath;
+  uint64_t frames = 60;
+  bool accurate = false;  // Run the accurate tier (see timing.hpp)
+  bool idleLoopSkipping = true;
+  std::string bootRomPath;
+  bool fastBoot = false;  // Start at the post-boot state
+  std::string statsJsonPath;
+  std::string statsCsvPath;
+  std::string recordPath;
+  std::string playPath;
+  std::string inputsPath;
+  uint32_t checkpointInterval = 60;
+  // Debugger commands from --break, --watch and --debug-script, in order
+  std::vector<std::string> debugCommands;
+  std::string debugScriptPath;
+  uint64_t maxStops = 0;
+  std::string gdbAddress;
+  std::string profilePath;
+  uint64_t profileInterval = Profiler::kDefaultInterval;
+  std::string stateCachePath;
+  uint64_t stateCacheMegabytes = StateCache::kDefaultCapacity >> 20;
+  uint32_t stateInterval = 60;
+  std::string capturePath;
+};
+
+void printUsage(const char *program) {
+  std::cerr << "Usage: " << program << " <rom.gb> [options]\n"
+            << "  --frames N          Frames to run (default 60)\n"
+            << "  --tier fast|accurate\n"
+            << "                      Instruction-level or M-cycle bus timing\n"
+            << "                      (default fast; accurate runs plain\n"
+            << "                      frames only)\n"
+            << "  --no-idle-skip      Disable idle-loop fast-forwarding\n"
+            << "  --boot-rom PATH     Start through a DMG or CGB boot ROM\n"
+            << "  --fast-boot         Start at the state the boot ROM leaves\n"
+            << "  --stats-json PATH   Write performance counters as JSON\n"
+            << "  --stats-csv PATH    Write performance counters as CSV\n"
+            << "  --record PATH       Record an input movie\n"
+            << "  --inputs PATH       Input script for --record or a plain\n"
+            << "                      run: lines of\n"
+            << "                      '<frame> <buttons hex>', held until\n"
+            << "                      the next line\n"
+            << "  --checkpoint-interval N\n"
+            << "                      Frames between recorded framebuffer\n"
+            << "                      hashes (default 60)\n"
+            << "  --play PATH         Replay a movie and verify its hashes\n"
+            << "  --break SPEC        Log stops at a breakpoint:\n"
+            << "                      'ADDRESS [bank N] [if CONDITION]'\n"
+            << "  --watch SPEC        Log stops at a watchpoint:\n"
+            << "                      'r|w|rw FIRST[-LAST] [if CONDITION]'\n"
+            << "  --debug-script PATH Debugger commands, one per line\n"
+            << "                      ('break ...', 'watch ...')\n"
+            << "  --max-stops N       Quit after N debugger stops\n"
+            << "  --gdb PORT|PATH     Wait for GDB on a 127.0.0.1 port or a\n"
+            << "                      Unix socket, then run with it attached\n"
+            << "  --profile PATH      Sample the emulated code; print hot\n"
+            << "                      spots and write collapsed call stacks\n"
+            << "                      for flame graph tools\n"
+            << "  --profile-interval N\n"
+            << "                      Cycles between samples (default "
+            << Profiler::kDefaultInterval << ")\n"
+            << "  --state-cache DIR   Resume plain runs from states cached\n"
+            << "                      by earlier runs with the same ROM and\n"
+            << "                      input prefix, and cache new ones\n"
+            << "  --state-cache-mb N  Cache size cap (default "
+            << (StateCache::kDefaultCapacity >> 20) << ")\n"
+            << "  --state-interval N  Frames between cached states\n"
+            << "                      (default 60)\n"
+            << "  --capture PATH      Stream the frames of a plain or\n"
+            << "                      --record run to a compressed file\n"
+            << "                      (export it with decode)\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(arg, "--frames") == 0 && hasValue) {
+      options.frames = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--tier") == 0 && hasValue) {
+      const char *tier = argv[++i];
+      if (std::strcmp(tier, AccurateTiming::kName) == 0) {
+        options.accurate = true;
+      } else if (std::strcmp(tier, FastTiming::kName) != 0) {
+        return false;
+      }
+    } else if (std::strcmp(arg, "--no-idle-skip") == 0) {
+      options.idleLoopSkipping = false;
+    } else if (std::strcmp(arg, "--boot-rom") == 0 && hasValue) {
+      options.bootRomPath = argv[++i];
+    } else if (std::strcmp(arg, "--fast-boot") == 0) {
+      options.fastBoot = true;
+    } else if (std::strcmp(arg, "--stats-json") == 0 && hasValue) {
+      options.statsJsonPath = argv[++i];
+    } else if (std::strcmp(arg, "--stats-csv") == 0 && hasValue) {
+      options.statsCsvPath = argv[++i];
+    } else if (std::strcmp(arg, "--record") == 0 && hasValue) {
+      options.recordPath = argv[++i];
+    } else if (std::strcmp(arg, "--play") == 0 && hasValue) {
+      options.playPath = argv[++i];
+    } else if (std::strcmp(arg, "--inputs") == 0 && hasValue) {
+      options.inputsPath = argv[++i];
+    } else if (std::strcmp(arg, "--checkpoint-interval") == 0 && hasValue) {
+      options.checkpointInterval = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--break") == 0 && hasValue) {
+      options.debugCommands.push_back(std::string("break ") + argv[++i]);
+    } else if (std::strcmp(arg, "--watch") == 0 && hasValue) {
+      options.debugCommands.push_back(std::string("watch ") + argv[++i]);
+    } else if (std::strcmp(arg, "--debug-script") == 0 && hasValue) {
+      options.debugScriptPath = argv[++i];
+    } else if (std::strcmp(arg, "--max-stops") == 0 && hasValue) {
+      options.maxStops = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--gdb") == 0 && hasValue) {
+      options.gdbAddress = argv[++i];
+    } else if (std::strcmp(arg, "--profile") == 0 && hasValue) {
+      options.profilePath = argv[++i];
+    } else if (std::strcmp(arg, "--profile-interval") == 0 && hasValue) {
+      options.profileInterval = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--state-cache") == 0 && hasValue) {
+      options.stateCachePath = argv[++i];
+    } else if (std::strcmp(arg, "--state-cache-mb") == 0 && hasValue) {
+      options.stateCacheMegabytes = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--state-interval") == 0 && hasValue) {
+      options.stateInterval = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--capture") == 0 && hasValue) {
+      options.capturePath = argv[++i];
+    } else if (arg[0] != '-' && options.romPath.empty()) {
+      options.romPath = arg;
+    } else {
+      return false;
+    }
+  }
+  // Movies are run frame by frame by their own loops
+  int modes = !options.recordPath.empty() + !options.playPath.empty() +
+              (!options.debugCommands.empty() ||
+               !options.debugScriptPath.empty()) +
+              !options.gdbAddress.empty();
+  if (modes > 1 || (options.fastBoot && !options.bootRomPath.empty())) {
+    return false;
+  }
+  // The tools above drive the fast tier
+  if (options.accurate && (modes > 0 || !options.profilePath.empty())) {
+    return false;
+  }
+  // Cached states stand in for whole frames of a plain fast-tier run
+  if (!options.stateCachePath.empty() &&
+      (modes > 0 || options.accurate || !options.profilePath.empty() ||
+       options.stateInterval == 0 || options.frames > UINT32_MAX)) {
+    return false;
+  }
+  if (!options.inputsPath.empty() && modes > 0 &&
+      options.recordPath.empty()) {
+    return false;
+  }
+  // Captures are taken by the plain and recording loops, every frame
+  if (!options.capturePath.empty() &&
+      ((modes > 0 && options.recordPath.empty()) ||
+       !options.stateCachePath.empty())) {
+    return false;
+  }
+  return !options.romPath.empty();
+}
+
+// Reads an input script into the buttons held in each of `inputs` frames;
+// each line's buttons are held from its frame until the next line's
+bool readInputScript(const std::string &path, std::vector<uint8_t> &inputs) {
+  std::ifstream file(path);
+  if (!file) {
+    return false;
+  }
+  std::vector<std::pair<uint64_t, uint8_t>> script;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    uint64_t frame;
+    unsigned buttons;
+    if (!(fields >> frame >> std::hex >> buttons)) {
+      return false;
+    }
+    script.emplace_back(frame, static_cast<uint8_t>(buttons));
+  }
+  std::stable_sort(script.begin(), script.end(),
+                   [](const auto &a, const auto &b) {
+                     return a.first < b.first;
+                   });
+  size_t next = 0;
+  uint8_t buttons = 0;
+  for (uint64_t frame = 0; frame < inputs.size(); frame++) {
+    for (; next < script.size() && script[next].first <= frame; next++) {
+      buttons = script[next].second;
+    }
+    inputs[frame] = buttons;
+  }
+  return true;
+}
+
+bool readFile(const std::string &path, std::vector<uint8_t> &data) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  data.assign(std::istreambuf_iterator<char>(file),
+              std::istreambuf_iterator<char>());
+  return true;
+}
+
+// Sets up the debugger from the command line and the debug script
+bool setUpDebugger(const Options &options, Debugger &debugger) {
+  std::vector<std::string> commands;
+  if (!options.debugScriptPath.empty()) {
+    std::ifstream file(options.debugScriptPath);
+    if (!file) {
+      std::cerr << "Failed to read " << options.debugScriptPath << "\n";
+      return false;
+    }
+    for (std::string line; std::getline(file, line);) {
+      commands.push_back(line);
+    }
+  }
+  commands.insert(commands.end(), options.debugCommands.begin(),
+                  options.debugCommands.end());
+  for (const std::string &command : commands) {
+    std::string error;
+    if (!debugger.command(command, error)) {
+      std::cerr << "Bad debugger command '" << command << "': " << error
+                << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+// Runs frames under the debugger, logging each stop and carrying on. The
+// frame boundaries, and so the machine state, match runFrame()'s.
+uint64_t runDebugged(GameBoy &gameboy, Debugger &debugger,
+                     const Options &options) {
+  uint64_t stops = 0;
+  for (uint64_t frame = 0; frame < options.frames; frame++) {
+    uint64_t end = gameboy.cpu.cycles +
+                   (PPU::kFrameCycles << gameboy.memory.io.speedShift());
+    while (gameboy.cpu.cycles < end) {
+      Stop stop = debugger.run(end - gameboy.cpu.cycles);
+      if (stop.reason == StopReason::None) {
+        break;
+      }
+      std::cout << "frame " << frame << ": " << describeStop(gameboy, stop)
+                << "\n";
+      if (++stops == options.maxStops) {
+        std::cout << "Stopped after " << stops << " debugger stops\n";
+        return frame;
+      }
+    }
+  }
+  return options.frames;
+}
+
+// Starts a loaded machine through the boot ROM, at the post-boot state or,
+// by default, straight at the cartridge entry point with the CPU's defaults
+template <typename Machine>
+bool boot(Machine &machine, const Options &options,
+          const std::vector<uint8_t> &bootRom) {
+  if (!options.bootRomPath.empty() && !machine.runBootRom(bootRom)) {
+    std::cerr << options.bootRomPath
+              << " is not a DMG (256-byte) or CGB (2304-byte) boot ROM\n";
+    return false;
+  }
+  if (options.fastBoot) {
+    machine.fastBoot();
+  }
+  return true;
+}
+
+// Starts the capture, if the run takes one, from a booted machine
+template <typename Machine>
+bool openCapture(const Machine &machine, const Options &options,
+                 CaptureWriter &capture) {
+  std::string error;
+  if (!options.capturePath.empty() &&
+      !capture.open(options.capturePath,
+                    CaptureFormat::forScreen(machine.memory.isCgb()),
+                    error)) {
+    std::cerr << "Failed to create capture " << error << "\n";
+    return false;
+  }
+  return true;
+}
+
+// Finishes the capture, if the run took one, and reports its size
+bool closeCapture(const Options &options, CaptureWriter &capture) {
+  if (options.capturePath.empty()) {
+    return true;
+  }
+  std::string error;
+  if (!capture.close(error)) {
+    std::cerr << "Failed to write capture " << error << "\n";
+    return false;
+  }
+  const CaptureStats &stats = capture.getStats();
+  std::cout << "Captured " << stats.frames << " frames in "
+            << stats.compressedBytes << " bytes ("
+            << stats.rawBytes / std::max<uint64_t>(stats.compressedBytes, 1)
+            << "x), " << stats.stalls << " stalls\n";
+  return true;
+}
+
+template <typename Machine>
+void printSummary(const Machine &machine, uint64_t frames) {
+  std::cout << "Ran " << frames << " frames (" << machine.cpu.cycles
+            << " cycles, " << machine.skippedIdleCycles << " skipped idle)\n";
+}
+
+// Runs a plain run's frames from the deepest state the cache holds for its
+// inputs, caching a state every --state-interval frames
+bool runWithStateCache(GameBoy &gameboy, const Options &options,
+                       const std::vector<uint8_t> &rom,
+                       const std::vector<uint8_t> &inputs) {
+  StateCache cache;
+  std::string error;
+  if (!cache.open(options.stateCachePath, options.stateCacheMegabytes << 20,
+                  error)) {
+    std::cerr << "Failed to open state cache " << error << "\n";
+    return false;
+  }
+  StateKey key =
+      StateKey::start(sha1(rom.data(), rom.size()), gameboy.stateHash());
+  uint32_t restored = cache.restore(gameboy, key, inputs);
+  for (uint32_t frame = 0; frame < restored; frame++) {
+    key.advance(inputs[frame]);
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  bool warned = false;
+  for (uint32_t frame = restored; frame < inputs.size(); frame++) {
+    gameboy.memory.setButtons(inputs[frame]);
+    gameboy.runFrame();
+    key.advance(inputs[frame]);
+    if (key.frame % options.stateInterval == 0 &&
+        !cache.store(gameboy, key) && !warned) {
+      std::cerr << "Failed to write to state cache "
+                << options.stateCachePath << "\n";
+      warned = true;
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+
+  const StateCacheStats &stats = cache.getStats();
+  std::cout << "State cache: " << stats.hits << "/" << stats.lookups
+            << " hits, resumed at frame " << restored << " in "
+            << stats.restoreSeconds * 1000 << " ms, " << stats.stores
+            << " stored, " << stats.evictions << " evicted\n";
+  // Estimated from this run's own speed, so only once it has run a frame
+  uint64_t emulated = inputs.size() - restored;
+  if (restored > 0 && emulated > 0) {
+    double saved = stats.framesRestored * elapsed.count() / emulated -
+                   stats.restoreSeconds;
+    std::cout << "State cache saved about " << saved * 1000 << " ms\n";
+  }
+  return true;
+}
+
+// Prints the most sampled PCs and banks, and writes the call stacks
+bool writeProfile(const Options &options, const Profiler &profiler) {
+  constexpr size_t kTop = 10;
+  uint64_t samples = std::max<uint64_t>(profiler.samples(), 1);
+  std::cout << "Profile: " << profiler.samples() << " samples every "
+            << profiler.interval() << " cycles\n";
+  std::vector<std::pair<RomLocation, uint64_t>> spots = profiler.hotSpots();
+  for (size_t i = 0; i < std::min(spots.size(), kTop); i++) {
+    const auto &[location, count] = spots[i];
+    char line[64];
+    std::snprintf(line, sizeof(line), "  %02X:%04X %6.2f%%\n", location.bank,
+                  location.address, 100.0 * count / samples);
+    std::cout << line;
+  }
+  std::vector<std::pair<uint16_t, uint64_t>> banks = profiler.hotBanks();
+  for (size_t i = 0; i < std::min(banks.size(), kTop); i++) {
+    const auto &[bank, count] = banks[i];
+    char line[64];
+    std::snprintf(line, sizeof(line), "  bank %3u %6.2f%%\n", bank,
+                  100.0 * count / samples);
+    std::cout << line;
+  }
+
+  std::ofstream out(options.profilePath);
+  profiler.writeCollapsed(out);
+  if (!out) {
+    std::cerr << "Failed to write " << options.profilePath << "\n";
+    return false;
+  }
+  return true;
+}
+
+#ifdef GB_INSTRUMENTATION
+bool writeStats(const Options &options, const PerfCounters &counters) {
+  if (!options.statsJsonPath.empty()) {
+    std::ofstream out(options.statsJsonPath);
+    writeCountersJson(out, counters);
+    if (!out) {
+      std::cerr << "Failed to write " << options.statsJsonPath << "\n";
+      return false;
+    }
+  }
+  if (!options.statsCsvPath.empty()) {
+    std::ofstream out(options.statsCsvPath);
+    writeCountersCsv(out, counters);
+    if (!out) {
+      std::cerr << "Failed to write " << options.statsCsvPath << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+#endif
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  bool wantsStats =
+      !options.statsJsonPath.empty() || !options.statsCsvPath.empty();
+  if (wantsStats && !kInstrumentation) {
+    std::cerr << "Performance counters are not available: rebuild with "
+                 "-DGB_INSTRUMENTATION=ON\n";
+    return 1;
+  }
+
+  std::vector<uint8_t> rom;
+  if (!readFile(options.romPath, rom)) {
+    std::cerr << "Failed to read ROM " << options.romPath << "\n";
+    return 1;
+  }
+  std::vector<uint8_t> bootRom;
+  if (!options.bootRomPath.empty() && !readFile(options.bootRomPath, bootRom)) {
+    std::cerr << "Failed to read boot ROM " << options.bootRomPath << "\n";
+    return 1;
+  }
+
+  if (options.accurate) {
+    AccurateGameBoy gameboy;
+    gameboy.loadRom(rom);
+    if (!boot(gameboy, options, bootRom)) {
+      return 1;
+    }
+    gameboy.idleLoopSkipping = options.idleLoopSkipping;
+    CaptureWriter capture;
+    if (!openCapture(gameboy, options, capture)) {
+      return 1;
+    }
+    bool capturing = !options.capturePath.empty();
+    for (uint64_t frame = 0; frame < options.frames; frame++) {
+      gameboy.runFrame();
+      if (capturing) {
+        capture.pushFrame(gameboy.ppu.getFramebuffer());
+      }
+    }
+    if (!closeCapture(options, capture)) {
+      return 1;
+    }
+    printSummary(gameboy, options.frames);
+#ifdef GB_INSTRUMENTATION
+    if (!writeStats(options, gameboy.memory.counters)) {
+      return 1;
+    }
+#endif
+    return 0;
+  }
+
+  GameBoy gameboy;
+  gameboy.loadRom(rom);
+  if (!boot(gameboy, options, bootRom)) {
+    return 1;
+  }
+  gameboy.idleLoopSkipping = options.idleLoopSkipping;
+  std::optional<Profiler> profiler;
+  if (!options.profilePath.empty()) {
+    profiler.emplace(gameboy, options.profileInterval);
+  }
+  CaptureWriter capture;
+  if (!openCapture(gameboy, options, capture)) {
+    return 1;
+  }
+  bool capturing = !options.capturePath.empty();
+
+  // The buttons for each frame; none pressed without an input script
+  std::vector<uint8_t> inputs;
+  if (options.playPath.empty()) {
+    inputs.resize(options.frames);
+  }
+  if (!options.inputsPath.empty() &&
+      !readInputScript(options.inputsPath, inputs)) {
+    std::cerr << "Failed to read inputs " << options.inputsPath << "\n";
+    return 1;
+  }
+
+  if (!options.playPath.empty()) {
+    Movie movie;
+    if (!movie.load(options.playPath)) {
+      std::cerr << "Failed to read movie " << options.playPath << "\n";
+      return 1;
+    }
+    ReplayResult result = playMovie(gameboy, movie);
+    options.frames = result.framesPlayed;
+    if (!result.ok) {
+      std::cerr << "Replay failed: " << result.error << "\n";
+      return 1;
+    }
+    std::cout << "Replay verified " << result.checkpointsVerified
+              << " checkpoints\n";
+  } else if (!options.recordPath.empty()) {
+    MovieRecorder recorder(gameboy, options.checkpointInterval);
+    for (uint64_t frame = 0; frame < options.frames; frame++) {
+      recorder.runFrame(inputs[frame]);
+      if (capturing) {
+        capture.pushFrame(gameboy.ppu.getFramebuffer());
+      }
+    }
+    if (!recorder.getMovie().save(options.recordPath)) {
+      std::cerr << "Failed to write movie " << options.recordPath << "\n";
+      return 1;
+    }
+  } else if (!options.gdbAddress.empty()) {
+    GdbStub stub(gameboy);
+    std::string error;
+    bool isPort = options.gdbAddress.find_first_not_of("0123456789") ==
+                  std::string::npos;
+    unsigned long port = std::strtoul(options.gdbAddress.c_str(), nullptr, 10);
+    if (isPort && (port > 0xFFFF || options.gdbAddress.size() > 5)) {
+      std::cerr << "Bad port " << options.gdbAddress << "\n";
+      return 1;
+    }
+    if (!(isPort ? stub.listenTcp(static_cast<uint16_t>(port), error)
+                 : stub.listenUnix(options.gdbAddress, error))) {
+      std::cerr << "Failed to listen for GDB: " << error << "\n";
+      return 1;
+    }
+    std::cout << "Waiting for GDB on "
+              << (isPort ? "127.0.0.1:" + std::to_string(stub.port())
+                         : options.gdbAddress)
+              << std::endl;
+    stub.waitForClient();
+    for (uint64_t frame = 0; frame < options.frames; frame++) {
+      stub.runFrame();
+    }
+  } else if (!options.debugCommands.empty() ||
+             !options.debugScriptPath.empty()) {
+    Debugger debugger(gameboy);
+    if (!setUpDebugger(options, debugger)) {
+      return 1;
+    }
+    options.frames = runDebugged(gameboy, debugger, options);
+  } else if (!options.stateCachePath.empty()) {
+    if (!runWithStateCache(gameboy, options, rom, inputs)) {
+      return 1;
+    }
+  } else {
+    bool scripted = !options.inputsPath.empty();
+    for (uint64_t frame = 0; frame < options.frames; frame++) {
+      if (scripted) {
+        gameboy.memory.setButtons(inputs[frame]);
+      }
+      gameboy.runFrame();
+      if (capturing) {
+        capture.pushFrame(gameboy.ppu.getFramebuffer());
+      }
+    }
+  }
+
+  if (!closeCapture(options, capture)) {
+    return 1;
+  }
+  printSummary(gameboy, options.frames);
+  if (profiler && !writeProfile(options, *profiler)) {
+    return 1;
+  }
+
+#ifdef GB_INSTRUMENTATION
+  if (!writeStats(options, gameboy.memory.counters)) {
+    return 1;
+  }
+#endif
+  return 0;
+}
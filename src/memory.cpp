@@ -8,12 +8,327 @@
 
 #include "../include/memory.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
+#include "../include/hash.hpp"
+#include "../include/save_state.hpp"
+
+namespace {
+
+// Fills a page from saved bytes, leaving all-zero pages unallocated unless
+// the page's storage is pinned
+template <size_t Size>
+void loadPage(SharedPage<Size> &page, const uint8_t *bytes,
+              const PageResource &resource, bool pinned = false) {
+  if (!bytes) {
+    return;
+  }
+  if (!pinned &&
+      std::all_of(bytes, bytes + Size, [](uint8_t byte) { return !byte; })) {
+    page = SharedPage<Size>();
+  } else {
+    std::copy(bytes, bytes + Size, page.unshare(resource));
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Constructs a Memory object with all storage zeroed and no
+ * cartridge inserted.
+ *
+ * @param resource Where pages are allocated once written.
+ */
+Memory::Memory(PageResource resource) : resource(std::move(resource)) {
+  cartridge.setResource(this->resource);
+  io.memory = this;
+  mapPages();
+}
+
+/**
+ * @brief Copies another Memory object; the I/O block stays bound to this one.
+ *
+ * @param other The memory to copy.
+ */
+Memory::Memory(const Memory &other) : Memory(other, Sharing{}) {
+  unshare();
+}
+
+/**
+ * @brief Takes over another Memory object's pages; the I/O block stays
+ * bound to this one.
+ *
+ * @param other The memory to take over.
+ */
+Memory::Memory(Memory &&other) : Memory(other, Sharing{}) {}
+
+/**
+ * @brief Copies another Memory object's state, sharing its pages, and maps
+ * them for this object.
+ */
+Memory::Memory(const Memory &other, Sharing)
+    : counters(other.counters),
+      io(other.io),
+      cartridge(other.cartridge),
+      vram(other.vram),
+      wram(other.wram),
+      high(other.high),
+      vramBank(other.vramBank),
+      wramBank(other.wramBank),
+      cgb(other.cgb),
+      bootRom(other.bootRom),
+      busLocked(other.busLocked),
+      resource(other.resource) {
+  io.memory = this;
+  unpinShared(other);
+  mapPages();
+}
+
+/**
+ * @brief Copies another Memory object's contents and mapping state.
+ *
+ * The pages are shared and then copied at once, since `other` may keep
+ * writing them in place. The page pointers are rebuilt rather than copied
+ * so that they point into this object's storage.
+ *
+ * @param other The memory to copy.
+ */
+Memory &Memory::operator=(const Memory &other) {
+  share(other);
+  unshare();
+  return *this;
+}
+
+/**
+ * @brief Takes over another Memory object's pages, leaving them shared.
+ *
+ * @param other The memory to take over.
+ */
+Memory &Memory::operator=(Memory &&other) {
+  share(other);
+  mapPages();
+  return *this;
+}
+
+/**
+ * @brief Creates a copy-on-write copy of this memory.
+ *
+ * Both sides' page tables are rebuilt so that neither maps a shared page
+ * for writing.
+ *
+ * @return The copy.
+ */
+Memory Memory::fork() {
+  std::lock_guard<std::mutex> lock(forkMutex);
+  Memory child(*this, Sharing{});
+  mapPages();
+  return child;
+}
+
+/**
+ * @brief Copies another Memory object's state, sharing its pages. Pinned
+ * work RAM banks, on either side, are copied instead.
+ *
+ * Leaves the page tables to the caller.
+ */
+void Memory::share(const Memory &other) {
+  if (&other == this) {
+    return;
+  }
+  cartridge = other.cartridge;
+  cartridge.setResource(resource);
+  vram = other.vram;
+  for (size_t bank = 0; bank < wram.size(); bank++) {
+    if (pinnedWram >> bank & 1) {
+      std::copy_n(other.wram[bank].data(), 0x1000,
+                  wram[bank].unshare(resource));
+    } else {
+      wram[bank] = other.wram[bank];
+    }
+  }
+  unpinShared(other);
+  high = other.high;
+  vramBank = other.vramBank;
+  wramBank = other.wramBank;
+  cgb = other.cgb;
+  bootRom = other.bootRom;
+  counters = other.counters;
+  io = other.io;
+  busLocked = other.busLocked;
+}
+
 /**
- * @brief Constructs a Memory object and initializes the memory to zero.
+ * @brief Takes private copies of the banks `other` has pinned, which this
+ * memory has just been given references to, so that they stay unshared.
  */
-Memory::Memory() { memory.fill(0); }
+void Memory::unpinShared(const Memory &other) {
+  for (size_t bank = 0; bank < wram.size(); bank++) {
+    if (other.pinnedWram >> bank & 1) {
+      wram[bank].unshare(resource);
+    }
+  }
+}
+
+/**
+ * @brief Takes private copies of all shared pages and maps them.
+ */
+void Memory::unshare() {
+  for (SharedPage<0x2000> &bank : vram) {
+    bank.unshare(resource);
+  }
+  for (SharedPage<0x1000> &bank : wram) {
+    bank.unshare(resource);
+  }
+  cartridge.unshare();
+  mapPages();
+}
+
+/**
+ * @brief Builds the page tables for the current bank selection.
+ */
+void Memory::mapPages() {
+  mapCartridge();
+  selectVramBank(vramBank);
+  selectWramBank(wramBank);
+  // OAM, I/O and HRAM need the slow path
+  mapRange(0xFE00, 0x10000, nullptr, nullptr);
+  lockBus(busLocked);
+}
+
+/**
+ * @brief Maps the cartridge's selected ROM and RAM banks.
+ *
+ * Once a cartridge is inserted, ROM pages have no write pointer so that
+ * writes reach the bank controller.
+ */
+void Memory::mapCartridge() {
+  uint8_t *writable = cartridge.writableRom();
+  mapRange(0x0000, 0x4000, cartridge.romBank0(), writable);
+  mapRange(0x4000, 0x8000, cartridge.romBankN(),
+           writable ? writable + Cartridge::kRomBankSize : nullptr);
+  mapRange(0xA000, 0xC000, cartridge.ramBank(), cartridge.writableRamBank());
+  if (bootRom) {
+    mapRange(0x0000, 0x0100, bootRom->data(), nullptr);
+    if (bootRom->size() > 0x100) {
+      mapRange(0x0200, 0x0900, bootRom->data() + 0x200, nullptr);
+    }
+  }
+}
+
+/**
+ * @brief Maps VRAM bank 0 or 1 at 8000-9FFF.
+ *
+ * @param bank The bank number.
+ */
+void Memory::selectVramBank(uint8_t bank) {
+  vramBank = bank & 0x01;
+  SharedPage<0x2000> &page = vram[vramBank];
+  mapRange(0x8000, 0xA000, page.data(), page.writable());
+}
+
+/**
+ * @brief Maps work RAM bank 0 at C000-CFFF, bank 1-7 at D000-DFFF and
+ * their echo at E000-FDFF.
+ *
+ * @param bank The bank number; 0 selects bank 1.
+ */
+void Memory::selectWramBank(uint8_t bank) {
+  wramBank = std::max<uint8_t>(bank & 0x07, 1);
+  SharedPage<0x1000> &fixed = wram[0];
+  SharedPage<0x1000> &banked = wram[wramBank];
+  mapRange(0xC000, 0xD000, fixed.data(), fixed.writable());
+  mapRange(0xD000, 0xE000, banked.data(), banked.writable());
+  // Echo of C000-DDFF
+  mapRange(0xE000, 0xF000, fixed.data(), fixed.writable());
+  mapRange(0xF000, 0xFE00, banked.data(), banked.writable());
+}
+
+/**
+ * @brief Gives this memory a private copy of the shared page holding an
+ * address and maps it for writing.
+ *
+ * @return The storage for the address, or null if it is not RAM (or is
+ * disabled cartridge RAM).
+ */
+uint8_t *Memory::unsharePage(uint16_t address) {
+  if (address < 0x8000 || address >= 0xFE00) {
+    return nullptr;
+  }
+  if (address < 0xA000) {
+    vram[vramBank].unshare(resource);
+    selectVramBank(vramBank);
+  } else if (address < 0xC000) {
+    if (!cartridge.unshareRamBank()) {
+      return nullptr;
+    }
+    mapCartridge();
+  } else {
+    // Bit 12 tells the banked half from bank 0, in the echo too
+    wram[address & 0x1000 ? wramBank : 0].unshare(resource);
+    selectWramBank(wramBank);
+  }
+  return writeMap[address >> 8] + (address & 0xFF);
+}
+
+uint8_t *Memory::workRam(uint8_t bank) {
+  bank &= 0x07;
+  uint8_t *bytes = wram[bank].unshare(resource);
+  pinnedWram |= 1 << bank;
+  selectWramBank(wramBank);
+  return bytes;
+}
+
+/**
+ * @brief Points the pages of [start, end) at consecutive pages of storage.
+ *
+ * @param start The first address, page aligned.
+ * @param end One past the last address, page aligned.
+ * @param read The storage for reads, or null for the slow path.
+ * @param write The storage for writes, or null for the slow path.
+ */
+void Memory::mapRange(uint16_t start, uint32_t end, const uint8_t *read,
+                      uint8_t *write) {
+  for (uint32_t address = start; address < end; address += 0x100) {
+    size_t page = address >> 8;
+    size_t offset = address - start;
+    readMap[page] = read ? read + offset : nullptr;
+    writeMap[page] = write ? write + offset : nullptr;
+    if (!busLocked) {
+      readPages[page] = readTraps[page] ? nullptr : readMap[page];
+      writePages[page] = writeTraps[page] ? nullptr : writeMap[page];
+    }
+  }
+}
+
+/**
+ * @brief Returns the plain storage a DMA reads at an address, or null for
+ * I/O and disabled cartridge RAM.
+ */
+const uint8_t *Memory::readableAt(uint16_t address) const {
+  if (const uint8_t *page = readMap[address >> 8]) {
+    return page + (address & 0xFF);
+  }
+  if (address >= 0xFE00 && !isIO(address)) {
+    return &high[address - 0xFE00];
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Returns the plain storage a DMA writes at an address, or null for
+ * ROM, I/O and disabled cartridge RAM. A shared page is copied first.
+ */
+uint8_t *Memory::writableAt(uint16_t address) {
+  if (uint8_t *page = writeMap[address >> 8]) {
+    return page + (address & 0xFF);
+  }
+  if (address >= 0xFE00 && !isIO(address)) {
+    return &high[address - 0xFE00];
+  }
+  return unsharePage(address);
+}
 
 /**
  * @brief Reads a byte from the specified memory address.
@@ -21,7 +336,20 @@ Memory::Memory() { memory.fill(0); }
  * @param address The 16-bit address to read from.
  * @return The byte value read from the specified address.
  */
-uint8_t Memory::readByte(uint16_t address) { return memory[address]; }
+template <typename Timing>
+uint8_t Memory::readByte(uint16_t address) {
+  if constexpr (Timing::kMCycleBus) {
+    io.elapse(4);
+    if (catchUp && reachesDevice(address)) {
+      catchUp();
+    }
+  }
+  counters.countRead(address);
+  if (const uint8_t *page = readPages[address >> 8]) {
+    return page[address & 0xFF];
+  }
+  return readSlow(address);
+}
 
 /**
  * @brief Writes a byte to the specified memory address.
@@ -29,12 +357,85 @@ uint8_t Memory::readByte(uint16_t address) { return memory[address]; }
  * @param address The 16-bit address to write to.
  * @param value The byte value to write to the specified address.
  */
+template <typename Timing>
 void Memory::writeByte(uint16_t address, uint8_t value) {
   if (address < 0 || address >= 0x10000) {
     // Handle invalid address or throw exception
     return;
   }
-  memory[address] = value;
+  if constexpr (Timing::kMCycleBus) {
+    io.elapse(4);
+    if (catchUp && reachesDevice(address)) {
+      catchUp();
+    }
+  }
+  counters.countWrite(address);
+  if (uint8_t *page = writePages[address >> 8]) {
+    page[address & 0xFF] = value;
+    return;
+  }
+  writeSlow(address, value);
+}
+
+/**
+ * @brief Reads an address that has no page mapped for the CPU.
+ */
+uint8_t Memory::readSlow(uint16_t address) {
+  if (watcher && readTraps[address >> 8]) {
+    const uint8_t *page = busLocked ? nullptr : readMap[address >> 8];
+    uint8_t value = page ? page[address & 0xFF] : readUnmapped(address);
+    watcher->watchedRead(address, value);
+    return value;
+  }
+  return readUnmapped(address);
+}
+
+/**
+ * @brief Reads an address that has no page mapped at all.
+ */
+uint8_t Memory::readUnmapped(uint16_t address) {
+  if (address < 0xFF00) {
+    // Locked by DMA, disabled cartridge RAM, or OAM and the unusable area
+    return busLocked || address < 0xFE00 ? 0xFF : high[address - 0xFE00];
+  }
+  if (isIO(address)) {
+    return io.read(address & 0x7F);
+  }
+  return high[address - 0xFE00];
+}
+
+/**
+ * @brief Writes an address that has no page mapped for the CPU.
+ */
+void Memory::writeSlow(uint16_t address, uint8_t value) {
+  if (watcher && writeTraps[address >> 8]) {
+    watcher->watchedWrite(address, value);
+    if (uint8_t *page = busLocked ? nullptr : writeMap[address >> 8]) {
+      page[address & 0xFF] = value;
+      return;
+    }
+  }
+  if (address >= 0xFF00) {
+    if (isIO(address)) {
+      io.write(address & 0x7F, value);
+    } else {
+      high[address - 0xFE00] = value;
+    }
+  } else if (busLocked) {
+    return;
+  } else if (address < 0x8000) {
+    uint16_t romBank = cartridge.highBank();
+    if (cartridge.writeControl(address, value)) {
+      if (cartridge.highBank() != romBank) {
+        counters.countBankSwitch();
+      }
+      mapCartridge();
+    }
+  } else if (address >= 0xFE00) {
+    high[address - 0xFE00] = value;
+  } else if (uint8_t *storage = unsharePage(address)) {
+    *storage = value;  // First write to a shared page
+  }
 }
 
 /**
@@ -43,8 +444,10 @@ void Memory::writeByte(uint16_t address, uint8_t value) {
  * @param address The 16-bit address to read from.
  * @return The 16-bit word value read from the specified address.
  */
+template <typename Timing>
 uint16_t Memory::readWord(uint16_t address) {
-  return readByte(address) | (readByte(address + 1) << 8);
+  uint16_t low = readByte<Timing>(address);  // Sequenced, low byte first
+  return low | (readByte<Timing>(address + 1) << 8);
 }
 
 /**
@@ -53,7 +456,234 @@ uint16_t Memory::readWord(uint16_t address) {
  * @param address The 16-bit address to write to.
  * @param value The 16-bit word value to write to the specified address.
  */
+template <typename Timing>
 void Memory::writeWord(uint16_t address, uint16_t value) {
-  writeByte(address, value & 0xFF);
-  writeByte(address + 1, value >> 8);
-}
\ No newline at end of file
+  writeByte<Timing>(address, value & 0xFF);
+  writeByte<Timing>(address + 1, value >> 8);
+}
+
+template uint8_t Memory::readByte<FastTiming>(uint16_t);
+template uint8_t Memory::readByte<AccurateTiming>(uint16_t);
+template void Memory::writeByte<FastTiming>(uint16_t, uint8_t);
+template void Memory::writeByte<AccurateTiming>(uint16_t, uint8_t);
+template uint16_t Memory::readWord<FastTiming>(uint16_t);
+template uint16_t Memory::readWord<AccurateTiming>(uint16_t);
+template void Memory::writeWord<FastTiming>(uint16_t, uint16_t);
+template void Memory::writeWord<AccurateTiming>(uint16_t, uint16_t);
+
+/**
+ * @brief Inserts a cartridge, mapping its first banks.
+ *
+ * @param rom The ROM image.
+ */
+void Memory::loadRom(const std::vector<uint8_t> &rom) {
+  loadRom(Cartridge::prepare(rom));
+}
+
+/**
+ * @brief Inserts a cartridge holding a shared ROM image.
+ *
+ * @param rom The prepared ROM image.
+ */
+void Memory::loadRom(Cartridge::Image rom) {
+  cartridge.load(std::move(rom));
+  cgb = cartridge.isCgb();
+  mapCartridge();
+}
+
+/**
+ * @brief Maps a boot ROM over the start of the cartridge.
+ *
+ * @param image A 256-byte DMG or 2304-byte CGB boot ROM.
+ * @return Whether the image was mapped.
+ */
+bool Memory::mapBootRom(Cartridge::Image image) {
+  if (!image || (image->size() != 0x100 && image->size() != 0x900)) {
+    return false;
+  }
+  bootRom = std::move(image);
+  mapCartridge();
+  return true;
+}
+
+/**
+ * @brief Points the boot ROM's pages back at the cartridge, so that once
+ * it is gone the boot ROM costs later accesses nothing.
+ */
+void Memory::unmapBootRom() {
+  if (bootRom) {
+    bootRom.reset();
+    mapCartridge();
+  }
+}
+
+/**
+ * @brief Copies a block one page-bounded run at a time.
+ *
+ * @param destination The first address written.
+ * @param source The first address read.
+ * @param length The number of bytes to copy.
+ */
+void Memory::transfer(uint16_t destination, uint16_t source, uint16_t length) {
+  while (length > 0) {
+    int sourceRoom = 0x100 - (source & 0xFF);
+    int destinationRoom = 0x100 - (destination & 0xFF);
+    uint16_t run = std::min({int{length}, sourceRoom, destinationRoom});
+    const uint8_t *from = readableAt(source);
+    uint8_t *to = writableAt(destination);
+    if (from && to) {
+      std::memmove(to, from, run);
+    } else {
+      for (uint16_t i = 0; i < run; i++) {
+        poke(destination + i, peek(source + i));
+      }
+    }
+    source += run;
+    destination += run;
+    length -= run;
+  }
+}
+
+/**
+ * @brief Locks or unlocks the CPU's access to the bus below FF00.
+ *
+ * @param locked Whether a DMA is in progress.
+ */
+void Memory::lockBus(bool locked) {
+  busLocked = locked;
+  if (busLocked) {
+    readPages.fill(nullptr);
+    writePages.fill(nullptr);
+  } else {
+    readPages = readMap;
+    writePages = writeMap;
+    applyTraps();
+  }
+}
+
+/**
+ * @brief Sets the trapped pages and rebuilds the CPU's view of the map.
+ */
+void Memory::setTraps(MemoryWatcher *watcher, const std::bitset<0x100> &reads,
+                      const std::bitset<0x100> &writes) {
+  this->watcher = watcher;
+  readTraps = watcher ? reads : std::bitset<0x100>();
+  writeTraps = watcher ? writes : std::bitset<0x100>();
+  lockBus(busLocked);
+}
+
+/**
+ * @brief Removes the trapped pages from the CPU's view of the map.
+ */
+void Memory::applyTraps() {
+  if (!watcher) {
+    return;
+  }
+  for (size_t page = 0; page < 0x100; page++) {
+    if (readTraps[page]) {
+      readPages[page] = nullptr;
+    }
+    if (writeTraps[page]) {
+      writePages[page] = nullptr;
+    }
+  }
+}
+
+/**
+ * @brief Sets the pressed joypad buttons, requesting the joypad interrupt
+ * on a newly pressed, selected button.
+ *
+ * @param pressed The pressed buttons; 1 bits are pressed.
+ */
+void Memory::setButtons(uint8_t pressed) {
+  io.setButtons(pressed);
+  io.syncJoypad();
+}
+
+/**
+ * @brief Hashes the full contents of memory.
+ *
+ * @return A host-independent FNV-1a hash of all 64 KB.
+ */
+uint64_t Memory::hash() const {
+  uint64_t hash = fnv1aValue(cartridge.hash(), kFnvOffsetBasis);
+  for (const SharedPage<0x2000> &bank : vram) {
+    hash = fnv1a(bank.data(), 0x2000, hash);
+  }
+  for (const SharedPage<0x1000> &bank : wram) {
+    hash = fnv1a(bank.data(), 0x1000, hash);
+  }
+  hash = fnv1a(high.data(), high.size(), hash);
+  hash = fnv1aValue(io.hash(), hash);
+  uint32_t mapping = vramBank | (wramBank << 8) | (cgb << 16) |
+                     (busLocked << 17);
+  if (bootRom) {  // Leaves the hashes of machines without one unchanged
+    hash = fnv1a(bootRom->data(), bootRom->size(), hash);
+  }
+  return fnv1aValue(mapping, hash);
+}
+
+void Memory::saveState(StateWriter &out) const {
+  cartridge.saveState(out);
+  for (const SharedPage<0x2000> &bank : vram) {
+    out.write(bank.data(), 0x2000);
+  }
+  for (const SharedPage<0x1000> &bank : wram) {
+    out.write(bank.data(), 0x1000);
+  }
+  out.write(high.data(), high.size());
+  out.write(vramBank);
+  out.write(wramBank);
+  out.write<uint8_t>(cgb);
+  out.write<uint8_t>(busLocked);
+  out.write<uint16_t>(bootRom ? bootRom->size() : 0);
+  if (bootRom) {
+    out.write(bootRom->data(), bootRom->size());
+  }
+  io.saveState(out);
+}
+
+bool Memory::loadState(StateReader &in, std::string &error) {
+  if (!cartridge.loadState(in)) {
+    mapPages();  // Some RAM banks may have been replaced
+    error = in.ok() ? "state is for a different cartridge" : "truncated state";
+    return false;
+  }
+  for (SharedPage<0x2000> &bank : vram) {
+    loadPage(bank, in.take(0x2000), resource);
+  }
+  for (size_t bank = 0; bank < wram.size(); bank++) {
+    loadPage(wram[bank], in.take(0x1000), resource, pinnedWram >> bank & 1);
+  }
+  if (const uint8_t *bytes = in.take(high.size())) {
+    std::copy(bytes, bytes + high.size(), high.begin());
+  }
+  vramBank = in.read<uint8_t>();
+  wramBank = in.read<uint8_t>();
+  cgb = in.read<uint8_t>();
+  busLocked = in.read<uint8_t>();
+  bool valid = vramBank <= 1 && wramBank >= 1 && wramBank <= 7;
+  // mapCartridge() maps a DMG or CGB boot ROM by these sizes
+  uint16_t bootRomSize = in.read<uint16_t>();
+  valid = valid && (bootRomSize == 0 || bootRomSize == 0x100 ||
+                    bootRomSize == 0x900);
+  bootRom.reset();
+  if (valid && bootRomSize) {
+    if (const uint8_t *bytes = in.take(bootRomSize)) {
+      bootRom = std::make_shared<const std::vector<uint8_t>>(
+          bytes, bytes + bootRomSize);
+    }
+  }
+  valid = io.loadState(in) && valid;
+  // The old pages may be gone, so the new ones are mapped even on failure
+  mapPages();
+  if (!in.ok()) {
+    error = "truncated state";
+    return false;
+  }
+  if (!valid) {
+    error = "corrupt state";
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file movie.cpp
+ * @brief Implementation of input movie recording and playback.
+ */
+
+#include "../include/movie.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+constexpr char kMagic[4] = {'G', 'B', 'M', 'V'};
+
+void putInt(std::vector<uint8_t> &out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; i++) {
+    out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+  }
+}
+
+// Reads a little-endian integer, returning false past the end of the data
+bool getInt(const std::vector<uint8_t> &in, size_t &offset, int bytes,
+            uint64_t &value) {
+  if (offset + bytes > in.size()) {
+    return false;
+  }
+  value = 0;
+  for (int i = 0; i < bytes; i++) {
+    value |= static_cast<uint64_t>(in[offset++]) << (i * 8);
+  }
+  return true;
+}
+
+}  // namespace
+
+bool Movie::save(const std::string &path) const {
+  std::vector<uint8_t> data(kMagic, kMagic + sizeof(kMagic));
+  putInt(data, kVersion, 4);
+  putInt(data, initialStateHash, 8);
+  putInt(data, inputs.size(), 4);
+  putInt(data, checkpoints.size(), 4);
+  data.insert(data.end(), inputs.begin(), inputs.end());
+  for (const Checkpoint &checkpoint : checkpoints) {
+    putInt(data, checkpoint.frame, 4);
+    putInt(data, checkpoint.framebufferHash, 8);
+  }
+
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(data.data()), data.size());
+  return static_cast<bool>(file);
+}
+
+bool Movie::load(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+  if (data.size() < sizeof(kMagic) ||
+      !std::equal(kMagic, kMagic + sizeof(kMagic), data.begin())) {
+    return false;
+  }
+
+  size_t offset = sizeof(kMagic);
+  uint64_t version, hash, frameCount, checkpointCount;
+  if (!getInt(data, offset, 4, version) || version != kVersion ||
+      !getInt(data, offset, 8, hash) ||
+      !getInt(data, offset, 4, frameCount) ||
+      !getInt(data, offset, 4, checkpointCount) ||
+      offset + frameCount > data.size()) {
+    return false;
+  }
+
+  Movie movie;
+  movie.initialStateHash = hash;
+  movie.inputs.assign(data.begin() + offset,
+                      data.begin() + offset + frameCount);
+  offset += frameCount;
+  for (uint64_t i = 0; i < checkpointCount; i++) {
+    uint64_t frame, framebufferHash;
+    if (!getInt(data, offset, 4, frame) ||
+        !getInt(data, offset, 8, framebufferHash)) {
+      return false;
+    }
+    movie.checkpoints.push_back(
+        {static_cast<uint32_t>(frame), framebufferHash});
+  }
+
+  *this = std::move(movie);
+  return true;
+}
+
+MovieRecorder::MovieRecorder(GameBoy &gameboy, uint32_t checkpointInterval)
+    : gameboy(gameboy), checkpointInterval(checkpointInterval) {
+  movie.initialStateHash = gameboy.stateHash();
+}
+
+void MovieRecorder::runFrame(uint8_t buttons) {
+  uint32_t frame = static_cast<uint32_t>(movie.inputs.size());
+  gameboy.memory.setButtons(buttons);
+  gameboy.runFrame();
+  movie.inputs.push_back(buttons);
+  if (checkpointInterval != 0 && (frame + 1) % checkpointInterval == 0) {
+    movie.checkpoints.push_back({frame, gameboy.ppu.framebufferHash()});
+  }
+}
+
+ReplayResult playMovie(GameBoy &gameboy, const Movie &movie) {
+  ReplayResult result;
+  if (gameboy.stateHash() != movie.initialStateHash) {
+    result.error = "initial state hash does not match the recording";
+    return result;
+  }
+
+  std::vector<Checkpoint>::const_iterator checkpoint =
+      movie.checkpoints.begin();
+  for (uint32_t frame = 0; frame < movie.inputs.size(); frame++) {
+    gameboy.memory.setButtons(movie.inputs[frame]);
+    gameboy.runFrame();
+    result.framesPlayed++;
+
+    for (; checkpoint != movie.checkpoints.end() && checkpoint->frame == frame;
+         ++checkpoint) {
+      if (gameboy.ppu.framebufferHash() != checkpoint->framebufferHash) {
+        result.error =
+            "framebuffer mismatch at frame " + std::to_string(frame);
+        return result;
+      }
+      result.checkpointsVerified++;
+    }
+  }
+
+  result.ok = true;
+  return result;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file perf_counters.cpp
+ * @brief Implementation of the performance counter helpers and exporters.
+ */
+
+#include "../include/perf_counters.hpp"
+
+#include <cstdio>
+
+namespace {
+
+// Formats an opcode as "0x3E"
+const char *opcodeName(uint8_t opcode) {
+  static char name[5];
+  std::snprintf(name, sizeof(name), "0x%02X", opcode);
+  return name;
+}
+
+uint64_t sum(const std::array<uint64_t, 256> &values) {
+  uint64_t total = 0;
+  for (uint64_t value : values) {
+    total += value;
+  }
+  return total;
+}
+
+}  // namespace
+
+Region regionOf(uint16_t address) {
+  if (address < 0x8000) return Region::Rom;
+  if (address < 0xA000) return Region::VRam;
+  if (address < 0xC000) return Region::ExternalRam;
+  if (address < 0xE000) return Region::WRam;
+  if (address < 0xFE00) return Region::Echo;
+  if (address < 0xFEA0) return Region::Oam;
+  if (address < 0xFF00) return Region::Unusable;
+  if (address < 0xFF80) return Region::IO;
+  if (address < 0xFFFF) return Region::HRam;
+  return Region::IE;
+}
+
+const char *regionName(Region region) {
+  static constexpr const char *names[] = {
+      "rom", "vram", "eram", "wram", "echo", "oam", "unusable", "io", "hram",
+      "ie"};
+  return names[static_cast<size_t>(region)];
+}
+
+void writeCountersJson(std::ostream &out, const PerfCounters &counters) {
+  out << "{\n";
+  out << "  \"instructions\": " << sum(counters.opcodeCount) << ",\n";
+  out << "  \"cycles\": " << sum(counters.opcodeCycles) << ",\n";
+  out << "  \"haltCycles\": " << counters.haltCycles << ",\n";
+  out << "  \"bankSwitches\": " << counters.bankSwitches << ",\n";
+
+  out << "  \"opcodes\": [";
+  bool first = true;
+  for (size_t opcode = 0; opcode < 256; opcode++) {
+    if (counters.opcodeCount[opcode] == 0) {
+      continue;
+    }
+    out << (first ? "\n" : ",\n");
+    out << "    {\"opcode\": \"" << opcodeName(opcode)
+        << "\", \"count\": " << counters.opcodeCount[opcode]
+        << ", \"cycles\": " << counters.opcodeCycles[opcode] << "}";
+    first = false;
+  }
+  out << "\n  ],\n";
+
+  out << "  \"regions\": [";
+  for (size_t i = 0; i < PerfCounters::kRegions; i++) {
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"region\": \"" << regionName(static_cast<Region>(i))
+        << "\", \"reads\": " << counters.reads[i]
+        << ", \"writes\": " << counters.writes[i] << "}";
+  }
+  out << "\n  ]\n";
+  out << "}\n";
+}
+
+void writeCountersCsv(std::ostream &out, const PerfCounters &counters) {
+  out << "category,name,count,cycles\n";
+  for (size_t opcode = 0; opcode < 256; opcode++) {
+    if (counters.opcodeCount[opcode] != 0) {
+      out << "opcode," << opcodeName(opcode) << ","
+          << counters.opcodeCount[opcode] << ","
+          << counters.opcodeCycles[opcode] << "\n";
+    }
+  }
+  for (size_t i = 0; i < PerfCounters::kRegions; i++) {
+    const char *name = regionName(static_cast<Region>(i));
+    out << "read," << name << "," << counters.reads[i] << ",\n";
+    out << "write," << name << "," << counters.writes[i] << ",\n";
+  }
+  out << "bank_switch,rom," << counters.bankSwitches << ",\n";
+  out << "halt,,," << counters.haltCycles << "\n";
+}
@@ -0,0 +1,309 @@
+/**
+ * @file ppu.cpp
+ * @brief Implementation of the PPU class for the Game Boy emulator.
+ */
+
+#include "../include/ppu.hpp"
+
+#include <algorithm>
+
+#include "../include/hash.hpp"
+#include "../include/save_state.hpp"
+
+namespace {
+
+// Maps a 2-bit color index through a DMG palette register to a shade
+uint8_t applyPalette(uint8_t palette, uint8_t color) {
+  return (palette >> (color * 2)) & 0x03;
+}
+
+// Looks up a color in CGB palette RAM
+uint16_t paletteColor(const uint8_t *paletteRam, uint8_t palette,
+                      uint8_t color) {
+  const uint8_t *entry = paletteRam + (palette * 4 + color) * 2;
+  return (entry[0] | (entry[1] << 8)) & 0x7FFF;
+}
+
+constexpr uint16_t kWhite = 0x7FFF;
+
+}  // namespace
+
+PPU::PPU(Memory &memory) : memory(memory) {}
+
+PPU &PPU::operator=(const PPU &other) {
+  mode = other.mode;
+  line = other.line;
+  windowLine = other.windowLine;
+  statLine = other.statLine;
+  framebuffer = other.framebuffer;
+  return *this;
+}
+
+uint32_t PPU::reset() {
+  mode = OamScan;
+  line = 0;
+  windowLine = 0;
+  statLine = false;
+  updateStat();
+  return kOamScanCycles;
+}
+
+uint32_t PPU::advanceMode() {
+  uint32_t duration = 0;
+  switch (mode) {
+    case OamScan:
+      mode = Transfer;
+      duration = kTransferCycles;
+      break;
+    case Transfer:
+      renderLine();
+      memory.io.hblank();
+      mode = HBlank;
+      duration = kHBlankCycles;
+      break;
+    case HBlank:
+      line++;
+      if (line == kVisibleLines) {
+        mode = VBlank;
+        memory.io.requestInterrupt(0x01);
+        duration = kLineCycles;
+      } else {
+        mode = OamScan;
+        duration = kOamScanCycles;
+      }
+      break;
+    case VBlank:
+      line++;
+      if (line == kTotalLines) {
+        line = 0;
+        windowLine = 0;
+        mode = OamScan;
+        duration = kOamScanCycles;
+      } else {
+        duration = kLineCycles;
+      }
+      break;
+  }
+  updateStat();
+  return duration;
+}
+
+void PPU::disable() {
+  mode = HBlank;
+  line = 0;
+  windowLine = 0;
+  statLine = false;
+  memory.io.reg(LY) = 0;
+  memory.io.reg(STAT) &= 0xF8;
+}
+
+uint64_t PPU::framebufferHash() const {
+  uint64_t hash = kFnvOffsetBasis;
+  for (uint16_t pixel : framebuffer) {
+    uint8_t bytes[2] = {static_cast<uint8_t>(pixel),
+                        static_cast<uint8_t>(pixel >> 8)};
+    hash = fnv1a(bytes, 2, hash);
+  }
+  return hash;
+}
+
+uint64_t PPU::stateHash() const {
+  uint32_t position =
+      mode | (line << 8) | (windowLine << 16) | (statLine << 24);
+  return fnv1aValue(position, framebufferHash());
+}
+
+void PPU::saveState(StateWriter &out) const {
+  out.write<uint8_t>(mode);
+  out.write(line);
+  out.write(windowLine);
+  out.write<uint8_t>(statLine);
+  for (uint16_t pixel : framebuffer) {
+    out.write(pixel);
+  }
+}
+
+bool PPU::loadState(StateReader &in) {
+  uint8_t savedMode = in.read<uint8_t>();
+  uint8_t savedLine = in.read<uint8_t>();
+  uint8_t savedWindowLine = in.read<uint8_t>();
+  statLine = in.read<uint8_t>();
+  for (uint16_t &pixel : framebuffer) {
+    pixel = in.read<uint16_t>();
+  }
+  // renderLine() writes the line's row, so the position must be reachable
+  if (savedMode > Transfer || savedLine >= kTotalLines ||
+      (savedMode == VBlank) != (savedLine >= kVisibleLines) ||
+      savedWindowLine > kVisibleLines) {
+    return false;
+  }
+  mode = static_cast<Mode>(savedMode);
+  line = savedLine;
+  windowLine = savedWindowLine;
+  return true;
+}
+
+/**
+ * @brief Writes LY and the STAT mode/coincidence bits, and requests a STAT
+ * interrupt on a rising edge of the combined STAT interrupt line.
+ */
+void PPU::updateStat() {
+  uint8_t stat = memory.io.reg(STAT);
+  bool coincidence = line == memory.io.reg(LYC);
+
+  stat = (stat & 0xF8) | (coincidence ? 0x04 : 0x00) | mode;
+  memory.io.reg(LY) = line;
+  memory.io.reg(STAT) = stat;
+
+  bool interrupt = (coincidence && (stat & 0x40)) ||
+                   (mode == HBlank && (stat & 0x08)) ||
+                   (mode == VBlank && (stat & 0x10)) ||
+                   (mode == OamScan && (stat & 0x20));
+  if (interrupt && !statLine) {
+    memory.io.requestInterrupt(0x02);
+  }
+  statLine = interrupt;
+}
+
+/**
+ * @brief Draws the current line's background, window and sprites.
+ *
+ * CGB tile attributes come from VRAM bank 1, which is all zero outside CGB
+ * mode, so the DMG path runs the same attribute code with no mode checks.
+ */
+void PPU::renderLine() {
+  uint16_t *pixels = &framebuffer[line * kScreenWidth];
+  uint8_t lcdc = memory.io.reg(LCDC);
+  bool cgb = memory.isCgb();
+  if (!(lcdc & 0x80)) {
+    std::fill_n(pixels, kScreenWidth, cgb ? kWhite : 0);
+    return;
+  }
+
+  // Raw background color indices and attributes, needed for sprite priority
+  uint8_t colors[kScreenWidth] = {};
+  uint8_t attributes[kScreenWidth] = {};
+  const uint8_t *tiles = memory.videoRam(0);
+  const uint8_t *tileAttributes = memory.videoRam(1);
+  bool unsignedTiles = lcdc & 0x10;
+
+  auto tilePixel = [&](uint16_t tileMap, uint8_t x, uint8_t y,
+                       uint8_t &attribute) {
+    uint16_t entry = tileMap + (y / 8) * 32 + x / 8;
+    uint8_t tile = tiles[entry];
+    attribute = tileAttributes[entry];
+    const uint8_t *bank = memory.videoRam((attribute >> 3) & 0x01);
+    uint16_t tileAddress =
+        unsignedTiles ? tile * 16 : 0x1000 + static_cast<int8_t>(tile) * 16;
+    uint8_t row = (y % 8) ^ ((attribute & 0x40) ? 7 : 0);
+    uint8_t bit = (7 - x % 8) ^ ((attribute & 0x20) ? 7 : 0);
+    const uint8_t *data = bank + tileAddress + row * 2;
+    return static_cast<uint8_t>(((data[0] >> bit) & 1) |
+                                (((data[1] >> bit) & 1) << 1));
+  };
+
+  // In CGB mode LCDC bit 0 only removes the background's priority
+  if (cgb || (lcdc & 0x01)) {
+    uint16_t tileMap = (lcdc & 0x08) ? 0x1C00 : 0x1800;
+    uint8_t y = line + memory.io.reg(SCY);
+    uint8_t scx = memory.io.reg(SCX);
+    for (uint32_t x = 0; x < kScreenWidth; x++) {
+      colors[x] =
+          tilePixel(tileMap, static_cast<uint8_t>(x + scx), y, attributes[x]);
+    }
+
+    int wx = memory.io.reg(WX) - 7;
+    if ((lcdc & 0x20) && line >= memory.io.reg(WY) && wx < 160) {
+      uint16_t windowMap = (lcdc & 0x40) ? 0x1C00 : 0x1800;
+      for (int x = std::max(wx, 0); x < 160; x++) {
+        colors[x] = tilePixel(windowMap, x - wx, windowLine, attributes[x]);
+      }
+      windowLine++;
+    }
+  }
+
+  if (cgb) {
+    const uint8_t *palettes = memory.io.paletteRam(false);
+    for (uint32_t x = 0; x < kScreenWidth; x++) {
+      pixels[x] = paletteColor(palettes, attributes[x] & 0x07, colors[x]);
+    }
+  } else {
+    uint8_t bgp = memory.io.reg(BGP);
+    for (uint32_t x = 0; x < kScreenWidth; x++) {
+      pixels[x] = applyPalette(bgp, colors[x]);
+    }
+  }
+  if (lcdc & 0x02) {
+    renderSprites(pixels, colors, attributes);
+  }
+}
+
+/**
+ * @brief Draws up to ten sprites on the current line over the background.
+ *
+ * On DMG sprites with a smaller X win, then the earlier OAM entry; on CGB
+ * only the OAM order counts. A sprite loses to background colors 1-3 if
+ * its own priority bit or (CGB) the tile's priority attribute is set,
+ * unless CGB LCDC bit 0 is clear.
+ */
+void PPU::renderSprites(uint16_t *pixels, const uint8_t *backgroundColors,
+                        const uint8_t *backgroundAttributes) {
+  uint8_t lcdc = memory.io.reg(LCDC);
+  bool cgb = memory.isCgb();
+  int height = (lcdc & 0x04) ? 16 : 8;
+  const uint8_t *oam = memory.objectAttributes();
+
+  uint8_t selected[10];
+  int count = 0;
+  for (int i = 0; i < 40 && count < 10; i++) {
+    int y = oam[i * 4] - 16;
+    if (line >= y && line < y + height) {
+      selected[count++] = i;
+    }
+  }
+  // Draw lowest priority first so higher priority sprites overwrite them
+  std::sort(selected, selected + count, [&](uint8_t a, uint8_t b) {
+    uint8_t xa = oam[a * 4 + 1];
+    uint8_t xb = oam[b * 4 + 1];
+    return xa != xb && !cgb ? xa > xb : a > b;
+  });
+
+  bool backgroundPriority = !cgb || (lcdc & 0x01);
+  const uint8_t *palettes = memory.io.paletteRam(true);
+  for (int i = 0; i < count; i++) {
+    const uint8_t *entry = oam + selected[i] * 4;
+    int y = entry[0] - 16;
+    int x = entry[1] - 8;
+    uint8_t tile = entry[2];
+    uint8_t flags = entry[3];
+    if (height == 16) {
+      tile &= 0xFE;
+    }
+
+    int row = line - y;
+    if (flags & 0x40) {
+      row = height - 1 - row;
+    }
+    const uint8_t *bank = memory.videoRam(cgb ? (flags >> 3) & 0x01 : 0);
+    const uint8_t *data = bank + tile * 16 + row * 2;
+    uint8_t palette = memory.io.reg((flags & 0x10) ? OBP1 : OBP0);
+
+    for (int column = 0; column < 8; column++) {
+      int screenX = x + column;
+      if (screenX < 0 || screenX >= static_cast<int>(kScreenWidth)) {
+        continue;
+      }
+      uint8_t bit = (flags & 0x20) ? column : 7 - column;
+      uint8_t color = ((data[0] >> bit) & 1) | (((data[1] >> bit) & 1) << 1);
+      if (color == 0) {
+        continue;
+      }
+      bool behind = (flags | backgroundAttributes[screenX]) & 0x80;
+      if (backgroundPriority && behind && backgroundColors[screenX] != 0) {
+        continue;
+      }
+      pixels[screenX] = cgb ? paletteColor(palettes, flags & 0x07, color)
+                            : applyPalette(palette, color);
+    }
+  }
+}
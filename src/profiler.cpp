@@ -0,0 +1,134 @@
+/**
+ * @file profiler.cpp
+ * @brief Implementation of the sampling profiler.
+ */
+
+#include "../include/profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ostream>
+
+#include "../include/gameboy.hpp"
+
+namespace {
+
+RomLocation unpack(uint32_t packed) {
+  return {static_cast<uint16_t>(packed >> 16),
+          static_cast<uint16_t>(packed & 0xFFFF)};
+}
+
+template <typename Key, typename Map>
+std::vector<std::pair<Key, uint64_t>> sortedByCount(const Map &counts) {
+  std::vector<std::pair<Key, uint64_t>> sorted(counts.begin(), counts.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+  return sorted;
+}
+
+}  // namespace
+
+size_t Profiler::StackHash::operator()(
+    const std::vector<uint32_t> &stack) const {
+  uint64_t hash = 0xcbf29ce484222325;  // FNV-1a over the frames
+  for (uint32_t frame : stack) {
+    hash = (hash ^ frame) * 0x100000001b3;
+  }
+  return static_cast<size_t>(hash);
+}
+
+Profiler::Profiler(GameBoy &gameboy, uint64_t interval)
+    : gameboy(gameboy), sampleInterval(std::max<uint64_t>(interval, 1)) {
+  gameboy.cpu.profiler = this;
+  gameboy.scheduler.schedule(Event::Profile,
+                             gameboy.cpu.cycles + sampleInterval);
+}
+
+Profiler::~Profiler() {
+  gameboy.cpu.profiler = nullptr;
+  gameboy.scheduler.cancel(Event::Profile);
+}
+
+void Profiler::sample() {
+  const CPU &cpu = gameboy.cpu;
+  unwind(cpu.SP);
+
+  if (sampledVersion != stackVersion) {
+    scratch.clear();
+    for (size_t i = 0; i < depth; i++) {
+      scratch.push_back(frames[i].function);
+    }
+    // Map nodes do not move, so the count can be kept
+    sampledCount = &stacks.try_emplace(scratch, 0).first->second;
+    sampledVersion = stackVersion;
+  }
+  ++*sampledCount;
+  pcs[locate(cpu.PC)]++;
+  uint16_t bank = gameboy.memory.romBank();
+  if (bank >= banks.size()) {
+    banks.resize(bank + 1);
+  }
+  banks[bank]++;
+  total++;
+}
+
+std::vector<std::pair<RomLocation, uint64_t>> Profiler::hotSpots() const {
+  std::vector<std::pair<RomLocation, uint64_t>> spots;
+  for (const auto &[pc, count] : sortedByCount<uint32_t>(pcs)) {
+    spots.emplace_back(unpack(pc), count);
+  }
+  return spots;
+}
+
+std::vector<std::pair<uint16_t, uint64_t>> Profiler::hotBanks() const {
+  std::vector<std::pair<uint16_t, uint64_t>> counts;
+  for (size_t bank = 0; bank < banks.size(); bank++) {
+    if (banks[bank] != 0) {
+      counts.emplace_back(static_cast<uint16_t>(bank), banks[bank]);
+    }
+  }
+  return sortedByCount<uint16_t>(counts);
+}
+
+void Profiler::writeCollapsed(std::ostream &out) const {
+  // Sorted, so that equal profiles give equal files
+  std::vector<std::pair<std::string, uint64_t>> lines;
+  for (const auto &[stack, count] : stacks) {
+    std::string line = "main";
+    for (uint32_t frame : stack) {
+      char name[16];
+      RomLocation location = unpack(frame);
+      std::snprintf(name, sizeof(name), ";%02X:%04X", location.bank,
+                    location.address);
+      line += name;
+    }
+    lines.emplace_back(std::move(line), count);
+  }
+  std::sort(lines.begin(), lines.end());
+  for (const auto &[line, count] : lines) {
+    out << line << " " << count << "\n";
+  }
+}
+
+void Profiler::merge(const Profiler &other) {
+  for (const auto &[stack, count] : other.stacks) {
+    stacks[stack] += count;
+  }
+  for (const auto &[pc, count] : other.pcs) {
+    pcs[pc] += count;
+  }
+  banks.resize(std::max(banks.size(), other.banks.size()));
+  for (size_t bank = 0; bank < other.banks.size(); bank++) {
+    banks[bank] += other.banks[bank];
+  }
+  total += other.total;
+}
+
+void Profiler::reset() {
+  stacks.clear();
+  pcs.clear();
+  banks.clear();
+  total = 0;
+  sampledVersion = ~uint64_t{0};  // The kept count is gone
+}
@@ -0,0 +1,96 @@
+/**
+ * @file sha1.cpp
+ * @brief Implementation of SHA-1 (FIPS 180-4).
+ */
+
+#include "../include/sha1.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// Processes one 64-byte block
+void compress(std::array<uint32_t, 5> &state, const uint8_t *block) {
+  uint32_t w[80];
+  for (int i = 0; i < 16; i++) {
+    w[i] = static_cast<uint32_t>(block[i * 4]) << 24 |
+           static_cast<uint32_t>(block[i * 4 + 1]) << 16 |
+           static_cast<uint32_t>(block[i * 4 + 2]) << 8 | block[i * 4 + 3];
+  }
+  for (int i = 16; i < 80; i++) {
+    w[i] = std::rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+  }
+
+  uint32_t a = state[0], b = state[1], c = state[2], d = state[3],
+           e = state[4];
+  for (int i = 0; i < 80; i++) {
+    uint32_t f, k;
+    if (i < 20) {
+      f = (b & c) | (~b & d);
+      k = 0x5A827999;
+    } else if (i < 40) {
+      f = b ^ c ^ d;
+      k = 0x6ED9EBA1;
+    } else if (i < 60) {
+      f = (b & c) | (b & d) | (c & d);
+      k = 0x8F1BBCDC;
+    } else {
+      f = b ^ c ^ d;
+      k = 0xCA62C1D6;
+    }
+    uint32_t temp = std::rotl(a, 5) + f + e + k + w[i];
+    e = d;
+    d = c;
+    c = std::rotl(b, 30);
+    b = a;
+    a = temp;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+}
+
+}  // namespace
+
+Sha1Digest sha1(const void *data, size_t size) {
+  std::array<uint32_t, 5> state = {0x67452301, 0xEFCDAB89, 0x98BADCFE,
+                                   0x10325476, 0xC3D2E1F0};
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  size_t full = size - size % 64;
+  for (size_t offset = 0; offset < full; offset += 64) {
+    compress(state, bytes + offset);
+  }
+
+  // The rest, a 1 bit, zeros and the length in bits, in one or two blocks
+  uint8_t tail[128] = {};
+  size_t rest = size - full;
+  std::copy(bytes + full, bytes + size, tail);
+  tail[rest] = 0x80;
+  size_t tailSize = rest < 56 ? 64 : 128;
+  uint64_t bits = static_cast<uint64_t>(size) * 8;
+  for (int i = 0; i < 8; i++) {
+    tail[tailSize - 1 - i] = static_cast<uint8_t>(bits >> (i * 8));
+  }
+  for (size_t offset = 0; offset < tailSize; offset += 64) {
+    compress(state, tail + offset);
+  }
+
+  Sha1Digest digest;
+  for (int i = 0; i < 20; i++) {
+    digest[i] = static_cast<uint8_t>(state[i / 4] >> (24 - (i % 4) * 8));
+  }
+  return digest;
+}
+
+std::string toHex(const Sha1Digest &digest) {
+  static constexpr char kDigits[] = "0123456789abcdef";
+  std::string hex;
+  for (uint8_t byte : digest) {
+    hex += kDigits[byte >> 4];
+    hex += kDigits[byte & 0x0F];
+  }
+  return hex;
+}
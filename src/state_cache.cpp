@@ -0,0 +1,211 @@
+/**
+ * @file state_cache.cpp
+ * @brief Implementation of the on-disk state cache.
+ */
+
+#include "../include/state_cache.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <tuple>
+#include <vector>
+
+#include "../include/hash.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char *kExtension = ".gbs";
+
+}  // namespace
+
+StateKey StateKey::start(const Sha1Digest &rom, uint64_t initialStateHash) {
+  return {rom, fnv1aValue(initialStateHash, kFnvOffsetBasis), 0};
+}
+
+void StateKey::advance(uint8_t buttons) {
+  inputs = fnv1a(&buttons, 1, inputs);
+  frame++;
+}
+
+std::string StateKey::fileName() const {
+  char suffix[48];
+  std::snprintf(suffix, sizeof(suffix), "-%016" PRIx64 "-%" PRIu32 "%s",
+                inputs, frame, kExtension);
+  return toHex(rom) + suffix;
+}
+
+bool StateCache::open(const std::string &directory, uint64_t capacity,
+                      std::string &error) {
+  std::error_code code;
+  fs::create_directories(directory, code);
+  if (code) {
+    error = directory + ": " + code.message();
+    return false;
+  }
+  this->directory = directory;
+  this->capacity = capacity;
+  entries.clear();
+  totalBytes = 0;
+
+  // Oldest first, so that use order follows modification time
+  std::vector<std::tuple<fs::file_time_type, std::string, uint64_t>> found;
+  for (const fs::directory_entry &entry :
+       fs::directory_iterator(directory, code)) {
+    if (entry.is_regular_file(code) &&
+        entry.path().extension() == kExtension) {
+      found.emplace_back(entry.last_write_time(code),
+                         entry.path().filename().string(),
+                         entry.file_size(code));
+    }
+  }
+  if (code) {
+    error = directory + ": " + code.message();
+    return false;
+  }
+  std::sort(found.begin(), found.end());
+  for (const auto &[time, name, bytes] : found) {
+    entries[name] = {bytes, ++useCounter};
+    totalBytes += bytes;
+  }
+  evict();
+  return true;
+}
+
+/**
+ * @brief Walks the run's keys forwards, then tries them backwards.
+ */
+uint32_t StateCache::restore(GameBoy &gameboy, const StateKey &start,
+                             std::span<const uint8_t> inputs) {
+  stats.lookups++;
+  std::vector<StateKey> keys;
+  keys.reserve(inputs.size());
+  StateKey key = start;
+  for (uint8_t buttons : inputs) {
+    key.advance(buttons);
+    keys.push_back(key);
+  }
+
+  std::vector<uint8_t> backup;  // For undoing a state that half loads
+  for (size_t i = keys.size(); i-- > 0;) {
+    std::string name = keys[i].fileName();
+    if (!entries.contains(name)) {
+      continue;
+    }
+    if (backup.empty()) {
+      backup = gameboy.saveState();
+    }
+    auto begin = std::chrono::steady_clock::now();
+    if (load(gameboy, name)) {
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - begin;
+      stats.hits++;
+      stats.framesRestored += i + 1;
+      stats.restoreSeconds += elapsed.count();
+      touch(name);
+      return static_cast<uint32_t>(i + 1);
+    }
+    remove(name);
+    std::string error;
+    gameboy.loadState(backup, error);
+  }
+  return 0;
+}
+
+bool StateCache::store(const GameBoy &gameboy, const StateKey &key) {
+  std::string name = key.fileName();
+  if (entries.contains(name)) {
+    touch(name);
+    return true;
+  }
+  std::vector<uint8_t> data = gameboy.saveState();
+  fs::path path = fs::path(directory) / name;
+  // Unique per process, then renamed into place whole
+  fs::path temporary = path;
+  temporary += "." + std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    if (!file) {
+      return false;
+    }
+  }
+  std::error_code code;
+  fs::rename(temporary, path, code);
+  if (code) {
+    fs::remove(temporary, code);
+    return false;
+  }
+
+  entries[name] = {data.size(), ++useCounter};
+  totalBytes += data.size();
+  stats.stores++;
+  evict();
+  return true;
+}
+
+/**
+ * @brief Loads a state straight from a mapping of its file.
+ */
+bool StateCache::load(GameBoy &gameboy, const std::string &name) {
+  std::string path = (fs::path(directory) / name).string();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info;
+  void *mapping = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  std::string error;
+  bool loaded = gameboy.loadState(
+      {static_cast<const uint8_t *>(mapping),
+       static_cast<size_t>(info.st_size)},
+      error);
+  munmap(mapping, info.st_size);
+  return loaded;
+}
+
+void StateCache::touch(const std::string &name) {
+  entries[name].lastUse = ++useCounter;
+  std::error_code code;
+  fs::last_write_time(fs::path(directory) / name,
+                      fs::file_time_type::clock::now(), code);
+}
+
+void StateCache::remove(const std::string &name) {
+  auto entry = entries.find(name);
+  if (entry == entries.end()) {
+    return;
+  }
+  std::error_code code;
+  fs::remove(fs::path(directory) / name, code);
+  totalBytes -= entry->second.bytes;
+  entries.erase(entry);
+}
+
+void StateCache::evict() {
+  while (totalBytes > capacity && !entries.empty()) {
+    auto oldest = std::min_element(
+        entries.begin(), entries.end(), [](const auto &a, const auto &b) {
+          return a.second.lastUse < b.second.lastUse;
+        });
+    remove(oldest->first);
+    stats.evictions++;
+  }
+}
@@ -0,0 +1,142 @@
+/**
+ * @file vector_emulator.cpp
+ * @brief Implementation of the lockstep VectorEmulator.
+ */
+
+#include "../include/vector_emulator.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+VectorEmulator::VectorEmulator(const std::vector<uint8_t> &rom, size_t count)
+    : keys(count), targets(count), order(count) {
+  Cartridge::Image image = Cartridge::prepare(rom);
+  machines.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    machines.push_back(std::make_unique<GameBoy>(std::make_shared<Arena>()));
+    machines.back()->loadRom(image);
+  }
+}
+
+void VectorEmulator::step(std::span<const uint8_t> actions,
+                          std::span<Observation> observations) {
+  for (uint32_t i = 0; i < machines.size(); i++) {
+    GameBoy &gameboy = *machines[i];
+    gameboy.memory.setButtons(actions[i]);
+    targets[i] = gameboy.cpu.cycles +
+                 (PPU::kFrameCycles << gameboy.memory.io.speedShift());
+    gameboy.stopAt = targets[i];
+    keys[i] = groupKey(i);
+  }
+
+  // Machines at the same ROM byte start out in shared groups, up to
+  // kGroupWidth wide
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+  for (size_t start = 0, end; start < order.size(); start = end) {
+    end = start + 1;
+    while (end < order.size() && end - start < kGroupWidth &&
+           keys[order[end]] == keys[order[start]]) {
+      end++;
+    }
+    pending.emplace_back(order.begin() + start, order.begin() + end);
+  }
+  while (!pending.empty()) {
+    std::vector<uint32_t> group = std::move(pending.back());
+    pending.pop_back();
+    runGroup(group);
+  }
+
+  for (uint32_t i = 0; i < machines.size(); i++) {
+    GameBoy &gameboy = *machines[i];
+    gameboy.stopAt = Scheduler::kNever;
+    observations[i].framebuffer = gameboy.ppu.getFramebuffer().data();
+    observations[i].cycles = gameboy.cpu.cycles;
+  }
+}
+
+/**
+ * @brief Returns the value machines are grouped by: where their next opcode
+ * lives in the shared ROM image, or null when it is not in ROM.
+ */
+const uint8_t *VectorEmulator::groupKey(uint32_t index) const {
+  const GameBoy &gameboy = *machines[index];
+  return gameboy.memory.romAt(gameboy.cpu.PC);
+}
+
+/**
+ * @brief Steps a group in lockstep until it finishes the frame or splits.
+ *
+ * When a step leaves the members at different keys the group is split by
+ * key: new groups are queued and single machines run on their own.
+ */
+void VectorEmulator::runGroup(std::vector<uint32_t> &group) {
+  while (group.size() > 1) {
+    const uint8_t *code = groupKey(group[0]);
+    if (!code) {
+      break;  // Code outside ROM can differ between machines
+    }
+    uint8_t opcode = *code;
+
+    // Step every member, dropping those that finished their frame
+    size_t kept = 0;
+    bool diverged = false;
+    const uint8_t *next = nullptr;
+    for (uint32_t index : group) {
+      GameBoy &gameboy = *machines[index];
+      if (gameboy.cpu.cycles >= targets[index]) {
+        continue;
+      }
+      if (gameboy.cpu.beginInstruction()) {
+        if (gameboy.memory.isBusLocked()) {
+          gameboy.cpu.execute(gameboy.cpu.fetchByte());
+        } else {
+          gameboy.memory.counters.countRead(gameboy.cpu.PC++);
+          gameboy.cpu.execute(opcode);
+          sharedDecodes++;
+        }
+      }
+      gameboy.finishInstruction();
+
+      keys[index] = groupKey(index);
+      next = kept == 0 ? keys[index] : next;
+      diverged |= keys[index] != next;
+      group[kept++] = index;
+    }
+    group.resize(kept);
+    if (!diverged) {
+      continue;
+    }
+
+    std::stable_sort(group.begin(), group.end(), [&](uint32_t a, uint32_t b) {
+      return keys[a] < keys[b];
+    });
+    for (size_t start = 0, end; start < group.size(); start = end) {
+      end = start + 1;
+      while (end < group.size() && keys[group[end]] == keys[group[start]]) {
+        end++;
+      }
+      if (end - start > 1) {
+        pending.emplace_back(group.begin() + start, group.begin() + end);
+      } else {
+        runScalar(group[start]);
+      }
+    }
+    return;
+  }
+  for (uint32_t index : group) {
+    runScalar(index);
+  }
+}
+
+/**
+ * @brief Finishes a machine's frame with the ordinary scalar loop.
+ */
+void VectorEmulator::runScalar(uint32_t index) {
+  GameBoy &gameboy = *machines[index];
+  if (gameboy.cpu.cycles < targets[index]) {
+    gameboy.runCycles(targets[index] - gameboy.cpu.cycles);
+    scalarFallbacks++;
+  }
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <vector>
+
+#include "../include/arena.hpp"
+#include "../include/gameboy.hpp"
+
+// ✅ **Test: Freed blocks are reused for the next allocation of that size**
+TEST(ArenaTest, ReusesFreedBlocks) {
+  Arena arena;
+  void *first = arena.allocate(4096);
+  arena.deallocate(first, 4096);
+  void *second = arena.allocate(4096);
+
+  EXPECT_EQ(first, second);
+  EXPECT_NE(arena.allocate(4096), second);
+}
+
+// ✅ **Test: The arena tracks the bytes it has handed out**
+TEST(ArenaTest, TracksBytesInUse) {
+  Arena arena;
+  void *block = arena.allocate(100);
+  void *other = arena.allocate(28);
+  EXPECT_EQ(arena.bytesInUse(), 128u);
+
+  arena.deallocate(block, 100);
+  EXPECT_EQ(arena.bytesInUse(), 28u);
+  arena.deallocate(other, 28);
+  EXPECT_EQ(arena.bytesInUse(), 0u);
+}
+
+// ✅ **Test: Standard containers allocate from it through std::pmr**
+TEST(ArenaTest, BacksPmrContainers) {
+  Arena arena;
+  std::pmr::vector<uint32_t> values(&arena);
+  for (uint32_t i = 0; i < 1000; i++) {
+    values.push_back(i);
+  }
+
+  EXPECT_EQ(values[999], 999u);
+  EXPECT_GE(arena.bytesInUse(), 1000 * sizeof(uint32_t));
+}
+
+// ✅ **Test: A machine's written pages come from its arena**
+TEST(ArenaTest, HoldsMachinePages) {
+  auto arena = std::make_shared<Arena>();
+  GameBoy gameboy(arena);
+  EXPECT_EQ(arena->bytesInUse(), 0u);
+
+  gameboy.memory.writeByte(0xC000, 0x12);
+  gameboy.memory.writeByte(0x8000, 0x34);
+  EXPECT_GE(arena->bytesInUse(), 0x1000u + 0x2000u);
+  EXPECT_EQ(gameboy.memory.readByte(0xC000), 0x12);
+}
+
+// ✅ **Test: Pages shared with a fork outlive the machine and arena that
+// allocated them**
+TEST(ArenaTest, SharedPagesKeepTheirArena) {
+  auto parent = std::make_unique<GameBoy>(std::make_shared<Arena>());
+  parent->memory.writeByte(0xC000, 0x12);
+  std::unique_ptr<GameBoy> fork = parent->fork();
+  ASSERT_NE(fork->getArena(), parent->getArena());
+
+  std::weak_ptr<Arena> arena = parent->getArena();
+  parent.reset();
+  EXPECT_FALSE(arena.expired());
+  EXPECT_EQ(fork->memory.readByte(0xC000), 0x12);
+
+  fork->memory.writeByte(0xC000, 0x34);  // Sole holder now: no copy
+  EXPECT_EQ(fork->memory.readByte(0xC000), 0x34);
+  fork.reset();
+  EXPECT_TRUE(arena.expired());
+}
@@ -0,0 +1,101 @@
+"""Tests for the Python bindings; run by ctest when they are built."""
+
+import threading
+import unittest
+
+import numpy as np
+
+import gameboy
+
+
+def logging_rom():
+    """A ROM that selects the action buttons and logs P1 to C000-C0FF."""
+    rom = bytearray(0x8000)
+    program = bytes([
+        0x3E, 0x10,        # 0100 LD A,0x10
+        0xE0, 0x00,        # 0102 LDH (P1),A
+        0x21, 0x00, 0xC0,  # 0104 LD HL,0xC000
+        0xF0, 0x00,        # 0107 LDH A,(P1)
+        0x77,              # 0109 LD (HL),A
+        0x2C,              # 010A INC L
+        0xC3, 0x07, 0x01,  # 010B JP 0x0107
+    ])
+    rom[0x100:0x100 + len(program)] = program
+    return bytes(rom)
+
+
+class BindingsTest(unittest.TestCase):
+    def test_step_presses_buttons(self):
+        machine = gameboy.GameBoy(logging_rom())
+        ram = machine.memory.wram(0)
+        machine.step(1, gameboy.BUTTON_A)
+        self.assertEqual(ram[0] & 0x0F, 0x0E)
+        machine.step(2, [0, gameboy.BUTTON_B])
+        self.assertEqual(ram[0] & 0x0F, 0x0D)
+        machine.step(1, np.zeros(1, dtype=np.uint8))
+        self.assertEqual(ram[0] & 0x0F, 0x0F)
+        with self.assertRaises(ValueError):
+            machine.step(3, [0, 0])
+
+    def test_views_share_memory(self):
+        machine = gameboy.GameBoy(logging_rom())
+        ram = machine.memory.wram(0)
+        ram[0x800] = 0x5A
+        self.assertEqual(machine.memory.read(0xC800), 0x5A)
+        self.assertTrue(np.shares_memory(ram, machine.memory.wram(0)))
+
+        screen = machine.framebuffer
+        self.assertEqual(screen.shape, (144, 160))
+        self.assertEqual(screen.dtype, np.uint16)
+        self.assertFalse(screen.flags.writeable)
+        self.assertTrue(np.shares_memory(screen, machine.framebuffer))
+        del machine
+        self.assertEqual(ram[0x800], 0x5A)  # The view keeps it alive
+
+    def test_save_and_load(self):
+        machine = gameboy.GameBoy(logging_rom())
+        machine.step(5, gameboy.BUTTON_A)
+        state = machine.save_state()
+        pc = machine.cpu.PC
+        hash_before = machine.state_hash()
+        machine.step(5, 0)
+        machine.load_state(state)
+        self.assertEqual(machine.state_hash(), hash_before)
+        self.assertEqual(machine.cpu.PC, pc)
+        with self.assertRaises(ValueError):
+            machine.load_state(state[:-1])
+        self.assertEqual(machine.state_hash(), hash_before)
+
+    def test_views_see_loaded_states(self):
+        machine = gameboy.GameBoy(logging_rom())
+        ram = machine.memory.wram(0)
+        state = machine.save_state()  # Work RAM all zeros
+        machine.step(1, gameboy.BUTTON_A)
+        self.assertNotEqual(ram[0], 0)
+        machine.load_state(state)
+        self.assertEqual(ram[0], 0)
+        ram[0x800] = 0x5A
+        self.assertEqual(machine.memory.read(0xC800), 0x5A)
+        with self.assertRaises(ValueError):
+            machine.load_state(state[:-1])
+        self.assertEqual(machine.memory.read(0xC800), 0x5A)
+        self.assertTrue(np.shares_memory(ram, machine.memory.wram(0)))
+
+    def test_threads_step_in_parallel(self):
+        actions = np.arange(30, dtype=np.uint8) % 4
+        expected = gameboy.GameBoy(logging_rom())
+        expected.step(len(actions), actions)
+
+        machines = [gameboy.GameBoy(logging_rom()) for _ in range(4)]
+        threads = [threading.Thread(target=m.step, args=(len(actions), actions))
+                   for m in machines]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        for machine in machines:
+            self.assertEqual(machine.state_hash(), expected.state_hash())
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../include/capture.hpp"
+#include "../include/lz.hpp"
+
+namespace {
+
+constexpr size_t kPixels = PPU::kScreenWidth * PPU::kScreenHeight;
+
+// A frame of shades that scrolls one pixel a frame, with a box that moves
+std::vector<uint16_t> frame(uint32_t number, uint16_t mask) {
+  std::vector<uint16_t> pixels(kPixels);
+  for (size_t i = 0; i < kPixels; i++) {
+    size_t x = i % PPU::kScreenWidth, y = i / PPU::kScreenWidth;
+    pixels[i] = static_cast<uint16_t>(((x + number) / 8 + y / 8) * 0x1234) &
+                mask;
+    if (x - number % 100 < 16 && y < 16) {
+      pixels[i] = mask;
+    }
+  }
+  return pixels;
+}
+
+}  // namespace
+
+// ✅ **Test: LZ blocks round-trip, and repetitive data shrinks**
+TEST(CaptureTest, LzRoundTrip) {
+  std::vector<std::vector<uint8_t>> inputs = {{}, {7}, {1, 2, 3, 4, 5}};
+  inputs.emplace_back(100000, 0);
+  std::vector<uint8_t> mixed;
+  for (uint32_t i = 0; i < 70000; i++) {
+    mixed.push_back(static_cast<uint8_t>(i % 7 == 0 ? i * 2654435761u >> 24
+                                                    : i / 300));
+  }
+  inputs.push_back(mixed);
+
+  std::vector<uint8_t> block, output;
+  for (const std::vector<uint8_t> &input : inputs) {
+    lzCompress(input, block);
+    ASSERT_TRUE(lzDecompress(block, input.size(), output));
+    EXPECT_EQ(output, input);
+  }
+  lzCompress(inputs[3], block);
+  EXPECT_LT(block.size(), 500u);
+}
+
+// ✅ **Test: Damaged LZ blocks are rejected, not overrun**
+TEST(CaptureTest, LzRejectsDamagedBlocks) {
+  std::vector<uint8_t> input(1000, 0x5A), block, output;
+  lzCompress(input, block);
+  EXPECT_FALSE(lzDecompress(block, input.size() - 1, output));
+  EXPECT_FALSE(lzDecompress(block, input.size() + 1, output));
+  EXPECT_FALSE(lzDecompress({block.data(), block.size() / 2}, input.size(),
+                            output));
+  // A match reaching back before the start
+  const uint8_t farMatch[] = {0x10, 0xAA, 0x05, 0x00};
+  EXPECT_FALSE(lzDecompress(farMatch, 5, output));
+}
+
+// ✅ **Test: Frames and audio read back exactly, in order**
+TEST(CaptureTest, RoundTrip) {
+  std::string path = ::testing::TempDir() + "capture_test.gbv";
+  for (bool cgb : {false, true}) {
+    uint16_t mask = cgb ? 0x7FFF : 0x0003;
+    CaptureFormat format = CaptureFormat::forScreen(cgb);
+    format.sampleRate = 48000;
+    uint32_t frames = CaptureWriter::kKeyInterval + 10;
+    std::vector<int16_t> tone;
+    for (int i = 0; i < 1600; i++) {
+      tone.push_back(static_cast<int16_t>(i * 41 - 32000));
+    }
+
+    CaptureWriter writer;
+    std::string error;
+    ASSERT_TRUE(writer.open(path, format, error)) << error;
+    for (uint32_t i = 0; i < frames; i++) {
+      writer.pushFrame(frame(i, mask));
+      writer.pushAudio(tone);
+    }
+    ASSERT_TRUE(writer.close(error)) << error;
+    const CaptureStats &stats = writer.getStats();
+    EXPECT_EQ(stats.frames, frames);
+    EXPECT_EQ(stats.keyFrames, 2u);
+    EXPECT_EQ(stats.audioSamples, frames * tone.size());
+    EXPECT_LT(stats.compressedBytes * 4, stats.rawBytes);
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.open(path, error)) << error;
+    EXPECT_EQ(reader.getFormat().bytesPerPixel, cgb ? 2 : 1);
+    EXPECT_EQ(reader.getFormat().sampleRate, 48000u);
+    CaptureReader::Record record;
+    for (uint32_t i = 0; i < frames; i++) {
+      ASSERT_TRUE(reader.next(record, error)) << error;
+      ASSERT_EQ(record, CaptureReader::Record::Frame);
+      std::vector<uint16_t> expected = frame(i, mask);
+      ASSERT_TRUE(std::equal(expected.begin(), expected.end(),
+                             reader.frame().begin(), reader.frame().end()))
+          << "frame " << i;
+      ASSERT_TRUE(reader.next(record, error)) << error;
+      ASSERT_EQ(record, CaptureReader::Record::Audio);
+      EXPECT_TRUE(std::equal(tone.begin(), tone.end(),
+                             reader.audio().begin(), reader.audio().end()));
+    }
+    ASSERT_TRUE(reader.next(record, error)) << error;
+    EXPECT_EQ(record, CaptureReader::Record::End);
+  }
+}
+
+// ✅ **Test: A cut-off capture is reported as truncated**
+TEST(CaptureTest, DetectsTruncation) {
+  std::string path = ::testing::TempDir() + "capture_truncated.gbv";
+  {
+    CaptureWriter writer;
+    std::string error;
+    ASSERT_TRUE(writer.open(path, CaptureFormat::forScreen(false), error));
+    writer.pushFrame(frame(0, 3));
+  }
+  std::ifstream in(path, std::ios::binary);
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream(path, std::ios::binary)
+      .write(reinterpret_cast<const char *>(data.data()), data.size() - 1);
+
+  CaptureReader reader;
+  std::string error;
+  ASSERT_TRUE(reader.open(path, error)) << error;
+  CaptureReader::Record record;
+  EXPECT_FALSE(reader.next(record, error));
+  EXPECT_EQ(error, "truncated capture");
+
+  std::ofstream(path, std::ios::binary) << "GBMV";
+  EXPECT_FALSE(reader.open(path, error));
+  EXPECT_EQ(error, "not a capture");
+}
+
+// ✅ **Test: A WAV file has the RIFF header and little-endian samples**
+TEST(CaptureTest, EncodesWav) {
+  std::vector<int16_t> samples = {0x0102, -2};
+  std::vector<uint8_t> wav = encodeWav(samples, 44100, 2);
+  ASSERT_EQ(wav.size(), 44u + 4);
+  EXPECT_EQ(std::string(wav.begin(), wav.begin() + 4), "RIFF");
+  EXPECT_EQ(std::string(wav.begin() + 8, wav.begin() + 16), "WAVEfmt ");
+  EXPECT_EQ(wav[22], 2);                        // Channels
+  EXPECT_EQ(wav[24] | wav[25] << 8, 44100);     // Sample rate
+  EXPECT_EQ(std::string(wav.begin() + 36, wav.begin() + 40), "data");
+  EXPECT_EQ(wav[40], 4);                        // Data size
+  EXPECT_EQ(wav[44], 0x02);
+  EXPECT_EQ(wav[45], 0x01);
+  EXPECT_EQ(wav[46], 0xFE);
+  EXPECT_EQ(wav[47], 0xFF);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include "../include/cartridge.hpp"
+#include "../include/memory.hpp"
+
+// ✅ Test Fixture for cartridges on the memory bus
+class CartridgeTest : public ::testing::Test {
+ protected:
+  Memory memory;
+
+  // Builds a ROM whose banks start with their own bank number
+  static std::vector<uint8_t> makeRom(uint8_t type, size_t banks,
+                                      uint8_t ramSize = 0) {
+    std::vector<uint8_t> rom(banks * Cartridge::kRomBankSize, 0);
+    for (size_t bank = 0; bank < banks; bank++) {
+      rom[bank * Cartridge::kRomBankSize] = static_cast<uint8_t>(bank);
+      rom[bank * Cartridge::kRomBankSize + 1] = static_cast<uint8_t>(bank >> 8);
+    }
+    rom[0x0147] = type;
+    rom[0x0149] = ramSize;
+    return rom;
+  }
+};
+
+// ✅ **Test: Without a cartridge the ROM area accepts writes**
+TEST_F(CartridgeTest, EmptySlotIsWritable) {
+  memory.writeByte(0x0150, 0x12);
+  memory.writeByte(0x4000, 0x34);
+
+  EXPECT_EQ(memory.readByte(0x0150), 0x12);
+  EXPECT_EQ(memory.readByte(0x4000), 0x34);
+}
+
+// ✅ **Test: A ROM-only cartridge ignores writes**
+TEST_F(CartridgeTest, RomOnlyIsReadOnly) {
+  memory.loadRom(makeRom(0x00, 2));
+  memory.writeByte(0x4000, 0x34);
+
+  EXPECT_EQ(memory.readByte(0x4000), 1);
+}
+
+// ✅ **Test: MBC1 switches ROM banks, with bank 0 selecting bank 1**
+TEST_F(CartridgeTest, Mbc1RomBanks) {
+  memory.loadRom(makeRom(0x01, 64));
+  memory.writeByte(0x2000, 0x05);
+  EXPECT_EQ(memory.readByte(0x4000), 5);
+
+  memory.writeByte(0x2000, 0x00);
+  EXPECT_EQ(memory.readByte(0x4000), 1);
+
+  memory.writeByte(0x4000, 0x01);  // Upper bits
+  memory.writeByte(0x2000, 0x02);
+  EXPECT_EQ(memory.readByte(0x4000), 0x22);
+  EXPECT_EQ(memory.readByte(0x0000), 0);
+}
+
+// ✅ **Test: MBC5 uses a 9-bit ROM bank number and allows bank 0**
+TEST_F(CartridgeTest, Mbc5RomBanks) {
+  memory.loadRom(makeRom(0x19, 512));
+  memory.writeByte(0x2000, 0x34);
+  memory.writeByte(0x3000, 0x01);
+  EXPECT_EQ(memory.readByte(0x4000), 0x34);
+  EXPECT_EQ(memory.readByte(0x4001), 0x01);
+
+  memory.writeByte(0x3000, 0x00);
+  memory.writeByte(0x2000, 0x00);
+  EXPECT_EQ(memory.readByte(0x4000), 0);
+}
+
+// ✅ **Test: Cartridge RAM must be enabled and is banked**
+TEST_F(CartridgeTest, RamBanks) {
+  memory.loadRom(makeRom(0x1B, 4, 0x03));  // MBC5, 32 KB RAM
+  memory.writeByte(0xA000, 0x11);
+  EXPECT_EQ(memory.readByte(0xA000), 0xFF);
+
+  memory.writeByte(0x0000, 0x0A);
+  memory.writeByte(0xA000, 0x11);
+  memory.writeByte(0x4000, 0x02);
+  memory.writeByte(0xA000, 0x22);
+  EXPECT_EQ(memory.readByte(0xA000), 0x22);
+
+  memory.writeByte(0x4000, 0x00);
+  EXPECT_EQ(memory.readByte(0xA000), 0x11);
+}
+
+// ✅ **Test: The header's CGB flag selects CGB mode**
+TEST_F(CartridgeTest, CgbFlag) {
+  std::vector<uint8_t> rom = makeRom(0x00, 2);
+  memory.loadRom(rom);
+  EXPECT_FALSE(memory.isCgb());
+
+  rom[0x0143] = 0x80;
+  memory.loadRom(rom);
+  EXPECT_TRUE(memory.isCgb());
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "../include/code_index.hpp"
+
+// ✅ Test Fixture with a small MBC1 ROM of four banks
+class CodeIndexTest : public ::testing::Test {
+ protected:
+  std::vector<uint8_t> rom = std::vector<uint8_t>(0x10000, 0x00);
+
+  void put(size_t offset, std::vector<uint8_t> bytes) {
+    std::copy(bytes.begin(), bytes.end(), rom.begin() + offset);
+  }
+
+  void SetUp() override {
+    rom[0x0147] = 0x01;  // MBC1
+    for (size_t vector = 0x40; vector <= 0x60; vector += 8) {
+      rom[vector] = 0xD9;  // RETI
+    }
+    put(0x0048, {0xCD, 0x00, 0x40, 0xD9});  // CALL $4000 with any bank
+    put(0x0100, {0xC3, 0x50, 0x01});        // JP $0150
+    put(0x0150, {
+                    0x3E, 0x02,        // 0150 LD A,2
+                    0xEA, 0x00, 0x20,  // 0152 LD ($2000),A
+                    0xCD, 0x00, 0x40,  // 0155 CALL $4000
+                    0x28, 0x01,        // 0158 JR Z,$015B
+                    0x76,              // 015A HALT
+                    0xE9,              // 015B JP HL
+                });
+    put(0x8000, {0xCB, 0x7F, 0xC9});  // 02:4000 BIT 7,A; RET
+  }
+
+  static const BasicBlock *block(const CodeIndex &index, uint16_t bank,
+                                 uint16_t address) {
+    const BasicBlock *found = index.findBlock({bank, address});
+    return found && found->start == RomLocation{bank, address} ? found
+                                                               : nullptr;
+  }
+};
+
+// ✅ **Test: Blocks split at branches, calls and branch targets**
+TEST_F(CodeIndexTest, FindsBasicBlocks) {
+  CodeIndex index = buildCodeIndex(rom);
+  EXPECT_EQ(index.blocks.size(), 12u);
+
+  const BasicBlock *entry = block(index, 0, 0x0150);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->instructions, 3);
+  EXPECT_EQ(entry->size, 8);
+  EXPECT_EQ(entry->exit, Flow::Call);
+  EXPECT_EQ(entry->successors,
+            (std::vector<RomLocation>{{2, 0x4000}, {0, 0x0158}}));
+
+  const BasicBlock *branch = block(index, 0, 0x0158);
+  ASSERT_NE(branch, nullptr);
+  EXPECT_EQ(branch->successors,
+            (std::vector<RomLocation>{{0, 0x015B}, {0, 0x015A}}));
+  // HALT falls into the JP HL block, which is a branch target
+  ASSERT_NE(block(index, 0, 0x015A), nullptr);
+  EXPECT_EQ(block(index, 0, 0x015A)->successors,
+            (std::vector<RomLocation>{{0, 0x015B}}));
+
+  const BasicBlock *banked = block(index, 2, 0x4000);
+  ASSERT_NE(banked, nullptr);
+  EXPECT_EQ(banked->instructions, 2);
+  EXPECT_EQ(banked->exit, Flow::Return);
+}
+
+// ✅ **Test: Bank switches before a call are followed**
+TEST_F(CodeIndexTest, FollowsBankSwitches) {
+  CodeIndex index = buildCodeIndex(rom);
+  ASSERT_EQ(index.bankedCalls.size(), 1u);
+  EXPECT_EQ(index.bankedCalls[0].site, (RomLocation{0, 0x0155}));
+  EXPECT_EQ(index.bankedCalls[0].target, (RomLocation{2, 0x4000}));
+  EXPECT_EQ(index.branchTargets,
+            (std::vector<RomLocation>{{0, 0x0150}, {0, 0x015B}, {2, 0x4000}}));
+  // The interrupt handler's bank is unknown, as is JP HL's target
+  EXPECT_EQ(index.unresolved,
+            (std::vector<RomLocation>{{0, 0x0048}, {0, 0x015B}}));
+}
+
+// ✅ **Test: Locations map to the block containing them**
+TEST_F(CodeIndexTest, LooksUpLocations) {
+  CodeIndex index = buildCodeIndex(rom);
+  const BasicBlock *found = index.findBlock({0, 0x0153});
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->start, (RomLocation{0, 0x0150}));
+  EXPECT_EQ(index.findBlock({1, 0x4000}), nullptr);
+  EXPECT_EQ(index.findBlock({0, 0x0200}), nullptr);
+  EXPECT_EQ(romOffset({2, 0x4001}), 0x8001u);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/conformance.hpp"
+
+namespace {
+
+constexpr uint64_t kBudget = 10 * PPU::kFrameCycles;
+
+std::vector<uint8_t> makeRom(std::initializer_list<uint8_t> code) {
+  std::vector<uint8_t> rom(0x8000, 0x00);
+  std::copy(code.begin(), code.end(), rom.begin() + 0x0100);
+  return rom;
+}
+
+// Prints `text` over the serial port, as Blargg's tests do
+std::vector<uint8_t> serialRom(const std::string &text) {
+  std::vector<uint8_t> rom = makeRom({
+      0x21, 0x00, 0x02,  // 0100 LD HL,0x0200
+      0x7E,              // 0103 LD A,(HL)
+      0x23,              // 0104 INC HL
+      0xB7,              // 0105 OR A
+      0x28, 0x0F,        // 0106 JR Z,0x0117
+      0xE0, 0x01,        // 0108 LDH (SB),A
+      0x3E, 0x81,        // 010A LD A,0x81
+      0xE0, 0x02,        // 010C LDH (SC),A
+      0xF0, 0x02,        // 010E LDH A,(SC)
+      0xE6, 0x80,        // 0110 AND 0x80
+      0x20, 0xFA,        // 0112 JR NZ,0x010E
+      0xC3, 0x03, 0x01,  // 0114 JP 0x0103
+      0xC3, 0x17, 0x01,  // 0117 JP 0x0117
+  });
+  std::copy(text.begin(), text.end(), rom.begin() + 0x0200);
+  return rom;
+}
+
+// Sets B, C, D, E, H and L and stops on LD B,B, as Mooneye's tests do
+std::vector<uint8_t> registerRom(uint8_t b, uint8_t c, uint8_t d, uint8_t e,
+                                 uint8_t h, uint8_t l) {
+  return makeRom({0x06, b, 0x0E, c, 0x16, d, 0x1E, e, 0x26, h, 0x2E, l,
+                  0x40,                // 010C LD B,B
+                  0xC3, 0x0D, 0x01});  // 010D JP 0x010D
+}
+
+}  // namespace
+
+// ✅ **Test: Blargg results printed over serial are recognized**
+TEST(ConformanceTest, BlarggSerial) {
+  ConformanceResult pass = runTestRom(serialRom("01-special\n\nPassed\n"),
+                                      kBudget);
+  EXPECT_EQ(pass.verdict, Verdict::Pass);
+  EXPECT_EQ(pass.output, "01-special\n\nPassed\n");
+
+  ConformanceResult fail = runTestRom(serialRom("Failed #3\n"), kBudget);
+  EXPECT_EQ(fail.verdict, Verdict::Fail);
+  EXPECT_LT(fail.cycles, kBudget);
+}
+
+// ✅ **Test: Blargg results left in cartridge RAM are recognized**
+TEST(ConformanceTest, BlarggMemory) {
+  std::vector<uint8_t> rom = makeRom({
+      0x3E, 0x0A, 0xEA, 0x00, 0x00,  // Enable cartridge RAM
+      0x3E, 0xDE, 0xEA, 0x01, 0xA0,  // Signature
+      0x3E, 0xB0, 0xEA, 0x02, 0xA0,  //
+      0x3E, 0x61, 0xEA, 0x03, 0xA0,  //
+      0x3E, 'o',  0xEA, 0x04, 0xA0,  // Text
+      0x3E, 'k',  0xEA, 0x05, 0xA0,  //
+      0x3E, 0x01, 0xEA, 0x00, 0xA0,  // Status: failed
+      0xC3, 0x23, 0x01,              // JP 0x0123
+  });
+  rom[0x0147] = 0x03;  // MBC1 with RAM
+  rom[0x0149] = 0x02;  // 8 KB
+  ConformanceResult result = runTestRom(rom, kBudget);
+
+  EXPECT_EQ(result.verdict, Verdict::Fail);
+  EXPECT_EQ(result.output, "ok");
+}
+
+// ✅ **Test: Mooneye's register signatures are recognized**
+TEST(ConformanceTest, MooneyeRegisters) {
+  EXPECT_EQ(runTestRom(registerRom(3, 5, 8, 13, 21, 34), kBudget).verdict,
+            Verdict::Pass);
+  EXPECT_EQ(runTestRom(registerRom(0x42, 0x42, 0x42, 0x42, 0x42, 0x42),
+                       kBudget)
+                .verdict,
+            Verdict::Fail);
+}
+
+// ✅ **Test: A ROM that never reports times out at its cycle budget**
+TEST(ConformanceTest, BudgetTimesOut) {
+  ConformanceResult result = runTestRom(makeRom({0xC3, 0x00, 0x01}), kBudget);
+
+  EXPECT_EQ(result.verdict, Verdict::Timeout);
+  EXPECT_GE(result.cycles, kBudget);
+  EXPECT_LT(result.cycles, kBudget + 64);
+}
+
+// ✅ **Test: A directory of ROMs runs in parallel and reports as JUnit**
+TEST(ConformanceTest, SuiteReportsJUnit) {
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "gb_conformance_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory / "mooneye");
+  auto write = [&](const std::string &name, const std::vector<uint8_t> &rom) {
+    std::ofstream file(directory / name, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(rom.data()), rom.size());
+  };
+  write("blargg.gb", serialRom("Passed\n"));
+  write("hangs.gb", makeRom({0xC3, 0x00, 0x01}));
+  write("mooneye/fails.gb", registerRom(0x42, 0x42, 0x42, 0x42, 0x42, 0x42));
+  write("notes.txt", {});
+
+  std::vector<std::string> paths = findTestRoms(directory.string());
+  ASSERT_EQ(paths.size(), 3u);
+  std::vector<ConformanceResult> results =
+      runConformance(directory.string(), paths, kBudget, 2);
+  std::filesystem::remove_all(directory);
+
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_EQ(results[0].name, "blargg.gb");
+  EXPECT_EQ(results[0].verdict, Verdict::Pass);
+  EXPECT_EQ(results[1].name, "hangs.gb");
+  EXPECT_EQ(results[1].verdict, Verdict::Timeout);
+  EXPECT_EQ(results[2].name, "mooneye/fails.gb");
+  EXPECT_EQ(results[2].verdict, Verdict::Fail);
+
+  std::ostringstream junit;
+  writeJUnit(junit, results, 1.5);
+  EXPECT_NE(junit.str().find("tests=\"3\" failures=\"2\" errors=\"0\""),
+            std::string::npos);
+  EXPECT_NE(junit.str().find("name=\"mooneye/fails.gb\""), std::string::npos);
+  EXPECT_NE(junit.str().find("<system-out>Passed\n</system-out>"),
+            std::string::npos);
+}
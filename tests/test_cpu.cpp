@@ -674,3 +674,79 @@ TEST_F(CPUTest, CCF) {
   EXPECT_EQ(cpu.getCarryFlag(), false);
   EXPECT_EQ(cpu.PC, 1);
 }
+
+// ✅ **Test: Conditional jumps test the flags when they execute**
+TEST_F(CPUTest, JR_con_n8_NotTaken) {
+  memory.writeByte(0x0000, 0x20);  // JR NZ, 0x02
+  memory.writeByte(0x0001, 0x02);
+  cpu.PC = 0;
+  cpu.setZeroFlag(true);
+
+  cpu.executeOpcode();
+
+  EXPECT_EQ(cpu.PC, 0x0002);
+  EXPECT_EQ(cpu.cycles, 8u);
+}
+
+// ✅ **Test: Taken branches take longer**
+TEST_F(CPUTest, ConditionalCycles) {
+  memory.writeByte(0x0000, 0x20);  // JR NZ, -2
+  memory.writeByte(0x0001, 0xFE);
+  cpu.PC = 0;
+  cpu.setZeroFlag(false);
+
+  cpu.executeOpcode();
+
+  EXPECT_EQ(cpu.PC, 0x0000);
+  EXPECT_EQ(cpu.cycles, 12u);
+  EXPECT_TRUE(cpu.jumpedBack);
+}
+
+// ✅ **Test: EI takes effect after the next instruction**
+TEST_F(CPUTest, EI_Delay) {
+  memory.writeByte(0x0000, 0xFB);  // EI
+  memory.writeByte(0x0001, 0x00);  // NOP
+  cpu.PC = 0;
+
+  cpu.executeOpcode();
+  EXPECT_FALSE(cpu.IME);
+  cpu.executeOpcode();
+  EXPECT_TRUE(cpu.IME);
+}
+
+// ✅ **Test: A DI straight after EI cancels it**
+TEST_F(CPUTest, EI_DI) {
+  memory.writeByte(0x0000, 0xFB);  // EI
+  memory.writeByte(0x0001, 0xF3);  // DI
+  memory.writeByte(0x0002, 0x00);  // NOP
+  cpu.PC = 0;
+
+  cpu.executeOpcode();
+  cpu.executeOpcode();
+  EXPECT_FALSE(cpu.IME);
+  cpu.executeOpcode();
+  EXPECT_FALSE(cpu.IME);
+}
+
+// ✅ **Test: A pending interrupt wakes HALT and is dispatched**
+TEST_F(CPUTest, InterruptWakesHalt) {
+  memory.writeByte(0x0000, 0x76);  // HALT
+  cpu.PC = 0;
+  cpu.SP = 0xFFFE;
+  cpu.IME = true;
+
+  cpu.executeOpcode();
+  cpu.executeOpcode();
+  EXPECT_TRUE(cpu.halted);
+  EXPECT_EQ(cpu.PC, 1);
+
+  memory.writeByte(0xFFFF, 0x01);  // IE: VBlank
+  memory.writeByte(0xFF0F, 0x01);  // IF: VBlank
+  cpu.executeOpcode();
+
+  EXPECT_FALSE(cpu.halted);
+  EXPECT_FALSE(cpu.IME);
+  EXPECT_EQ(cpu.PC, 0x0040);
+  EXPECT_EQ(memory.readWord(0xFFFC), 0x0001);
+  EXPECT_EQ(memory.readByte(0xFF0F) & 0x1F, 0x00);
+}
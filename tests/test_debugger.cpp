@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../include/debugger.hpp"
+
+// ✅ Test Fixture with a loop that switches banks and touches WRAM
+class DebuggerTest : public ::testing::Test {
+ protected:
+  GameBoy gameboy;
+  std::vector<uint8_t> rom = std::vector<uint8_t>(0x10000, 0x00);
+
+  void SetUp() override {
+    auto put = [&](size_t offset, std::vector<uint8_t> bytes) {
+      std::copy(bytes.begin(), bytes.end(), rom.begin() + offset);
+    };
+    rom[0x0147] = 0x01;                // MBC1
+    put(0x0100, {0xC3, 0x50, 0x01});  // JP $0150
+    put(0x0150, {
+                    0x3E, 0x02,        // 0150 LD A,2
+                    0xEA, 0x00, 0x20,  // 0152 LD ($2000),A
+                    0x3E, 0x42,        // 0155 LD A,$42
+                    0xEA, 0x00, 0xC0,  // 0157 LD ($C000),A
+                    0xFA, 0x10, 0xC0,  // 015A LD A,($C010)
+                    0x04,              // 015D INC B
+                    0xCD, 0x00, 0x40,  // 015E CALL $4000
+                    0xC3, 0x5D, 0x01,  // 0161 JP $015D
+                });
+    put(0x8000, {0xC9});  // 02:4000 RET
+    gameboy.loadRom(rom);
+  }
+};
+
+// ✅ **Test: A breakpoint stops before its instruction, once per visit**
+TEST_F(DebuggerTest, BreaksBeforeInstruction) {
+  Debugger debugger(gameboy);
+  int id = debugger.addBreakpoint(0x0155);
+
+  Stop stop = debugger.run(100000);
+  EXPECT_EQ(stop.reason, StopReason::Breakpoint);
+  EXPECT_EQ(stop.id, id);
+  EXPECT_EQ(stop.address, 0x0155);
+  EXPECT_EQ(gameboy.cpu.PC, 0x0155);
+  EXPECT_EQ(gameboy.cpu.A, 0x02);
+
+  // Resuming runs the instruction instead of stopping at it again
+  EXPECT_EQ(debugger.run(10000).reason, StopReason::None);
+  EXPECT_EQ(gameboy.memory.peek(0xC000), 0x42);
+}
+
+// ✅ **Test: Conditions are checked at the breakpoint**
+TEST_F(DebuggerTest, ConditionalBreakpoint) {
+  Debugger debugger(gameboy);
+  std::string error;
+  ASSERT_TRUE(debugger.command("break 0x015D if B == 5 && [0xC000] == $42",
+                               error))
+      << error;
+
+  Stop stop = debugger.run(100000);
+  EXPECT_EQ(stop.reason, StopReason::Breakpoint);
+  EXPECT_EQ(gameboy.cpu.B, 5);
+
+  stop = debugger.run(100000);
+  EXPECT_EQ(stop.reason, StopReason::Breakpoint);
+  EXPECT_EQ(gameboy.cpu.B, 5);  // After B wrapped around
+}
+
+// ✅ **Test: Banked breakpoints stop only with their bank mapped**
+TEST_F(DebuggerTest, BankedBreakpoint) {
+  Debugger debugger(gameboy);
+  debugger.addBreakpoint(0x4000, 1);
+  EXPECT_EQ(debugger.run(20000).reason, StopReason::None);
+
+  int id = debugger.addBreakpoint(0x4000, 2);
+  Stop stop = debugger.run(20000);
+  EXPECT_EQ(stop.reason, StopReason::Breakpoint);
+  EXPECT_EQ(stop.id, id);
+  EXPECT_EQ(gameboy.memory.romBank(), 2);
+}
+
+// ✅ **Test: Watchpoints stop after the accessing instruction**
+TEST_F(DebuggerTest, Watchpoints) {
+  Debugger debugger(gameboy);
+  std::string error;
+  ASSERT_TRUE(debugger.command("watch w 0xC000", error)) << error;
+  ASSERT_TRUE(debugger.command("watch r $C010-$C01F if value == 0", error))
+      << error;
+
+  Stop stop = debugger.run(100000);
+  EXPECT_EQ(stop.reason, StopReason::Watchpoint);
+  EXPECT_EQ(stop.id, 1);
+  EXPECT_EQ(stop.access, Access::Write);
+  EXPECT_EQ(stop.address, 0xC000);
+  EXPECT_EQ(stop.value, 0x42);
+  EXPECT_EQ(gameboy.cpu.PC, 0x015A);
+  EXPECT_EQ(gameboy.memory.peek(0xC000), 0x42);  // The write still happened
+
+  stop = debugger.run(100000);
+  EXPECT_EQ(stop.reason, StopReason::Watchpoint);
+  EXPECT_EQ(stop.id, 2);
+  EXPECT_EQ(stop.access, Access::Read);
+  EXPECT_EQ(stop.address, 0xC010);
+  EXPECT_EQ(gameboy.cpu.A, 0x00);
+
+  ASSERT_TRUE(debugger.remove(1));
+  ASSERT_TRUE(debugger.remove(2));
+  EXPECT_EQ(debugger.run(100000).reason, StopReason::None);
+}
+
+// ✅ **Test: step() runs one instruction**
+TEST_F(DebuggerTest, Steps) {
+  Debugger debugger(gameboy);
+  Stop stop = debugger.step();
+  EXPECT_EQ(stop.reason, StopReason::Step);
+  EXPECT_EQ(gameboy.cpu.PC, 0x0150);
+  debugger.step();
+  EXPECT_EQ(gameboy.cpu.PC, 0x0152);
+  EXPECT_NE(describeStop(gameboy, stop).find("$0152: LD ($2000),A"),
+            std::string::npos);
+}
+
+// ✅ **Test: Breakpoints that never fire leave the run unchanged**
+TEST_F(DebuggerTest, MatchesPlainRun) {
+  GameBoy plain;
+  plain.loadRom(rom);
+  plain.runCycles(200000);
+
+  Debugger debugger(gameboy);
+  debugger.addBreakpoint(0x015D, Debugger::kAnyBank,
+                         [](const GameBoy &, const Stop &) { return false; });
+  debugger.addWatchpoint(0xC000, 0xC0FF, Access::ReadWrite,
+                         [](const GameBoy &, const Stop &) { return false; });
+  EXPECT_EQ(debugger.run(200000).reason, StopReason::None);
+  EXPECT_EQ(gameboy.stateHash(), plain.stateHash());
+}
+
+// ✅ **Test: A watched idle loop is run, not skipped, so every poll is seen**
+TEST(DebuggerIdleTest, WatchpointsSeeEveryPoll) {
+  GameBoy gameboy;
+  gameboy.memory.writeByte(0xFF40, 0x80);  // LCDC: on
+  const uint8_t program[] = {
+      0xF0, 0x44,  // 0000 LDH A,(LY)
+      0xFE, 0x90,  // 0002 CP $90
+      0x20, 0xFA,  // 0004 JR NZ,$0000
+      0x18, 0xF8,  // 0006 JR $0000
+  };
+  for (uint16_t address = 0; address < sizeof(program); address++) {
+    gameboy.memory.writeByte(address, program[address]);
+  }
+
+  Debugger debugger(gameboy);
+  uint64_t polls = 0;
+  debugger.addWatchpoint(0xFF44, 0xFF44, Access::Read,
+                         [&polls](const GameBoy &, const Stop &) {
+                           polls++;
+                           return false;
+                         });
+  EXPECT_EQ(debugger.run(PPU::kFrameCycles).reason, StopReason::None);
+  EXPECT_EQ(gameboy.skippedIdleCycles, 0u);
+  EXPECT_GT(polls, PPU::kFrameCycles / 40);  // One per 32-cycle iteration
+  EXPECT_TRUE(gameboy.idleLoopSkipping);     // Restored after the run
+}
+
+// ✅ **Test: Malformed commands are rejected with a reason**
+TEST_F(DebuggerTest, RejectsBadCommands) {
+  Debugger debugger(gameboy);
+  std::string error;
+  EXPECT_TRUE(debugger.command("", error));
+  EXPECT_TRUE(debugger.command("# comment", error));
+  for (const char *command :
+       {"break", "break 0x10000", "break 0x4000 bank", "watch x 0xC000",
+        "watch r 0xC000-", "break 0x150 if A ==", "break 0x150 if Q == 1",
+        "break 0x150 if A == 1 B", "delete 99", "run"}) {
+    error.clear();
+    EXPECT_FALSE(debugger.command(command, error)) << command;
+    EXPECT_FALSE(error.empty()) << command;
+  }
+  EXPECT_TRUE(debugger.empty());
+}
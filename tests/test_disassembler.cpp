@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../include/disassembler.hpp"
+
+namespace {
+
+Instruction decode(std::vector<uint8_t> bytes, uint16_t address = 0x0150) {
+  return decodeInstruction(bytes, address);
+}
+
+std::string text(std::vector<uint8_t> bytes, uint16_t address = 0x0150) {
+  return formatInstruction(decode(bytes, address));
+}
+
+}  // namespace
+
+// ✅ **Test: The metadata uses the CPU's handler names**
+TEST(DisassemblerTest, SharesCpuNaming) {
+  EXPECT_STREQ(kOpcodes[0x01].handler, "LD_r16_n16");
+  EXPECT_STREQ(kOpcodes[0x20].handler, "JR_con_n8");
+  EXPECT_STREQ(kOpcodes[0xC4].handler, "CALL_con_n16");
+  EXPECT_EQ(kOpcodes[0x20].cycles, 8);
+  EXPECT_EQ(kOpcodes[0x20].takenCycles, 12);
+}
+
+// ✅ **Test: Immediates, addresses and offsets are formatted**
+TEST(DisassemblerTest, FormatsOperands) {
+  EXPECT_EQ(text({0x00}), "NOP");
+  EXPECT_EQ(text({0x01, 0x34, 0x12}), "LD BC,$1234");
+  EXPECT_EQ(text({0x3E, 0x7F}), "LD A,$7F");
+  EXPECT_EQ(text({0xE0, 0x40}), "LDH ($FF40),A");
+  EXPECT_EQ(text({0xEA, 0x00, 0x20}), "LD ($2000),A");
+  EXPECT_EQ(text({0xE8, 0x05}), "ADD SP,+5");
+  EXPECT_EQ(text({0xF8, 0xFD}), "LD HL,SP-3");
+  EXPECT_EQ(text({0x22}), "LD (HL+),A");
+  EXPECT_EQ(text({0x96}), "SUB A,(HL)");
+  EXPECT_EQ(text({0xD3}), "INVALID");
+}
+
+// ✅ **Test: Jumps and calls carry their targets and flow**
+TEST(DisassemblerTest, DecodesControlFlow) {
+  Instruction loop = decode({0x20, 0xFE});
+  EXPECT_EQ(loop.flow, Flow::Branch);
+  EXPECT_TRUE(loop.hasTarget);
+  EXPECT_EQ(loop.target, 0x0150);
+  EXPECT_EQ(formatInstruction(loop), "JR NZ,$0150");
+
+  Instruction call = decode({0xCD, 0x00, 0x40});
+  EXPECT_EQ(call.flow, Flow::Call);
+  EXPECT_EQ(call.target, 0x4000);
+
+  Instruction restart = decode({0xFF});
+  EXPECT_EQ(restart.flow, Flow::Call);
+  EXPECT_EQ(restart.target, 0x38);
+  EXPECT_EQ(formatInstruction(restart), "RST $38");
+
+  EXPECT_EQ(decode({0xE9}).flow, Flow::JumpIndirect);
+  EXPECT_FALSE(decode({0xE9}).hasTarget);
+  EXPECT_EQ(decode({0xC8}).flow, Flow::ReturnIf);
+  EXPECT_EQ(decode({0xD9}).flow, Flow::Return);
+  EXPECT_EQ(decode({0xD3}).flow, Flow::Invalid);
+}
+
+// ✅ **Test: 0xCB opcodes decode from their regular table**
+TEST(DisassemblerTest, DecodesPrefixedOpcodes) {
+  Instruction bit = decode({0xCB, 0x7E});
+  EXPECT_TRUE(bit.prefixed);
+  EXPECT_EQ(bit.length, 2);
+  EXPECT_EQ(bit.cycles, 12);
+  EXPECT_STREQ(bit.handler, "BIT_u3_HL");
+  EXPECT_EQ(formatInstruction(bit), "BIT 7,(HL)");
+
+  EXPECT_EQ(text({0xCB, 0x37}), "SWAP A");
+  EXPECT_EQ(text({0xCB, 0x00}), "RLC B");
+  EXPECT_EQ(text({0xCB, 0xC6}), "SET 0,(HL)");
+  EXPECT_EQ(decode({0xCB, 0xC6}).cycles, 16);
+}
+
+// ✅ **Test: A linear sweep steps by instruction length**
+TEST(DisassemblerTest, DisassemblesRange) {
+  std::vector<uint8_t> code = {0x00, 0x3E, 0x12, 0xCB, 0x7F, 0xC3, 0x00};
+  std::vector<Instruction> instructions = disassemble(code, 0x0100);
+  ASSERT_EQ(instructions.size(), 4u);
+  EXPECT_EQ(instructions[1].address, 0x0101);
+  EXPECT_EQ(instructions[2].address, 0x0103);
+  EXPECT_EQ(instructions[3].address, 0x0105);
+  // Truncated at the end: the missing byte reads as 0xFF
+  EXPECT_EQ(instructions[3].target, 0xFF00);
+}
+
+// ✅ **Test: Decoding from a machine does not disturb it**
+TEST(DisassemblerTest, DecodesFromMemory) {
+  Memory memory;
+  memory.writeByte(0x0100, 0xC3);
+  memory.writeByte(0x0101, 0x50);
+  memory.writeByte(0x0102, 0x01);
+  Instruction instruction = decodeInstruction(memory, 0x0100);
+  EXPECT_EQ(formatInstruction(instruction), "JP $0150");
+  EXPECT_EQ(instruction.flow, Flow::Jump);
+}
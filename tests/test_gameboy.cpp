@@ -0,0 +1,486 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/gameboy.hpp"
+#include "../include/save_state.hpp"
+
+// ✅ Test Fixture for the whole machine
+class GameBoyTest : public ::testing::Test {
+ protected:
+  GameBoy gameboy;
+
+  void SetUp() override { gameboy.memory.writeByte(PPU::LCDC, 0x80); }
+
+  void loadProgram(std::initializer_list<uint8_t> program) {
+    uint16_t address = 0;
+    for (uint8_t byte : program) {
+      gameboy.memory.writeByte(address++, byte);
+    }
+  }
+};
+
+// ✅ **Test: LY advances once per scanline**
+TEST_F(GameBoyTest, LYAdvancesPerLine) {
+  loadProgram({0xC3, 0x00, 0x00});  // JP 0x0000
+  gameboy.runCycles(PPU::kLineCycles * 10);
+
+  EXPECT_EQ(gameboy.memory.readByte(PPU::LY), 10);
+}
+
+// ✅ **Test: A frame ends back on line 0 with VBlank requested**
+TEST_F(GameBoyTest, FrameRequestsVBlank) {
+  loadProgram({0xC3, 0x00, 0x00});  // JP 0x0000
+  gameboy.runFrame();
+
+  EXPECT_EQ(gameboy.memory.readByte(PPU::LY), 0);
+  EXPECT_EQ(gameboy.memory.readByte(PPU::IF) & 0x01, 0x01);
+}
+
+// ✅ **Test: Skipping an LY polling loop leaves the machine unchanged**
+TEST_F(GameBoyTest, IdleLoopSkipIsExact) {
+  std::initializer_list<uint8_t> program = {
+      0xF0, 0x44,        // LDH A,(LY)
+      0xFE, 0x90,        // CP 0x90
+      0x20, 0xFA,        // JR NZ,-6
+      0x3C,              // INC A
+      0xC3, 0x00, 0x00,  // JP 0x0000
+  };
+  loadProgram(program);
+  GameBoy reference;
+  reference.idleLoopSkipping = false;
+  reference.memory.writeByte(PPU::LCDC, 0x80);
+  for (uint16_t address = 0; address < program.size(); address++) {
+    reference.memory.writeByte(address, gameboy.memory.readByte(address));
+  }
+
+  for (int frame = 0; frame < 3; frame++) {
+    gameboy.runFrame();
+    reference.runFrame();
+
+    EXPECT_EQ(gameboy.cpu.cycles, reference.cpu.cycles);
+    EXPECT_EQ(gameboy.cpu.PC, reference.cpu.PC);
+    EXPECT_EQ(gameboy.cpu.A, reference.cpu.A);
+    EXPECT_EQ(gameboy.cpu.F, reference.cpu.F);
+    EXPECT_EQ(gameboy.ppu.getLine(), reference.ppu.getLine());
+    EXPECT_EQ(gameboy.ppu.getMode(), reference.ppu.getMode());
+  }
+  EXPECT_GT(gameboy.skippedIdleCycles, 0u);
+  EXPECT_EQ(reference.skippedIdleCycles, 0u);
+}
+
+namespace {
+
+// Enables the VBlank interrupt, then polls LY for a value it never takes;
+// the handler stores DIV in FF80 and counts itself in B
+const std::vector<uint8_t> kInterruptPollProgram = {
+    0x31, 0x00, 0xD0,  // 0000 LD SP,0xD000
+    0x3E, 0x01,        // 0003 LD A,0x01
+    0xE0, 0xFF,        // 0005 LDH (IE),A
+    0xFB,              // 0007 EI
+    0xF0, 0x44,        // 0008 LDH A,(LY)
+    0xFE, 0xFF,        // 000A CP 0xFF
+    0x20, 0xFA,        // 000C JR NZ,-6
+};
+const std::vector<uint8_t> kInterruptPollHandler = {
+    0xF0, 0x04,  // 0040 LDH A,(DIV)
+    0xE0, 0x80,  // 0042 LDH (0xFF80),A
+    0x04,        // 0044 INC B
+    0xD9,        // 0045 RETI
+};
+
+// Runs the program above with or without idle-loop skipping and returns
+// the state hash after each frame
+template <typename Machine>
+std::vector<uint64_t> interruptPollHashes(bool idleLoopSkipping) {
+  Machine machine;
+  machine.idleLoopSkipping = idleLoopSkipping;
+  machine.memory.writeByte(PPU::LCDC, 0x80);
+  for (size_t i = 0; i < kInterruptPollProgram.size(); i++) {
+    machine.memory.writeByte(i, kInterruptPollProgram[i]);
+  }
+  for (size_t i = 0; i < kInterruptPollHandler.size(); i++) {
+    machine.memory.writeByte(0x40 + i, kInterruptPollHandler[i]);
+  }
+
+  std::vector<uint64_t> hashes;
+  for (int frame = 0; frame < 8; frame++) {
+    machine.runFrame();
+    hashes.push_back(machine.stateHash());
+  }
+  EXPECT_EQ(machine.cpu.B, 8);
+  EXPECT_EQ(machine.skippedIdleCycles > 0, idleLoopSkipping);
+  return hashes;
+}
+
+}  // namespace
+
+// ✅ **Test: Skipping stops for a pending interrupt, in both tiers**
+TEST(GameBoyIdleTest, IdleLoopSkipKeepsInterruptTiming) {
+  EXPECT_EQ(interruptPollHashes<GameBoy>(true),
+            interruptPollHashes<GameBoy>(false));
+  EXPECT_EQ(interruptPollHashes<AccurateGameBoy>(true),
+            interruptPollHashes<AccurateGameBoy>(false));
+}
+
+// ✅ **Test: Loops that poll ordinary memory are not skipped**
+TEST_F(GameBoyTest, IdleLoopIgnoresPlainMemory) {
+  loadProgram({
+      0xF0, 0x80,  // LDH A,(0xFF80)
+      0xFE, 0x01,  // CP 0x01
+      0x20, 0xFA,  // JR NZ,-6
+  });
+  gameboy.runFrame();
+
+  EXPECT_EQ(gameboy.skippedIdleCycles, 0u);
+}
+
+// ✅ **Test: A fork runs on exactly like the machine it came from**
+TEST_F(GameBoyTest, ForkContinuesIdentically) {
+  loadProgram({
+      0x21, 0x00, 0xC0,  // LD HL,0xC000
+      0x34,              // INC (HL)
+      0x23,              // INC HL
+      0x18, 0xFC,        // JR -4
+  });
+  gameboy.runFrame();
+
+  std::unique_ptr<GameBoy> fork = gameboy.fork();
+  EXPECT_EQ(fork->stateHash(), gameboy.stateHash());
+  gameboy.runFrame();
+  fork->runFrame();
+  EXPECT_EQ(fork->stateHash(), gameboy.stateHash());
+
+  fork->memory.writeByte(0xC000, 0xAA);
+  EXPECT_NE(gameboy.memory.readByte(0xC000), 0xAA);
+}
+
+namespace {
+
+// Calls, pushes and pops in a loop, touching no I/O registers
+const std::vector<uint8_t> kStackProgram = {
+    0x31, 0x00, 0xD0,  // 0000 LD SP,0xD000
+    0xCD, 0x10, 0x00,  // 0003 CALL 0x0010
+    0xC5,              // 0006 PUSH BC
+    0xC1,              // 0007 POP BC
+    0x04,              // 0008 INC B
+    0xC2, 0x03, 0x00,  // 0009 JP NZ,0x0003
+    0xC3, 0x00, 0x00,  // 000C JP 0x0000
+    0x00,              // 000F
+    0x0C,              // 0010 INC C
+    0xC9,              // 0011 RET
+};
+
+// Records the address and clock of each write to the stack page below
+// 0xD000
+template <typename Machine>
+class StackWrites : public MemoryWatcher {
+ public:
+  explicit StackWrites(Machine &machine) : machine(machine) {
+    std::bitset<0x100> writes;
+    writes.set(0xCF);
+    machine.memory.setTraps(this, {}, writes);
+  }
+  ~StackWrites() override { machine.memory.setTraps(nullptr, {}, {}); }
+
+  void watchedRead(uint16_t, uint8_t) override {}
+  void watchedWrite(uint16_t address, uint8_t) override {
+    addresses.push_back(address);
+    times.push_back(machine.cpu.cycles);
+  }
+
+  std::vector<uint16_t> addresses;
+  std::vector<uint64_t> times;
+
+ private:
+  Machine &machine;
+};
+
+template <typename Machine>
+void loadStackProgram(Machine &machine) {
+  machine.memory.writeByte(PPU::LCDC, 0x80);
+  for (size_t address = 0; address < kStackProgram.size(); address++) {
+    machine.memory.writeByte(address, kStackProgram[address]);
+  }
+}
+
+}  // namespace
+
+// ✅ **Test: Both tiers give every instruction the same duration**
+TEST(GameBoyTierTest, TiersAgreeAcrossInstructions) {
+  GameBoy fast;
+  AccurateGameBoy accurate;
+  loadStackProgram(fast);
+  loadStackProgram(accurate);
+
+  for (int frame = 0; frame < 3; frame++) {
+    fast.runFrame();
+    accurate.runFrame();
+    EXPECT_EQ(accurate.stateHash(), fast.stateHash());
+  }
+  EXPECT_EQ(accurate.cpu.cycles, fast.cpu.cycles);
+  EXPECT_EQ(accurate.cpu.BC(), fast.cpu.BC());
+}
+
+// ✅ **Test: The accurate tier clocks each bus access as it happens**
+TEST(GameBoyTierTest, AccurateTierClocksEachAccess) {
+  GameBoy fast;
+  AccurateGameBoy accurate;
+  loadStackProgram(fast);
+  loadStackProgram(accurate);
+  fast.step();  // LD SP,0xD000 (12 cycles)
+  accurate.step();
+
+  StackWrites fastWrites(fast);
+  StackWrites accurateWrites(accurate);
+  fast.step();  // CALL 0x0010 (24 cycles)
+  accurate.step();
+
+  // Fast: both pushed bytes at the end of the CALL. Accurate: three fetch
+  // M-cycles and an internal one, then the high byte and the low byte in
+  // M-cycles of their own.
+  EXPECT_EQ(fastWrites.times, (std::vector<uint64_t>{36, 36}));
+  EXPECT_EQ(accurateWrites.times, (std::vector<uint64_t>{32, 36}));
+  EXPECT_EQ(accurateWrites.addresses,
+            (std::vector<uint16_t>{0xCFFF, 0xCFFE}));
+  EXPECT_EQ(accurate.cpu.cycles, 36u);
+  EXPECT_EQ(fast.cpu.cycles, 36u);
+}
+
+// Starts the timer at 16 cycles per tick with TIMA two ticks from overflow,
+// then reads IF; returns how many reads miss the timer interrupt request
+template <typename Machine>
+int readsBeforeTimerInterrupt() {
+  Machine machine;
+  const std::vector<uint8_t> program = {
+      0x3E, 0x05,  // LD A,0x05
+      0xE0, 0x07,  // LDH (TAC),A
+      0x3E, 0xFE,  // LD A,0xFE
+      0xE0, 0x05,  // LDH (TIMA),A
+  };
+  for (size_t address = 0; address < 0x100; address += 2) {
+    machine.memory.writeByte(address, 0xF0);  // LDH A,(IF)
+    machine.memory.writeByte(address + 1, 0x0F);
+  }
+  for (size_t address = 0; address < program.size(); address++) {
+    machine.memory.writeByte(address, program[address]);
+  }
+  for (size_t i = 0; i < 4; i++) {
+    machine.step();
+  }
+
+  int reads = 0;
+  for (machine.step(); (machine.cpu.A & 0x04) == 0; machine.step()) {
+    reads++;
+  }
+  return reads;
+}
+
+// ✅ **Test: The accurate tier catches devices up before an I/O access**
+TEST(GameBoyTierTest, AccurateTierCatchesUpDevices) {
+  // The overflow falls due during a read: only the accurate tier runs the
+  // timer event before the read rather than after the instruction
+  int fast = readsBeforeTimerInterrupt<GameBoy>();
+  int accurate = readsBeforeTimerInterrupt<AccurateGameBoy>();
+  EXPECT_EQ(accurate, 1);
+  EXPECT_EQ(fast, 2);
+}
+
+namespace {
+
+// Runs a boot ROM of NOPs that unmaps itself at 00FC, and returns the
+// cycles taken to reach the cartridge's entry point
+template <typename Machine>
+uint64_t bootCycles() {
+  std::vector<uint8_t> rom(0x8000, 0x00);
+  rom[0x0000] = 0x11;
+  std::vector<uint8_t> boot(0x100, 0x00);
+  boot[0xFC] = 0x3E;  // LD A,1
+  boot[0xFD] = 0x01;
+  boot[0xFE] = 0xE0;  // LDH (BOOT),A
+  boot[0xFF] = 0x50;
+
+  Machine machine;
+  machine.loadRom(rom);
+  EXPECT_FALSE(machine.runBootRom(std::vector<uint8_t>(0x80)));
+  EXPECT_EQ(machine.cpu.PC, 0x0100);
+  EXPECT_TRUE(machine.runBootRom(boot));
+  EXPECT_EQ(machine.cpu.PC, 0x0000);
+  EXPECT_EQ(machine.memory.readByte(0x0000), 0x00);
+
+  for (int i = 0; i < 0x100 && machine.cpu.PC != 0x0100; i++) {
+    machine.step();
+  }
+  EXPECT_EQ(machine.cpu.PC, 0x0100);
+  EXPECT_FALSE(machine.memory.isBootRomMapped());
+  EXPECT_EQ(machine.memory.readByte(0x0000), 0x11);
+  return machine.cpu.cycles;
+}
+
+}  // namespace
+
+// ✅ **Test: A boot ROM runs from 0000 and hands over at 0100**
+TEST(GameBoyBootTest, BootRomHandsOver) {
+  EXPECT_EQ(bootCycles<GameBoy>(), 252 * 4 + 8 + 12);
+  EXPECT_EQ(bootCycles<AccurateGameBoy>(), 252 * 4 + 8 + 12);
+}
+
+// ✅ **Test: Fast boot installs the state the boot ROM leaves**
+TEST(GameBoyBootTest, FastBoot) {
+  std::vector<uint8_t> rom(0x8000, 0x00);
+  rom[0x014D] = 0x5A;  // Header checksum
+  GameBoy gameboy;
+  gameboy.loadRom(rom);
+  gameboy.fastBoot();
+
+  EXPECT_EQ(gameboy.cpu.AF(), 0x01B0);
+  EXPECT_EQ(gameboy.cpu.BC(), 0x0013);
+  EXPECT_EQ(gameboy.cpu.DE(), 0x00D8);
+  EXPECT_EQ(gameboy.cpu.HL(), 0x014D);
+  EXPECT_EQ(gameboy.cpu.SP, 0xFFFE);
+  EXPECT_EQ(gameboy.cpu.PC, 0x0100);
+  Memory &memory = gameboy.memory;
+  EXPECT_EQ(memory.readByte(0xFF00), 0xCF);
+  EXPECT_EQ(memory.readByte(0xFF02), 0x7E);
+  EXPECT_EQ(memory.readByte(0xFF04), 0xAB);
+  EXPECT_EQ(memory.readByte(0xFF0F), 0xE1);
+  EXPECT_EQ(memory.readByte(0xFF26), 0xF1);
+  EXPECT_EQ(memory.readByte(0xFF40), 0x91);
+  EXPECT_EQ(memory.readByte(0xFF46), 0xFF);
+  EXPECT_EQ(memory.readByte(0xFF47), 0xFC);
+
+  gameboy.runCycles(PPU::kLineCycles * 3);  // The LCD is on
+  EXPECT_EQ(memory.readByte(PPU::LY), 3);
+}
+
+// ✅ **Test: Fast boot gives a CGB cartridge the CGB registers**
+TEST(GameBoyBootTest, FastBootCgb) {
+  std::vector<uint8_t> rom(0x8000, 0x00);
+  rom[0x0143] = 0x80;
+  AccurateGameBoy gameboy;
+  gameboy.loadRom(rom);
+  gameboy.fastBoot();
+
+  EXPECT_EQ(gameboy.cpu.AF(), 0x1180);
+  EXPECT_EQ(gameboy.cpu.DE(), 0xFF56);
+  EXPECT_EQ(gameboy.cpu.HL(), 0x000D);
+}
+
+namespace {
+
+// Turns on the LCD and timer, then fills C000-C0FF with a counter
+std::vector<uint8_t> stateRom(bool cgb) {
+  std::vector<uint8_t> rom(0x8000, 0x00);
+  const uint8_t program[] = {
+      0x3E, 0x91,        // 0100 LD A,0x91
+      0xE0, 0x40,        // 0102 LDH (LCDC),A
+      0x3E, 0x05,        // 0104 LD A,0x05
+      0xE0, 0x07,        // 0106 LDH (TAC),A
+      0x21, 0x00, 0xC0,  // 0108 LD HL,0xC000
+      0x3C,              // 010B INC A
+      0x77,              // 010C LD (HL),A
+      0x2C,              // 010D INC L
+      0xC3, 0x0B, 0x01,  // 010E JP 0x010B
+  };
+  std::copy(std::begin(program), std::end(program), rom.begin() + 0x100);
+  rom[0x0143] = cgb ? 0x80 : 0x00;
+  return rom;
+}
+
+}  // namespace
+
+// ✅ **Test: A loaded state matches the saved machine and runs on the same**
+TEST(GameBoyStateTest, SaveAndLoadRoundTrip) {
+  for (bool cgb : {false, true}) {
+    GameBoy original;
+    original.loadRom(stateRom(cgb));
+    original.fastBoot();
+    original.runFrame();
+    original.runCycles(1234);  // Part way through a frame
+    std::vector<uint8_t> state = original.saveState();
+
+    GameBoy copy;
+    copy.loadRom(stateRom(cgb));
+    std::string error;
+    ASSERT_TRUE(copy.loadState(state, error)) << error;
+    EXPECT_EQ(copy.stateHash(), original.stateHash());
+    EXPECT_EQ(copy.memory.readByte(0xC000), original.memory.readByte(0xC000));
+
+    for (int frame = 0; frame < 3; frame++) {
+      original.runFrame();
+      copy.runFrame();
+    }
+    EXPECT_EQ(copy.stateHash(), original.stateHash());
+  }
+}
+
+// ✅ **Test: States for another ROM, and damaged states, are rejected**
+TEST(GameBoyStateTest, RejectsMismatchedStates) {
+  GameBoy original;
+  original.loadRom(stateRom(false));
+  original.runFrame();
+  std::vector<uint8_t> state = original.saveState();
+
+  GameBoy other;
+  std::vector<uint8_t> rom = stateRom(false);
+  rom[0x4000] = 0x01;
+  other.loadRom(rom);
+  std::string error;
+  EXPECT_FALSE(other.loadState(state, error));
+  EXPECT_EQ(error, "state is for a different cartridge");
+
+  GameBoy same;
+  same.loadRom(stateRom(false));
+  std::vector<uint8_t> truncated(state.begin(), state.end() - 1);
+  EXPECT_FALSE(same.loadState(truncated, error));
+  EXPECT_EQ(error, "truncated state");
+  state[0] = 'X';
+  EXPECT_FALSE(same.loadState(state, error));
+  EXPECT_EQ(error, "not a saved state");
+}
+
+// ✅ **Test: States with impossible device values are rejected**
+TEST(GameBoyStateTest, RejectsCorruptStates) {
+  GameBoy original;
+  original.loadRom(stateRom(false));
+  original.runFrame();
+  std::vector<uint8_t> state = original.saveState();
+
+  // Finds the devices' state from the end: PPU, then events and the
+  // skipped-cycle count
+  StateWriter io, cpu, ppu;
+  original.memory.io.saveState(io);
+  original.cpu.saveState(cpu);
+  original.ppu.saveState(ppu);
+  size_t ppuStart = state.size() - 8 * (static_cast<size_t>(Event::Count) + 1) -
+                    ppu.data().size();
+  size_t ioEnd = ppuStart - cpu.data().size();
+  size_t bootRomSize = ioEnd - io.data().size() - 2;
+
+  using Bytes = std::vector<std::pair<size_t, uint8_t>>;
+  const Bytes corruptions[] = {
+      {{ppuStart, PPU::Transfer}, {ppuStart + 1, 150}},  // In VBlank
+      {{ppuStart + 1, 200}},                 // Past the last line
+      {{ppuStart + 2, 200}},                 // Window line off the screen
+      {{ioEnd - 1, 0x90}},                   // Too many VRAM DMA blocks
+      {{bootRomSize, 0x01}},                 // A 1-byte boot ROM
+      {{bootRomSize, 0x01}, {bootRomSize + 1, 0x01}},  // 0x101 bytes
+  };
+  GameBoy gameboy;
+  gameboy.loadRom(stateRom(false));
+  std::string error;
+  for (const Bytes &bytes : corruptions) {
+    std::vector<uint8_t> corrupt = state;
+    for (auto [offset, value] : bytes) {
+      corrupt[offset] = value;
+    }
+    EXPECT_FALSE(gameboy.loadState(corrupt, error)) << bytes[0].first;
+    EXPECT_EQ(error, "corrupt state");
+  }
+  ASSERT_TRUE(gameboy.loadState(state, error)) << error;
+  gameboy.runFrame();
+  original.runFrame();
+  EXPECT_EQ(gameboy.stateHash(), original.stateHash());
+}
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/gdb_stub.hpp"
+
+// A scripted GDB: sends packets and reads replies, skipping acknowledgements
+class Client {
+ public:
+  bool connectTcp(uint16_t port) {
+    socket = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int noDelay = 1;
+    ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return setTimeout() && ::connect(socket,
+                                     reinterpret_cast<sockaddr *>(&address),
+                                     sizeof(address)) == 0;
+  }
+
+  bool connectUnix(const std::string &path) {
+    socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return setTimeout() && ::connect(socket,
+                                     reinterpret_cast<sockaddr *>(&address),
+                                     sizeof(address)) == 0;
+  }
+
+  ~Client() {
+    if (socket >= 0) {
+      ::close(socket);
+    }
+  }
+
+  void sendRaw(const std::string &data) {
+    ::send(socket, data.data(), data.size(), MSG_NOSIGNAL);
+  }
+
+  void send(const std::string &packet) {
+    unsigned sum = 0;
+    for (char c : packet) {
+      sum += static_cast<uint8_t>(c);
+    }
+    char trailer[4];
+    std::snprintf(trailer, sizeof(trailer), "#%02x", sum & 0xFF);
+    sendRaw("$" + packet + trailer);
+  }
+
+  // The next packet's payload, or "<timeout>"
+  std::string receive() {
+    std::string packet;
+    bool inside = false;
+    char c;
+    while (::recv(socket, &c, 1, 0) == 1) {
+      if (!inside) {
+        inside = c == '$';
+      } else if (c != '#') {
+        packet += c;
+      } else {
+        char checksum[2];
+        ::recv(socket, checksum, 2, MSG_WAITALL);
+        sendRaw("+");
+        return packet;
+      }
+    }
+    return "<timeout>";
+  }
+
+  std::string ask(const std::string &packet) {
+    send(packet);
+    return receive();
+  }
+
+ private:
+  bool setTimeout() {
+    timeval timeout{5, 0};
+    return ::setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+                        sizeof(timeout)) == 0;
+  }
+
+  int socket = -1;
+};
+
+// ✅ Test Fixture running a bank-switching loop on an emulation thread
+class GdbStubTest : public ::testing::Test {
+ protected:
+  GameBoy gameboy;
+  GdbStub stub{gameboy};
+  std::atomic<bool> running{true};
+  std::thread emulation;
+
+  void SetUp() override {
+    std::vector<uint8_t> rom(0x10000, 0x00);
+    auto put = [&](size_t offset, std::vector<uint8_t> bytes) {
+      std::copy(bytes.begin(), bytes.end(), rom.begin() + offset);
+    };
+    rom[0x0147] = 0x01;                // MBC1
+    put(0x0100, {0xC3, 0x50, 0x01});  // JP $0150
+    put(0x0150, {
+                    0x3E, 0x02,        // 0150 LD A,2
+                    0xEA, 0x00, 0x20,  // 0152 LD ($2000),A
+                    0x3E, 0x42,        // 0155 LD A,$42
+                    0xEA, 0x00, 0xC0,  // 0157 LD ($C000),A
+                    0x04,              // 015A INC B
+                    0xCD, 0x00, 0x40,  // 015B CALL $4000
+                    0xC3, 0x5A, 0x01,  // 015E JP $015A
+                });
+    put(0x8000, {0xC9});  // 02:4000 RET
+    gameboy.loadRom(rom);
+  }
+
+  void start() {
+    emulation = std::thread([this] {
+      while (running.load()) {
+        stub.runFrame();
+      }
+    });
+  }
+
+  void TearDown() override {
+    running.store(false);
+    if (emulation.joinable()) {
+      emulation.join();
+    }
+  }
+
+  // 16-bit little-endian register `index` of a `g` reply
+  static unsigned registerOf(const std::string &registers, size_t index) {
+    unsigned value = std::stoul(registers.substr(index * 4, 4), nullptr, 16);
+    return (value & 0xFF) << 8 | value >> 8;
+  }
+};
+
+// ✅ **Test: Registers, memory, breakpoints and stepping over TCP**
+TEST_F(GdbStubTest, DebugsOverTcp) {
+  std::string error;
+  ASSERT_TRUE(stub.listenTcp(0, error)) << error;
+  ASSERT_NE(stub.port(), 0);
+  start();
+
+  Client client;
+  ASSERT_TRUE(client.connectTcp(stub.port()));
+  EXPECT_NE(client.ask("qSupported:swbreak+").find("PacketSize"),
+            std::string::npos);
+  EXPECT_EQ(client.ask("?"), "S05");
+  EXPECT_EQ(client.ask("vMustReplyEmpty"), "");
+
+  // Break in bank 2 only, as bank << 16 | address
+  EXPECT_EQ(client.ask("Z0,24000,1"), "OK");
+  EXPECT_EQ(client.ask("c"), "S05");
+  std::string registers = client.ask("g");
+  ASSERT_EQ(registers.size(), 24u);
+  EXPECT_EQ(registerOf(registers, 5), 0x4000u);  // PC
+  EXPECT_EQ(client.ask("p5"), "0040");
+
+  EXPECT_EQ(client.ask("mc000,1"), "42");
+  EXPECT_EQ(client.ask("Mc001,2:beef"), "OK");
+  EXPECT_EQ(client.ask("mc000,3"), "42beef");
+  EXPECT_EQ(client.ask("m10000,1"), "E01");
+
+  // Step over the RET; the breakpoint does not stop a step
+  EXPECT_EQ(client.ask("s"), "S05");
+  EXPECT_EQ(client.ask("p5"), "5e01");
+  EXPECT_EQ(client.ask("z0,24000,1"), "OK");
+
+  // The CALL pushes its return address
+  EXPECT_EQ(client.ask("Z2,fffc,2"), "OK");
+  EXPECT_EQ(client.ask("c"), "T05watch:fffc;");
+  EXPECT_EQ(client.ask("?"), "T05watch:fffc;");
+  EXPECT_EQ(client.ask("z2,fffc,2"), "OK");
+
+  EXPECT_EQ(client.ask("P2=3412"), "OK");
+  registers = client.ask("g");
+  EXPECT_EQ(registerOf(registers, 2), 0x1234u);  // DE
+
+  // ^C stops a running machine
+  client.send("c");
+  client.sendRaw("\x03");
+  EXPECT_EQ(client.receive(), "S02");
+  EXPECT_EQ(client.ask("D"), "OK");
+}
+
+// ✅ **Test: A client can attach over a Unix socket and detach**
+TEST_F(GdbStubTest, AttachesOverUnixSocket) {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "gb_gdb_stub_test").string();
+  std::string error;
+  ASSERT_TRUE(stub.listenUnix(path, error)) << error;
+  start();
+
+  {
+    Client client;
+    ASSERT_TRUE(client.connectUnix(path));
+    EXPECT_EQ(client.ask("QStartNoAckMode"), "OK");
+    EXPECT_EQ(client.ask("qAttached"), "1");
+    EXPECT_EQ(client.ask("Z1,15a,1"), "OK");
+  }  // Disconnecting removes the breakpoint
+
+  Client client;
+  ASSERT_TRUE(client.connectUnix(path));
+  EXPECT_EQ(client.ask("?"), "S05");
+  client.send("c");
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  client.sendRaw("\x03");
+  EXPECT_EQ(client.receive(), "S02");
+  std::string registers = client.ask("g");
+  ASSERT_EQ(registers.size(), 24u);
+  EXPECT_EQ(client.ask("D"), "OK");
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../include/golden.hpp"
+#include "../include/movie.hpp"
+
+// ✅ Test Fixture for the golden-image harness over a scratch ROM directory
+class GoldenTest : public ::testing::Test {
+ protected:
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "gb_golden_test";
+  GoldenOptions options;
+
+  void SetUp() override {
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    options.frames = 120;
+    options.interval = 30;
+    options.imageDirectory = (directory / "failures").string();
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory); }
+
+  // Turns the LCD on and loops
+  static std::vector<uint8_t> lcdRom() {
+    std::vector<uint8_t> rom(0x8000, 0x00);
+    const uint8_t code[] = {
+        0x3E, 0x91,        // 0100 LD A,0x91
+        0xE0, 0x40,        // 0102 LDH (LCDC),A
+        0xC3, 0x04, 0x01,  // 0104 JP 0x0104
+    };
+    std::copy(std::begin(code), std::end(code), rom.begin() + 0x0100);
+    return rom;
+  }
+
+  std::string writeRom(const std::string &name) {
+    std::filesystem::path path = directory / name;
+    std::vector<uint8_t> rom = lcdRom();
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(rom.data()), rom.size());
+    return path.string();
+  }
+
+  std::vector<GoldenResult> runSuite(const std::vector<std::string> &paths) {
+    return runGoldenSuite(directory.string(), paths, options, 2);
+  }
+};
+
+// ✅ **Test: Golden files round-trip through text**
+TEST_F(GoldenTest, SavesAndLoads) {
+  std::string path = (directory / "a.golden").string();
+  std::vector<GoldenCheckpoint> saved = {{59, 0x0123456789ABCDEFull, 7},
+                                         {119, 1, ~0ull}};
+  ASSERT_TRUE(saveGolden(path, saved));
+
+  std::vector<GoldenCheckpoint> loaded;
+  ASSERT_TRUE(loadGolden(path, loaded));
+  ASSERT_EQ(loaded.size(), 2u);
+  EXPECT_EQ(loaded[0].frame, 59u);
+  EXPECT_EQ(loaded[0].framebufferHash, 0x0123456789ABCDEFull);
+  EXPECT_EQ(loaded[1].perceptualHash, ~0ull);
+}
+
+// ✅ **Test: Recorded goldens then verify, on several threads**
+TEST_F(GoldenTest, RecordsThenVerifies) {
+  std::vector<std::string> paths = {writeRom("a.gb"), writeRom("b.gb"),
+                                    writeRom("c.gb")};
+  std::vector<GoldenResult> missing = runSuite(paths);
+  EXPECT_FALSE(missing[0].ok);
+  EXPECT_FALSE(missing[0].error.empty());
+
+  options.update = true;
+  for (const GoldenResult &result : runSuite(paths)) {
+    EXPECT_TRUE(result.ok) << result.name << ": " << result.error;
+    EXPECT_EQ(result.checkpoints, 4u);
+  }
+
+  options.update = false;
+  for (const GoldenResult &result : runSuite(paths)) {
+    EXPECT_TRUE(result.ok) << result.name << ": " << result.error;
+    EXPECT_TRUE(result.images.empty());
+  }
+}
+
+// ✅ **Test: A changed frame fails and is written as a PNG**
+TEST_F(GoldenTest, DumpsChangedFrames) {
+  std::string rom = writeRom("a.gb");
+  options.update = true;
+  ASSERT_TRUE(runSuite({rom})[0].ok);
+
+  std::string goldenPath = (directory / "a.golden").string();
+  std::vector<GoldenCheckpoint> golden;
+  ASSERT_TRUE(loadGolden(goldenPath, golden));
+  golden[2].framebufferHash ^= 1;
+  ASSERT_TRUE(saveGolden(goldenPath, golden));
+
+  options.update = false;
+  GoldenResult result = runSuite({rom})[0];
+  EXPECT_FALSE(result.ok);
+  EXPECT_EQ(result.mismatches, 1u);
+  ASSERT_EQ(result.images.size(), 1u);
+  EXPECT_TRUE(std::filesystem::exists(result.images[0]));
+  EXPECT_NE(result.images[0].find("a.gb.frame89.png"), std::string::npos);
+
+  // The picture itself did not change, so any tolerance accepts it
+  options.tolerance = 1;
+  EXPECT_TRUE(runSuite({rom})[0].ok);
+}
+
+// ✅ **Test: A ROM's input movie sets the frames and input**
+TEST_F(GoldenTest, PlaysInputMovie) {
+  std::string rom = writeRom("a.gb");
+  GameBoy gameboy;
+  gameboy.loadRom(lcdRom());
+  MovieRecorder recorder(gameboy, 0);
+  for (int frame = 0; frame < 60; frame++) {
+    recorder.runFrame(frame % 2 ? 0x01 : 0x00);
+  }
+  ASSERT_TRUE(recorder.getMovie().save((directory / "a.gbmv").string()));
+
+  options.update = true;
+  GoldenResult result = runSuite({rom})[0];
+  EXPECT_TRUE(result.ok) << result.error;
+  EXPECT_EQ(result.checkpoints, 2u);
+}
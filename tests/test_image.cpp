@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../include/image.hpp"
+
+namespace {
+
+Image gradient(uint32_t width, uint32_t height) {
+  Image image{width, height, {}};
+  for (uint32_t y = 0; y < height; y++) {
+    for (uint32_t x = 0; x < width; x++) {
+      uint8_t value = static_cast<uint8_t>(x * 255 / width);
+      image.rgb.insert(image.rgb.end(), {value, value, value});
+    }
+  }
+  return image;
+}
+
+uint32_t bigEndian(const std::vector<uint8_t> &data, size_t offset) {
+  return data[offset] << 24 | data[offset + 1] << 16 | data[offset + 2] << 8 |
+         data[offset + 3];
+}
+
+}  // namespace
+
+// ✅ **Test: A PNG has the signature, header and stored pixel rows**
+TEST(ImageTest, EncodesPng) {
+  Image image{2, 1, {1, 2, 3, 4, 5, 6}};
+  std::vector<uint8_t> png = encodePng(image);
+
+  const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  ASSERT_GT(png.size(), sizeof(signature));
+  EXPECT_TRUE(std::equal(std::begin(signature), std::end(signature),
+                         png.begin()));
+
+  // IHDR: 13 bytes of 2x1, 8-bit RGB
+  EXPECT_EQ(bigEndian(png, 8), 13u);
+  EXPECT_EQ(std::string(png.begin() + 12, png.begin() + 16), "IHDR");
+  EXPECT_EQ(bigEndian(png, 16), 2u);
+  EXPECT_EQ(bigEndian(png, 20), 1u);
+  EXPECT_EQ(png[24], 8);
+  EXPECT_EQ(png[25], 2);
+
+  // IDAT: zlib header, one final stored block of the filtered row, Adler-32
+  size_t idat = 8 + 25;
+  EXPECT_EQ(std::string(png.begin() + idat + 4, png.begin() + idat + 8),
+            "IDAT");
+  const std::vector<uint8_t> expected = {0x78, 0x01, 0x01, 0x07, 0x00, 0xF8,
+                                         0xFF, 0x00, 1,    2,    3,    4,
+                                         5,    6,    0x00, 0x3F, 0x00, 0x16};
+  EXPECT_EQ(bigEndian(png, idat), expected.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+                         png.begin() + idat + 8));
+
+  // IEND, with its well-known CRC
+  const std::vector<uint8_t> end = {0, 0, 0, 0, 'I', 'E', 'N', 'D',
+                                    0xAE, 0x42, 0x60, 0x82};
+  EXPECT_TRUE(std::equal(end.begin(), end.end(), png.end() - end.size()));
+}
+
+// ✅ **Test: Pixel data over 64 KB is split into several stored blocks**
+TEST(ImageTest, SplitsLargeImages) {
+  Image image = gradient(200, 120);  // 72120 bytes of rows
+  std::vector<uint8_t> png = encodePng(image);
+
+  size_t block = 8 + 25 + 8 + 2;
+  EXPECT_EQ(png[block], 0x00);  // Not final
+  EXPECT_EQ(png[block + 1] | png[block + 2] << 8, 0xFFFF);
+  size_t second = block + 5 + 0xFFFF;
+  EXPECT_EQ(png[second], 0x01);  // Final
+  EXPECT_EQ(png[second + 1] | png[second + 2] << 8, 72120 - 0xFFFF);
+}
+
+// ✅ **Test: The DMG screen is captured as four greys**
+TEST(ImageTest, CapturesScreen) {
+  GameBoy gameboy;
+  Image image = captureScreen(gameboy);
+
+  EXPECT_EQ(image.width, PPU::kScreenWidth);
+  EXPECT_EQ(image.height, PPU::kScreenHeight);
+  ASSERT_EQ(image.rgb.size(), PPU::kScreenWidth * PPU::kScreenHeight * 3);
+  EXPECT_EQ(image.rgb[0], 0xFF);  // Shade 0 is white
+}
+
+// ✅ **Test: Similar images have close perceptual hashes**
+TEST(ImageTest, PerceptualHash) {
+  Image image = gradient(160, 144);
+  uint64_t hash = perceptualHash(image);
+  EXPECT_EQ(hash, ~0ull);  // Brightness rises left to right everywhere
+
+  Image touched = image;
+  touched.rgb[(70 * 160 + 80) * 3] ^= 0xFF;
+  EXPECT_LE(hashDistance(hash, perceptualHash(touched)), 2);
+
+  Image mirrored = image;
+  for (uint32_t y = 0; y < 144; y++) {
+    for (uint32_t x = 0; x < 160; x++) {
+      mirrored.rgb[(y * 160 + x) * 3] = image.rgb[(y * 160 + 159 - x) * 3];
+      mirrored.rgb[(y * 160 + x) * 3 + 1] = mirrored.rgb[(y * 160 + x) * 3];
+      mirrored.rgb[(y * 160 + x) * 3 + 2] = mirrored.rgb[(y * 160 + x) * 3];
+    }
+  }
+  EXPECT_EQ(hashDistance(hash, perceptualHash(mirrored)), 64);
+}
@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "../include/gameboy.hpp"
+#include "../include/joypad.hpp"
+#include "../include/serial.hpp"
+
+// ✅ Test Fixture for the I/O registers on a complete machine
+class IOTest : public ::testing::Test {
+ protected:
+  GameBoy gameboy;
+
+  void SetUp() override {
+    // JP 0x0000 keeps the CPU busy without touching I/O
+    gameboy.memory.writeByte(0x0000, 0xC3);
+    gameboy.memory.writeByte(0x0001, 0x00);
+    gameboy.memory.writeByte(0x0002, 0x00);
+  }
+
+  // Moves the CPU into a JR -2 loop in HRAM, where it can run during DMA
+  void runFromHighRam() {
+    gameboy.memory.writeByte(0xFF80, 0x18);
+    gameboy.memory.writeByte(0xFF81, 0xFE);
+    gameboy.cpu.PC = 0xFF80;
+  }
+};
+
+// ✅ **Test: DIV counts every 256 cycles and resets on write**
+TEST_F(IOTest, DividerFollowsClock) {
+  gameboy.runCycles(256 * 5);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF04), 5);
+
+  gameboy.memory.writeByte(0xFF04, 0x42);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF04), 0);
+}
+
+// ✅ **Test: TIMA counts at the TAC rate**
+TEST_F(IOTest, TimerCounts) {
+  gameboy.memory.writeByte(0xFF07, 0x05);  // Enabled, 16 cycles
+  gameboy.runCycles(16 * 10);
+
+  EXPECT_EQ(gameboy.memory.readByte(0xFF05), 10);
+}
+
+// ✅ **Test: TIMA overflow reloads TMA and requests the timer interrupt**
+TEST_F(IOTest, TimerOverflow) {
+  gameboy.memory.writeByte(0xFF06, 0xF0);  // TMA
+  gameboy.memory.writeByte(0xFF05, 0xFE);  // TIMA
+  gameboy.memory.writeByte(0xFF07, 0x05);  // Enabled, 16 cycles
+  gameboy.runCycles(16 * 3);
+
+  EXPECT_EQ(gameboy.memory.readByte(0xFF05), 0xF1);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF0F) & 0x04, 0x04);
+}
+
+// ✅ **Test: LY is read-only and STAT keeps its PPU-owned bits**
+TEST_F(IOTest, ReadOnlyBits) {
+  gameboy.memory.writeByte(PPU::LCDC, 0x80);
+  gameboy.runCycles(PPU::kLineCycles * 3);
+  gameboy.memory.writeByte(PPU::LY, 0x99);
+  EXPECT_EQ(gameboy.memory.readByte(PPU::LY), 3);
+
+  uint8_t mode = gameboy.memory.readByte(PPU::STAT) & 0x03;
+  gameboy.memory.writeByte(PPU::STAT, 0xFF);
+  EXPECT_EQ(gameboy.memory.readByte(PPU::STAT) & 0x03, mode);
+  EXPECT_EQ(gameboy.memory.readByte(PPU::STAT) & 0x78, 0x78);
+}
+
+// ✅ **Test: Turning the LCD off stops the PPU at line 0**
+TEST_F(IOTest, LcdOffResetsLine) {
+  gameboy.memory.writeByte(PPU::LCDC, 0x80);
+  gameboy.runCycles(PPU::kLineCycles * 20);
+  gameboy.memory.writeByte(PPU::LCDC, 0x00);
+  gameboy.runCycles(PPU::kLineCycles * 20);
+
+  EXPECT_EQ(gameboy.memory.readByte(PPU::LY), 0);
+  EXPECT_EQ(gameboy.ppu.getMode(), PPU::HBlank);
+}
+
+// ✅ **Test: OAM DMA copies 160 bytes once the transfer time has elapsed**
+TEST_F(IOTest, DmaCopiesToOam) {
+  for (uint16_t i = 0; i < 0xA0; i++) {
+    gameboy.memory.writeByte(0xC100 + i, static_cast<uint8_t>(i ^ 0x5A));
+  }
+  runFromHighRam();
+  gameboy.memory.writeByte(0xFF46, 0xC1);
+  gameboy.runCycles(IO::kDmaCycles);
+
+  for (uint16_t i = 0; i < 0xA0; i++) {
+    EXPECT_EQ(gameboy.memory.readByte(0xFE00 + i), i ^ 0x5A);
+  }
+}
+
+// ✅ **Test: During OAM DMA the CPU only reaches FF00-FFFF**
+TEST_F(IOTest, DmaLocksBus) {
+  gameboy.memory.writeByte(0xC000, 0x12);
+  runFromHighRam();
+  gameboy.memory.writeByte(0xFF46, 0xC0);
+  gameboy.runCycles(IO::kDmaCycles / 2);
+
+  EXPECT_EQ(gameboy.memory.readByte(0xC000), 0xFF);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF80), 0x18);
+  gameboy.runCycles(IO::kDmaCycles / 2);
+  EXPECT_EQ(gameboy.memory.readByte(0xC000), 0x12);
+  EXPECT_EQ(gameboy.memory.readByte(0xFE00), 0x12);
+}
+
+// ✅ **Test: Buttons set from another thread reach P1 and the interrupt**
+TEST_F(IOTest, ButtonsFromAnotherThread) {
+  gameboy.memory.writeByte(0xFF00, 0x10);  // Select action buttons
+  std::thread host([this] { gameboy.memory.io.setButtons(ButtonStart); });
+  host.join();
+  gameboy.runCycles(16);
+
+  EXPECT_EQ(gameboy.memory.readByte(0xFF00) & 0x0F, 0x07);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF0F) & 0x10, 0x10);
+}
+
+// ✅ **Test: STOP with KEY1 armed switches to double speed**
+TEST_F(IOTest, DoubleSpeed) {
+  gameboy.memory.setCgb(true);
+  gameboy.memory.writeByte(PPU::LCDC, 0x80);
+  gameboy.memory.writeByte(0xFF4D, 0x01);
+  gameboy.memory.writeByte(0x0000, 0x10);  // STOP
+  gameboy.memory.writeByte(0x0001, 0x00);
+  gameboy.memory.writeByte(0x0002, 0x18);  // JR -2
+  gameboy.memory.writeByte(0x0003, 0xFE);
+  gameboy.step();
+  EXPECT_EQ(gameboy.memory.readByte(0xFF4D), 0xFE);
+
+  // A line now takes twice as many CPU cycles; DIV keeps the CPU's rate
+  uint64_t start = gameboy.cpu.cycles;
+  gameboy.runCycles(PPU::kLineCycles * 2 * 10 - (start - 4));
+  EXPECT_EQ(gameboy.memory.readByte(PPU::LY), 10);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF04),
+            static_cast<uint8_t>(gameboy.cpu.cycles >> 8));
+}
+
+// ✅ **Test: Palette data auto-increments through palette RAM**
+TEST_F(IOTest, PaletteRam) {
+  gameboy.memory.setCgb(true);
+  gameboy.memory.writeByte(0xFF68, 0x80 | 0x3F);
+  gameboy.memory.writeByte(0xFF69, 0x12);
+  gameboy.memory.writeByte(0xFF69, 0x34);
+
+  EXPECT_EQ(gameboy.memory.io.paletteRam(false)[0x3F], 0x12);
+  EXPECT_EQ(gameboy.memory.io.paletteRam(false)[0x00], 0x34);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF68), 0x80 | 0x40 | 0x01);
+}
+
+// ✅ **Test: General purpose VRAM DMA copies at once and stalls the CPU**
+TEST_F(IOTest, GeneralDma) {
+  gameboy.memory.setCgb(true);
+  for (uint16_t i = 0; i < 0x20; i++) {
+    gameboy.memory.writeByte(0xC000 + i, static_cast<uint8_t>(i + 1));
+  }
+  gameboy.memory.writeByte(0xFF51, 0xC0);
+  gameboy.memory.writeByte(0xFF52, 0x00);
+  gameboy.memory.writeByte(0xFF53, 0x01);  // 8100
+  gameboy.memory.writeByte(0xFF54, 0x00);
+  uint64_t before = gameboy.cpu.cycles;
+  gameboy.memory.writeByte(0xFF55, 0x01);  // Two blocks
+
+  EXPECT_EQ(gameboy.cpu.cycles - before, 64u);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF55), 0xFF);
+  for (uint16_t i = 0; i < 0x20; i++) {
+    EXPECT_EQ(gameboy.memory.readByte(0x8100 + i), i + 1);
+  }
+}
+
+// ✅ **Test: HBlank DMA copies one block per line**
+TEST_F(IOTest, HBlankDma) {
+  gameboy.memory.setCgb(true);
+  for (uint16_t i = 0; i < 0x30; i++) {
+    gameboy.memory.writeByte(0xC000 + i, 0xAA);
+  }
+  gameboy.memory.writeByte(0xFF51, 0xC0);
+  gameboy.memory.writeByte(0xFF52, 0x00);
+  gameboy.memory.writeByte(0xFF53, 0x00);
+  gameboy.memory.writeByte(0xFF54, 0x00);
+  gameboy.memory.writeByte(0xFF55, 0x82);  // Three blocks, HBlank mode
+  EXPECT_EQ(gameboy.memory.readByte(0xFF55), 0x02);
+
+  gameboy.memory.writeByte(PPU::LCDC, 0x80);
+  gameboy.runCycles(PPU::kLineCycles);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF55), 0x01);
+  EXPECT_EQ(gameboy.memory.readByte(0x800F), 0xAA);
+  EXPECT_EQ(gameboy.memory.readByte(0x8010), 0x00);
+
+  gameboy.runCycles(PPU::kLineCycles * 2);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF55), 0xFF);
+  EXPECT_EQ(gameboy.memory.readByte(0x802F), 0xAA);
+}
+
+// ✅ **Test: An internally clocked transfer ends after eight bit periods**
+TEST_F(IOTest, SerialTransferWithoutPeer) {
+  gameboy.memory.writeByte(0xFF01, 0x42);
+  gameboy.memory.writeByte(0xFF02, 0x81);
+  gameboy.runCycles(8 * IO::kSerialBitCycles - 32);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF02), 0xFF);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF0F) & 0x08, 0x00);
+
+  gameboy.runCycles(32);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF01), 0xFF);  // Nothing plugged in
+  EXPECT_EQ(gameboy.memory.readByte(0xFF02), 0x7F);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF0F) & 0x08, 0x08);
+}
+
+// ✅ **Test: Without a clock from the other end a transfer never ends**
+TEST_F(IOTest, SerialWaitsForExternalClock) {
+  gameboy.memory.writeByte(0xFF02, 0x80);
+  gameboy.runCycles(8 * IO::kSerialBitCycles * 4);
+
+  EXPECT_EQ(gameboy.memory.readByte(0xFF02), 0xFE);
+  gameboy.memory.io.receiveSerial(0x5A);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF01), 0x5A);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF02), 0x7E);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF0F) & 0x08, 0x08);
+}
+
+// ✅ **Test: The CGB fast clock shifts a byte in 128 cycles**
+TEST_F(IOTest, SerialFastClock) {
+  gameboy.memory.setCgb(true);
+  gameboy.memory.writeByte(0xFF02, 0x83);
+  gameboy.runCycles(8 * IO::kFastSerialBitCycles + 4);
+
+  EXPECT_EQ(gameboy.memory.readByte(0xFF02), 0x7F);
+  EXPECT_EQ(gameboy.memory.readByte(0xFF0F) & 0x08, 0x08);
+}
+
+// ✅ **Test: A SerialLog records each byte the machine sends**
+TEST_F(IOTest, SerialLogRecordsOutput) {
+  SerialLog log;
+  gameboy.memory.io.connectSerial(&log);
+  for (char c : std::string("ok")) {
+    gameboy.memory.writeByte(0xFF01, c);
+    gameboy.memory.writeByte(0xFF02, 0x81);
+    gameboy.runCycles(8 * IO::kSerialBitCycles + 4);
+  }
+  gameboy.memory.io.connectSerial(nullptr);
+
+  EXPECT_EQ(log.output(), "ok");
+}
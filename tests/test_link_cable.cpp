@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../include/link_cable.hpp"
+
+// ✅ Test Fixture for two machines exchanging bytes over a link cable
+class LinkCableTest : public ::testing::Test {
+ protected:
+  static constexpr int kBytes = 16;
+
+  GameBoy master;
+  GameBoy slave;
+
+  void SetUp() override {
+    master.loadRom(transferLoop(0x01, 0x81));  // Internal clock
+    slave.loadRom(transferLoop(0x81, 0x80));   // External clock
+  }
+
+  // Sends kBytes bytes counting up from `first` with SC = `control`,
+  // storing each byte received at C000 onwards
+  static std::vector<uint8_t> transferLoop(uint8_t first, uint8_t control) {
+    std::vector<uint8_t> rom(0x8000, 0x00);
+    uint8_t end = first + kBytes;
+    const uint8_t code[] = {
+        0x06, first,        // 0100 LD B,first
+        0x21, 0x00, 0xC0,   // 0102 LD HL,0xC000
+        0x78,               // 0105 LD A,B
+        0xE0, 0x01,         // 0106 LDH (SB),A
+        0x3E, control,      // 0108 LD A,control
+        0xE0, 0x02,         // 010A LDH (SC),A
+        0xF0, 0x02,         // 010C LDH A,(SC)
+        0xE6, 0x80,         // 010E AND 0x80
+        0x20, 0xFA,         // 0110 JR NZ,0x010C
+        0xF0, 0x01,         // 0112 LDH A,(SB)
+        0x77,               // 0114 LD (HL),A
+        0x23,               // 0115 INC HL
+        0x04,               // 0116 INC B
+        0x78,               // 0117 LD A,B
+        0xFE, end,          // 0118 CP end
+        0x20, 0xE9,         // 011A JR NZ,0x0105
+        0x18, 0xFE,         // 011C JR -2
+    };
+    std::copy(std::begin(code), std::end(code), rom.begin() + 0x0100);
+    return rom;
+  }
+
+  // Checks that each machine received the other's bytes, in order
+  void expectExchanged() {
+    for (int i = 0; i < kBytes; i++) {
+      EXPECT_EQ(master.memory.readByte(0xC000 + i), 0x81 + i) << i;
+      EXPECT_EQ(slave.memory.readByte(0xC000 + i), 0x01 + i) << i;
+    }
+  }
+
+  static constexpr uint64_t kRunCycles = 8 * IO::kSerialBitCycles * 20;
+};
+
+// ✅ **Test: Machines stepped in lockstep exchange every byte**
+TEST_F(LinkCableTest, ExchangesInLockstep) {
+  LinkCable cable(master, slave);
+  cable.run(kRunCycles);
+
+  expectExchanged();
+}
+
+// ✅ **Test: Lockstep runs are deterministic**
+TEST_F(LinkCableTest, LockstepIsDeterministic) {
+  GameBoy otherMaster;
+  GameBoy otherSlave;
+  otherMaster.loadRom(transferLoop(0x01, 0x81));
+  otherSlave.loadRom(transferLoop(0x81, 0x80));
+  LinkCable cable(master, slave);
+  LinkCable otherCable(otherMaster, otherSlave);
+  cable.run(kRunCycles);
+  otherCable.run(kRunCycles);
+
+  EXPECT_EQ(master.stateHash(), otherMaster.stateHash());
+  EXPECT_EQ(slave.stateHash(), otherSlave.stateHash());
+}
+
+// ✅ **Test: Machines on separate threads exchange every byte**
+TEST_F(LinkCableTest, ExchangesAcrossThreads) {
+  LinkCable cable(master, slave, 512);
+  std::thread masterThread([&] { master.runCycles(kRunCycles); });
+  std::thread slaveThread([&] { slave.runCycles(kRunCycles); });
+  masterThread.join();
+  slaveThread.join();
+
+  expectExchanged();
+}
+
+// ✅ **Test: Disconnecting releases a machine waiting for the other**
+TEST_F(LinkCableTest, DisconnectReleasesWaiter) {
+  LinkCable cable(master, slave);
+  std::thread masterThread([&] { master.runCycles(kRunCycles); });
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (cable.waits() == 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  EXPECT_GT(cable.waits(), 0u);  // Stuck a skew ahead of the idle slave
+
+  cable.disconnect();
+  masterThread.join();
+  EXPECT_GE(master.cpu.cycles, kRunCycles);
+}
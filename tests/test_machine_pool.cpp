@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../include/joypad.hpp"
+#include "../include/machine_pool.hpp"
+
+// ✅ Test Fixture: a snapshot of a ROM that logs P1 reads to C000-C0FF
+class MachinePoolTest : public ::testing::Test {
+ protected:
+  GameBoy snapshot;
+
+  void SetUp() override {
+    std::vector<uint8_t> rom(0x8000, 0x00);
+    const uint8_t program[] = {
+        0x3E, 0x91,        // 0100 LD A,0x91
+        0xE0, 0x40,        // 0102 LDH (LCDC),A
+        0x3E, 0x10,        // 0104 LD A,0x10
+        0xE0, 0x00,        // 0106 LDH (P1),A
+        0x21, 0x00, 0xC0,  // 0108 LD HL,0xC000
+        0xF0, 0x00,        // 010B LDH A,(P1)
+        0x77,              // 010D LD (HL),A
+        0x2C,              // 010E INC L
+        0xC3, 0x0B, 0x01,  // 010F JP 0x010B
+    };
+    std::copy(std::begin(program), std::end(program), rom.begin() + 0x100);
+    snapshot.loadRom(rom);
+    snapshot.fastBoot();
+    snapshot.runFrame();
+  }
+
+  // A short job whose result depends on its input
+  static uint64_t runJob(GameBoy &machine, size_t job) {
+    machine.memory.io.setButtons(job % 2 ? ButtonA : 0);
+    for (int frame = 0; frame < 3; frame++) {
+      machine.runFrame();
+    }
+    return machine.stateHash();
+  }
+};
+
+// ✅ **Test: Every acquired machine starts in the snapshot's state**
+TEST_F(MachinePoolTest, ResetsToSnapshot) {
+  MachinePool pool(snapshot, 1);
+  uint64_t first;
+  {
+    MachinePool::Lease machine = pool.acquire();
+    EXPECT_EQ(machine->stateHash(), snapshot.stateHash());
+    first = runJob(*machine, 1);
+    EXPECT_NE(first, snapshot.stateHash());
+  }
+  MachinePool::Lease machine = pool.acquire();
+  EXPECT_EQ(machine->stateHash(), snapshot.stateHash());
+  EXPECT_EQ(runJob(*machine, 1), first);
+  EXPECT_EQ(pool.size(), 1u);
+}
+
+// ✅ **Test: The pool constructs machines only when all are on loan**
+TEST_F(MachinePoolTest, GrowsWhenEmpty) {
+  MachinePool pool(snapshot);
+  {
+    MachinePool::Lease a = pool.acquire();
+    MachinePool::Lease b = pool.acquire();
+    EXPECT_EQ(pool.size(), 2u);
+  }
+  MachinePool::Lease c = pool.acquire();
+  EXPECT_EQ(pool.size(), 2u);
+}
+
+// ✅ **Test: Pooled jobs on several threads match jobs on fresh machines**
+TEST_F(MachinePoolTest, JobsMatchFreshMachines) {
+  constexpr size_t kJobs = 16;
+  MachinePool pool(snapshot, 2);
+  std::vector<uint64_t> pooled(kJobs);
+  runJobs(pool, kJobs, 3, [&](size_t job, GameBoy &machine) {
+    pooled[job] = runJob(machine, job);
+  });
+
+  for (size_t job = 0; job < kJobs; job++) {
+    std::unique_ptr<GameBoy> fresh = snapshot.fork();
+    EXPECT_EQ(runJob(*fresh, job), pooled[job]);
+  }
+  EXPECT_LE(pool.size(), 3u);
+}
@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/joypad.hpp"
 #include "../include/memory.hpp"
+#include "../include/save_state.hpp"
 
 class MemoryTest : public ::testing::Test {
  protected:
@@ -27,13 +33,244 @@ TEST_F(MemoryTest, ReadWriteWord) {
 TEST_F(MemoryTest, DefaultMemoryZero) { EXPECT_EQ(mem.readByte(0x5000), 0x00); }
 
 // Test: Writing to Echo RAM (`E000-FDFF`) should affect `C000-DDFF`
-// TEST_F(MemoryTest, EchoRAM) {
-//     mem.writeByte(0xC000, 0x77);
-//     EXPECT_EQ(mem.readByte(0xE000), 0x77);
-// }
+TEST_F(MemoryTest, EchoRAM) {
+  mem.writeByte(0xC000, 0x77);
+  EXPECT_EQ(mem.readByte(0xE000), 0x77);
+}
 
 // Test: High RAM (`FF80-FFFE`)
 TEST_F(MemoryTest, HighRAM) {
   mem.writeByte(0xFF80, 0x55);
   EXPECT_EQ(mem.readByte(0xFF80), 0x55);
-}
\ No newline at end of file
+}
+// Test: P1 reports the buttons of the selected group, active low
+TEST_F(MemoryTest, Joypad) {
+  mem.setButtons(ButtonA | ButtonDown);
+
+  mem.writeByte(0xFF00, 0x10);  // Select action buttons
+  EXPECT_EQ(mem.readByte(0xFF00), 0xDE);
+
+  mem.writeByte(0xFF00, 0x20);  // Select d-pad
+  EXPECT_EQ(mem.readByte(0xFF00), 0xE7);
+
+  mem.writeByte(0xFF00, 0x30);  // Select neither
+  EXPECT_EQ(mem.readByte(0xFF00), 0xFF);
+}
+
+// Test: Pressing a selected button requests the joypad interrupt
+TEST_F(MemoryTest, JoypadInterrupt) {
+  mem.writeByte(0xFF00, 0x10);  // Select action buttons
+  mem.setButtons(ButtonUp);
+  EXPECT_EQ(mem.readByte(0xFF0F) & 0x10, 0);
+
+  mem.setButtons(ButtonUp | ButtonStart);
+  EXPECT_EQ(mem.readByte(0xFF0F) & 0x10, 0x10);
+}
+
+// Test: Block transfers copy across page boundaries and into OAM
+TEST_F(MemoryTest, Transfer) {
+  for (uint16_t i = 0; i < 0x200; i++) {
+    mem.writeByte(0xC080 + i, static_cast<uint8_t>(i));
+  }
+  mem.transfer(0x8010, 0xC080, 0x200);
+  mem.transfer(0xFE00, 0xC080, 0xA0);
+
+  for (uint16_t i = 0; i < 0x200; i++) {
+    EXPECT_EQ(mem.readByte(0x8010 + i), static_cast<uint8_t>(i));
+  }
+  for (uint16_t i = 0; i < 0xA0; i++) {
+    EXPECT_EQ(mem.readByte(0xFE00 + i), static_cast<uint8_t>(i));
+  }
+}
+
+// Test: A locked bus leaves only FF00-FFFF to the CPU
+TEST_F(MemoryTest, LockedBus) {
+  mem.writeByte(0xC000, 0x12);
+  mem.writeByte(0xFF80, 0x34);
+  mem.lockBus(true);
+
+  EXPECT_EQ(mem.readByte(0xC000), 0xFF);
+  EXPECT_EQ(mem.readByte(0xFE00), 0xFF);
+  EXPECT_EQ(mem.readByte(0xFF80), 0x34);
+  mem.writeByte(0xC000, 0x56);
+  EXPECT_EQ(mem.peek(0xC000), 0x12);
+
+  mem.lockBus(false);
+  EXPECT_EQ(mem.readByte(0xC000), 0x12);
+}
+
+// Test: VBK switches VRAM banks in CGB mode only
+TEST_F(MemoryTest, VramBanks) {
+  mem.writeByte(0x8000, 0x11);
+  mem.writeByte(0xFF4F, 0x01);
+  EXPECT_EQ(mem.readByte(0x8000), 0x11);  // DMG: no bank 1
+
+  mem.setCgb(true);
+  mem.writeByte(0xFF4F, 0x01);
+  EXPECT_EQ(mem.readByte(0xFF4F), 0xFF);
+  mem.writeByte(0x8000, 0x22);
+  EXPECT_EQ(mem.videoRam(1)[0], 0x22);
+
+  mem.writeByte(0xFF4F, 0x00);
+  EXPECT_EQ(mem.readByte(0x8000), 0x11);
+}
+
+// Test: SVBK switches D000-DFFF and its echo; 0 selects bank 1
+TEST_F(MemoryTest, WramBanks) {
+  mem.setCgb(true);
+  mem.writeByte(0xD000, 0x11);
+  mem.writeByte(0xFF70, 0x03);
+  mem.writeByte(0xD000, 0x33);
+  EXPECT_EQ(mem.readByte(0xF000), 0x33);
+
+  mem.writeByte(0xFF70, 0x00);
+  EXPECT_EQ(mem.readByte(0xFF70), 0xF8);
+  EXPECT_EQ(mem.readByte(0xD000), 0x11);
+}
+
+// Test: Copies keep their own bank mapping
+TEST_F(MemoryTest, CopyRemapsBanks) {
+  mem.setCgb(true);
+  mem.writeByte(0xFF70, 0x02);
+  mem.writeByte(0xD000, 0x22);
+
+  Memory copy = mem;
+  copy.writeByte(0xD000, 0x44);
+  EXPECT_EQ(mem.readByte(0xD000), 0x22);
+  EXPECT_EQ(copy.readByte(0xD000), 0x44);
+}
+
+// Test: A fork shares RAM until either side writes
+TEST_F(MemoryTest, ForkCopiesOnWrite) {
+  const uint16_t addresses[] = {0x8000, 0xA000, 0xC000, 0xD000, 0xE010};
+  for (uint16_t address : addresses) {
+    mem.writeByte(address, 0x11);
+  }
+
+  Memory fork = mem.fork();
+  for (uint16_t address : addresses) {
+    EXPECT_EQ(fork.readByte(address), 0x11);
+    fork.writeByte(address, 0x22);
+    EXPECT_EQ(mem.readByte(address), 0x11);
+  }
+  mem.writeByte(0xC001, 0x33);
+  EXPECT_EQ(fork.readByte(0xC001), 0x00);
+  EXPECT_EQ(fork.readByte(0xC010), 0x22);  // Written through the echo
+}
+
+// Test: Forking and writing forks is safe across threads
+TEST_F(MemoryTest, ForkFromThreads) {
+  mem.writeByte(0xC000, 0x11);
+  std::vector<std::thread> workers;
+  std::vector<int> mismatches(4);
+  for (int worker = 0; worker < 4; worker++) {
+    workers.emplace_back([this, worker, &mismatches] {
+      for (int i = 0; i < 200; i++) {
+        Memory fork = mem.fork();
+        Memory grandchild = fork.fork();
+        fork.writeByte(0xC000, static_cast<uint8_t>(worker));
+        mismatches[worker] += grandchild.readByte(0xC000) != 0x11;
+        mismatches[worker] += fork.readByte(0xC000) != worker;
+      }
+    });
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  for (int count : mismatches) {
+    EXPECT_EQ(count, 0);
+  }
+  EXPECT_EQ(mem.readByte(0xC000), 0x11);
+}
+
+// Test: A boot ROM covers the cartridge until FF50 is written
+TEST_F(MemoryTest, BootRomUnmaps) {
+  std::vector<uint8_t> rom(0x8000, 0x00);
+  rom[0x0000] = 0x11;
+  rom[0x0100] = 0x12;
+  mem.loadRom(rom);
+  EXPECT_FALSE(mem.mapBootRom(
+      std::make_shared<const std::vector<uint8_t>>(0x200, 0x22)));
+  ASSERT_TRUE(mem.mapBootRom(
+      std::make_shared<const std::vector<uint8_t>>(0x100, 0x22)));
+
+  EXPECT_EQ(mem.readByte(0x0000), 0x22);
+  EXPECT_EQ(mem.readByte(0x00FF), 0x22);
+  EXPECT_EQ(mem.readByte(0x0100), 0x12);
+  mem.writeByte(0x0000, 0x33);
+  EXPECT_EQ(mem.readByte(0x0000), 0x22);  // Not writable
+
+  Memory fork = mem.fork();
+  mem.writeByte(0xFF50, 0x01);
+  EXPECT_FALSE(mem.isBootRomMapped());
+  EXPECT_EQ(mem.readByte(0x0000), 0x11);
+  EXPECT_EQ(fork.readByte(0x0000), 0x22);  // Forks keep their own mapping
+  EXPECT_TRUE(fork.isBootRomMapped());
+}
+
+// Test: A CGB boot ROM leaves the cartridge header visible
+TEST_F(MemoryTest, CgbBootRomSkipsHeader) {
+  std::vector<uint8_t> rom(0x8000, 0x11);
+  rom[0x0147] = 0x00;  // No MBC
+  mem.loadRom(rom);
+  ASSERT_TRUE(mem.mapBootRom(
+      std::make_shared<const std::vector<uint8_t>>(0x900, 0x22)));
+
+  EXPECT_EQ(mem.readByte(0x00FF), 0x22);
+  EXPECT_EQ(mem.readByte(0x0100), 0x11);
+  EXPECT_EQ(mem.readByte(0x01FF), 0x11);
+  EXPECT_EQ(mem.readByte(0x0200), 0x22);
+  EXPECT_EQ(mem.readByte(0x08FF), 0x22);
+  EXPECT_EQ(mem.readByte(0x0900), 0x11);
+}
+
+// Test: A work RAM bank stays put under writes, and through it writes land
+TEST_F(MemoryTest, WorkRamStaysPut) {
+  Memory fork = mem.fork();  // Leaves every page shared
+  uint8_t *bank0 = mem.workRam(0);
+  uint8_t *bank1 = mem.workRam(1);
+  mem.writeByte(0xC123, 0x11);
+  mem.writeByte(0xD456, 0x22);
+  EXPECT_EQ(bank0[0x123], 0x11);
+  EXPECT_EQ(bank1[0x456], 0x22);
+  EXPECT_EQ(mem.workRam(0), bank0);
+
+  bank0[0x789] = 0x33;
+  EXPECT_EQ(mem.readByte(0xC789), 0x33);
+  EXPECT_EQ(mem.readByte(0xE789), 0x33);  // The echo
+  EXPECT_EQ(fork.readByte(0xC789), 0x00);
+}
+
+// ✅ **Test: A pinned bank keeps its storage through loads and assignments**
+TEST_F(MemoryTest, WorkRamSurvivesLoads) {
+  uint8_t *bank0 = mem.workRam(0);
+  {
+    Memory fork = mem.fork();
+    fork.writeByte(0xC001, 0x09);
+  }
+  bank0[0x000] = 0x01;
+  EXPECT_EQ(mem.peek(0xC000), 0x01);
+  EXPECT_EQ(mem.peek(0xC001), 0x00);
+
+  // All zeros, which would otherwise go back to the shared zero page
+  StateWriter out;
+  Memory().saveState(out);
+  StateReader in(out.data());
+  std::string error;
+  ASSERT_TRUE(mem.loadState(in, error)) << error;
+  EXPECT_EQ(bank0[0x000], 0x00);
+  bank0[0x005] = 0x07;
+  EXPECT_EQ(mem.peek(0xC005), 0x07);
+
+  Memory other;
+  other.writeByte(0xC010, 0x44);
+  uint8_t *otherBank0 = other.workRam(0);
+  mem = other;
+  EXPECT_EQ(bank0[0x010], 0x44);
+  other.writeByte(0xC020, 0x55);  // Still other's own storage
+  EXPECT_EQ(otherBank0[0x020], 0x55);
+  EXPECT_EQ(mem.peek(0xC020), 0x00);
+  EXPECT_EQ(mem.workRam(0), bank0);
+  EXPECT_EQ(other.workRam(0), otherBank0);
+}
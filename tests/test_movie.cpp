@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include "../include/gameboy.hpp"
+#include "../include/joypad.hpp"
+#include "../include/movie.hpp"
+
+// ✅ Test Fixture for input movies
+class MovieTest : public ::testing::Test {
+ protected:
+  // Turns the LCD on, then copies P1 into BGP forever, so the picture
+  // depends on the buttons held
+  static void loadProgram(GameBoy &gameboy) {
+    const uint8_t program[] = {
+        0x3E, 0x91,        // LD A,0x91
+        0xE0, 0x40,        // LDH (LCDC),A
+        0xF0, 0x00,        // LDH A,(P1)
+        0xE0, 0x47,        // LDH (BGP),A
+        0xC3, 0x04, 0x00,  // JP 0x0004
+    };
+    for (uint16_t i = 0; i < sizeof(program); i++) {
+      gameboy.memory.writeByte(i, program[i]);
+    }
+    loadTile(gameboy);
+  }
+
+  // Turns the LCD on with the VBlank interrupt enabled, then polls LY in an
+  // idle loop; the handler copies DIV into BGP, so the picture depends on
+  // when each interrupt is taken
+  static void loadInterruptProgram(GameBoy &gameboy) {
+    const uint8_t program[] = {
+        0x31, 0x00, 0xD0,  // 0000 LD SP,0xD000
+        0x3E, 0x01,        // 0003 LD A,0x01
+        0xE0, 0xFF,        // 0005 LDH (IE),A
+        0x3E, 0x91,        // 0007 LD A,0x91
+        0xE0, 0x40,        // 0009 LDH (LCDC),A
+        0xFB,              // 000B EI
+        0xF0, 0x44,        // 000C LDH A,(LY)
+        0xFE, 0xFF,        // 000E CP 0xFF
+        0x20, 0xFA,        // 0010 JR NZ,-6
+    };
+    const uint8_t handler[] = {
+        0xF0, 0x04,  // 0040 LDH A,(DIV)
+        0xE0, 0x47,  // 0042 LDH (BGP),A
+        0xD9,        // 0044 RETI
+    };
+    for (uint16_t i = 0; i < sizeof(program); i++) {
+      gameboy.memory.writeByte(i, program[i]);
+    }
+    for (uint16_t i = 0; i < sizeof(handler); i++) {
+      gameboy.memory.writeByte(0x40 + i, handler[i]);
+    }
+    loadTile(gameboy);
+  }
+
+  static void loadTile(GameBoy &gameboy) {
+    for (uint16_t row = 0; row < 8; row++) {
+      gameboy.memory.writeByte(0x8000 + row * 2, 0xFF);  // Tile 0: color 1
+    }
+  }
+
+  static Movie record(const std::vector<uint8_t> &inputs) {
+    GameBoy gameboy;
+    loadProgram(gameboy);
+    MovieRecorder recorder(gameboy, 2);
+    for (uint8_t buttons : inputs) {
+      recorder.runFrame(buttons);
+    }
+    return recorder.getMovie();
+  }
+};
+
+// ✅ **Test: A recording replays bit-exactly on a fresh machine**
+TEST_F(MovieTest, ReplayMatches) {
+  Movie movie = record({0, ButtonA, ButtonA | ButtonB, 0, ButtonStart, 0});
+  ASSERT_EQ(movie.checkpoints.size(), 3u);
+
+  GameBoy gameboy;
+  loadProgram(gameboy);
+  ReplayResult result = playMovie(gameboy, movie);
+
+  EXPECT_TRUE(result.ok) << result.error;
+  EXPECT_EQ(result.framesPlayed, 6u);
+  EXPECT_EQ(result.checkpointsVerified, 3u);
+}
+
+// ✅ **Test: Idle-loop skipping does not change what a movie replays**
+TEST_F(MovieTest, ReplayMatchesAcrossIdleLoopSkipping) {
+  for (bool recordSkipping : {false, true}) {
+    GameBoy recorded;
+    recorded.idleLoopSkipping = recordSkipping;
+    loadInterruptProgram(recorded);
+    MovieRecorder recorder(recorded, 1);
+    for (int frame = 0; frame < 12; frame++) {
+      recorder.runFrame(frame % 3 ? 0 : ButtonA);
+    }
+
+    GameBoy gameboy;
+    gameboy.idleLoopSkipping = !recordSkipping;
+    loadInterruptProgram(gameboy);
+    ReplayResult result = playMovie(gameboy, recorder.getMovie());
+
+    EXPECT_TRUE(result.ok) << result.error;
+    EXPECT_EQ(result.checkpointsVerified, 12u);
+    EXPECT_EQ(recorded.skippedIdleCycles > 0, recordSkipping);
+    EXPECT_EQ(gameboy.skippedIdleCycles > 0, !recordSkipping);
+  }
+}
+
+// ✅ **Test: Different input is caught at the next checkpoint**
+TEST_F(MovieTest, DetectsDivergence) {
+  Movie movie = record({0, 0, ButtonA, ButtonA});
+  movie.inputs[3] = ButtonSelect;
+
+  GameBoy gameboy;
+  loadProgram(gameboy);
+  ReplayResult result = playMovie(gameboy, movie);
+
+  EXPECT_FALSE(result.ok);
+  EXPECT_EQ(result.checkpointsVerified, 1u);
+  EXPECT_EQ(result.framesPlayed, 4u);
+}
+
+// ✅ **Test: A different starting state is rejected**
+TEST_F(MovieTest, DetectsWrongStart) {
+  Movie movie = record({0, 0});
+
+  GameBoy gameboy;
+  ReplayResult result = playMovie(gameboy, movie);
+
+  EXPECT_FALSE(result.ok);
+  EXPECT_EQ(result.framesPlayed, 0u);
+}
+
+// ✅ **Test: Save and load round trip**
+TEST_F(MovieTest, SaveLoad) {
+  Movie movie = record({ButtonUp, ButtonDown, 0, ButtonLeft});
+  std::string path = ::testing::TempDir() + "movie_test.gbm";
+  ASSERT_TRUE(movie.save(path));
+
+  Movie loaded;
+  ASSERT_TRUE(loaded.load(path));
+  std::remove(path.c_str());
+
+  EXPECT_EQ(loaded.initialStateHash, movie.initialStateHash);
+  EXPECT_EQ(loaded.inputs, movie.inputs);
+  ASSERT_EQ(loaded.checkpoints.size(), movie.checkpoints.size());
+  for (size_t i = 0; i < movie.checkpoints.size(); i++) {
+    EXPECT_EQ(loaded.checkpoints[i].frame, movie.checkpoints[i].frame);
+    EXPECT_EQ(loaded.checkpoints[i].framebufferHash,
+              movie.checkpoints[i].framebufferHash);
+  }
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "../include/cpu.hpp"
+#include "../include/gameboy.hpp"
+#include "../include/memory.hpp"
+#include "../include/perf_counters.hpp"
+
+// ✅ **Test: Memory map regions**
+TEST(PerfCountersTest, RegionOf) {
+  EXPECT_EQ(regionOf(0x0150), Region::Rom);
+  EXPECT_EQ(regionOf(0x9800), Region::VRam);
+  EXPECT_EQ(regionOf(0xC000), Region::WRam);
+  EXPECT_EQ(regionOf(0xFE00), Region::Oam);
+  EXPECT_EQ(regionOf(0xFF44), Region::IO);
+  EXPECT_EQ(regionOf(0xFF80), Region::HRam);
+  EXPECT_EQ(regionOf(0xFFFF), Region::IE);
+}
+
+// ✅ **Test: Exporters include every counter**
+TEST(PerfCountersTest, Export) {
+  PerfCounters counters;
+  counters.countOpcode(0x3E, 8);
+  counters.countRead(0xC000);
+  counters.countHalt(16);
+
+  std::ostringstream json;
+  writeCountersJson(json, counters);
+  EXPECT_NE(json.str().find("\"opcode\": \"0x3E\", \"count\": 1, \"cycles\": 8"),
+            std::string::npos);
+  EXPECT_NE(json.str().find("\"haltCycles\": 16"), std::string::npos);
+
+  std::ostringstream csv;
+  writeCountersCsv(csv, counters);
+  EXPECT_NE(csv.str().find("opcode,0x3E,1,8\n"), std::string::npos);
+  EXPECT_NE(csv.str().find("read,wram,1,\n"), std::string::npos);
+}
+
+#ifdef GB_INSTRUMENTATION
+// ✅ **Test: The CPU and bus feed the counters when compiled in**
+TEST(PerfCountersTest, CountsExecution) {
+  Memory memory;
+  CPU cpu{memory};
+  memory.writeByte(0x0000, 0xFA);  // LD A, (0xC000)
+  memory.writeByte(0x0001, 0x00);
+  memory.writeByte(0x0002, 0xC0);
+  memory.writeByte(0x0003, 0x76);  // HALT
+  memory.counters.reset();
+
+  cpu.executeOpcode();
+  cpu.executeOpcode();
+  cpu.executeOpcode();
+
+  const PerfCounters &counters = memory.counters;
+  EXPECT_EQ(counters.opcodeCount[0xFA], 1u);
+  EXPECT_EQ(counters.opcodeCycles[0xFA], 16u);
+  EXPECT_EQ(counters.opcodeCount[0x76], 1u);
+  EXPECT_EQ(counters.haltCycles, 4u);
+  EXPECT_EQ(counters.reads[static_cast<size_t>(Region::WRam)], 1u);
+  EXPECT_EQ(counters.reads[static_cast<size_t>(Region::Rom)], 4u);
+}
+
+// ✅ **Test: Skipping an idle loop counts only the iterations that ran**
+TEST(PerfCountersTest, IdleLoopSkipIsUncounted) {
+  GameBoy gameboy;
+  gameboy.memory.writeByte(0xFF40, 0x80);  // LCDC: on
+  const uint8_t program[] = {
+      0xF0, 0x44,  // LDH A,(LY)
+      0xFE, 0x90,  // CP 0x90
+      0x20, 0xFA,  // JR NZ,-6
+  };
+  for (uint16_t address = 0; address < sizeof(program); address++) {
+    gameboy.memory.writeByte(address, program[address]);
+  }
+  gameboy.memory.counters.reset();
+  gameboy.runFrame();
+
+  // Once LY reaches 0x90 the loop falls through into NOPs
+  const PerfCounters &counters = gameboy.memory.counters;
+  uint64_t loads = counters.opcodeCount[0xF0];
+  uint64_t fetched = 2 * (loads + counters.opcodeCount[0xFE] +
+                          counters.opcodeCount[0x20]) +
+                     counters.opcodeCount[0x00];
+  EXPECT_GT(gameboy.skippedIdleCycles, 0u);
+  EXPECT_EQ(counters.reads[static_cast<size_t>(Region::Rom)], fetched);
+  EXPECT_EQ(counters.reads[static_cast<size_t>(Region::IO)], loads);
+}
+#endif
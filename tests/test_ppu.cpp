@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include "../include/memory.hpp"
+#include "../include/ppu.hpp"
+
+// ✅ Test Fixture for PPU
+class PPUTest : public ::testing::Test {
+ protected:
+  Memory memory;
+  PPU ppu{memory};
+};
+
+// ✅ **Test: Mode sequence within a visible line**
+TEST_F(PPUTest, VisibleLineModes) {
+  EXPECT_EQ(ppu.reset(), PPU::kOamScanCycles);
+  EXPECT_EQ(memory.readByte(PPU::STAT) & 0x03, PPU::OamScan);
+
+  EXPECT_EQ(ppu.advanceMode(), PPU::kTransferCycles);
+  EXPECT_EQ(memory.readByte(PPU::STAT) & 0x03, PPU::Transfer);
+
+  EXPECT_EQ(ppu.advanceMode(), PPU::kHBlankCycles);
+  EXPECT_EQ(memory.readByte(PPU::STAT) & 0x03, PPU::HBlank);
+
+  EXPECT_EQ(ppu.advanceMode(), PPU::kOamScanCycles);
+  EXPECT_EQ(memory.readByte(PPU::LY), 1);
+}
+
+// ✅ **Test: LY=LYC sets the coincidence flag and requests STAT**
+TEST_F(PPUTest, Coincidence) {
+  memory.writeByte(PPU::LYC, 1);
+  memory.writeByte(PPU::STAT, 0x40);
+  ppu.reset();
+  EXPECT_EQ(memory.readByte(PPU::STAT) & 0x04, 0);
+
+  for (int i = 0; i < 3; i++) {
+    ppu.advanceMode();
+  }
+
+  EXPECT_EQ(memory.readByte(PPU::STAT) & 0x04, 0x04);
+  EXPECT_EQ(memory.readByte(PPU::IF) & 0x02, 0x02);
+}
+
+// ✅ **Test: Background tiles are drawn through BGP**
+TEST_F(PPUTest, RendersBackground) {
+  memory.writeByte(PPU::LCDC, 0x91);  // LCD, unsigned tile data, BG on
+  memory.writeByte(PPU::BGP, 0xE4);   // Identity palette
+  memory.writeByte(0x9800, 0x01);     // First map entry uses tile 1
+  for (uint16_t row = 0; row < 8; row++) {
+    memory.writeByte(0x8010 + row * 2, 0xF0);  // Tile 1: color 3 | color 2
+    memory.writeByte(0x8010 + row * 2 + 1, 0xFF);
+  }
+  ppu.reset();
+  ppu.advanceMode();
+  ppu.advanceMode();  // Line 0 is drawn entering HBlank
+
+  const auto &framebuffer = ppu.getFramebuffer();
+  EXPECT_EQ(framebuffer[0], 3);
+  EXPECT_EQ(framebuffer[4], 2);
+  EXPECT_EQ(framebuffer[8], 0);
+}
+
+// ✅ **Test: CGB tiles use their attributes' palette, bank and flips**
+TEST_F(PPUTest, RendersCgbAttributes) {
+  memory.setCgb(true);
+  memory.writeByte(PPU::LCDC, 0x91);
+  memory.writeByte(0xFF4F, 0x01);   // VRAM bank 1
+  memory.writeByte(0x9800, 0x2A);   // Palette 2, tile data bank 1, X flip
+  memory.writeByte(0x8000, 0xF0);   // Tile 0 in bank 1: color 1 | color 0
+  memory.writeByte(0xFF4F, 0x00);
+  memory.writeByte(0xFF68, 0x80 | (2 * 8 + 2));  // Palette 2, color 1
+  memory.writeByte(0xFF69, 0x1F);   // Red
+  memory.writeByte(0xFF69, 0x00);
+  ppu.reset();
+  ppu.advanceMode();
+  ppu.advanceMode();
+
+  const auto &framebuffer = ppu.getFramebuffer();
+  EXPECT_EQ(framebuffer[0], 0x0000);  // Flipped: color 0 first
+  EXPECT_EQ(framebuffer[4], 0x001F);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/gameboy.hpp"
+#include "../include/profiler.hpp"
+
+namespace {
+
+using Block = std::pair<size_t, std::vector<uint8_t>>;
+
+std::vector<uint8_t> makeRom(size_t size, std::vector<Block> blocks) {
+  std::vector<uint8_t> rom(size, 0x00);
+  for (const auto &[offset, bytes] : blocks) {
+    std::copy(bytes.begin(), bytes.end(), rom.begin() + offset);
+  }
+  return rom;
+}
+
+std::string collapsed(const Profiler &profiler) {
+  std::ostringstream out;
+  profiler.writeCollapsed(out);
+  return out.str();
+}
+
+// main calls 0200, which calls a loop in ROM bank 2
+std::vector<uint8_t> nestedCallRom() {
+  std::vector<uint8_t> rom = makeRom(
+      0x10000, {{0x0100,
+                 {
+                     0x3E, 0x02,        // 0100 LD A,2
+                     0xEA, 0x00, 0x20,  // 0102 LD ($2000),A
+                     0xCD, 0x00, 0x02,  // 0105 CALL $0200
+                     0xC3, 0x05, 0x01,  // 0108 JP $0105
+                 }},
+                {0x0200,
+                 {
+                     0xCD, 0x00, 0x40,  // 0200 CALL $4000
+                     0x06, 0x10,        // 0203 LD B,16
+                     0x05,              // 0205 DEC B
+                     0xC2, 0x05, 0x02,  // 0206 JP NZ,$0205
+                     0xC9,              // 0209 RET
+                 }},
+                {0x8000,
+                 {
+                     0x06, 0x40,        // 02:4000 LD B,64
+                     0x05,              // 02:4002 DEC B
+                     0xC2, 0x02, 0x40,  // 02:4003 JP NZ,$4002
+                     0xC9,              // 02:4006 RET
+                 }}});
+  rom[0x0147] = 0x01;  // MBC1
+  return rom;
+}
+
+}  // namespace
+
+// ✅ **Test: Samples are attributed to call stacks, PCs and banks**
+TEST(ProfilerTest, RecordsCallStacks) {
+  GameBoy gameboy;
+  gameboy.loadRom(nestedCallRom());
+  Profiler profiler(gameboy, 61);
+  gameboy.runCycles(200000);
+
+  EXPECT_GE(profiler.samples(), 200000u / 61 - 1);
+  std::string stacks = collapsed(profiler);
+  EXPECT_NE(stacks.find("main;00:0200;02:4000 "), std::string::npos);
+  EXPECT_NE(stacks.find("main;00:0200 "), std::string::npos);
+  EXPECT_NE(stacks.find("main "), std::string::npos);
+
+  std::vector<std::pair<RomLocation, uint64_t>> spots = profiler.hotSpots();
+  ASSERT_FALSE(spots.empty());
+  EXPECT_EQ(spots[0].first.bank, 2);
+  EXPECT_GE(spots[0].first.address, 0x4002);
+  EXPECT_LE(spots[0].first.address, 0x4003);
+  EXPECT_EQ(profiler.hotBanks()[0].first, 2);
+
+  uint64_t total = 0;
+  for (const auto &[location, count] : spots) {
+    total += count;
+  }
+  EXPECT_EQ(total, profiler.samples());
+}
+
+// ✅ **Test: Interrupt handlers appear as calls**
+TEST(ProfilerTest, AttributesInterrupts) {
+  GameBoy gameboy;
+  gameboy.loadRom(makeRom(
+      0x8000, {{0x0040, {0xCD, 0x00, 0x03, 0xD9}},  // CALL $0300; RETI
+               {0x0100,
+                {
+                    0x3E, 0x91,        // 0100 LD A,$91
+                    0xE0, 0x40,        // 0102 LDH (LCDC),A
+                    0x3E, 0x01,        // 0104 LD A,1
+                    0xE0, 0xFF,        // 0106 LDH (IE),A
+                    0xFB,              // 0108 EI
+                    0x76,              // 0109 HALT
+                    0xC3, 0x09, 0x01,  // 010A JP $0109
+                }},
+               {0x0300,
+                {
+                    0x06, 0xFF,        // 0300 LD B,255
+                    0x05,              // 0302 DEC B
+                    0xC2, 0x02, 0x03,  // 0303 JP NZ,$0302
+                    0xC9,              // 0306 RET
+                }}}));
+  Profiler profiler(gameboy, 97);
+  for (int frame = 0; frame < 10; frame++) {
+    gameboy.runFrame();
+  }
+
+  std::string stacks = collapsed(profiler);
+  EXPECT_NE(stacks.find("main;00:0040;00:0300 "), std::string::npos);
+  EXPECT_NE(stacks.find("main "), std::string::npos);  // Halted
+}
+
+// ✅ **Test: Frames unwound by hand are dropped**
+TEST(ProfilerTest, UnwindsByStackPointer) {
+  GameBoy gameboy;
+  gameboy.loadRom(makeRom(0x8000, {{0x0100, {0xCD, 0x00, 0x03}},  // CALL
+                                   {0x0300,
+                                    {
+                                        0xE1,              // 0300 POP HL
+                                        0x06, 0x08,        // 0301 LD B,8
+                                        0x05,              // 0303 DEC B
+                                        0xC2, 0x03, 0x03,  // 0304 JP NZ,$0303
+                                        0xC3, 0x00, 0x01,  // 0307 JP $0100
+                                    }}}));
+  Profiler profiler(gameboy, 13);
+  gameboy.runCycles(100000);
+
+  EXPECT_GT(profiler.samples(), 0u);
+  EXPECT_EQ(collapsed(profiler).find(";00:0300;00:0300"), std::string::npos);
+}
+
+// ✅ **Test: Profiling leaves the machine's behavior and hash alone**
+TEST(ProfilerTest, DoesNotChangeState) {
+  GameBoy plain;
+  plain.loadRom(nestedCallRom());
+  plain.runCycles(300000);
+
+  GameBoy profiled;
+  profiled.loadRom(nestedCallRom());
+  {
+    Profiler profiler(profiled, 50);
+    profiled.runCycles(300000);
+  }
+  EXPECT_EQ(profiled.stateHash(), plain.stateHash());
+}
+
+// ✅ **Test: Profiles of separate machines merge**
+TEST(ProfilerTest, Merges) {
+  GameBoy first, second;
+  first.loadRom(nestedCallRom());
+  second.loadRom(nestedCallRom());
+  Profiler a(first, 61), b(second, 61);
+  first.runCycles(100000);
+  second.runCycles(100000);
+
+  EXPECT_EQ(collapsed(a), collapsed(b));
+  uint64_t samples = a.samples();
+  a.merge(b);
+  EXPECT_EQ(a.samples(), 2 * samples);
+  EXPECT_EQ(a.hotSpots()[0].second, 2 * b.hotSpots()[0].second);
+
+  a.reset();
+  EXPECT_EQ(a.samples(), 0u);
+  EXPECT_EQ(collapsed(a), "");
+}
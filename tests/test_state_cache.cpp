@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../include/joypad.hpp"
+#include "../include/state_cache.hpp"
+
+// ✅ Test Fixture: a scratch cache directory and a ROM that logs its input
+class StateCacheTest : public ::testing::Test {
+ protected:
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "gb_state_cache_test";
+  std::vector<uint8_t> rom = [] {
+    std::vector<uint8_t> image(0x8000, 0x00);
+    const uint8_t program[] = {
+        0x3E, 0x91,        // 0100 LD A,0x91
+        0xE0, 0x40,        // 0102 LDH (LCDC),A
+        0x3E, 0x10,        // 0104 LD A,0x10
+        0xE0, 0x00,        // 0106 LDH (P1),A
+        0x21, 0x00, 0xC0,  // 0108 LD HL,0xC000
+        0xF0, 0x00,        // 010B LDH A,(P1)
+        0x77,              // 010D LD (HL),A
+        0x2C,              // 010E INC L
+        0xC3, 0x0B, 0x01,  // 010F JP 0x010B
+    };
+    std::copy(std::begin(program), std::end(program), image.begin() + 0x100);
+    return image;
+  }();
+  Sha1Digest romHash = sha1(rom.data(), rom.size());
+
+  void SetUp() override { std::filesystem::remove_all(directory); }
+  void TearDown() override { std::filesystem::remove_all(directory); }
+
+  // Runs frames from `start`, storing a state every `interval` frames
+  static void run(GameBoy &gameboy, StateKey &key,
+                  const std::vector<uint8_t> &inputs, StateCache *cache,
+                  uint32_t interval) {
+    for (uint8_t buttons : inputs) {
+      gameboy.memory.io.setButtons(buttons);
+      gameboy.runFrame();
+      key.advance(buttons);
+      if (cache && key.frame % interval == 0) {
+        EXPECT_TRUE(cache->store(gameboy, key));
+      }
+    }
+  }
+
+  static std::vector<uint8_t> inputs(size_t frames, size_t diverge) {
+    std::vector<uint8_t> buttons(frames);
+    for (size_t frame = 0; frame < frames; frame++) {
+      buttons[frame] = frame % 3 == 0 ? ButtonA : 0;
+    }
+    for (size_t frame = diverge; frame < frames; frame++) {
+      buttons[frame] = ButtonB;
+    }
+    return buttons;
+  }
+};
+
+// ✅ **Test: SHA-1 matches the FIPS 180 examples**
+TEST_F(StateCacheTest, Sha1) {
+  EXPECT_EQ(toHex(sha1("", 0)), "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+  EXPECT_EQ(toHex(sha1("abc", 3)),
+            "a9993e364706816aba3e25717850c26c9cd0d89d");
+  std::string twoBlocks =
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  EXPECT_EQ(toHex(sha1(twoBlocks.data(), twoBlocks.size())),
+            "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+  std::string million(1000000, 'a');
+  EXPECT_EQ(toHex(sha1(million.data(), million.size())),
+            "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+}
+
+// ✅ **Test: A run resumes from the deepest state on its input prefix**
+TEST_F(StateCacheTest, ResumesFromDeepestState) {
+  StateCache cache;
+  std::string error;
+  ASSERT_TRUE(cache.open(directory.string(), StateCache::kDefaultCapacity,
+                         error))
+      << error;
+  GameBoy first;
+  first.loadRom(rom);
+  first.fastBoot();
+  StateKey start = StateKey::start(romHash, first.stateHash());
+  StateKey key = start;
+  run(first, key, inputs(20, 20), &cache, 5);
+  EXPECT_EQ(cache.getStats().stores, 4u);
+
+  // Shares the first 12 frames, so resumes after frame 10
+  std::vector<uint8_t> second = inputs(20, 12);
+  GameBoy resumed;
+  resumed.loadRom(rom);
+  resumed.fastBoot();
+  uint32_t frames = cache.restore(resumed, start, second);
+  EXPECT_EQ(frames, 10u);
+  key = start;
+  for (uint32_t frame = 0; frame < frames; frame++) {
+    key.advance(second[frame]);
+  }
+  run(resumed, key, {second.begin() + frames, second.end()}, nullptr, 1);
+
+  GameBoy fresh;
+  fresh.loadRom(rom);
+  fresh.fastBoot();
+  key = start;
+  run(fresh, key, second, nullptr, 1);
+  EXPECT_EQ(resumed.stateHash(), fresh.stateHash());
+
+  EXPECT_EQ(cache.getStats().lookups, 1u);
+  EXPECT_EQ(cache.getStats().hits, 1u);
+  EXPECT_EQ(cache.getStats().framesRestored, 10u);
+}
+
+// ✅ **Test: A miss leaves the machine alone**
+TEST_F(StateCacheTest, MissLeavesMachine) {
+  StateCache cache;
+  std::string error;
+  ASSERT_TRUE(cache.open(directory.string(), StateCache::kDefaultCapacity,
+                         error));
+  GameBoy gameboy;
+  gameboy.loadRom(rom);
+  StateKey start = StateKey::start(romHash, gameboy.stateHash());
+  StateKey key = start;
+  run(gameboy, key, inputs(4, 4), &cache, 2);
+
+  GameBoy other;
+  other.loadRom(rom);
+  uint64_t hash = other.stateHash();
+  EXPECT_EQ(cache.restore(other, start, inputs(4, 0)), 0u);
+  EXPECT_EQ(other.stateHash(), hash);
+  EXPECT_DOUBLE_EQ(cache.getStats().hitRate(), 0.0);
+}
+
+// ✅ **Test: The cap evicts the least recently used state, across opens**
+TEST_F(StateCacheTest, EvictsLeastRecentlyUsed) {
+  GameBoy gameboy;
+  gameboy.loadRom(rom);
+  StateKey start = StateKey::start(romHash, gameboy.stateHash());
+  uint64_t stateBytes = gameboy.saveState().size();
+
+  StateCache cache;
+  std::string error;
+  ASSERT_TRUE(cache.open(directory.string(), stateBytes * 5 / 2, error));
+  StateKey key = start;
+  run(gameboy, key, inputs(2, 2), &cache, 1);
+  StateKey first = start;
+  first.advance(inputs(2, 2)[0]);
+  std::vector<uint8_t> replay = {inputs(2, 2)[0]};
+  GameBoy reader;
+  reader.loadRom(rom);
+  EXPECT_EQ(cache.restore(reader, start, replay), 1u);  // Now most recent
+  run(gameboy, key, inputs(1, 0), &cache, 1);
+
+  EXPECT_EQ(cache.getStats().evictions, 1u);
+  EXPECT_TRUE(cache.contains(first));
+  EXPECT_TRUE(cache.contains(key));
+  EXPECT_LE(cache.size(), stateBytes * 5 / 2);
+
+  StateCache reopened;
+  ASSERT_TRUE(reopened.open(directory.string(), stateBytes * 5 / 2, error));
+  EXPECT_EQ(reopened.size(), cache.size());
+  EXPECT_TRUE(reopened.contains(first));
+}
+
+// ✅ **Test: A damaged state file is dropped and the search goes on**
+TEST_F(StateCacheTest, SkipsDamagedStates) {
+  StateCache cache;
+  std::string error;
+  ASSERT_TRUE(cache.open(directory.string(), StateCache::kDefaultCapacity,
+                         error));
+  GameBoy gameboy;
+  gameboy.loadRom(rom);
+  StateKey start = StateKey::start(romHash, gameboy.stateHash());
+  StateKey key = start;
+  run(gameboy, key, inputs(4, 4), &cache, 2);
+  std::ofstream(directory / key.fileName(), std::ios::binary) << "GBST";
+
+  GameBoy resumed;
+  resumed.loadRom(rom);
+  EXPECT_EQ(cache.restore(resumed, start, inputs(4, 4)), 2u);
+  EXPECT_FALSE(cache.contains(key));
+  EXPECT_FALSE(std::filesystem::exists(directory / key.fileName()));
+}
+
+// ✅ **Test: States serve runs with either idle-loop skipping setting**
+TEST_F(StateCacheTest, SharedAcrossIdleLoopSkipping) {
+  // Polls LY with VBlank enabled; the handler logs DIV to C000 onwards
+  std::vector<uint8_t> image(0x8000, 0x00);
+  const uint8_t program[] = {
+      0x21, 0x00, 0xC0,  // 0100 LD HL,0xC000
+      0x3E, 0x01,        // 0103 LD A,0x01
+      0xE0, 0xFF,        // 0105 LDH (IE),A
+      0xFB,              // 0107 EI
+      0xF0, 0x44,        // 0108 LDH A,(LY)
+      0xFE, 0xFF,        // 010A CP 0xFF
+      0x20, 0xFA,        // 010C JR NZ,-6
+  };
+  const uint8_t handler[] = {
+      0xF0, 0x04,  // 0040 LDH A,(DIV)
+      0x77,        // 0042 LD (HL),A
+      0x2C,        // 0043 INC L
+      0xD9,        // 0044 RETI
+  };
+  std::copy(std::begin(program), std::end(program), image.begin() + 0x100);
+  std::copy(std::begin(handler), std::end(handler), image.begin() + 0x40);
+  Sha1Digest imageHash = sha1(image.data(), image.size());
+
+  for (bool storeSkipping : {false, true}) {
+    std::filesystem::remove_all(directory);
+    StateCache cache;
+    std::string error;
+    ASSERT_TRUE(cache.open(directory.string(), StateCache::kDefaultCapacity,
+                           error));
+    GameBoy stored;
+    stored.idleLoopSkipping = storeSkipping;
+    stored.loadRom(image);
+    stored.fastBoot();  // Leaves a VBlank request pending
+    StateKey start = StateKey::start(imageHash, stored.stateHash());
+    StateKey key = start;
+    run(stored, key, inputs(6, 6), &cache, 3);
+
+    GameBoy resumed;
+    resumed.idleLoopSkipping = !storeSkipping;
+    resumed.loadRom(image);
+    resumed.fastBoot();
+    std::vector<uint8_t> buttons = inputs(10, 10);
+    uint32_t frames = cache.restore(resumed, start, buttons);
+    EXPECT_EQ(frames, 6u);
+    key = start;
+    for (uint32_t frame = 0; frame < frames; frame++) {
+      key.advance(buttons[frame]);
+    }
+    run(resumed, key, {buttons.begin() + frames, buttons.end()}, nullptr, 1);
+
+    GameBoy fresh;
+    fresh.idleLoopSkipping = !storeSkipping;
+    fresh.loadRom(image);
+    fresh.fastBoot();
+    key = start;
+    run(fresh, key, buttons, nullptr, 1);
+    EXPECT_EQ(resumed.stateHash(), fresh.stateHash());
+    EXPECT_EQ(stored.skippedIdleCycles > 0, storeSkipping);
+  }
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../include/joypad.hpp"
+#include "../include/vector_emulator.hpp"
+
+// ✅ Test Fixture: a ROM whose path depends on the A button
+class VectorEmulatorTest : public ::testing::Test {
+ protected:
+  std::vector<uint8_t> rom = [] {
+    std::vector<uint8_t> image(0x8000, 0x00);
+    const uint8_t program[] = {
+        0x3E, 0x91,        // LD A,0x91
+        0xE0, 0x40,        // LDH (LCDC),A
+        0x3E, 0x10,        // LD A,0x10
+        0xE0, 0x00,        // LDH (P1),A
+        0xF0, 0x00,        // 0108 LDH A,(P1)
+        0xCB, 0x47,        // BIT 0,A
+        0x28, 0x03,        // JR Z,0x0111
+        0x04,              // INC B
+        0x18, 0x01,        // JR 0x0112
+        0x05,              // 0111 DEC B
+        0x78,              // 0112 LD A,B
+        0xE0, 0x43,        // LDH (SCX),A
+        0xC3, 0x08, 0x01,  // JP 0x0108
+    };
+    std::copy(std::begin(program), std::end(program), image.begin() + 0x100);
+    return image;
+  }();
+
+  static uint8_t action(size_t machine, size_t frame) {
+    return ((machine + frame / 3) % 3 == 0) ? ButtonA : 0;
+  }
+};
+
+// ✅ **Test: Every machine matches a standalone machine given the same input**
+TEST_F(VectorEmulatorTest, MatchesScalarMachines) {
+  constexpr size_t kMachines = 7;
+  VectorEmulator batch(rom, kMachines);
+  std::vector<std::unique_ptr<GameBoy>> reference;
+  for (size_t i = 0; i < kMachines; i++) {
+    reference.push_back(std::make_unique<GameBoy>());
+    reference.back()->loadRom(rom);
+  }
+
+  std::vector<uint8_t> actions(kMachines);
+  std::vector<Observation> observations(kMachines);
+  for (size_t frame = 0; frame < 12; frame++) {
+    for (size_t i = 0; i < kMachines; i++) {
+      actions[i] = action(i, frame);
+      reference[i]->memory.setButtons(actions[i]);
+      reference[i]->runFrame();
+    }
+    batch.step(actions, observations);
+
+    for (size_t i = 0; i < kMachines; i++) {
+      EXPECT_EQ(batch.machine(i).stateHash(), reference[i]->stateHash());
+      EXPECT_EQ(observations[i].cycles, reference[i]->cpu.cycles);
+      EXPECT_EQ(observations[i].framebuffer,
+                batch.machine(i).ppu.getFramebuffer().data());
+    }
+  }
+  EXPECT_GT(batch.sharedDecodes, 0u);
+}
+
+// ✅ **Test: Machines with identical input stay in one group**
+TEST_F(VectorEmulatorTest, IdenticalInputsShareDecodes) {
+  VectorEmulator batch(rom, 4);
+  std::vector<uint8_t> actions(4, ButtonA);
+  std::vector<Observation> observations(4);
+  batch.step(actions, observations);
+
+  EXPECT_EQ(batch.scalarFallbacks, 0u);
+  EXPECT_EQ(batch.machine(0).stateHash(), batch.machine(3).stateHash());
+  EXPECT_EQ(&batch.machine(0).memory.getCartridge().getImage()->front(),
+            &batch.machine(3).memory.getCartridge().getImage()->front());
+}